@@ -10,7 +10,9 @@
 --
 -- DATE: October 4, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - "/replay" on the command line replays a capture headless
+--			  October 17, 2026 - "/headless" runs a connection from the console, without a window
+--			  October 17, 2026 - Starts the thread of sessions once the window exists
 --
 -- DESIGNER: Ruoqi Jia
 --
@@ -31,7 +33,17 @@ int WINAPI WinMain(HINSTANCE hInst, HINSTANCE hprevInstance,
 	HWND hwnd;
 	WNDCLASSEX wcl;
 	MSG Msg;
+	if (strncmp(lspszCmdParam, "/replay", 7) == 0)	//Headless replay of a capture, no window
+		return Run_Replay(lspszCmdParam + 7);
+	if (strncmp(lspszCmdParam, "/headless", 9) == 0)	//Console front end, no window
+		return Run_Headless_Console(__argc - 2, __argv + 2);
 	Initialize_Window(hInst, nCmdShow, hwnd, wcl);
+	listener.hwnd = hwnd;							//Where sessions posts what its ports did
+	if (!sessions.Start(read_chunk_size, write_chunk_size, send_pace_ms))
+	{
+		MessageBox(NULL, "Error Creating thread for the ports", "", MB_OK);
+		return 1;
+	}
 	while (GetMessage(&Msg, NULL, 0, 0))
 	{
 		TranslateMessage(&Msg);
@@ -0,0 +1,309 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: BackBuffer.cpp - Actual function implementation for BackBuffer.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- BackBuffer();
+-- ~BackBuffer();
+-- BOOL Resize(HWND hwnd);
+-- VOID Fill(int left, int top, int right, int bottom);
+-- VOID DrawRun(int x, int y, const unsigned int *text, int len, unsigned long color);
+-- VOID DrawCells(int x, int y, const unsigned int *text, int len, int pitch, unsigned long color);
+-- VOID Scroll(int dy);
+-- VOID Present(HDC hdc, const RECT &rc);
+-- VOID Release();
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Scroll moves the bitmap contents when the view scrolls
+--			  October 17, 2026 - Runs set the text color as well as the background
+--			  October 17, 2026 - Runs are drawn as UTF-16 with ExtTextOutW
+--			  October 17, 2026 - Fixed pitch runs are drawn with the spacing passed to ExtTextOutW
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Off-screen composition surface for the window. See BackBuffer.h.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include "BackBuffer.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: BackBuffer
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: BackBuffer();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Nothing is allocated until the first Resize.
+----------------------------------------------------------------------------------------------------------------------*/
+BackBuffer::BackBuffer()
+	: _hdc(NULL), _bitmap(NULL), _oldBitmap(NULL), _width(0), _height(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ~BackBuffer
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: ~BackBuffer();
+--
+-- RETURNS: N/A
+----------------------------------------------------------------------------------------------------------------------*/
+BackBuffer::~BackBuffer()
+{
+	Release();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Resize
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: BOOL Resize(HWND hwnd);
+--					-HWND hwnd: Handle to the window the buffer is presented on
+--
+-- RETURNS: TRUE if the bitmap was recreated and has to be composed again, FALSE if the size did not change
+--
+-- NOTES:
+--	Recreates the bitmap when the client area changed size. A minimized window has an empty client area, in
+--	that case the old bitmap is kept.
+----------------------------------------------------------------------------------------------------------------------*/
+BOOL BackBuffer::Resize(HWND hwnd)
+{
+	RECT rc;
+	GetClientRect(hwnd, &rc);
+	int width = rc.right - rc.left, height = rc.bottom - rc.top;
+	if (width <= 0 || height <= 0 || (_hdc && width == _width && height == _height))
+		return FALSE;
+	Release();
+	HDC hdc = GetDC(hwnd);								//Window device context to be compatible with
+	_hdc = CreateCompatibleDC(hdc);
+	_bitmap = CreateCompatibleBitmap(hdc, width, height);
+	ReleaseDC(hwnd, hdc);
+	_oldBitmap = SelectObject(_hdc, _bitmap);
+	_width = width, _height = height;
+	Fill(0, 0, width, height);
+	return TRUE;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Fill
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Fill(int left, int top, int right, int bottom);
+--					-int left, top, right, bottom: Rectangle to clear to the white background
+--
+-- RETURNS: VOID
+----------------------------------------------------------------------------------------------------------------------*/
+void BackBuffer::Fill(int left, int top, int right, int bottom)
+{
+	RECT rc = { left, top, right, bottom };
+	if (_hdc)
+		FillRect(_hdc, &rc, (HBRUSH)GetStockObject(WHITE_BRUSH));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: DrawRun
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Sets the text color of the run as well
+--			  October 17, 2026 - Converts the code points to UTF-16 for ExtTextOutW
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID DrawRun(int x, int y, const unsigned int *text, int len, unsigned long color);
+--					-int x, y:					Top left corner of the first character
+--					-const unsigned int *text:	Code points of the characters of the run
+--					-int len:					Number of characters
+--					-unsigned long color:		Background and text color of the run (see RenderTarget.h)
+--
+-- RETURNS: VOID
+----------------------------------------------------------------------------------------------------------------------*/
+void BackBuffer::DrawRun(int x, int y, const unsigned int *text, int len, unsigned long color)
+{
+	if (!_hdc)
+		return;
+	SetBkColor(_hdc, Run_Background(color));
+	SetTextColor(_hdc, Run_Ink(color));
+	_utf16.clear();
+	for (int i = 0; i < len; ++i)
+		if (text[i] < 0x10000)
+			_utf16.push_back((WCHAR)text[i]);
+		else											//Surrogate pair
+		{
+			_utf16.push_back((WCHAR)(0xD800 + ((text[i] - 0x10000) >> 10)));
+			_utf16.push_back((WCHAR)(0xDC00 + (text[i] & 0x3FF)));
+		}
+	ExtTextOutW(_hdc, x, y, 0, NULL, _utf16.data(), (UINT)_utf16.size(), NULL);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: DrawCells
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID DrawCells(int x, int y, const unsigned int *text, int len, int pitch, unsigned long color);
+--					-int x, y:					Top left corner of the first character
+--					-const unsigned int *text:	Code points of the characters of the run
+--					-int len:					Number of characters
+--					-int pitch:					Pixels from one character to the next
+--					-unsigned long color:		Background and text color of the run (see RenderTarget.h)
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	One ExtTextOutW with the distance to the next character given for each one, so GDI places the glyphs and
+--	fills the background over the whole pitch instead of the advance widths of the font. The second half of a
+--	surrogate pair moves by 0.
+----------------------------------------------------------------------------------------------------------------------*/
+void BackBuffer::DrawCells(int x, int y, const unsigned int *text, int len, int pitch, unsigned long color)
+{
+	if (!_hdc)
+		return;
+	SetBkColor(_hdc, Run_Background(color));
+	SetTextColor(_hdc, Run_Ink(color));
+	_utf16.clear();
+	_dx.clear();
+	for (int i = 0; i < len; ++i)
+		if (text[i] < 0x10000)
+		{
+			_utf16.push_back((WCHAR)text[i]);
+			_dx.push_back(pitch);
+		}
+		else											//Surrogate pair
+		{
+			_utf16.push_back((WCHAR)(0xD800 + ((text[i] - 0x10000) >> 10)));
+			_utf16.push_back((WCHAR)(0xDC00 + (text[i] & 0x3FF)));
+			_dx.push_back(pitch);
+			_dx.push_back(0);
+		}
+	ExtTextOutW(_hdc, x, y, 0, NULL, _utf16.data(), (UINT)_utf16.size(), _dx.data());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Scroll
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Scroll(int dy);
+--					-int dy: Pixels to move the contents down by, negative to move them up
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Moves the bitmap onto itself with one BitBlt, which GDI handles correctly when source and destination
+--	overlap. The rows that are exposed keep their old content until they are composed again.
+----------------------------------------------------------------------------------------------------------------------*/
+void BackBuffer::Scroll(int dy)
+{
+	if (!_hdc || dy == 0 || dy >= _height || -dy >= _height)
+		return;
+	if (dy > 0)
+		BitBlt(_hdc, 0, dy, _width, _height - dy, _hdc, 0, 0, SRCCOPY);
+	else
+		BitBlt(_hdc, 0, 0, _width, _height + dy, _hdc, 0, -dy, SRCCOPY);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Present
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Present(HDC hdc, const RECT &rc);
+--					-HDC hdc:			Device context of the window
+--					-const RECT &rc:	Area of the window to update
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Copies the area from the bitmap onto the window with a single BitBlt.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID BackBuffer::Present(HDC hdc, const RECT &rc)
+{
+	if (_hdc)
+		BitBlt(hdc, rc.left, rc.top, rc.right - rc.left, rc.bottom - rc.top, _hdc, rc.left, rc.top, SRCCOPY);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Release
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Release();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Deletes the bitmap and the memory device context.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID BackBuffer::Release()
+{
+	if (!_hdc)
+		return;
+	SelectObject(_hdc, _oldBitmap);
+	DeleteObject(_bitmap);
+	DeleteDC(_hdc);
+	_hdc = NULL, _bitmap = NULL, _oldBitmap = NULL;
+	_width = _height = 0;
+}
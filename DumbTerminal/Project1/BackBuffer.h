@@ -0,0 +1,63 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: BackBuffer.h - Off-screen bitmap the window contents are composed in for the dumb terminal
+--			emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- BackBuffer();
+-- ~BackBuffer();
+-- BOOL Resize(HWND hwnd);
+-- VOID Fill(int left, int top, int right, int bottom);
+-- VOID DrawRun(int x, int y, const unsigned int *text, int len, unsigned long color);
+-- VOID DrawCells(int x, int y, const unsigned int *text, int len, int pitch, unsigned long color);
+-- VOID Scroll(int dy);
+-- VOID Present(HDC hdc, const RECT &rc);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Scroll moves the bitmap contents when the view scrolls
+--			  October 17, 2026 - Runs are drawn as UTF-16 with ExtTextOutW
+--			  October 17, 2026 - Fixed pitch runs are drawn with the spacing passed to ExtTextOutW
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	GDI implementation of RenderTarget. A memory device context holds a bitmap the size of the client area that
+--	persists between paints and is only recreated when the window is resized. All text output goes to this bitmap;
+--	WM_PAINT copies the update rectangle onto the window with one BitBlt, so the visible surface never sees a
+--	partially drawn frame. The program is built with the ANSI API, but runs are Unicode and are drawn with the
+--	wide ExtTextOutW, so characters outside the code page show up as themselves.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef BACKBUFFER_H
+#define BACKBUFFER_H
+#include "RenderTarget.h"
+#include <vector>
+#include <windows.h>
+class BackBuffer : public RenderTarget
+{
+public:
+	BackBuffer();
+	~BackBuffer();
+	BOOL	Resize(HWND hwnd);										//Match the client area of hwnd
+	void	Fill(int left, int top, int right, int bottom);
+	void	DrawRun(int x, int y, const unsigned int *text, int len, unsigned long color);
+	void	DrawCells(int x, int y, const unsigned int *text, int len, int pitch, unsigned long color);
+	void	Scroll(int dy);
+	VOID	Present(HDC hdc, const RECT &rc);						//Copy rc onto the window
+
+private:
+	VOID	Release();
+
+	HDC		_hdc;				//Memory device context the bitmap is selected into
+	HBITMAP	_bitmap;			//The off-screen surface
+	HGDIOBJ	_oldBitmap;			//Bitmap that came with _hdc, restored before it is deleted
+	int		_width, _height;	//Size of the bitmap
+	std::vector<WCHAR>	_utf16;	//Run being drawn, kept between runs so it is allocated once
+	std::vector<INT>	_dx;	//Spacing of a fixed pitch run, same
+};
+#endif
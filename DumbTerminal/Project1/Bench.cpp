@@ -0,0 +1,950 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: Bench.cpp - Benchmarks of the receive-to-screen pipeline of the dumb terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- int main(int argc, char **argv);
+-- VOID *operator new(size_t size);
+-- VOID operator delete(VOID *p);
+-- static std::vector<char> Make_Workload(const std::string &name, size_t bytes);
+-- static Stage *Make_Stage(const std::string &name);
+-- static Result Measure(const std::string &stage, const std::vector<char> &data, size_t chunk, int reps);
+-- static VOID Print_Result(const Options &options, const std::string &workload, const std::string &stage,
+--						const Result &result);
+-- static size_t Peak_Resident();
+-- static VOID Run_Scrollback(const Options &options, const std::string &workload, const std::vector<char> &data);
+-- static VOID Run_Keystrokes(const Options &options);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Added the ansi workload and the parse stage
+--			  October 17, 2026 - Added the scan stages
+--			  October 17, 2026 - Added the utf8 workload and the decode stage
+--			  October 17, 2026 - Added the hex and hexview stages
+--			  October 17, 2026 - The screen stage stores runs of text, as the terminal does
+--			  October 17, 2026 - Added the scrollback stage
+--			  October 17, 2026 - Added the keystroke stage
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Built by CMakeLists.txt as dtbench. Every workload is fed to every stage in read_chunk_size (4KB) chunks, the
+--	way the reader thread hands bytes to the UI thread, and each stage reports MB/s, ns per byte and heap
+--	allocations per MB, where a MB is 2^20 bytes. The workloads are synthetic and generated from a fixed seed, so
+--	the same build gives the same bytes every run:
+--		ascii		Printable lines of 40 to 120 characters ending in CR LF
+--		crlog		Log lines with progress counters redrawn in place after a CR, as build and download tools do
+--		backspace	Interactive typing: words, typos erased with runs of BS and retyped, the odd tab and CR LF
+--		binary		Uniformly random bytes, every control character included
+--		ansi		Colored log lines: SGR colors around the level and the message, the odd progress line redrawn
+--					with CR and EL, as the tools on our devices print them
+--		utf8		Log lines in UTF-8: mostly ASCII, with one word in six accented, Greek, CJK, a symbol or an
+--					emoji, i.e. two to four bytes per character
+--	The stages follow a chunk from the port to the draw calls. The first eight stand alone; rows includes what the
+--	ones before it do, because the terminal does it all in a single pass, and render includes rows:
+--		ingest		Copying through rxRing, from the reader's buffer to the UI thread's
+--		control		Dispatching every byte on the control characters, with nothing stored, as the terminal did
+--					before it parsed escape sequences
+--		scan-scalar	The search for the next control character the parser does in the ground state, stepping over
+--		scan-sse2	each control found, with the byte, SSE2 and AVX2 versions of Printable_Run (see ControlScan.h).
+--		scan-avx2	A version the processor does not support is left out
+--		decode		Utf8Decoder turning the bytes into code points, to compare with ingest, which only copies them
+--		parse		VtParser splitting the bytes into text runs, controls and sequences, on a handler that only
+--					counts them
+--		screen		Control handling applied to a ScreenModel, with the runs of text between controls found by
+--					Printable_Run and stored a run at a time, as the terminal stores them: cells appended and
+--					replaced, lines broken, trimmed. Escape sequences are not parsed and the bytes not decoded
+--		rows		Terminal::Write: parsing, decoding and the above, plus wrapping into the RowIndex and marking
+--					what changed
+--		render		The above plus Compose of every changed area into a RenderTarget that only counts DrawRun
+--					calls, so the draw commands are generated but nothing is rasterized
+--	and, for the hex view, on their own:
+--		hex			Hex_Dump of every chunk into a buffer, i.e. formatting every byte received, which the view
+--					never has to do
+--		hexview		HexView::Write, then Compose of every changed area into the counting target, i.e. what the
+--					hex view costs per chunk: recording the bytes and formatting the rows in view
+--	Each measurement is the median of --reps runs, each on a fresh stage. Allocations are counted by replacing the
+--	global operator new, only while a stage is being fed.
+--
+--	Two more stages only run when asked for with --stage, because they measure something other than throughput:
+--		scrollback	Terminal::Write of the workload over and over until --total bytes (1GB) went into the history,
+--					with the window's scrollback limits, then the bytes the history holds resident and compressed
+--					(ScreenModel::ResidentBytes and CompressedBytes) and the peak resident set of the process
+--		keystroke	A typing session of 10k lines from the backspace workload, whatever --workload says, fed a byte
+--					at a time as render does, each byte timed on its own: the latency of a keystroke's echo from
+--					Write to the last draw command, as percentiles over all keystrokes and over the backspaces
+--
+--	Arguments: [--bytes N] [--reps N] [--chunk N] [--total N] [--workload NAME] [--stage NAME] [--label TEXT]
+--			   [--json]
+--	The default output is a table. --json prints one JSON object per line instead, tagged with --label (e.g. the
+--	commit id), so results can be appended to a file and compared across commits.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+#include "ControlScan.h"
+#include "HexFormat.h"
+#include "HexView.h"
+#include "Replay.h"
+#include "RingBuffer.h"
+#include "ScreenModel.h"
+#include "Terminal.h"
+#include "Utf8Decoder.h"
+#include "VtParser.h"
+static std::atomic<unsigned long long>	allocations(0);		//operator new calls since the program started
+static volatile size_t					sink;				//Keeps the results of the control stage alive
+static const char						*WORKLOADS[] = { "ascii", "crlog", "backspace", "binary", "ansi", "utf8" };
+static const char						*STAGES[] = { "ingest", "control", "scan-scalar", "scan-sse2", "scan-avx2",
+	"decode", "parse", "screen", "rows", "render", "hex", "hexview" };
+static const size_t						SCROLLBACK_LINES = 100000;	//Limits of the history, as in the window
+static const size_t						SCROLLBACK_BYTES = 64 << 20;
+static const size_t						SESSION_LINES = 10000;		//Lines typed by the keystroke stage
+
+struct Options
+{
+	size_t		bytes;					//Bytes in each workload
+	int			reps;					//Runs per measurement
+	size_t		chunk;					//Bytes fed at a time
+	size_t		total;					//Bytes the scrollback stage appends
+	std::string	workload;				//Only this workload, empty for all
+	std::string	stage;					//Only this stage, empty for all
+	std::string	label;					//Tag of the JSON lines
+	bool		json;
+};
+
+struct Result
+{
+	double	seconds;					//Median time to feed the workload
+	double	allocs;						//Allocations while feeding it
+	double	drawCalls;					//Draw calls while feeding it, render and hexview stages only
+};
+
+class Stage								//One stage of the pipeline, fed a chunk at a time
+{
+public:
+	virtual ~Stage() {}
+	virtual void	Feed(const char *buf, size_t len) = 0;
+	virtual double	DrawCalls() const { return 0; }
+};
+
+class IngestStage : public Stage		//Reader's buffer -> rxRing -> UI thread's buffer
+{
+public:
+	IngestStage() : _ring(Ring()), _out(1 << 16) { _ring.Clear(); }
+	void Feed(const char *buf, size_t len)
+	{
+		for (size_t done = 0, n; done < len; done += n)
+		{
+			n = _ring.Write(buf + done, len - done);
+			_ring.Read(_out.data(), n);
+		}
+	}
+
+private:
+	static RingBuffer &Ring()
+	{
+		static RingBuffer ring(1 << 16);	//Over-aligned, so kept off the heap like rxRing
+		return ring;
+	}
+
+	RingBuffer			&_ring;
+	std::vector<char>	_out;
+};
+
+class ControlStage : public Stage		//The byte dispatch Terminal::Write did before the parser, on counters
+{
+public:
+	ControlStage() : _col(0), _lines(0), _cells(0) {}
+	~ControlStage() { sink = _col + _lines + _cells; }
+	void Feed(const char *buf, size_t len)
+	{
+		for (size_t i = 0; i < len; ++i)
+			switch (buf[i])
+			{
+			case '\b':
+				_col -= _col > 0;
+				break;
+			case '\r':
+				_col = 0;
+				break;
+			case '\n':
+				++_lines;
+				_col = 0;
+				break;
+			case '\t':
+				_col = (_col / Terminal::TAB_CELLS + 1) * Terminal::TAB_CELLS;
+				break;
+			default:
+				++_col;
+				++_cells;
+			}
+	}
+
+private:
+	size_t	_col, _lines, _cells;
+};
+
+class ScanStage : public Stage			//Printable_Run over the chunk, one call per run of text
+{
+public:
+	explicit ScanStage(ScanLevel level) : _level(level), _runs(0) {}
+	~ScanStage() { sink = _runs; }
+	void Feed(const char *buf, size_t len)
+	{
+		for (size_t i = 0; i < len; ++i, ++_runs)
+			i += Printable_Run_With(_level, buf + i, len - i);
+	}
+
+private:
+	ScanLevel	_level;
+	size_t		_runs;
+};
+
+class DecodeStage : public Stage		//Utf8Decoder, into a buffer of code points
+{
+public:
+	DecodeStage() : _count(0) {}
+	~DecodeStage() { sink = _count; }
+	void Feed(const char *buf, size_t len)
+	{
+		if (_out.size() < len + 1)
+			_out.resize(len + 1);
+		_count += _decoder.Decode(buf, len, _out.data());
+	}
+
+private:
+	Utf8Decoder					_decoder;
+	std::vector<unsigned int>	_out;
+	size_t						_count;
+};
+
+class ParseStage : public Stage, private VtHandler	//VtParser, on a handler that only counts
+{
+public:
+	ParseStage() : _count(0) {}
+	~ParseStage() { sink = _count; }
+	void Feed(const char *buf, size_t len) { _parser.Feed(buf, len, *this); }
+
+private:
+	void Print(const char * /*text*/, size_t len) { _count += len; }
+	void Execute(char /*c*/) { ++_count; }
+	void EscDispatch(const VtSequence & /*seq*/, char /*final*/) { ++_count; }
+	void CsiDispatch(const VtSequence &seq, char /*final*/) { _count += seq.paramCount; }
+	void OscDispatch(const char * /*text*/, size_t /*len*/) { ++_count; }
+
+	VtParser	_parser;
+	size_t		_count;
+};
+
+class ScreenStage : public Stage		//Control handling applied to the history, no layout
+{
+public:
+	ScreenStage() : _col(0) { _screen.SetLimits(100000, 64 << 20); }
+	void Feed(const char *buf, size_t len)
+	{
+		size_t head, line, n;
+		for (const char *end = buf + len; buf < end; buf += n)
+		{
+			if ((n = Printable_Run(buf, end - buf)) > 0)		//Text, replacing cells and then appended as a run
+			{
+				line = _screen.LineCount() - 1;
+				size_t i = 0;
+				for (; i < n && _col < _screen.LineLength(line); ++i)
+					_screen.Put(_col++, (unsigned char)buf[i], 0);
+				_screen.AppendRun(buf + i, n - i, 0);
+				_col += n - i;
+				continue;
+			}
+			n = 1;
+			switch (*buf)
+			{
+			case '\b':
+				_col -= _col > 0;
+				break;
+			case '\r':
+				_col = 0;
+				break;
+			case '\n':
+				_screen.NewLine();
+				_col = 0;
+				break;
+			case '\t':
+				for (size_t stop = (_col / Terminal::TAB_CELLS + 1) * Terminal::TAB_CELLS; _col < stop; ++_col)
+					if (_col >= _screen.LineLength(_screen.LineCount() - 1))
+						_screen.Append(' ', 0);
+				break;
+			}
+		}
+		_screen.Trim(head);
+		_col = _col > head ? _col - head : 0;
+	}
+
+private:
+	ScreenModel	_screen;
+	size_t		_col;
+};
+
+class CountingTarget : public RenderTarget	//Takes the draw commands and only counts them
+{
+public:
+	CountingTarget() : calls(0) {}
+	void Fill(int /*left*/, int /*top*/, int /*right*/, int /*bottom*/) { ++calls; }
+	void DrawRun(int /*x*/, int /*y*/, const unsigned int * /*text*/, int /*len*/, unsigned long /*color*/) { ++calls; }
+	void DrawCells(int /*x*/, int /*y*/, const unsigned int * /*text*/, int /*len*/, int /*pitch*/,
+		unsigned long /*color*/) { ++calls; }
+	void Scroll(int /*dy*/) { ++calls; }
+	unsigned long long calls;
+};
+
+class TerminalStage : public Stage		//Terminal::Write, and with compose the draw commands as well
+{
+public:
+	explicit TerminalStage(bool compose) : _metrics(8, 16, 80, 25), _compose(compose)
+	{
+		_terminal.UpdateMetrics(_metrics, true);
+		_terminal.SetScrollback(SCROLLBACK_LINES, SCROLLBACK_BYTES);
+	}
+	void Feed(const char *buf, size_t len)
+	{
+		int left, top, right, bottom, dy;
+		_terminal.ResetFrame();
+		_terminal.Write(buf, len, 0);
+		if ((dy = _terminal.TakeScroll()) != 0 && _compose)
+			_target.Scroll(dy);
+		while (_terminal.NextDirty(left, top, right, bottom))
+			if (_compose)
+				_terminal.Compose(_target, left, top, right, bottom);
+	}
+	double DrawCalls() const { return (double)_target.calls; }
+	const ScreenModel &Screen() const { return _terminal.Screen(); }
+
+private:
+	FixedMetrics	_metrics;
+	Terminal		_terminal;
+	CountingTarget	_target;
+	bool			_compose;
+};
+
+class HexStage : public Stage			//Hex_Dump of the chunk, every byte formatted
+{
+public:
+	HexStage() : _offset(0) {}
+	void Feed(const char *buf, size_t len)
+	{
+		if (_out.size() < Hex_Dump_Size(len))
+			_out.resize(Hex_Dump_Size(len));
+		sink = Hex_Dump(_out.data(), _offset, buf, len);
+		_offset += len;
+	}
+
+private:
+	std::vector<char>	_out;
+	unsigned long long	_offset;
+};
+
+class HexViewStage : public Stage		//HexView::Write and Compose of the rows in view
+{
+public:
+	HexViewStage() : _metrics(8, 16, 80, 25)
+	{
+		_view.UpdateMetrics(_metrics, true);
+		_view.SetLimit(16 << 20);
+	}
+	void Feed(const char *buf, size_t len)
+	{
+		int left, top, right, bottom, dy;
+		_view.ResetFrame();
+		_view.Write(buf, len, 0);
+		if ((dy = _view.TakeScroll()) != 0)
+			_target.Scroll(dy);
+		while (_view.NextDirty(left, top, right, bottom))
+			_view.Compose(_target, left, top, right, bottom);
+	}
+	double DrawCalls() const { return (double)_target.calls; }
+
+private:
+	FixedMetrics	_metrics;
+	HexView			_view;
+	CountingTarget	_target;
+};
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: operator new
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID *operator new(size_t size);
+--					-size_t size: Bytes to allocate
+--
+-- RETURNS: The memory, throws std::bad_alloc when there is none
+--
+-- NOTES:
+--	Counts the allocation and takes the memory from malloc. The array forms go through here as well.
+----------------------------------------------------------------------------------------------------------------------*/
+void *operator new(size_t size)
+{
+	void *p;
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if ((p = malloc(size ? size : 1)) == NULL)
+		throw std::bad_alloc();
+	return p;
+}
+
+void *operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: operator delete
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID operator delete(VOID *p);
+--					-VOID *p: Memory from operator new, or NULL
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Gives the memory back to malloc. The array and sized forms go through here as well.
+----------------------------------------------------------------------------------------------------------------------*/
+void operator delete(void *p) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+	free(p);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Make_Workload
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Added ansi
+--			  October 17, 2026 - Added utf8
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static std::vector<char> Make_Workload(const std::string &name, size_t bytes);
+--					-const std::string &name:	One of WORKLOADS
+--					-size_t bytes:				Size of the workload
+--
+-- RETURNS: The bytes of the workload, empty for an unknown name
+--
+-- NOTES:
+--	Generated with an xorshift generator from a fixed seed, so every run and every build sees the same bytes.
+--	The workloads are described at the top of the file.
+----------------------------------------------------------------------------------------------------------------------*/
+static std::vector<char> Make_Workload(const std::string &name, size_t bytes)
+{
+	static const char	WORD[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+	unsigned long long	state = 0x9E3779B97F4A7C15ULL;
+	std::vector<char>	data;
+	char				text[64];
+	auto Next = [&state](unsigned long long range)			//Next number in [0, range)
+	{
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		return (size_t)(state % range);
+	};
+	auto Word = [&](size_t len)								//len letters and digits
+	{
+		for (size_t i = 0; i < len; ++i)
+			data.push_back(WORD[Next(sizeof(WORD) - 1)]);
+	};
+	data.reserve(bytes + 256);
+	while (data.size() < bytes)
+	{
+		if (name == "ascii")
+		{
+			for (size_t len = 40 + Next(81), i = 0; i < len; ++i)
+				data.push_back((char)(' ' + Next(95)));
+			data.push_back('\r');
+			data.push_back('\n');
+		}
+		else if (name == "crlog")
+		{
+			data.insert(data.end(), text, text + snprintf(text, sizeof(text), "[%6zu] fetching ", data.size()));
+			Word(8 + Next(24));
+			for (int percent = 0; percent <= 100; percent += 1 + (int)Next(10))
+			{
+				data.push_back('\r');
+				data.insert(data.end(), text, text + snprintf(text, sizeof(text), "  %3d%% %zu kB", percent,
+					Next(100000)));
+			}
+			data.push_back('\r');
+			data.push_back('\n');
+		}
+		else if (name == "backspace")
+		{
+			Word(2 + Next(9));
+			if (Next(4) == 0)								//Typo, erased and retyped
+			{
+				size_t erase = 1 + Next(4);
+				Word(erase);
+				data.insert(data.end(), erase, '\b');
+				Word(erase);
+			}
+			data.push_back(Next(12) == 0 ? '\t' : ' ');
+			if (Next(10) == 0)
+			{
+				data.push_back('\r');
+				data.push_back('\n');
+			}
+		}
+		else if (name == "binary")
+			data.push_back((char)Next(256));
+		else if (name == "utf8")
+		{
+			static const char *WIDE[] = { "caf\xc3\xa9", "na\xc3\xafve", "\xce\xb1\xce\xb2\xce\xb3",
+				"\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e", "\xe2\x86\x92", "\xe2\x9c\x93",
+				"\xf0\x9f\x93\xa6" };
+			data.insert(data.end(), text, text + snprintf(text, sizeof(text), "%8zu ", data.size()));
+			for (size_t words = 3 + Next(10); words > 0; --words)
+			{
+				if (Next(6) == 0)
+				{
+					const char *word = WIDE[Next(sizeof(WIDE) / sizeof(WIDE[0]))];
+					data.insert(data.end(), word, word + strlen(word));
+				}
+				else
+					Word(2 + Next(9));
+				data.push_back(' ');
+			}
+			data.push_back('\r');
+			data.push_back('\n');
+		}
+		else if (name == "ansi")
+		{
+			static const char *LEVEL[] = { "\x1b[32mINFO\x1b[0m", "\x1b[33mWARN\x1b[0m", "\x1b[1;31mERROR\x1b[0m",
+				"\x1b[38;5;244mDEBUG\x1b[39m" };
+			const char *level = LEVEL[Next(4)];
+			data.insert(data.end(), text, text + snprintf(text, sizeof(text), "\x1b[2m%8zu\x1b[22m %s ", data.size(),
+				level));
+			for (size_t words = 3 + Next(10); words > 0; --words)
+			{
+				if (Next(8) == 0)								//A highlighted word
+				{
+					data.insert(data.end(), text, text + snprintf(text, sizeof(text), "\x1b[%zum", 31 + Next(7)));
+					Word(3 + Next(8));
+					data.insert(data.end(), text, text + snprintf(text, sizeof(text), "\x1b[0m"));
+				}
+				else
+					Word(2 + Next(9));
+				data.push_back(' ');
+			}
+			if (Next(6) == 0)									//Progress redrawn in place
+				for (int percent = 0; percent <= 100; percent += 5 + (int)Next(20))
+					data.insert(data.end(), text, text + snprintf(text, sizeof(text), "\r\x1b[K\x1b[36m%3d%%\x1b[0m",
+						percent));
+			data.push_back('\r');
+			data.push_back('\n');
+		}
+		else
+			return std::vector<char>();
+	}
+	data.resize(bytes);
+	return data;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Make_Stage
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Added parse
+--			  October 17, 2026 - Added the scan stages
+--			  October 17, 2026 - Added the utf8 workload and the decode stage
+--			  October 17, 2026 - Added decode
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static Stage *Make_Stage(const std::string &name);
+--					-const std::string &name: One of STAGES
+--
+-- RETURNS: A new stage, NULL for an unknown name or a scan the processor does not support
+--
+-- NOTES:
+--	The stages are described at the top of the file.
+----------------------------------------------------------------------------------------------------------------------*/
+static Stage *Make_Stage(const std::string &name)
+{
+	if (name == "ingest")
+		return new IngestStage;
+	if (name == "control")
+		return new ControlStage;
+	for (int level = SCAN_SCALAR; level < SCAN_LEVELS; ++level)
+		if (name == std::string("scan-") + Scan_Name((ScanLevel)level))
+			return Scan_Supported((ScanLevel)level) ? new ScanStage((ScanLevel)level) : NULL;
+	if (name == "decode")
+		return new DecodeStage;
+	if (name == "parse")
+		return new ParseStage;
+	if (name == "screen")
+		return new ScreenStage;
+	if (name == "rows")
+		return new TerminalStage(false);
+	if (name == "render")
+		return new TerminalStage(true);
+	if (name == "hex")
+		return new HexStage;
+	if (name == "hexview")
+		return new HexViewStage;
+	return NULL;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Measure
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static Result Measure(const std::string &stage, const std::vector<char> &data, size_t chunk, int reps);
+--					-const std::string &stage:		Stage to run
+--					-const std::vector<char> &data:	Workload fed to it
+--					-size_t chunk:					Bytes fed at a time
+--					-int reps:						Runs to take the median of
+--
+-- RETURNS: The median time, and the allocations and draw calls of the median run
+--
+-- NOTES:
+--	Each run builds a fresh stage first, so neither its construction nor what an earlier run left behind is
+--	timed or counted.
+----------------------------------------------------------------------------------------------------------------------*/
+static Result Measure(const std::string &stage, const std::vector<char> &data, size_t chunk, int reps)
+{
+	typedef std::chrono::steady_clock Clock;
+	std::vector<Result> runs;
+	for (int rep = 0; rep < reps; ++rep)
+	{
+		std::unique_ptr<Stage>	s(Make_Stage(stage));
+		Result					run;
+		unsigned long long		before = allocations.load(std::memory_order_relaxed);
+		Clock::time_point		start = Clock::now();
+		for (size_t done = 0; done < data.size(); done += chunk)
+			s->Feed(data.data() + done, std::min(chunk, data.size() - done));
+		run.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		run.allocs = (double)(allocations.load(std::memory_order_relaxed) - before);
+		run.drawCalls = s->DrawCalls();
+		runs.push_back(run);
+	}
+	std::sort(runs.begin(), runs.end(), [](const Result &a, const Result &b) { return a.seconds < b.seconds; });
+	return runs[runs.size() / 2];
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Print_Result
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Print_Result(const Options &options, const std::string &workload,
+--						const std::string &stage, const Result &result);
+--					-const Options &options:		Size of the workload and the output format
+--					-const std::string &workload:	Workload measured
+--					-const std::string &stage:		Stage measured
+--					-const Result &result:			The measurement
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Prints a row of the table, or a JSON line with --json. Draw calls per MB are only meaningful for render and
+--	are 0 for the other stages.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Print_Result(const Options &options, const std::string &workload, const std::string &stage,
+	const Result &result)
+{
+	double mb = (double)options.bytes / (1 << 20);
+	double seconds = result.seconds > 0 ? result.seconds : 1e-9;
+	if (options.json)
+		printf("{\"label\":\"%s\",\"workload\":\"%s\",\"stage\":\"%s\",\"bytes\":%zu,\"chunk\":%zu,\"seconds\":%.6f,"
+			"\"mb_per_s\":%.2f,\"ns_per_byte\":%.3f,\"allocs_per_mb\":%.2f,\"draw_calls_per_mb\":%.1f}\n",
+			options.label.c_str(), workload.c_str(), stage.c_str(), options.bytes, options.chunk, result.seconds,
+			mb / seconds, seconds * 1e9 / options.bytes, result.allocs / mb, result.drawCalls / mb);
+	else
+		printf("%-10s %-11s %10.1f %10.3f %12.2f %14.1f\n", workload.c_str(), stage.c_str(), mb / seconds,
+			seconds * 1e9 / options.bytes, result.allocs / mb, result.drawCalls / mb);
+	fflush(stdout);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Peak_Resident
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static size_t Peak_Resident();
+--
+-- RETURNS: The most memory the process has had resident since it started, in bytes, 0 when the system would not
+--			tell
+--
+-- NOTES:
+--	The peak working set on Windows, the maximum resident set from getrusage on Linux.
+----------------------------------------------------------------------------------------------------------------------*/
+static size_t Peak_Resident()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	return K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.PeakWorkingSetSize : 0;
+#else
+	struct rusage usage;
+	return getrusage(RUSAGE_SELF, &usage) == 0 ? (size_t)usage.ru_maxrss << 10 : 0;		//ru_maxrss is in KB
+#endif
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Run_Scrollback
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Run_Scrollback(const Options &options, const std::string &workload,
+--						const std::vector<char> &data);
+--					-const Options &options:		Bytes to append, chunk size and the output format
+--					-const std::string &workload:	Workload appended
+--					-const std::vector<char> &data:	Its bytes, fed again and again until options.total went in
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Runs once, not --reps times: a gigabyte takes seconds, and the memory at the end is the result, not the time.
+--	The peak is the process's, so it covers whatever ran before; run a single workload to see the history alone.
+--	Memory is printed in MB.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Run_Scrollback(const Options &options, const std::string &workload, const std::vector<char> &data)
+{
+	typedef std::chrono::steady_clock Clock;
+	TerminalStage		stage(false);
+	size_t				done = 0, n;
+	Clock::time_point	start = Clock::now();
+	while (done < options.total)
+		for (size_t at = 0; at < data.size() && done < options.total; at += n, done += n)
+		{
+			n = std::min(std::min(options.chunk, data.size() - at), options.total - done);
+			stage.Feed(data.data() + at, n);
+		}
+	double	seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	double	mb = (double)(1 << 20);
+	if (options.json)
+		printf("{\"label\":\"%s\",\"workload\":\"%s\",\"stage\":\"scrollback\",\"bytes\":%zu,\"chunk\":%zu,"
+			"\"seconds\":%.6f,\"mb_per_s\":%.2f,\"lines\":%zu,\"resident_bytes\":%zu,\"compressed_bytes\":%zu,"
+			"\"peak_rss_bytes\":%zu}\n", options.label.c_str(), workload.c_str(), done, options.chunk, seconds,
+			done / mb / seconds, stage.Screen().LineCount(), stage.Screen().ResidentBytes(),
+			stage.Screen().CompressedBytes(), Peak_Resident());
+	else
+		printf("%-10s %-11s %10.1f MB/s, %zu lines kept, %.1f MB resident, %.1f MB compressed, %.1f MB peak RSS\n",
+			workload.c_str(), "scrollback", done / mb / seconds, stage.Screen().LineCount(),
+			stage.Screen().ResidentBytes() / mb, stage.Screen().CompressedBytes() / mb, Peak_Resident() / mb);
+	fflush(stdout);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Run_Keystrokes
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Run_Keystrokes(const Options &options);
+--					-const Options &options: Output format
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Each keystroke is one byte through TerminalStage(true), i.e. Write, the scroll and Compose of what changed,
+--	as the echo of a typed character is drawn. The latencies are in ns; the clock is read twice per keystroke, so
+--	they include the cost of one read of steady_clock.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Run_Keystrokes(const Options &options)
+{
+	typedef std::chrono::steady_clock Clock;
+	std::vector<char>	data = Make_Workload("backspace", SESSION_LINES * 100);
+	std::vector<double>	all, erase;
+	TerminalStage		stage(true);
+	size_t				lines = 0, len = 0;
+	while (len < data.size() && lines < SESSION_LINES)
+		lines += data[len++] == '\n';
+	all.reserve(len);
+	for (size_t i = 0; i < len; ++i)
+	{
+		Clock::time_point start = Clock::now();
+		stage.Feed(&data[i], 1);
+		all.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+		if (data[i] == '\b')
+			erase.push_back(all.back());
+	}
+	std::sort(all.begin(), all.end());
+	std::sort(erase.begin(), erase.end());
+	auto At = [](const std::vector<double> &ns, double fraction)	//Percentile of the sorted latencies
+	{
+		return ns.empty() ? 0 : ns[std::min(ns.size() - 1, (size_t)(fraction * ns.size()))];
+	};
+	if (options.json)
+		printf("{\"label\":\"%s\",\"workload\":\"backspace\",\"stage\":\"keystroke\",\"lines\":%zu,"
+			"\"keystrokes\":%zu,\"backspaces\":%zu,\"p50_ns\":%.0f,\"p99_ns\":%.0f,\"p999_ns\":%.0f,\"max_ns\":%.0f,"
+			"\"backspace_p50_ns\":%.0f,\"backspace_p99_ns\":%.0f,\"backspace_p999_ns\":%.0f,\"backspace_max_ns\":%.0f,"
+			"\"draw_calls_per_key\":%.2f}\n", options.label.c_str(), lines, all.size(), erase.size(), At(all, 0.5),
+			At(all, 0.99), At(all, 0.999), At(all, 1), At(erase, 0.5), At(erase, 0.99), At(erase, 0.999), At(erase, 1),
+			stage.DrawCalls() / len);
+	else
+	{
+		printf("%zu lines, %zu keystrokes, %zu backspaces, %.2f draw calls per keystroke\n", lines, all.size(),
+			erase.size(), stage.DrawCalls() / len);
+		printf("%-10s %10s %10s %10s %10s\n", "ns", "p50", "p99", "p99.9", "max");
+		printf("%-10s %10.0f %10.0f %10.0f %10.0f\n", "keystroke", At(all, 0.5), At(all, 0.99), At(all, 0.999),
+			At(all, 1));
+		printf("%-10s %10.0f %10.0f %10.0f %10.0f\n", "backspace", At(erase, 0.5), At(erase, 0.99), At(erase, 0.999),
+			At(erase, 1));
+	}
+	fflush(stdout);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: main
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Runs the scrollback stage when asked for
+--			  October 17, 2026 - Runs the keystroke stage when asked for
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int main(int argc, char **argv);
+--					-int argc:		Number of arguments
+--					-char **argv:	Arguments, listed at the top of the file
+--
+-- RETURNS: 0, or 2 for bad arguments
+--
+-- NOTES:
+--	Measures every stage on every workload, 8MB each and 5 runs per measurement unless told otherwise. A scan the
+--	processor does not support is skipped.
+----------------------------------------------------------------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+	Options options = { 8 << 20, 5, 4096, (size_t)1 << 30, "", "", "", false };
+	for (int i = 1; i < argc; ++i)
+	{
+		const char *next = i + 1 < argc ? argv[i + 1] : "";
+		if (strcmp(argv[i], "--json") == 0)
+			options.json = true;
+		else if (strcmp(argv[i], "--bytes") == 0 && atol(next) > 0)
+			options.bytes = (size_t)atol(argv[++i]);
+		else if (strcmp(argv[i], "--reps") == 0 && atoi(next) > 0)
+			options.reps = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--chunk") == 0 && atol(next) > 0)
+			options.chunk = (size_t)atol(argv[++i]);
+		else if (strcmp(argv[i], "--total") == 0 && atoll(next) > 0)
+			options.total = (size_t)atoll(argv[++i]);
+		else if (strcmp(argv[i], "--workload") == 0 && !Make_Workload(next, 1).empty())
+			options.workload = argv[++i];
+		else if (strcmp(argv[i], "--stage") == 0
+			&& (strcmp(next, "scrollback") == 0 || strcmp(next, "keystroke") == 0
+			|| std::unique_ptr<Stage>(Make_Stage(next))))
+			options.stage = argv[++i];
+		else if (strcmp(argv[i], "--label") == 0 && i + 1 < argc)
+			options.label = argv[++i];
+		else
+		{
+			fprintf(stderr, "usage: dtbench [--bytes N] [--reps N] [--chunk N] [--total N]\n"
+				"               [--workload ascii|crlog|backspace|binary|ansi|utf8]\n"
+				"               [--stage ingest|control|scan-scalar|scan-sse2|scan-avx2|decode|parse|\n"
+				"                        screen|rows|render|hex|hexview|scrollback|keystroke]\n"
+				"               [--label TEXT] [--json]\n");
+			return 2;
+		}
+	}
+	if (options.stage == "keystroke")
+	{
+		Run_Keystrokes(options);
+		return 0;
+	}
+	if (!options.json && options.stage != "scrollback")
+		printf("%-10s %-11s %10s %10s %12s %14s\n", "workload", "stage", "MB/s", "ns/byte", "allocs/MB",
+			"draw calls/MB");
+	for (const char *workload : WORKLOADS)
+	{
+		if (!options.workload.empty() && options.workload != workload)
+			continue;
+		std::vector<char> data = Make_Workload(workload, options.bytes);
+		if (options.stage == "scrollback")
+			Run_Scrollback(options, workload, data);
+		for (const char *stage : STAGES)
+			if ((options.stage.empty() || options.stage == stage) && std::unique_ptr<Stage>(Make_Stage(stage)))
+				Print_Result(options, workload, stage, Measure(stage, data, options.chunk, options.reps));
+	}
+	return 0;
+}
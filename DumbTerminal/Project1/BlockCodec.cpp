@@ -0,0 +1,237 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: BlockCodec.cpp - Actual function implementation for BlockCodec.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- size_t Compress_Block(const unsigned char *src, size_t len, std::vector<unsigned char> &out);
+-- bool Expand_Block(const unsigned char *src, size_t len, unsigned char *dst, size_t dstLen);
+-- static VOID Put_Length(std::vector<unsigned char> &out, size_t len);
+-- static VOID Put_Sequence(std::vector<unsigned char> &out, const unsigned char *lit, size_t litLen,
+--							size_t offset, size_t matchLen);
+-- static bool Get_Length(const unsigned char *&ip, const unsigned char *end, size_t &len);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Block compressor used for cold scrollback pages. See BlockCodec.h for the format.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <cstring>
+#include "BlockCodec.h"
+
+static const size_t		MIN_MATCH = 4;				//Shortest back reference worth encoding
+static const size_t		MAX_OFFSET = 0xFFFF;		//Farthest back reference the 2 byte offset can hold
+static const int		HASH_BITS = 13;				//Entries in the match finder table, as a power of two
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Put_Length
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Put_Length(std::vector<unsigned char> &out, size_t len);
+--					-std::vector<unsigned char> &out:	Output of the compressor
+--					-size_t len:						What is left of a length after the 15 in the token
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Writes the extra length bytes: 255 for every full 255 and one final byte below 255.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Put_Length(std::vector<unsigned char> &out, size_t len)
+{
+	for (; len >= 255; len -= 255)
+		out.push_back(255);
+	out.push_back((unsigned char)len);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Put_Sequence
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Put_Sequence(std::vector<unsigned char> &out, const unsigned char *lit, size_t litLen,
+--									   size_t offset, size_t matchLen);
+--					-std::vector<unsigned char> &out:	Output of the compressor
+--					-const unsigned char *lit:			Literals that come before the match
+--					-size_t litLen:						Number of literals
+--					-size_t offset:						Distance back to the match
+--					-size_t matchLen:					Length of the match, 0 for the last sequence
+--
+-- RETURNS: VOID
+----------------------------------------------------------------------------------------------------------------------*/
+static void Put_Sequence(std::vector<unsigned char> &out, const unsigned char *lit, size_t litLen,
+	size_t offset, size_t matchLen)
+{
+	size_t extra = matchLen ? matchLen - MIN_MATCH : 0;
+	out.push_back((unsigned char)(((litLen < 15 ? litLen : 15) << 4) | (extra < 15 ? extra : 15)));
+	if (litLen >= 15)
+		Put_Length(out, litLen - 15);
+	out.insert(out.end(), lit, lit + litLen);
+	if (matchLen == 0)
+		return;
+	out.push_back((unsigned char)(offset & 0xFF));
+	out.push_back((unsigned char)(offset >> 8));
+	if (extra >= 15)
+		Put_Length(out, extra - 15);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Compress_Block
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Compress_Block(const unsigned char *src, size_t len, std::vector<unsigned char> &out);
+--					-const unsigned char *src:			Bytes to compress
+--					-size_t len:						Number of bytes in src
+--					-std::vector<unsigned char> &out:	Receives the compressed block, replacing its content
+--
+-- RETURNS: Size of the compressed block
+--
+-- NOTES:
+--	Greedy parse: every position is looked up in a hash table of the last position its first four bytes were
+--	seen at, and a confirmed match is extended as far as it goes. Runs of one byte come out as a match with an
+--	offset of 1. The search steps faster through data that keeps failing to match, so incompressible input costs
+--	little more than a copy.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t Compress_Block(const unsigned char *src, size_t len, std::vector<unsigned char> &out)
+{
+	std::vector<size_t>	table((size_t)1 << HASH_BITS, 0);		//Last position of each hashed 4 byte sequence
+	size_t				anchor = 0, pos = 0;					//Start of pending literals, current position
+	out.clear();
+	out.reserve(len / 2 + 16);
+	while (pos + MIN_MATCH <= len)
+	{
+		unsigned int seq;
+		memcpy(&seq, src + pos, sizeof(seq));
+		size_t hash = (seq * 2654435761u) >> (32 - HASH_BITS);
+		size_t candidate = table[hash];
+		table[hash] = pos;
+		if (candidate < pos && pos - candidate <= MAX_OFFSET && memcmp(src + candidate, src + pos, MIN_MATCH) == 0)
+		{
+			size_t matchLen = MIN_MATCH;
+			while (pos + matchLen < len && src[candidate + matchLen] == src[pos + matchLen])
+				++matchLen;
+			Put_Sequence(out, src + anchor, pos - anchor, pos - candidate, matchLen);
+			pos += matchLen;
+			anchor = pos;
+		}
+		else
+			pos += 1 + ((pos - anchor) >> 6);					//Skip ahead through data that does not match
+	}
+	Put_Sequence(out, src + anchor, len - anchor, 0, 0);		//Trailing literals
+	return out.size();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Get_Length
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static bool Get_Length(const unsigned char *&ip, const unsigned char *end, size_t &len);
+--					-const unsigned char *&ip:	Read position in the compressed block, advanced past the bytes read
+--					-const unsigned char *end:	End of the compressed block
+--					-size_t &len:				Length to add the extra length bytes to
+--
+-- RETURNS: false if the block ends in the middle of the length
+----------------------------------------------------------------------------------------------------------------------*/
+static bool Get_Length(const unsigned char *&ip, const unsigned char *end, size_t &len)
+{
+	unsigned char b;
+	do
+	{
+		if (ip == end)
+			return false;
+		len += b = *ip++;
+	} while (b == 255);
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Expand_Block
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Expand_Block(const unsigned char *src, size_t len, unsigned char *dst, size_t dstLen);
+--					-const unsigned char *src:	Compressed block
+--					-size_t len:				Size of the compressed block
+--					-unsigned char *dst:		Receives the original bytes
+--					-size_t dstLen:				Size of the original bytes
+--
+-- RETURNS: true if the block decoded to exactly dstLen bytes, false if it is damaged
+--
+-- NOTES:
+--	Every length and offset is checked against both buffers, so a damaged block can not write outside dst.
+--	Matches are copied a byte at a time when they overlap the bytes they produce.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Expand_Block(const unsigned char *src, size_t len, unsigned char *dst, size_t dstLen)
+{
+	const unsigned char	*ip = src, *end = src + len;
+	size_t				op = 0;
+	while (ip < end)
+	{
+		unsigned char	token = *ip++;
+		size_t			litLen = token >> 4, matchLen = token & 0x0F;
+		if (litLen == 15 && !Get_Length(ip, end, litLen))
+			return false;
+		if (litLen > (size_t)(end - ip) || litLen > dstLen - op)
+			return false;
+		memcpy(dst + op, ip, litLen);
+		ip += litLen, op += litLen;
+		if (ip == end)											//Last sequence has no match
+			break;
+		if (end - ip < 2)
+			return false;
+		size_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if (matchLen == 15 && !Get_Length(ip, end, matchLen))
+			return false;
+		matchLen += MIN_MATCH;
+		if (offset == 0 || offset > op || matchLen > dstLen - op)
+			return false;
+		if (offset >= matchLen)
+			memcpy(dst + op, dst + op - offset, matchLen);
+		else
+			for (size_t i = 0; i < matchLen; ++i)				//Overlapping copy repeats the pattern
+				dst[op + i] = dst[op + i - offset];
+		op += matchLen;
+	}
+	return op == dstLen;
+}
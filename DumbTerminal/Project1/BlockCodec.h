@@ -0,0 +1,38 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: BlockCodec.h - Fast block compressor for cold scrollback pages of the dumb terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- size_t Compress_Block(const unsigned char *src, size_t len, std::vector<unsigned char> &out);
+-- bool Expand_Block(const unsigned char *src, size_t len, unsigned char *dst, size_t dstLen);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	A byte-oriented LZ77 coder in the style of LZ4, small enough to live in the project. The output is a list of
+--	sequences, each one a token byte, a run of literals and a back reference:
+--
+--		token:		high 4 bits literal count, low 4 bits match length - 4 (15 means more length bytes follow)
+--		literals:	copied as is
+--		offset:		2 bytes little endian, distance back to the start of the match
+--
+--	The last sequence has literals only. Matches are found with a single hash table lookup per position and no
+--	entropy coding is done, so compressing a page costs about as much as copying it a few times. Terminal text and
+--	attribute bytes usually shrink to a fraction of their size. Nothing here depends on windows.h.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef BLOCKCODEC_H
+#define BLOCKCODEC_H
+#include <cstddef>
+#include <vector>
+size_t	Compress_Block(const unsigned char *src, size_t len, std::vector<unsigned char> &out);
+bool	Expand_Block(const unsigned char *src, size_t len, unsigned char *dst, size_t dstLen);
+#endif
@@ -0,0 +1,720 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: CaptureLog.cpp - Actual function implementation for CaptureLog.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- CaptureLog(size_t bufferSize);
+-- ~CaptureLog();
+-- bool Start(const char *path, unsigned long long frequency, unsigned long long now);
+-- VOID Record(Direction dir, unsigned long long ticks, const char *buf, size_t len);
+-- VOID Flush();
+-- bool Stop();
+-- bool Capturing() const;
+-- unsigned long long Dropped() const;
+-- VOID Append(Direction dir, unsigned long long ticks, const char *buf, size_t len);
+-- bool Hand();
+-- VOID Disk();
+-- static VOID Put_Le(std::vector<char> &out, unsigned long long v, int bytes);
+-- static VOID Put_Varint(std::vector<char> &out, unsigned long long v);
+-- static unsigned long long Get_Le(const char *p, int bytes);
+-- static bool Get_Varint(const std::vector<char> &in, size_t &pos, unsigned long long &v);
+-- CaptureReader();
+-- bool CaptureReader::Open(const char *path);
+-- bool CaptureReader::Next(CaptureRecord &rec);
+-- double CaptureReader::Seconds(const CaptureRecord &rec) const;
+-- bool CaptureReader::LoadChunk();
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - CaptureReader reads a capture back for replay
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Capture file writer shared by the reader, writer and UI threads, and the reader used to replay a capture. See
+--	CaptureLog.h for the format.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <cstring>
+#include "CaptureLog.h"
+
+static const size_t		CHUNK_HEADER = 16;			//Bytes of the header at the start of every chunk
+static const size_t		RECORD_HEADER = 21;			//Most bytes of a record header: direction and two varints
+static const unsigned	CAPTURE_VERSION = 1;
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Put_Le
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Put_Le(std::vector<char> &out, unsigned long long v, int bytes);
+--					-std::vector<char> &out:	Buffer the value is appended to
+--					-unsigned long long v:		Value to store
+--					-int bytes:					Width of the value in bytes
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Appends a little-endian integer, so the file reads the same on any machine.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Put_Le(std::vector<char> &out, unsigned long long v, int bytes)
+{
+	for (int i = 0; i < bytes; ++i, v >>= 8)
+		out.push_back((char)(v & 0xFF));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Put_Varint
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Put_Varint(std::vector<char> &out, unsigned long long v);
+--					-std::vector<char> &out:	Buffer the value is appended to
+--					-unsigned long long v:		Value to store
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Appends v seven bits at a time, low bits first, with the top bit set on every byte but the last. Timestamp
+--	deltas and lengths are small, so most take one or two bytes.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Put_Varint(std::vector<char> &out, unsigned long long v)
+{
+	for (; v >= 0x80; v >>= 7)
+		out.push_back((char)((v & 0x7F) | 0x80));
+	out.push_back((char)v);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Get_Le
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static unsigned long long Get_Le(const char *p, int bytes);
+--					-const char *p:	First byte of the value
+--					-int bytes:		Width of the value in bytes
+--
+-- RETURNS: The value
+--
+-- NOTES:
+--	Reads a little-endian integer written by Put_Le.
+----------------------------------------------------------------------------------------------------------------------*/
+static unsigned long long Get_Le(const char *p, int bytes)
+{
+	unsigned long long v = 0;
+	for (int i = bytes - 1; i >= 0; --i)
+		v = v << 8 | (unsigned char)p[i];
+	return v;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Get_Varint
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static bool Get_Varint(const std::vector<char> &in, size_t &pos, unsigned long long &v);
+--					-const std::vector<char> &in:	Buffer to read from
+--					-size_t &pos:					Where the value starts, moved past it
+--					-unsigned long long &v:			Set to the value
+--
+-- RETURNS: false when the value runs past the end of the buffer or is too long
+--
+-- NOTES:
+--	Reads a value written by Put_Varint.
+----------------------------------------------------------------------------------------------------------------------*/
+static bool Get_Varint(const std::vector<char> &in, size_t &pos, unsigned long long &v)
+{
+	v = 0;
+	for (int shift = 0; pos < in.size() && shift < 64; shift += 7)
+	{
+		unsigned char b = (unsigned char)in[pos++];
+		v |= (unsigned long long)(b & 0x7F) << shift;
+		if (!(b & 0x80))
+			return true;
+	}
+	return false;
+}
+
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: CaptureLog
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: CaptureLog(size_t bufferSize);
+--					-size_t bufferSize: Size of each of the two buffers, which is also the largest chunk
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Allocates both buffers up front so recording never allocates. Nothing is captured until Start.
+----------------------------------------------------------------------------------------------------------------------*/
+CaptureLog::CaptureLog(size_t bufferSize)
+	: _bufferSize(bufferSize < 4096 ? 4096 : bufferSize), _spareFull(false), _capturing(false),
+	_stopping(false), _failed(false), _records(0), _fillBytes(0), _spareBytes(0), _base(0), _last(0), _gap(0),
+	_dropped(0)
+{
+	_fill.reserve(_bufferSize);
+	_spare.reserve(_bufferSize);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ~CaptureLog
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: ~CaptureLog();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Stops a capture that is still running, so the disk thread is joined and the file complete.
+----------------------------------------------------------------------------------------------------------------------*/
+CaptureLog::~CaptureLog()
+{
+	Stop();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Start
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Clears the write failure of an earlier capture
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Start(const char *path, unsigned long long frequency, unsigned long long now);
+--					-const char *path:				File to create, replaced if it exists
+--					-unsigned long long frequency:	Ticks per second of the timestamps that will be recorded
+--					-unsigned long long now:		Ticks at the start of the capture
+--
+-- RETURNS: true when the file was created, false when it could not be or a capture is already running
+--
+-- NOTES:
+--	Writes the file header and starts the disk thread.
+----------------------------------------------------------------------------------------------------------------------*/
+bool CaptureLog::Start(const char *path, unsigned long long frequency, unsigned long long now)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	if (_capturing)
+		return false;
+	_file.open(path, std::ios::binary | std::ios::trunc);
+	if (!_file.is_open())
+		return false;
+	_spare.clear();
+	_spare.insert(_spare.end(), "DTCP", "DTCP" + 4);
+	Put_Le(_spare, CAPTURE_VERSION, 2);
+	Put_Le(_spare, 0, 2);
+	Put_Le(_spare, frequency, 8);
+	Put_Le(_spare, now, 8);
+	_spareFull = true;									//The disk thread writes the header first
+	_fill.assign(CHUNK_HEADER, 0);
+	_records = 0;
+	_fillBytes = _spareBytes = 0;
+	_gap = _dropped = 0;
+	_stopping = _failed = false;
+	_capturing = true;
+	_disk = std::thread(&CaptureLog::Disk, this);
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Record
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Record(Direction dir, unsigned long long ticks, const char *buf, size_t len);
+--					-Direction dir:				RX for bytes received, TX for bytes sent
+--					-unsigned long long ticks:	When the bytes were received or sent
+--					-const char *buf:			The bytes
+--					-size_t len:				Number of bytes in buf
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Called by the reader and writer threads. Copies the bytes into the fill buffer, handing it to the disk thread
+--	when it is full; a record bigger than a buffer is split. When the spare buffer has not been written out yet
+--	the bytes are dropped rather than waited for, and a gap record is written before the next record that fits.
+--	Does nothing when no capture is running.
+----------------------------------------------------------------------------------------------------------------------*/
+void CaptureLog::Record(Direction dir, unsigned long long ticks, const char *buf, size_t len)
+{
+	bool handed = false;
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		if (!_capturing)
+			return;
+		while (len > 0)
+		{
+			size_t room = _bufferSize - CHUNK_HEADER - 2 * RECORD_HEADER;	//Leaves space for a gap record
+			size_t n = len < room ? len : room;
+			if (_fill.size() + (_gap ? RECORD_HEADER : 0) + RECORD_HEADER + n > _bufferSize)
+			{
+				if (!Hand())							//Disk thread still busy with the spare
+				{
+					_gap += len;
+					_dropped += len;
+					break;
+				}
+				handed = true;
+			}
+			if (_gap)
+			{
+				Append(GAP, ticks, NULL, (size_t)_gap);
+				_gap = 0;
+			}
+			Append(dir, ticks, buf, n);
+			buf += n;
+			len -= n;
+		}
+	}
+	if (handed)
+		_ready.notify_all();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Append
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Counts the bytes recorded into the fill buffer
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Append(Direction dir, unsigned long long ticks, const char *buf, size_t len);
+--					-Direction dir:				Kind of record
+--					-unsigned long long ticks:	Timestamp of the record
+--					-const char *buf:			The bytes, NULL for a gap record
+--					-size_t len:				Number of bytes, or bytes dropped for a gap record
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Encodes one record at the end of the fill buffer. The caller holds the lock and has made sure it fits.
+----------------------------------------------------------------------------------------------------------------------*/
+void CaptureLog::Append(Direction dir, unsigned long long ticks, const char *buf, size_t len)
+{
+	if (_records == 0)
+		_base = _last = ticks;
+	_fill.push_back((char)dir);
+	Put_Varint(_fill, ticks > _last ? ticks - _last : 0);	//Two threads record, so ticks may step back a little
+	Put_Varint(_fill, len);
+	if (buf)
+	{
+		_fill.insert(_fill.end(), buf, buf + len);
+		_fillBytes += len;
+	}
+	if (ticks > _last)
+		_last = ticks;
+	++_records;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Hand
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Hands over the count of bytes recorded with the buffer
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Hand();
+--
+-- RETURNS: true when the fill buffer was handed to the disk thread, false when the spare is still being written
+--
+-- NOTES:
+--	Completes the chunk header of the fill buffer and swaps the buffers. The caller holds the lock and notifies
+--	the disk thread after releasing it. The new fill buffer keeps its capacity, so nothing is allocated.
+----------------------------------------------------------------------------------------------------------------------*/
+bool CaptureLog::Hand()
+{
+	if (_spareFull)
+		return false;
+	if (_records == 0)									//Nothing to write
+		return true;
+	std::vector<char> header;
+	header.reserve(CHUNK_HEADER);
+	Put_Le(header, _fill.size() - CHUNK_HEADER, 4);
+	Put_Le(header, _records, 4);
+	Put_Le(header, _base, 8);
+	std::memcpy(_fill.data(), header.data(), CHUNK_HEADER);
+	_fill.swap(_spare);
+	_spareFull = true;
+	_fill.assign(CHUNK_HEADER, 0);
+	_records = 0;
+	_spareBytes = _fillBytes;
+	_fillBytes = 0;
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Flush
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Flush();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Called by the UI thread on a timer, so a slow session reaches the disk within a second or so instead of when a
+--	whole buffer has filled. Does nothing when the disk thread is still writing the previous chunk.
+----------------------------------------------------------------------------------------------------------------------*/
+void CaptureLog::Flush()
+{
+	bool handed;
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		handed = _capturing && _records > 0 && Hand();
+	}
+	if (handed)
+		_ready.notify_all();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Stop
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Returns false when a write to the file failed
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Stop();
+--
+-- RETURNS: false when a write to the file failed, true otherwise, including when no capture was running
+--
+-- NOTES:
+--	Stops recording, waits for the disk thread to write out both buffers and closes the file. Called by the UI
+--	thread; this is the only place that waits for the disk. The bytes a failed write lost are in Dropped.
+----------------------------------------------------------------------------------------------------------------------*/
+bool CaptureLog::Stop()
+{
+	{
+		std::unique_lock<std::mutex> guard(_lock);
+		if (!_capturing)
+			return true;
+		_capturing = false;								//Record stops here
+		_ready.wait(guard, [this] { return !_spareFull; });
+		Hand();
+		_stopping = true;
+	}
+	_ready.notify_all();
+	_disk.join();
+	_file.close();
+	return !_failed && !_file.fail();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Disk
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Counts the bytes of a chunk that could not be written as dropped
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Disk();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Body of the disk thread. Writes out the spare buffer each time it is handed over, without holding the lock,
+--	then marks it free again. Exits once Stop has been called and everything handed over is written. After a
+--	write fails nothing more is written, since CaptureReader stops at the chunk cut short anyway; the bytes of
+--	that chunk and of the ones after it are counted as dropped.
+----------------------------------------------------------------------------------------------------------------------*/
+void CaptureLog::Disk()
+{
+	std::unique_lock<std::mutex> guard(_lock);
+	for (;;)
+	{
+		_ready.wait(guard, [this] { return _spareFull || _stopping; });
+		if (!_spareFull)
+			break;
+		guard.unlock();									//Recording goes on in _fill meanwhile
+		if (!_failed)
+			_failed = !_file.write(_spare.data(), _spare.size()) || !_file.flush();
+		guard.lock();
+		if (_failed)
+			_dropped += _spareBytes;
+		_spare.clear();
+		_spareFull = false;
+		_ready.notify_all();							//Stop may be waiting for the spare
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Capturing
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Capturing() const;
+--
+-- RETURNS: true while a capture is running
+--
+-- NOTES:
+--	Used by the UI to enable the menu items.
+----------------------------------------------------------------------------------------------------------------------*/
+bool CaptureLog::Capturing() const
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return _capturing;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Dropped
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Counts the bytes failed writes lost
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: unsigned long long Dropped() const;
+--
+-- RETURNS: Number of bytes dropped since Start because the disk fell behind or a write to the file failed
+--
+-- NOTES:
+--	Reported when the capture is stopped.
+----------------------------------------------------------------------------------------------------------------------*/
+unsigned long long CaptureLog::Dropped() const
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return _dropped;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: CaptureReader
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: CaptureReader();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Nothing can be read until Open succeeds.
+----------------------------------------------------------------------------------------------------------------------*/
+CaptureReader::CaptureReader()
+	: _pos(0), _left(0), _ticks(0), _first(0), _started(false), _frequency(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Open
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Open(const char *path);
+--					-const char *path: Capture file to read
+--
+-- RETURNS: false when the file cannot be opened or is not a capture
+--
+-- NOTES:
+--	Reads and checks the file header. The first chunk is loaded by the first Next.
+----------------------------------------------------------------------------------------------------------------------*/
+bool CaptureReader::Open(const char *path)
+{
+	char header[24];
+	_file.open(path, std::ios::binary);
+	if (!_file.read(header, sizeof(header)) || std::memcmp(header, "DTCP", 4) != 0
+		|| Get_Le(header + 4, 2) != CAPTURE_VERSION)
+		return false;
+	_frequency = Get_Le(header + 8, 8);
+	_left = 0;
+	_started = false;
+	return _frequency > 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Next
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Next(CaptureRecord &rec);
+--					-CaptureRecord &rec: Set to the next record
+--
+-- RETURNS: false at the end of the file, or where the file is cut short or does not decode
+--
+-- NOTES:
+--	Decodes the next record, loading the next chunk when the current one is used up. rec.data points into the
+--	chunk and stays valid until the next call.
+----------------------------------------------------------------------------------------------------------------------*/
+bool CaptureReader::Next(CaptureRecord &rec)
+{
+	unsigned long long delta, len;
+	if (_left == 0 && !LoadChunk())
+		return false;
+	if (_pos >= _chunk.size() || (unsigned char)_chunk[_pos] > CaptureLog::GAP)
+		return false;
+	rec.dir = (CaptureLog::Direction)_chunk[_pos++];
+	if (!Get_Varint(_chunk, _pos, delta) || !Get_Varint(_chunk, _pos, len))
+		return false;
+	_ticks += delta;
+	rec.ticks = _ticks;
+	rec.len = (size_t)len;
+	rec.data = NULL;
+	if (rec.dir != CaptureLog::GAP)
+	{
+		if (len > _chunk.size() - _pos)
+			return false;
+		rec.data = _chunk.data() + _pos;
+		_pos += rec.len;
+	}
+	if (!_started)
+	{
+		_first = rec.ticks;
+		_started = true;
+	}
+	--_left;
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Seconds
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: double Seconds(const CaptureRecord &rec) const;
+--					-const CaptureRecord &rec: A record returned by Next
+--
+-- RETURNS: Seconds between the first record of the file and rec
+--
+-- NOTES:
+--	Used to replay records at the pace they were captured.
+----------------------------------------------------------------------------------------------------------------------*/
+double CaptureReader::Seconds(const CaptureRecord &rec) const
+{
+	return (double)(rec.ticks - _first) / _frequency;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: LoadChunk
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool LoadChunk();
+--
+-- RETURNS: false at the end of the file or when the chunk is cut short
+--
+-- NOTES:
+--	Reads the next chunk header and its records into memory. An empty chunk is skipped.
+----------------------------------------------------------------------------------------------------------------------*/
+bool CaptureReader::LoadChunk()
+{
+	char header[CHUNK_HEADER];
+	do
+	{
+		if (!_file.read(header, sizeof(header)))
+			return false;
+		_chunk.resize((size_t)Get_Le(header, 4));
+		if (!_file.read(_chunk.data(), _chunk.size()))
+			return false;
+		_left = (unsigned long)Get_Le(header + 4, 4);
+	} while (_left == 0);
+	_ticks = Get_Le(header + 8, 8);
+	_pos = 0;
+	return true;
+}
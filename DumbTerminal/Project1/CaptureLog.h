@@ -0,0 +1,127 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: CaptureLog.h - Records the bytes sent and received by the dumb terminal emulator program to a
+--			binary capture file, with the disk writes done on a thread of its own
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- CaptureLog(size_t bufferSize);
+-- ~CaptureLog();
+-- bool Start(const char *path, unsigned long long frequency, unsigned long long now);
+-- VOID Record(Direction dir, unsigned long long ticks, const char *buf, size_t len);
+-- VOID Flush();
+-- bool Stop();
+-- bool Capturing() const;
+-- unsigned long long Dropped() const;
+-- bool CaptureReader::Open(const char *path);
+-- bool CaptureReader::Next(CaptureRecord &rec);
+-- double CaptureReader::Seconds(const CaptureRecord &rec) const;
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - CaptureReader reads a capture back for replay
+--			  October 17, 2026 - A failed disk write is counted as dropped bytes and reported by Stop
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Record is called by the reader thread for every chunk received and by the writer thread for every chunk sent.
+--	It only encodes a record header and copies the bytes into the fill buffer, under a mutex that is never held
+--	across disk I/O. When the fill buffer is full, or on Flush, it is swapped with the spare buffer and the disk
+--	thread writes it out while recording goes on in the other one. If the disk falls so far behind that both
+--	buffers are full, the bytes are dropped and counted instead of making the serial threads wait; a gap record
+--	marks the place in the file. When a write to the file fails, e.g. the disk is full, the bytes of that chunk and
+--	of every chunk after it are counted as dropped too, and Stop returns false.
+--
+--	File format, all integers little-endian:
+--		header:	"DTCP", u16 version (1), u16 reserved, u64 timestamp ticks per second, u64 ticks at start
+--		chunk:	u32 bytes of records, u32 number of records, u64 ticks of the first record, then the records
+--		record:	u8 direction (0 received, 1 sent, 2 gap), varint ticks since the previous record of the chunk,
+--				varint length, then that many bytes; a gap record has no bytes, its length is the number dropped
+--	Varints are unsigned LEB128. Each chunk is one buffer written out, and its timestamps only depend on its own
+--	header, so a file cut short by a crash can be read up to the last complete chunk.
+--
+--	CaptureReader reads the records back one at a time, a chunk in memory at a time, for replay. It stops at the
+--	end of the file or at the first chunk that is cut short or does not decode.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef CAPTURELOG_H
+#define CAPTURELOG_H
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+class CaptureLog
+{
+public:
+	enum Direction { RX = 0, TX = 1, GAP = 2 };
+
+	explicit CaptureLog(size_t bufferSize);
+	~CaptureLog();
+	bool	Start(const char *path, unsigned long long frequency, unsigned long long now);	//Create the file
+	void	Record(Direction dir, unsigned long long ticks, const char *buf, size_t len);	//Any thread
+	void	Flush();										//Hand what is buffered to the disk thread
+	bool	Stop();											//Write out the rest and close the file
+	bool	Capturing() const;
+	unsigned long long	Dropped() const;					//Bytes lost because the disk fell behind or failed
+
+private:
+	void	Append(Direction dir, unsigned long long ticks, const char *buf, size_t len);
+	bool	Hand();											//Swap the buffers if the spare is free
+	void	Disk();											//Body of the disk thread
+
+	mutable std::mutex		_lock;
+	std::condition_variable	_ready;							//Signalled when a buffer is handed over or written
+	std::thread				_disk;
+	std::ofstream			_file;
+	size_t					_bufferSize;
+	std::vector<char>		_fill;							//Chunk being recorded into
+	std::vector<char>		_spare;							//Chunk the disk thread is writing, or free
+	bool					_spareFull;						//_spare holds a chunk not written yet
+	bool					_capturing;
+	bool					_stopping;						//Disk thread exits once _spare is written
+	bool					_failed;						//A write failed, disk thread and Stop only
+	unsigned long			_records;						//Records in _fill
+	unsigned long long		_fillBytes;						//Bytes recorded in _fill, record headers left out
+	unsigned long long		_spareBytes;					//Bytes recorded in _spare
+	unsigned long long		_base;							//Ticks of the first record in _fill
+	unsigned long long		_last;							//Ticks of the last record in _fill
+	unsigned long long		_gap;							//Bytes dropped and not yet marked in the file
+	unsigned long long		_dropped;						//Bytes dropped since Start
+};
+
+struct CaptureRecord
+{
+	CaptureLog::Direction	dir;
+	unsigned long long		ticks;							//When the bytes were received or sent
+	const char				*data;							//The bytes, valid until the next Next; NULL for a gap
+	size_t					len;							//Number of bytes, or bytes dropped for a gap
+};
+
+class CaptureReader
+{
+public:
+	CaptureReader();
+	bool	Open(const char *path);							//Read the file header
+	bool	Next(CaptureRecord &rec);						//false at the end of the file or of what decodes
+	double	Seconds(const CaptureRecord &rec) const;		//Time of rec after the first record
+	unsigned long long	Frequency() const { return _frequency; }
+
+private:
+	bool	LoadChunk();
+
+	std::ifstream			_file;
+	std::vector<char>		_chunk;							//Records of the current chunk
+	size_t					_pos;							//Next record in _chunk
+	unsigned long			_left;							//Records of the chunk not read yet
+	unsigned long long		_ticks;							//Ticks of the last record read
+	unsigned long long		_first;							//Ticks of the first record of the file
+	bool					_started;						//_first is set
+	unsigned long long		_frequency;						//Ticks per second
+};
+#endif
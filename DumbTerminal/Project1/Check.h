@@ -0,0 +1,85 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: Check.h - Assertions of the tests of the dumb terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- bool Check_Result(bool ok, const char *what, const char *file, int line);
+-- int Check_Summary(const char *test);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Each test is a program of its own, built and registered with ctest by CMakeLists.txt. CHECK reports a failed
+--	condition with its file and line and carries on, so one run shows every check that fails; Check_Summary is
+--	what main returns, non-zero when any check failed. Checks may be made on any thread. Only one file of a
+--	program includes this header.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef CHECK_H
+#define CHECK_H
+#include <atomic>
+#include <cstdio>
+#define CHECK(cond)	Check_Result((cond), #cond, __FILE__, __LINE__)
+static std::atomic<int>	check_count(0);			//Checks done, on any thread
+static std::atomic<int>	check_failures(0);		//Checks that failed
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Check_Result
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Check_Result(bool ok, const char *what, const char *file, int line);
+--					-bool ok:			Outcome of the check
+--					-const char *what:	Condition checked, as written
+--					-const char *file:	Source file of the check
+--					-int line:			Line of the check
+--
+-- RETURNS: ok, so a test can stop early when carrying on makes no sense
+----------------------------------------------------------------------------------------------------------------------*/
+static bool Check_Result(bool ok, const char *what, const char *file, int line)
+{
+	++check_count;
+	if (!ok)
+	{
+		++check_failures;
+		fprintf(stderr, "%s:%d: check failed: %s\n", file, line, what);
+	}
+	return ok;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Check_Summary
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int Check_Summary(const char *test);
+--					-const char *test: Name of the test program
+--
+-- RETURNS: 0 when every check passed, 1 otherwise
+----------------------------------------------------------------------------------------------------------------------*/
+static int Check_Summary(const char *test)
+{
+	printf("%s: %d checks, %d failed\n", test, check_count.load(), check_failures.load());
+	return check_failures == 0 ? 0 : 1;
+}
+#endif
@@ -0,0 +1,489 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: ControlScan.cpp - Actual function implementation for ControlScan.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- static size_t Scan_Scalar(const char *buf, size_t len);
+-- static size_t Scan_Sse2(const char *buf, size_t len);
+-- static size_t Scan_Avx2(const char *buf, size_t len);
+-- static size_t Ascii_Scalar(const char *buf, size_t len);
+-- static size_t Ascii_Sse2(const char *buf, size_t len);
+-- static size_t Ascii_Avx2(const char *buf, size_t len);
+-- static unsigned int First_Bit(unsigned int mask);
+-- bool Scan_Supported(ScanLevel level);
+-- ScanLevel Scan_Level();
+-- size_t Printable_Run(const char *buf, size_t len);
+-- size_t Printable_Run_With(ScanLevel level, const char *buf, size_t len);
+-- size_t Ascii_Run(const char *buf, size_t len);
+-- size_t Ascii_Run_With(ScanLevel level, const char *buf, size_t len);
+-- const char *Scan_Name(ScanLevel level);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Added Ascii_Run for the UTF-8 decoder
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Control character and non-ASCII byte searches. See ControlScan.h. The SSE2 and AVX2 versions are compiled with
+--	the instruction set enabled for that function alone, so the program still runs on a processor without them.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include "ControlScan.h"
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define SCAN_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SCAN_TARGET(isa)
+#else
+#define SCAN_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+typedef size_t (*ScanFunction)(const char *buf, size_t len);
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Scan_Scalar
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static size_t Scan_Scalar(const char *buf, size_t len);
+--					-const char *buf:	Bytes to search
+--					-size_t len:		Number of bytes in buf
+--
+-- RETURNS: Number of printable bytes before the first control character, len when there is none
+----------------------------------------------------------------------------------------------------------------------*/
+static size_t Scan_Scalar(const char *buf, size_t len)
+{
+	const unsigned char *p = (const unsigned char *)buf;
+	size_t i = 0;
+	while (i < len && p[i] >= 0x20 && p[i] != 0x7F)
+		++i;
+	return i;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Ascii_Scalar
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static size_t Ascii_Scalar(const char *buf, size_t len);
+--					-const char *buf:	Bytes to search
+--					-size_t len:		Number of bytes in buf
+--
+-- RETURNS: Number of ASCII bytes before the first byte from 0x80 up, len when there is none
+----------------------------------------------------------------------------------------------------------------------*/
+static size_t Ascii_Scalar(const char *buf, size_t len)
+{
+	const unsigned char *p = (const unsigned char *)buf;
+	size_t i = 0;
+	while (i < len && p[i] < 0x80)
+		++i;
+	return i;
+}
+
+#ifdef SCAN_X86
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: First_Bit
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static unsigned int First_Bit(unsigned int mask);
+--					-unsigned int mask: Compare mask, not 0
+--
+-- RETURNS: Index of the lowest bit set
+----------------------------------------------------------------------------------------------------------------------*/
+static unsigned int First_Bit(unsigned int mask)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return (unsigned int)index;
+#else
+	return (unsigned int)__builtin_ctz(mask);
+#endif
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Scan_Sse2
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static size_t Scan_Sse2(const char *buf, size_t len);
+--					-const char *buf:	Bytes to search
+--					-size_t len:		Number of bytes in buf
+--
+-- RETURNS: Number of printable bytes before the first control character, len when there is none
+--
+-- NOTES:
+--	SSE2 has no unsigned byte compare, so a byte is found to be below 0x20 by taking the unsigned minimum with 0x1F
+--	and checking that nothing changed. DEL is a compare for equality. The two masks are combined and the first bit
+--	set is the first control character of the block.
+----------------------------------------------------------------------------------------------------------------------*/
+SCAN_TARGET("sse2")
+static size_t Scan_Sse2(const char *buf, size_t len)
+{
+	const __m128i	below = _mm_set1_epi8(0x1F), del = _mm_set1_epi8(0x7F);
+	size_t			i = 0;
+	for (; i + 16 <= len; i += 16)
+	{
+		__m128i	v = _mm_loadu_si128((const __m128i *)(buf + i));
+		__m128i	control = _mm_or_si128(_mm_cmpeq_epi8(_mm_min_epu8(v, below), v), _mm_cmpeq_epi8(v, del));
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(control);
+		if (mask != 0)
+			return i + First_Bit(mask);
+	}
+	return i + Scan_Scalar(buf + i, len - i);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Scan_Avx2
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static size_t Scan_Avx2(const char *buf, size_t len);
+--					-const char *buf:	Bytes to search
+--					-size_t len:		Number of bytes in buf
+--
+-- RETURNS: Number of printable bytes before the first control character, len when there is none
+--
+-- NOTES:
+--	Scan_Sse2 at 32 bytes per block. A tail of 16 bytes or more is left to Scan_Sse2.
+----------------------------------------------------------------------------------------------------------------------*/
+SCAN_TARGET("avx2")
+static size_t Scan_Avx2(const char *buf, size_t len)
+{
+	const __m256i	below = _mm256_set1_epi8(0x1F), del = _mm256_set1_epi8(0x7F);
+	size_t			i = 0;
+	for (; i + 32 <= len; i += 32)
+	{
+		__m256i	v = _mm256_loadu_si256((const __m256i *)(buf + i));
+		__m256i	control = _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_min_epu8(v, below), v),
+					_mm256_cmpeq_epi8(v, del));
+		unsigned int mask = (unsigned int)_mm256_movemask_epi8(control);
+		if (mask != 0)
+			return i + First_Bit(mask);
+	}
+	return i + Scan_Sse2(buf + i, len - i);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Ascii_Sse2
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static size_t Ascii_Sse2(const char *buf, size_t len);
+--					-const char *buf:	Bytes to search
+--					-size_t len:		Number of bytes in buf
+--
+-- RETURNS: Number of ASCII bytes before the first byte from 0x80 up, len when there is none
+--
+-- NOTES:
+--	The top bit of every byte is what MOVMSKB collects, so a block is all ASCII when the mask is 0 and no compare
+--	is needed.
+----------------------------------------------------------------------------------------------------------------------*/
+SCAN_TARGET("sse2")
+static size_t Ascii_Sse2(const char *buf, size_t len)
+{
+	size_t i = 0;
+	for (; i + 16 <= len; i += 16)
+	{
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)(buf + i)));
+		if (mask != 0)
+			return i + First_Bit(mask);
+	}
+	return i + Ascii_Scalar(buf + i, len - i);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Ascii_Avx2
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static size_t Ascii_Avx2(const char *buf, size_t len);
+--					-const char *buf:	Bytes to search
+--					-size_t len:		Number of bytes in buf
+--
+-- RETURNS: Number of ASCII bytes before the first byte from 0x80 up, len when there is none
+--
+-- NOTES:
+--	Ascii_Sse2 at 32 bytes per block. A tail of 16 bytes or more is left to Ascii_Sse2.
+----------------------------------------------------------------------------------------------------------------------*/
+SCAN_TARGET("avx2")
+static size_t Ascii_Avx2(const char *buf, size_t len)
+{
+	size_t i = 0;
+	for (; i + 32 <= len; i += 32)
+	{
+		unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i *)(buf + i)));
+		if (mask != 0)
+			return i + First_Bit(mask);
+	}
+	return i + Ascii_Sse2(buf + i, len - i);
+}
+#endif
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Scan_Supported
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Scan_Supported(ScanLevel level);
+--					-ScanLevel level: Version to check
+--
+-- RETURNS: true when the version can run here
+--
+-- NOTES:
+--	Asks CPUID. AVX2 also needs the operating system to save the 256-bit registers, which XGETBV tells; GCC's
+--	__builtin_cpu_supports checks both.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Scan_Supported(ScanLevel level)
+{
+	if (level == SCAN_SCALAR)
+		return true;
+#if defined(SCAN_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	int leaves = info[0];
+	__cpuid(info, 1);
+	if (level == SCAN_SSE2)
+		return (info[3] & (1 << 26)) != 0;
+	bool osAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+	if (level != SCAN_AVX2 || !osAvx || leaves < 7)
+		return false;
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#elif defined(SCAN_X86)
+	__builtin_cpu_init();
+	if (level == SCAN_SSE2)
+		return __builtin_cpu_supports("sse2") != 0;
+	return level == SCAN_AVX2 && __builtin_cpu_supports("avx2") != 0;
+#else
+	return false;
+#endif
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Scan_Level
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: ScanLevel Scan_Level();
+--
+-- RETURNS: The widest version supported here
+--
+-- NOTES:
+--	Worked out on the first call only.
+----------------------------------------------------------------------------------------------------------------------*/
+ScanLevel Scan_Level()
+{
+	static const ScanLevel level = Scan_Supported(SCAN_AVX2) ? SCAN_AVX2
+		: Scan_Supported(SCAN_SSE2) ? SCAN_SSE2 : SCAN_SCALAR;
+	return level;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Printable_Run_With
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Printable_Run_With(ScanLevel level, const char *buf, size_t len);
+--					-ScanLevel level:	Version to use, which has to be supported
+--					-const char *buf:	Bytes to search
+--					-size_t len:		Number of bytes in buf
+--
+-- RETURNS: Number of printable bytes before the first control character, len when there is none
+--
+-- NOTES:
+--	For comparing the versions, e.g. in dtbench. Anything not built in falls back to the byte version.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t Printable_Run_With(ScanLevel level, const char *buf, size_t len)
+{
+#ifdef SCAN_X86
+	if (level == SCAN_AVX2)
+		return Scan_Avx2(buf, len);
+	if (level == SCAN_SSE2)
+		return Scan_Sse2(buf, len);
+#endif
+	return Scan_Scalar(buf, len);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Printable_Run
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Printable_Run(const char *buf, size_t len);
+--					-const char *buf:	Bytes to search
+--					-size_t len:		Number of bytes in buf
+--
+-- RETURNS: Number of printable bytes before the first control character, len when there is none
+--
+-- NOTES:
+--	Calls the version Scan_Level picked through a pointer set on the first call.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t Printable_Run(const char *buf, size_t len)
+{
+#ifdef SCAN_X86
+	static const ScanFunction scan = Scan_Level() == SCAN_AVX2 ? Scan_Avx2
+		: Scan_Level() == SCAN_SSE2 ? Scan_Sse2 : Scan_Scalar;
+	return scan(buf, len);
+#else
+	return Scan_Scalar(buf, len);
+#endif
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Ascii_Run_With
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Ascii_Run_With(ScanLevel level, const char *buf, size_t len);
+--					-ScanLevel level:	Version to use, which has to be supported
+--					-const char *buf:	Bytes to search
+--					-size_t len:		Number of bytes in buf
+--
+-- RETURNS: Number of ASCII bytes before the first byte from 0x80 up, len when there is none
+--
+-- NOTES:
+--	For comparing the versions, e.g. in dtbench. Anything not built in falls back to the byte version.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t Ascii_Run_With(ScanLevel level, const char *buf, size_t len)
+{
+#ifdef SCAN_X86
+	if (level == SCAN_AVX2)
+		return Ascii_Avx2(buf, len);
+	if (level == SCAN_SSE2)
+		return Ascii_Sse2(buf, len);
+#endif
+	return Ascii_Scalar(buf, len);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Ascii_Run
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Ascii_Run(const char *buf, size_t len);
+--					-const char *buf:	Bytes to search
+--					-size_t len:		Number of bytes in buf
+--
+-- RETURNS: Number of ASCII bytes before the first byte from 0x80 up, len when there is none
+--
+-- NOTES:
+--	Calls the version Scan_Level picked through a pointer set on the first call.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t Ascii_Run(const char *buf, size_t len)
+{
+#ifdef SCAN_X86
+	static const ScanFunction scan = Scan_Level() == SCAN_AVX2 ? Ascii_Avx2
+		: Scan_Level() == SCAN_SSE2 ? Ascii_Sse2 : Ascii_Scalar;
+	return scan(buf, len);
+#else
+	return Ascii_Scalar(buf, len);
+#endif
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Scan_Name
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: const char *Scan_Name(ScanLevel level);
+--					-ScanLevel level: A version
+--
+-- RETURNS: "scalar", "sse2" or "avx2"
+----------------------------------------------------------------------------------------------------------------------*/
+const char *Scan_Name(ScanLevel level)
+{
+	static const char *NAMES[SCAN_LEVELS] = { "scalar", "sse2", "avx2" };
+	return level < SCAN_LEVELS ? NAMES[level] : "";
+}
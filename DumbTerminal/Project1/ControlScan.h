@@ -0,0 +1,56 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: ControlScan.h - Vectorized searches for control characters and non-ASCII bytes in received bytes
+--			for the dumb terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- size_t Printable_Run(const char *buf, size_t len);
+-- size_t Printable_Run_With(ScanLevel level, const char *buf, size_t len);
+-- size_t Ascii_Run(const char *buf, size_t len);
+-- size_t Ascii_Run_With(ScanLevel level, const char *buf, size_t len);
+-- ScanLevel Scan_Level();
+-- bool Scan_Supported(ScanLevel level);
+-- const char *Scan_Name(ScanLevel level);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Added Ascii_Run for the UTF-8 decoder
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Printable_Run returns how many bytes at the start of a buffer are printable, i.e. where the next control
+--	character is: a C0 control (NUL, BEL, BS, TAB, LF, CR, ESC and the rest below 0x20) or DEL. Bytes from 0x80 up
+--	are printable, as they are to the parser. The parser calls it in the ground state to find the run of text it
+--	hands to the terminal in one piece. Ascii_Run does the same for the first byte from 0x80 up, so the terminal can
+--	copy plain ASCII text straight into the screen model and only decode the UTF-8 sequences between.
+--
+--	Each search has three versions: a byte at a time, SSE2 at 16 bytes and AVX2 at 32 bytes per compare. The first
+--	call picks the widest the processor and the operating system support, and every call after that goes straight
+--	to it. A vector version reads whole blocks only while they lie inside the buffer and finishes the tail a byte
+--	at a time, so it never reads past len. On processors other than x86 and x64 only the byte version exists.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef CONTROLSCAN_H
+#define CONTROLSCAN_H
+#include <cstddef>
+enum ScanLevel
+{
+	SCAN_SCALAR,							//A byte at a time
+	SCAN_SSE2,								//16 bytes per compare
+	SCAN_AVX2,								//32 bytes per compare
+	SCAN_LEVELS
+};
+
+size_t		Printable_Run(const char *buf, size_t len);							//Best version there is
+size_t		Printable_Run_With(ScanLevel level, const char *buf, size_t len);	//A given, supported version
+size_t		Ascii_Run(const char *buf, size_t len);								//Best version there is
+size_t		Ascii_Run_With(ScanLevel level, const char *buf, size_t len);		//A given, supported version
+ScanLevel	Scan_Level();														//Version Printable_Run uses
+bool		Scan_Supported(ScanLevel level);
+const char	*Scan_Name(ScanLevel level);
+#endif
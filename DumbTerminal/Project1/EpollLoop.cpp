@@ -0,0 +1,210 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: EpollLoop.cpp - Actual function implementation for EpollLoop.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- EpollLoop();
+-- ~EpollLoop();
+-- int Wait(Key *keys, int max, int timeoutMs);
+-- VOID Post(Key key);
+-- bool Watch(Handle fd, Key key);
+-- VOID Unwatch(Handle fd);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	epoll event loop. See EpollLoop.h.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include "EpollLoop.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: EpollLoop
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: EpollLoop();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Creates the epoll instance and the eventfd, which is watched level-triggered so a Post is never missed.
+----------------------------------------------------------------------------------------------------------------------*/
+EpollLoop::EpollLoop()
+	: _poll(epoll_create1(0)), _wake(eventfd(0, EFD_NONBLOCK))
+{
+	struct epoll_event ev = {};
+	ev.events = EPOLLIN;
+	ev.data.u64 = WAKE;
+	epoll_ctl(_poll, EPOLL_CTL_ADD, _wake, &ev);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ~EpollLoop
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: ~EpollLoop();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Closes the epoll instance and the eventfd. Nothing may be waiting in Wait any more.
+----------------------------------------------------------------------------------------------------------------------*/
+EpollLoop::~EpollLoop()
+{
+	close(_poll);
+	close(_wake);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Wait
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int Wait(Key *keys, int max, int timeoutMs);
+--					-Key *keys:			Receives the keys reported
+--					-int max:			Room in keys
+--					-int timeoutMs:		Longest wait, -1 for no limit
+--
+-- RETURNS: Number of keys put in keys, 0 on timeout or when interrupted by a signal, -1 on error
+--
+-- NOTES:
+--	Called by one thread only. Does not block when keys posted earlier are still queued. The eventfd is drained
+--	before the queue is read, so a Post made after that wakes the next Wait.
+----------------------------------------------------------------------------------------------------------------------*/
+int EpollLoop::Wait(Key *keys, int max, int timeoutMs)
+{
+	struct epoll_event	ev[64];
+	uint64_t			count;
+	int					ready, n = 0;
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		if (!_posted.empty())
+			timeoutMs = 0;
+	}
+	if ((ready = epoll_wait(_poll, ev, max < 64 ? max : 64, timeoutMs)) < 0)
+		return errno == EINTR ? 0 : -1;
+	for (int i = 0; i < ready; ++i)
+		if (ev[i].data.u64 == WAKE)
+			read(_wake, &count, sizeof(count));
+		else
+			keys[n++] = (Key)ev[i].data.u64;
+	std::lock_guard<std::mutex> guard(_lock);
+	for (; n < max && !_posted.empty(); _posted.pop_front())
+		keys[n++] = _posted.front();
+	return n;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Post
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Post(Key key);
+--					-Key key: Key to report
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Queues key and signals the eventfd. Any thread may call it, including the one in Wait.
+----------------------------------------------------------------------------------------------------------------------*/
+void EpollLoop::Post(Key key)
+{
+	uint64_t one = 1;
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		_posted.push_back(key);
+	}
+	write(_wake, &one, sizeof(one));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Watch
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Was Add
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Watch(Handle fd, Key key);
+--					-Handle fd:	Descriptor to watch, non-blocking
+--					-Key key:	Reported when fd becomes readable or writable or hangs up
+--
+-- RETURNS: false when epoll refused the descriptor
+--
+-- NOTES:
+--	Edge-triggered: fd is only reported again once it was read or written until EAGAIN. Whatever it already had
+--	when it was added is reported at once.
+----------------------------------------------------------------------------------------------------------------------*/
+bool EpollLoop::Watch(Handle fd, Key key)
+{
+	struct epoll_event ev = {};
+	ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+	ev.data.u64 = key;
+	return epoll_ctl(_poll, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Unwatch
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Was Remove
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Unwatch(Handle fd);
+--					-Handle fd: Descriptor watched earlier
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Stops reporting fd. Events it raised before are still returned by the Wait in progress, if any, so the key
+--	may come up once more after this.
+----------------------------------------------------------------------------------------------------------------------*/
+void EpollLoop::Unwatch(Handle fd)
+{
+	epoll_ctl(_poll, EPOLL_CTL_DEL, fd, NULL);
+}
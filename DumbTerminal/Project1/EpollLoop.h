@@ -0,0 +1,58 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: EpollLoop.h - Event loop on an edge-triggered epoll instance for the dumb terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- EpollLoop();
+-- ~EpollLoop();
+-- int Wait(Key *keys, int max, int timeoutMs);
+-- VOID Post(Key key);
+-- bool Watch(Handle fd, Key key);
+-- VOID Unwatch(Handle fd);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Add and Remove are IoLoop's Watch and Unwatch
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Linux counterpart of IocpLoop, built by CMakeLists.txt and not by the Visual Studio project. Descriptors are
+--	added edge-triggered for input, output and hangup, so a descriptor is reported once each time it becomes
+--	readable or writable and never again while nothing changes. Reading or writing until EAGAIN is all it takes
+--	to re-arm it, which is what ReadReady and WriteReady of PosixTransport do when they return 0: no system call
+--	is spent re-arming after every read.
+--
+--	Posted keys are queued under a mutex and an eventfd wakes the waiting thread. Wait returns the keys of the
+--	descriptors that became ready followed by the keys posted since the last Wait, up to max; whatever does not
+--	fit is returned by the next Wait, which then does not block.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef EPOLLLOOP_H
+#define EPOLLLOOP_H
+#include <deque>
+#include <mutex>
+#include "IoLoop.h"
+class EpollLoop : public IoLoop
+{
+public:
+	EpollLoop();
+	~EpollLoop();
+	int		Wait(Key *keys, int max, int timeoutMs);
+	void	Post(Key key);
+	bool	Watch(Handle fd, Key key);				//Report fd under key until it is unwatched or closed
+	void	Unwatch(Handle fd);
+
+private:
+	static const Key	WAKE = ~(Key)0;				//Key of _wake
+
+	int					_poll;						//epoll instance
+	int					_wake;						//eventfd signalled by Post
+	std::mutex			_lock;						//Guards _posted
+	std::deque<Key>		_posted;					//Keys posted and not returned by Wait yet
+};
+#endif
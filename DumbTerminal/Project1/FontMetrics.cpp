@@ -0,0 +1,80 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: FontMetrics.cpp - Actual function implementation for FontMetrics.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- VOID Refresh(const MetricsProvider &provider);
+-- VOID RefreshSize(const MetricsProvider &provider);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Also caches the client height, RefreshWidth becomes RefreshSize
+--			  October 17, 2026 - Advance widths are kept for every character of the Basic Multilingual Plane
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Fills the metrics cache from a provider. Lookups are inline in FontMetrics.h.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include "FontMetrics.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Refresh
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Also reads the client height
+--			  October 17, 2026 - Reads the advance width of every character of the Basic Multilingual Plane
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Refresh(const MetricsProvider &provider);
+--					-const MetricsProvider &provider: Source of the font and window metrics
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Reads the line height, the advance width table and the client width. Called when the font is selected.
+----------------------------------------------------------------------------------------------------------------------*/
+void MetricsCache::Refresh(const MetricsProvider &provider)
+{
+	_lineHeight = provider.LineHeight();
+	provider.AdvanceWidths(_advance.data());
+	std::copy(_advance.begin(), _advance.begin() + 256, _latin1);
+	_clientWidth = provider.ClientWidth();
+	_clientHeight = provider.ClientHeight();
+	_valid = true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: RefreshSize
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Renamed from RefreshWidth, also reads the client height
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID RefreshSize(const MetricsProvider &provider);
+--					-const MetricsProvider &provider: Source of the font and window metrics
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Reads only the client width and height. Called on WM_SIZE since resizing does not change the font.
+----------------------------------------------------------------------------------------------------------------------*/
+void MetricsCache::RefreshSize(const MetricsProvider &provider)
+{
+	_clientWidth = provider.ClientWidth();
+	_clientHeight = provider.ClientHeight();
+}
@@ -0,0 +1,77 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: FontMetrics.h - Cached font and window metrics used when laying out characters in the dumb
+--			terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- VOID Refresh(const MetricsProvider &provider);
+-- VOID RefreshSize(const MetricsProvider &provider);
+-- bool Valid() const;
+-- int LineHeight() const;
+-- int Advance(unsigned int c) const;
+-- int Advance(char c) const;
+-- int ClientWidth() const;
+-- int ClientHeight() const;
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Also caches the client height, RefreshWidth becomes RefreshSize
+--			  October 17, 2026 - Advance widths are kept for every character of the Basic Multilingual Plane
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Laying out a character needs the line height, the advance width of the character and the width of the
+--	client area. Asking the device for them on every character is expensive, so MetricsCache asks a
+--	MetricsProvider once and answers from a table afterwards. The cache is rebuilt with Refresh when the
+--	selected font changes, and only the client size is re-read with RefreshSize when the window is resized.
+--
+--	Characters are Unicode code points. The table holds the advance width of every one of the Basic Multilingual
+--	Plane, CHARS of them, read with one call to the provider; a character above it, which the font is unlikely to
+--	have anyway, is laid out as wide as U+FFFD.
+--
+--	MetricsProvider is an interface so the cache can be filled from GDI in the program and from a fake provider
+--	where no display is available.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef FONTMETRICS_H
+#define FONTMETRICS_H
+#include <cstddef>
+#include <vector>
+class MetricsProvider
+{
+public:
+	static const size_t	CHARS = 0x10000;				//Characters with an advance width of their own
+
+	virtual ~MetricsProvider() {}
+	virtual int		LineHeight() const = 0;				//Height of a line including external leading
+	virtual void	AdvanceWidths(int *widths) const = 0;	//Advance width of each of the first CHARS characters
+	virtual int		ClientWidth() const = 0;			//Width of the area text is laid out in
+	virtual int		ClientHeight() const = 0;			//Height of the area rows are shown in
+};
+
+class MetricsCache
+{
+public:
+	void	Refresh(const MetricsProvider &provider);		//Reload everything, e.g. after a font change
+	void	RefreshSize(const MetricsProvider &provider);	//Reload the client size after a resize
+	bool	Valid() const { return _valid; }
+	int		LineHeight() const { return _lineHeight; }
+	int		Advance(unsigned int c) const { return _advance[c < MetricsProvider::CHARS ? c : 0xFFFD]; }
+	int		Advance(char c) const { return _latin1[(unsigned char)c]; }	//Byte of Latin-1 text
+	int		ClientWidth() const { return _clientWidth; }
+	int		ClientHeight() const { return _clientHeight; }
+
+private:
+	bool				_valid = false;			//Set once Refresh has been called
+	int					_lineHeight = 0;		//Height of one line of text
+	std::vector<int>	_advance = std::vector<int>(MetricsProvider::CHARS);	//Advance width of each character
+	int					_latin1[256] = {};		//Copy of the first 256, kept next to the other fields
+	int					_clientWidth = 0;		//Width of the client area
+	int					_clientHeight = 0;		//Height of the client area
+};
+#endif
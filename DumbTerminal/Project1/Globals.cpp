@@ -1,8 +1,21 @@
 #include "Globals.h"
-HANDLE		hComm;
-Coordinates coor;
+char		comm_name[8] = "COM1";		//Connect opens COM1 unless another port is picked
+IocpLoop	ioLoop;
+SerialListener listener;					//Posts what sessions reports to the window
+SessionManager sessions(ioLoop, listener);	//Started by WinMain once the window exists
 BOOL		isConnected = FALSE;	//The program is not connected when it starts
-OVERLAPPED	ov_read		= { 0 };	//Initialize empty overlapped
-OVERLAPPED	ov_write	= { 0 };
-COLORREF	write_color = RGB(255, 255, 0);	//Initialize color to yellow
-COLORREF	read_color	= RGB(0, 255, 0);	//Initialize color to green
+BOOL		isReplaying = FALSE;
+DWORD		last_frame_draw_calls = 0;		//Nothing drawn yet
+DWORD		last_frame_cells = 0;
+DWORD		read_chunk_size = 4096;			//Read up to 4KB of queued bytes per wakeup
+DWORD		write_chunk_size = 1 << 16;		//Send up to 64KB of queued bytes per write
+DWORD		send_pace_ms = 100;				//but no more than the link carries in 100ms
+size_t		scrollback_lines = 100000;		//Keep about 100k lines of history
+size_t		scrollback_bytes = 64 << 20;	//in at most 64MB, compressed or not
+size_t		hex_scrollback_bytes = 16 << 20;	//Keep the last 16MB in the hex view, a million rows
+RingBuffer	replayRing(1 << 16);			//64KB between the replay thread and the UI thread, as a session has
+volatile LONG replayPending = FALSE;		//No WM_SERIAL_DATA outstanding at start
+CaptureLog	capture(1 << 20);				//Two 1MB buffers, several seconds at any baud rate
+char		replay_path[MAX_PATH];
+double		replay_speed = 1;
+volatile LONG replayStop = FALSE;
@@ -9,7 +9,7 @@
 --
 -- DATE: October 4, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - The ports are sessions of a SessionManager, the replay has a ring of its own
 --
 -- DESIGNER: Ruoqi Jia
 --
@@ -23,28 +23,70 @@
 #define GLOBALS_H
 #include <fstream>
 #include <string>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <utility>
 #include <windows.h>
 #include <stdio.h>
+#include <io.h>
 #include "menu.h"
+#include "RingBuffer.h"
+#include "SendQueue.h"
+#include "Stats.h"
+#include "CaptureLog.h"
+#include "Transport.h"
+#include "Win32Transport.h"
+#include "ScreenModel.h"
+#include "FontMetrics.h"
+#include "RowIndex.h"
+#include "RenderTarget.h"
+#include "ControlScan.h"
+#include "Utf8Decoder.h"
+#include "VtParser.h"
+#include "PagedView.h"
+#include "Terminal.h"
+#include "HexFormat.h"
+#include "HexView.h"
+#include "BackBuffer.h"
+#include "Replay.h"
+#include "LoopbackTransport.h"
+#include "IoLoop.h"
+#include "IocpLoop.h"
+#include "SessionManager.h"
+#include "Headless.h"
 #include "Physical.h"
 #include "Session.h"
-struct Coordinates					//Contains the x and y coordinates that are used to draw text
-{
-	unsigned		_x = 0, _y = 0;	
-	void Reset() { _x = _y = 0; }	//Set values back to origin
-};
-static HANDLE	rThread;					//Handle for the read thread
-static DWORD	rThreadId;					//Stores the thread id
+#define WM_SERIAL_DATA	(WM_APP + 1)		//Bytes are waiting, wParam the id of the session, NONE for the replay
+#define WM_SEND_DONE	(WM_APP + 2)		//The last byte of a file was sent, wParam the id of its session
+#define WM_REPLAY_DONE	(WM_APP + 3)		//Posted by the replay thread at the end of the capture, wParam FALSE on error
+#define IDT_REFLOW		1					//Timer that lays out the history after a resize
+#define REFLOW_LINES	10000				//Lines laid out per IDT_REFLOW tick
+#define IDT_SEND		2					//Timer that updates the progress of a file send
+#define SEND_PROGRESS_MS 500				//Interval of IDT_SEND
+#define IDT_CAPTURE		3					//Timer that hands buffered capture records to the disk
+#define CAPTURE_FLUSH_MS 1000				//Interval of IDT_CAPTURE
 const	char		Name[] = "Dumb Terminal Emulator";	//Name of the program
-const	LPCSTR		lpszCommName = "COM1";	//Port name
-extern	HANDLE		hComm;					//Handle for the serial port
+extern	char		comm_name[8];		//Port the next Connect opens, picked in the Port menu
+extern	IocpLoop	ioLoop;				//Services every open port, on the thread of sessions
+extern	SessionManager sessions;			//The ports connected, one session each
 extern	BOOL		isConnected;		//Keep track of the current mode for the program
-extern	COLORREF	write_color;	//Color to dispplay when writing 
-extern	COLORREF	read_color;		//Color to display when reading
-extern OVERLAPPED ov_read;
-extern OVERLAPPED ov_write;
-extern	Coordinates coor;						//Coorinate to display text on the current window
-static	std::vector<std::pair<std::string, COLORREF>> rwHistory;	//Stores all I/O history
+extern	BOOL		isReplaying;		//A capture is being replayed into the window
+extern	DWORD		last_frame_draw_calls;	//Text output calls issued by the last repaint or receive update
+extern	DWORD		last_frame_cells;		//Cells drawn by the last repaint or receive update
+extern	DWORD		read_chunk_size;	//Maximum number of bytes taken from the receive queue per ReadFile
+extern	DWORD		write_chunk_size;	//Maximum number of queued bytes sent per WriteFile
+extern	DWORD		send_pace_ms;		//Link time one WriteFile is sized to cover
+extern	size_t		scrollback_lines;	//Most lines of history kept, 0 for no limit
+extern	size_t		scrollback_bytes;	//Most bytes of memory the history may use, 0 for no limit
+extern	size_t		hex_scrollback_bytes;	//Most bytes the hex view keeps, 0 for no limit
+extern	RingBuffer	replayRing;				//Bytes handed from the replay thread to the UI thread
+extern	volatile LONG replayPending;		//TRUE while a WM_SERIAL_DATA of the replay is posted but not yet handled
+extern	CaptureLog	capture;				//Records the bytes sent and received to a file
+extern	char		replay_path[MAX_PATH];	//Capture being replayed
+extern	double		replay_speed;		//1 for the original timing, N for N times faster, 0 for no waiting
+extern	volatile LONG replayStop;			//Set by the UI thread to end the replay early
 #endif
@@ -0,0 +1,994 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: Headless.cpp - Actual function implementation for Headless.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- bool Parse_Headless_Args(int argc, char **argv, HeadlessOptions &options, std::string &error);
+-- bool Run_Headless(IoLoop &loop, Transport *port, const HeadlessOptions &options, HeadlessReport &report);
+-- int Headless_Main(IoLoop &loop, NewDevice newDevice, int argc, char **argv);
+-- static bool Number_Arg(const char *text, double &value);
+-- static VOID Print_Stats();
+-- static Transport *New_Port(NewDevice newDevice, const HeadlessOptions &options);
+-- static int Run_Cycles(IoLoop &loop, NewDevice newDevice, const HeadlessOptions &options);
+-- HeadlessRun::HeadlessRun(SessionManager &manager, int id, HeadlessListener &events,
+--						const HeadlessOptions &options, RenderTarget &target);
+-- bool HeadlessRun::Run(HeadlessReport &report);
+-- size_t HeadlessRun::Drain();
+-- VOID HeadlessRun::Writer();
+-- VOID HeadlessRun::Account();
+-- VOID HeadlessRun::Detach();
+-- VOID HeadlessRun::Wait();
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Counts reads, writes and frames in the statistics and prints them for --stats
+--			  October 17, 2026 - Connect and disconnect soak for --cycles
+--			  October 17, 2026 - Runs the port as a session of a SessionManager instead of a reader and a writer
+--			  thread of its own
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Console front end. See Headless.h.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#endif
+#include "CaptureLog.h"
+#include "Headless.h"
+#include "LoopbackTransport.h"
+#include "RenderTarget.h"
+#include "Replay.h"
+#include "SessionManager.h"
+#include "Stats.h"
+static const size_t				HEADLESS_CHUNK = 4096;				//Most bytes per read and per write
+static const unsigned long		HEADLESS_PACE_MS = 100;				//Link time one write covers, as send_pace_ms
+static const size_t				SEND_BLOCK = 1 << 20;				//Bytes of a file attached to the session at once
+static const size_t				LOOPBACK_CAPACITY = 1 << 16;		//As much as a driver's receive queue
+static const size_t				DRAIN_MAX = 1 << 16;				//Most bytes laid out per frame, a session's ring
+static const unsigned long long	FNV_BASIS = 14695981039346656037ULL;	//Running hashes of what was sent and received
+static const unsigned long long	FNV_PRIME = 1099511628211ULL;
+static const unsigned long		CYCLE_WARMUP = 100;					//Connections made before the resources are sampled
+static const size_t				CYCLE_MEMORY_SLACK = 1 << 20;		//Growth of memory still taken as flat
+static const char				*USAGE =
+	"usage: [--port NAME|loop] [--baud N] [--data 5-8] [--parity N|E|O|M|S] [--stop 1|2] [--flow none|rtscts|xonxoff]\n"
+	"       [--send FILE|-] [--repeat N] [--capture FILE] [--quiet] [--seconds S] [--idle MS] [--verify]\n"
+	"       [--stats S] [--cycles N]";
+
+class HeadlessListener : public SessionListener	//Wakes the main thread when the session has news
+{
+public:
+	HeadlessListener() : received(false), sent(false), closed(false) {}
+	void	Received(int)	{ Raise(received); }
+	void	Sent(int)		{ Raise(sent); }
+	void	Closed(int)		{ Raise(closed); }
+
+	std::mutex				lock;			//Guards the flags and what a HeadlessRun shares between its threads
+	std::condition_variable	changed;		//Signalled when a flag is raised and when a block changes hands
+	bool					received, sent, closed;
+
+private:
+	void	Raise(bool &flag) { std::lock_guard<std::mutex> guard(lock); flag = true; changed.notify_all(); }
+};
+
+class HeadlessRun							//One run: the session, the writer thread and what they share
+{
+public:
+	HeadlessRun(SessionManager &manager, int id, HeadlessListener &events, const HeadlessOptions &options,
+		RenderTarget &target);
+	bool	Run(HeadlessReport &report);
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	size_t	Drain();						//Take what the session received and lay it out, main thread only
+	void	Writer();						//Body of the writer thread
+	void	Account();						//Hash what the session sent of the block, under the lock
+	void	Detach();						//Take the block back from the session, without the lock
+	void	Wait();							//Until it is time to stop
+
+	SessionManager			&_manager;
+	int						_id;
+	HeadlessListener		&_events;		//Its lock guards everything below that both threads use
+	const HeadlessOptions	&_options;
+	PortSession				&_session;		//Terminal and read color of the session, main thread only
+	RenderTarget			&_target;
+	CaptureLog				_capture;
+	std::vector<char>		_buffer;		//Received bytes are taken into it, main thread only
+	std::vector<char>		_block;			//Bytes to send, the writer thread's while _blockReady is not set
+	size_t					_blockLen;
+	bool					_blockReady;	//_block holds bytes to send, the writer waits until they were sent
+	bool					_attached;		//_block is attached to the session, main thread only
+	size_t					_blockSent;		//Bytes of _block hashed as sent, main thread only
+	Clock::time_point		_start;
+	Clock::time_point		_lastActive;	//Last byte received or sent, or the end of the send
+	bool					_sendDone;		//The writer thread has nothing more to send
+	bool					_stalled;		//Stopped by --idle before the send was done
+	bool					_stopSending;	//--seconds have passed, nothing more is attached
+	bool					_portError;
+	unsigned long long		_rxBytes, _txBytes;
+	unsigned long long		_rxHash, _txHash;
+};
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Number_Arg
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static bool Number_Arg(const char *text, double &value);
+--					-const char *text:	Argument following an option, NULL when it was the last one
+--					-double &value:		Set to the number
+--
+-- RETURNS: false when text is missing, not a number or negative
+--
+-- NOTES:
+--	Options only take numbers of zero or more.
+----------------------------------------------------------------------------------------------------------------------*/
+static bool Number_Arg(const char *text, double &value)
+{
+	char *end;
+	if (text == NULL)
+		return false;
+	value = strtod(text, &end);
+	return end != text && *end == '\0' && value >= 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Print_Stats
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Print_Stats();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Prints the statistics of all threads to stderr, followed by an empty line, for --stats, without the rows only
+--	the window fills in (see Stats.h).
+----------------------------------------------------------------------------------------------------------------------*/
+static void Print_Stats()
+{
+	StatsSnapshot snapshot;
+	Stats_Read(snapshot);
+	fprintf(stderr, "%s\n", Stats_Format(snapshot, false).c_str());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Sample_Resources
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - No longer static, dtreadertest checks the reader with it too
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Sample_Resources(size_t &handles, size_t &bytes);
+--					-size_t &handles:	Set to the handles the process has open, file descriptors on Linux
+--					-size_t &bytes:		Set to the memory the process uses
+--
+-- RETURNS: false when the system would not tell
+--
+-- NOTES:
+--	On Windows the memory is the private bytes of the process, on Linux its resident set, from /proc/self/statm.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Sample_Resources(size_t &handles, size_t &bytes)
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS_EX	counters;
+	DWORD						count;
+	if (!GetProcessHandleCount(GetCurrentProcess(), &count)
+		|| !K32GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS *)&counters, sizeof(counters)))
+		return false;
+	handles = count;
+	bytes = counters.PrivateUsage;
+	return true;
+#else
+	DIR				*fds;
+	FILE			*statm;
+	unsigned long	size, resident;
+	if ((fds = opendir("/proc/self/fd")) == NULL)
+		return false;
+	for (handles = 0; readdir(fds) != NULL; ++handles)
+		;
+	closedir(fds);									//The count took in ".", ".." and fds itself, as every sample does
+	if ((statm = fopen("/proc/self/statm", "r")) == NULL)
+		return false;
+	bool ok = fscanf(statm, "%lu %lu", &size, &resident) == 2;
+	fclose(statm);
+	bytes = (size_t)resident * (size_t)sysconf(_SC_PAGESIZE);
+	return ok;
+#endif
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Parse_Headless_Args
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Parse_Headless_Args(int argc, char **argv, HeadlessOptions &options, std::string &error);
+--					-int argc:					Number of arguments
+--					-char **argv:				Arguments, without the program name
+--					-HeadlessOptions &options:	Set to the defaults, then to what the arguments say
+--					-std::string &error:		Set to what is wrong, followed by the usage, when false is returned
+--
+-- RETURNS: false when an argument is unknown or its value is missing or out of range
+--
+-- NOTES:
+--	The arguments are listed in Headless.h. Verification is turned on for the loopback whatever the arguments
+--	say, since everything sent on it comes back.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Parse_Headless_Args(int argc, char **argv, HeadlessOptions &options, std::string &error)
+{
+	double value;
+	options.port = "loop";
+	options.settings.baud = 9600;
+	options.settings.dataBits = 8;
+	options.settings.parity = 'N';
+	options.settings.stopBits = 1;
+	options.settings.flow = PortSettings::FLOW_NONE;
+	options.send.clear();
+	options.repeat = 1;
+	options.capture.clear();
+	options.echo = true;
+	options.seconds = 0;
+	options.idleMs = 1000;
+	options.verify = false;
+	options.statsSeconds = -1;
+	options.scrollbackLines = 100000;				//Same as the window
+	options.scrollbackBytes = 64 << 20;
+	options.cycles = 0;
+	for (int i = 0; i < argc; ++i)
+	{
+		const char *arg = argv[i], *next = i + 1 < argc ? argv[i + 1] : NULL;
+		bool		ok = true;
+		if (strcmp(arg, "--quiet") == 0)
+		{
+			options.echo = false;
+			continue;
+		}
+		if (strcmp(arg, "--verify") == 0)
+		{
+			options.verify = true;
+			continue;
+		}
+		if (next == NULL)								//Every other option takes a value
+			ok = false;
+		else if (strcmp(arg, "--port") == 0)
+			options.port = next;
+		else if (strcmp(arg, "--send") == 0)
+			options.send = next;
+		else if (strcmp(arg, "--capture") == 0)
+			options.capture = next;
+		else if (strcmp(arg, "--parity") == 0)
+		{
+			if ((ok = strlen(next) == 1 && strchr("NEOMS", next[0] & ~0x20) != NULL))
+				options.settings.parity = next[0] & ~0x20;	//Upper case
+		}
+		else if (strcmp(arg, "--flow") == 0)
+		{
+			if (strcmp(next, "none") == 0)
+				options.settings.flow = PortSettings::FLOW_NONE;
+			else if (strcmp(next, "rtscts") == 0)
+				options.settings.flow = PortSettings::FLOW_HARDWARE;
+			else if (strcmp(next, "xonxoff") == 0)
+				options.settings.flow = PortSettings::FLOW_SOFTWARE;
+			else
+				ok = false;
+		}
+		else if (!Number_Arg(next, value))
+			ok = false;
+		else if (strcmp(arg, "--baud") == 0 && value >= 1)
+			options.settings.baud = (unsigned long)value;
+		else if (strcmp(arg, "--data") == 0 && value >= 5 && value <= 8)
+			options.settings.dataBits = (int)value;
+		else if (strcmp(arg, "--stop") == 0 && (value == 1 || value == 2))
+			options.settings.stopBits = (int)value;
+		else if (strcmp(arg, "--repeat") == 0 && value >= 1)
+			options.repeat = (unsigned long)value;
+		else if (strcmp(arg, "--seconds") == 0)
+			options.seconds = value;
+		else if (strcmp(arg, "--idle") == 0)
+			options.idleMs = (unsigned long)value;
+		else if (strcmp(arg, "--stats") == 0)
+			options.statsSeconds = value;
+		else if (strcmp(arg, "--cycles") == 0)
+			options.cycles = (unsigned long)value;
+		else
+			ok = false;
+		if (!ok)
+		{
+			error = std::string("Bad argument ") + arg + (next != NULL ? std::string(" ") + next : "") + "\n" + USAGE;
+			return false;
+		}
+		++i;											//Skip the value
+	}
+	if (options.port == "loop")
+		options.verify = true;
+	return true;
+}
+
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: HeadlessRun
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Runs an open session instead of a port
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: HeadlessRun(SessionManager &manager, int id, HeadlessListener &events,
+--						const HeadlessOptions &options, RenderTarget &target);
+--					-SessionManager &manager:			Manager the session is open in, started
+--					-int id:							The session
+--					-HeadlessListener &events:			Listener of the manager
+--					-const HeadlessOptions &options:	What to send, where to record and when to stop
+--					-RenderTarget &target:				Surface the session's terminal is composed onto
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	The capture has the same 1MB buffers as the window's. The block is allocated once, for the largest read of a
+--	file.
+----------------------------------------------------------------------------------------------------------------------*/
+HeadlessRun::HeadlessRun(SessionManager &manager, int id, HeadlessListener &events, const HeadlessOptions &options,
+	RenderTarget &target)
+	: _manager(manager), _id(id), _events(events), _options(options), _session(*manager.Session(id)), _target(target),
+	_capture(1 << 20), _buffer(HEADLESS_CHUNK), _block(SEND_BLOCK), _blockLen(0), _blockReady(false),
+	_attached(false), _blockSent(0), _sendDone(false), _stalled(false), _stopSending(false), _portError(false),
+	_rxBytes(0), _txBytes(0), _rxHash(FNV_BASIS), _txHash(FNV_BASIS)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Run
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Reports a failed write to the capture file and the bytes dropped
+--			  October 17, 2026 - The session records the capture, with Stats_Now timestamps
+--			  October 17, 2026 - Closes the session instead of cancelling the port
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Run(HeadlessReport &report);
+--					-HeadlessReport &report: Set to the totals
+--
+-- RETURNS: false when the capture file cannot be created, else true
+--
+-- NOTES:
+--	Has the session record the capture and starts the writer thread, then serves the session until it is time to
+--	stop. The block still attached is taken back, which ends the writer, what was received meanwhile is laid out,
+--	and the session is closed before the capture is, so the loop's thread no longer records into it.
+----------------------------------------------------------------------------------------------------------------------*/
+bool HeadlessRun::Run(HeadlessReport &report)
+{
+	report = HeadlessReport();
+	if (!_options.capture.empty() && !_capture.Start(_options.capture.c_str(), 1000000, Stats_Now()))
+		return false;
+	_manager.Capture(_id, _options.capture.empty() ? NULL : &_capture);
+	_start = _lastActive = Clock::now();
+	std::thread writer(&HeadlessRun::Writer, this);
+	Wait();
+	Detach();
+	{
+		std::lock_guard<std::mutex> guard(_events.lock);
+		_stopSending = true;
+		_blockReady = false;						//Let the writer go
+		_portError = _portError || (_events.closed && !_options.send.empty());	//Only an error while sending
+	}
+	_events.changed.notify_all();
+	writer.join();
+	Drain();
+	_manager.Close(_id);
+	report.captureFailed = !_capture.Stop();
+	report.captureDropped = _capture.Dropped();
+	report.rxBytes = _rxBytes;
+	report.txBytes = _txBytes;
+	report.seconds = std::chrono::duration<double>(Clock::now() - _start).count();
+	report.portError = _portError;
+	report.stalled = _stalled;
+	report.verified = _rxBytes == _txBytes && _rxHash == _txHash;
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Drain
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Replaces the reader thread, the loop's thread of the session reads the port
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Drain();
+--
+-- RETURNS: Bytes taken from the session, DRAIN_MAX when there may be more waiting
+--
+-- NOTES:
+--	The headless Drain_Received, called on the main thread when the session has bytes waiting. Takes them with
+--	Receive, which re-arms the notification, writes them to the session's terminal in the read color and streams
+--	them to stdout unless --quiet, then composes what changed as one frame, as the window does. At most DRAIN_MAX
+--	bytes are taken, so a frame does not grow without end while the loop's thread keeps the session full. The
+--	reads themselves are counted by the session manager.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t HeadlessRun::Drain()
+{
+	Terminal			&terminal = _session.terminal;
+	size_t				n, total = 0;
+	int					left, top, right, bottom, dy;
+	unsigned long long	start = Stats_Now();
+	while (total < DRAIN_MAX && (n = _manager.Receive(_id, _buffer.data(), _buffer.size())) > 0)
+	{
+		terminal.Write(_buffer.data(), n, _session.readColor);
+		if (_options.echo)
+		{
+			fwrite(_buffer.data(), 1, n, stdout);
+			fflush(stdout);
+		}
+		for (size_t i = 0; i < n; ++i)
+			_rxHash = (_rxHash ^ (unsigned char)_buffer[i]) * FNV_PRIME;
+		_rxBytes += n;
+		total += n;
+	}
+	if (total == 0)
+		return 0;
+	if ((dy = terminal.TakeScroll()) != 0)
+		_target.Scroll(dy);
+	while (terminal.NextDirty(left, top, right, bottom))
+		terminal.Compose(_target, left, top, right, bottom);
+	Stats_Count(STAT_FRAMES);
+	Stats_Sample(STAT_FRAME_US, Stats_Now() - start);
+	return total;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Writer
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Hands blocks to the main thread instead of writing to the port
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Writer();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Body of the writer thread. Reads the file --repeat times, SEND_BLOCK bytes at a time, or standard input once
+--	until it ends, HEADLESS_CHUNK bytes at a time, into _block; the main thread attaches each block to the
+--	session and lets the writer have it back once the session sent it. Ends early once the send is stopped, and
+--	marks the send done. A file that cannot be opened is counted as a port error, so the run fails without
+--	sending. A read of standard input cannot be cancelled, so a run sending it is only over once it ends,
+--	whatever --seconds says.
+----------------------------------------------------------------------------------------------------------------------*/
+void HeadlessRun::Writer()
+{
+	std::ifstream	file;
+	bool			fromStdin = _options.send == "-", opened = true;
+	size_t			n;
+	if (!_options.send.empty() && !fromStdin)
+	{
+		file.open(_options.send.c_str(), std::ios::binary);
+		opened = file.is_open();
+	}
+	std::unique_lock<std::mutex> guard(_events.lock);
+	for (unsigned long pass = 0; opened && !_stopSending && !_options.send.empty()
+		&& pass < (fromStdin ? 1 : _options.repeat); ++pass)
+	{
+		file.clear();
+		file.seekg(0);
+		while (!_stopSending)
+		{
+			guard.unlock();							//The block is not the main thread's while it is not ready
+			if (fromStdin)
+				n = fread(_block.data(), 1, HEADLESS_CHUNK, stdin);
+			else
+				n = (size_t)file.read(_block.data(), _block.size()).gcount();
+			guard.lock();
+			if (n == 0)
+				break;
+			_blockLen = n;
+			_blockReady = true;
+			_events.changed.notify_all();
+			_events.changed.wait(guard, [this] { return !_blockReady; });
+		}
+	}
+	_portError = _portError || !opened;
+	_sendDone = true;
+	_lastActive = Clock::now();
+	_events.changed.notify_all();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Account
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Replaces SendAll, the session writes the block
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Account();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Called with the lock held. Asks the session how much of the attached block the port took and adds the bytes
+--	since the last call to the totals. Bytes sent count as activity, so a send that keeps moving is not taken for
+--	a stall. The writes themselves are counted and captured by the session manager.
+----------------------------------------------------------------------------------------------------------------------*/
+void HeadlessRun::Account()
+{
+	size_t sent, total;
+	if (!_attached)
+		return;
+	_manager.Progress(_id, sent, total);
+	if (sent <= _blockSent)
+		return;
+	for (size_t i = _blockSent; i < sent; ++i)
+		_txHash = (_txHash ^ (unsigned char)_block[i]) * FNV_PRIME;
+	_txBytes += sent - _blockSent;
+	_blockSent = sent;
+	_lastActive = Clock::now();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Detach
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Detach();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Takes the block back from the session when the send is stopped, aborting the write in progress until the loop's
+--	thread lets go of it, as End_Send does, then accounts for what was sent of it. Called without the lock, since
+--	the loop's thread may be waiting for it to report the write. Does nothing when no block is attached.
+----------------------------------------------------------------------------------------------------------------------*/
+void HeadlessRun::Detach()
+{
+	if (!_attached)
+		return;
+	while (!_manager.Detach(_id, 50))
+		_manager.AbortWrite(_id);
+	std::lock_guard<std::mutex> guard(_events.lock);
+	Account();
+	_attached = false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Wait
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Prints the statistics every --stats seconds
+--			  October 17, 2026 - Drains the session and attaches the blocks of the writer thread meanwhile
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Wait();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Serves the session on the main thread, the way the window's UI thread does: drains it when it has bytes
+--	waiting, and attaches the next block of the writer thread when the last one was sent.
+--
+--	Returns when the port failed or hung up or, when only listening, when --seconds have passed. When sending, the
+--	send is stopped after --seconds and the run ends once nothing was sent or received for --idle milliseconds:
+--	after the send the idle time is what lets the echo of the last bytes sent arrive, so a soak run stopped by
+--	the clock still verifies; before it, running out of idle time means the link stalled, e.g. held back by flow
+--	control that never releases, and the run fails instead of hanging. With --idle 0 the run ends as soon as the
+--	send is done. With --stats it also wakes up every S seconds to print the statistics, without the lock.
+----------------------------------------------------------------------------------------------------------------------*/
+void HeadlessRun::Wait()
+{
+	std::unique_lock<std::mutex> guard(_events.lock);
+	Clock::time_point	deadline = Clock::time_point::max(), wake, idleEnd, now, report = Clock::time_point::max();
+	Clock::duration		every = std::chrono::duration_cast<Clock::duration>(
+							std::chrono::duration<double>(_options.statsSeconds));
+	bool				sending = !_options.send.empty();
+	size_t				got;
+	if (_options.seconds > 0)
+		deadline = _start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(_options.seconds));
+	if (_options.statsSeconds > 0)
+		report = _start + every;
+	while (!_events.closed)
+	{
+		if (_events.received)
+		{
+			_events.received = false;				//Before Receive re-arms the session
+			guard.unlock();							//The writer thread keeps reading meanwhile
+			got = Drain();
+			guard.lock();
+			if (got > 0)
+				_lastActive = Clock::now();
+			_events.received = _events.received || got >= DRAIN_MAX;	//Come back for the rest
+			continue;
+		}
+		if (_events.sent)							//The whole block went out
+		{
+			_events.sent = false;
+			Account();
+			_attached = _blockReady = false;		//The writer thread reads the next one
+			_events.changed.notify_all();
+			continue;
+		}
+		if (_blockReady && !_attached && !_stopSending)
+		{
+			_blockSent = 0;
+			_attached = true;
+			_manager.Attach(_id, _block.data(), _blockLen);
+		}
+		now = Clock::now();
+		if (now >= report)
+		{
+			guard.unlock();							//The threads keep going while it prints
+			Print_Stats();
+			guard.lock();
+			if ((report += every) <= now)			//Printing took longer than the period
+				report = now + every;
+			continue;
+		}
+		wake = report;
+		if (now < deadline)
+			wake = std::min(wake, deadline);
+		else if (!sending)
+			break;
+		else if (!_stopSending)
+		{
+			_stopSending = true;					//Let what is on the line come back first
+			guard.unlock();
+			Detach();
+			guard.lock();
+			_blockReady = false;					//Let the writer go
+			_events.changed.notify_all();
+			continue;
+		}
+		Account();									//What went out since the last look is activity too
+		if (sending && _options.idleMs == 0)
+		{
+			if (_sendDone)
+				break;
+		}
+		else if (sending)
+		{
+			if ((idleEnd = _lastActive + std::chrono::milliseconds(_options.idleMs)) <= now)
+			{
+				_stalled = !_sendDone;
+				break;
+			}
+			wake = std::min(wake, idleEnd);
+		}
+		if (wake == Clock::time_point::max())
+			_events.changed.wait(guard);
+		else
+			_events.changed.wait_until(guard, wake);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: New_Port
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static Transport *New_Port(NewDevice newDevice, const HeadlessOptions &options);
+--					-NewDevice newDevice:				Creates the device transport of the platform
+--					-const HeadlessOptions &options:	--port
+--
+-- RETURNS: A closed transport, for a session to own once it is opened
+--
+-- NOTES:
+--	A new LoopbackTransport for "--port loop", else a new device transport.
+----------------------------------------------------------------------------------------------------------------------*/
+static Transport *New_Port(NewDevice newDevice, const HeadlessOptions &options)
+{
+	return options.port == "loop" ? new LoopbackTransport(LOOPBACK_CAPACITY) : newDevice();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Run_Cycles
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Opens and closes a session of a SessionManager instead of starting a PortReader
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static int Run_Cycles(IoLoop &loop, NewDevice newDevice, const HeadlessOptions &options);
+--					-IoLoop &loop:						Loop of the platform the sessions are serviced by
+--					-NewDevice newDevice:				Creates the device transport of the platform
+--					-const HeadlessOptions &options:	Port, settings, --cycles and --verify
+--
+-- RETURNS: 0 when every connection worked and the handles and memory stayed flat, else 1
+--
+-- NOTES:
+--	The soak run of --cycles: connects --cycles times the way Connect and Disconnect do, opening and configuring
+--	a new port, opening a session on it in one SessionManager that runs for the whole soak, and closing the
+--	session, which closes and frees the port. With --verify, which the loopback always has, each connection also
+--	sends a probe and waits up to a second for its echo, so every session is known to have been serviced. The
+--	time Close takes, from the post to the port unregistered and closed, is reported at its worst.
+--
+--	The handles and memory of the process are sampled after CYCLE_WARMUP connections, once the allocator has
+--	settled, and again at the end. The run fails if a single handle more is open, or the memory grew by more than
+--	CYCLE_MEMORY_SLACK, since either means something is leaked per connection.
+----------------------------------------------------------------------------------------------------------------------*/
+static int Run_Cycles(IoLoop &loop, NewDevice newDevice, const HeadlessOptions &options)
+{
+	HeadlessListener	events;
+	SessionManager		manager(loop, events);
+	Transport			*port;
+	int					id;
+	char				probe[64], echo[sizeof(probe)];
+	size_t				baseHandles = 0, baseBytes = 0, handles = 0, bytes = 0, got;
+	unsigned long		warmup = options.cycles > CYCLE_WARMUP * 10 ? CYCLE_WARMUP : options.cycles / 10, done;
+	unsigned long long	start, stopUs, worstStopUs = 0, totalStopUs = 0, began = Stats_Now();
+	bool				sampled = true, ok = true;
+	for (size_t i = 0; i < sizeof(probe); ++i)
+		probe[i] = (char)('A' + i % 26);
+	if (!manager.Start(HEADLESS_CHUNK, HEADLESS_CHUNK, HEADLESS_PACE_MS))
+	{
+		fprintf(stderr, "Error starting the session manager\n");
+		return 1;
+	}
+	for (done = 0; ok && done < options.cycles; ++done)
+	{
+		if (done == warmup)
+			sampled = Sample_Resources(baseHandles, baseBytes);
+		port = New_Port(newDevice, options);
+		if (!port->Open(options.port.c_str()) || !port->Configure(options.settings))
+		{
+			fprintf(stderr, "Error opening %s on connection %lu\n", options.port.c_str(), done + 1);
+			port->Close();
+			delete port;
+			return 1;
+		}
+		{
+			std::lock_guard<std::mutex> guard(events.lock);
+			events.received = events.sent = events.closed = false;
+		}
+		if ((id = manager.Open(port, options.port.c_str())) == SessionManager::NONE)
+		{
+			fprintf(stderr, "Error opening a session on connection %lu\n", done + 1);
+			return 1;
+		}
+		if (options.verify)
+		{
+			manager.Send(id, probe, sizeof(probe));
+			std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+			for (got = 0; ok && got < sizeof(probe); got += manager.Receive(id, echo + got, sizeof(echo) - got))
+			{
+				std::unique_lock<std::mutex> guard(events.lock);
+				ok = events.changed.wait_until(guard, deadline,
+					[&events] { return events.received || events.closed; }) && !events.closed;
+				events.received = false;			//Before Receive re-arms the session
+			}
+			ok = ok && memcmp(probe, echo, sizeof(probe)) == 0;
+			if (!ok)
+				fprintf(stderr, "The probe did not come back on connection %lu\n", done + 1);
+		}
+		start = Stats_Now();
+		manager.Close(id);
+		stopUs = Stats_Now() - start;
+		worstStopUs = std::max(worstStopUs, stopUs);
+		totalStopUs += stopUs;
+	}
+	manager.Stop();
+	if (!ok)
+		return 1;
+	fprintf(stderr, "%lu connections in %.3f s, disconnect took %.3f ms on average and %.3f ms at most\n", done,
+		(Stats_Now() - began) / 1e6, done > 0 ? totalStopUs / 1e3 / done : 0.0, worstStopUs / 1e3);
+	if (!sampled || !Sample_Resources(handles, bytes))
+	{
+		fprintf(stderr, "Could not sample the handles and memory of the process\n");
+		return 1;
+	}
+	fprintf(stderr, "After %lu warm-up connections: handles %lu -> %lu, memory %.1f KB -> %.1f KB\n", warmup,
+		(unsigned long)baseHandles, (unsigned long)handles, baseBytes / 1024.0, bytes / 1024.0);
+	if (handles > baseHandles || bytes > baseBytes + CYCLE_MEMORY_SLACK)
+	{
+		fprintf(stderr, "Leak: the handles or memory grew with the connections\n");
+		return 1;
+	}
+	return 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Run_Headless
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Opens the port as a session of a SessionManager on loop, whose terminal it uses
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Run_Headless(IoLoop &loop, Transport *port, const HeadlessOptions &options,
+--						HeadlessReport &report);
+--					-IoLoop &loop:						Loop of the platform the session is serviced by
+--					-Transport *port:					Open and configured port, owned by the session from here on
+--					-const HeadlessOptions &options:	What to send, where to record and when to stop
+--					-HeadlessReport &report:			Set to the totals
+--
+-- RETURNS: false when the capture file cannot be created, else true
+--
+-- NOTES:
+--	Runs one connection on the port until it is time to stop. The session's terminal is laid out as an 80 by 25
+--	window of 8 by 16 pixel cells, as a replay is, with the scrollback limits of the options, and composed into a
+--	MemoryRenderTarget of that size. When the manager cannot be started the run is reported as a port error. The
+--	port is closed and deleted on return.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Run_Headless(IoLoop &loop, Transport *port, const HeadlessOptions &options, HeadlessReport &report)
+{
+	FixedMetrics		metrics(8, 16, 80, 25);
+	HeadlessListener	events;
+	SessionManager		manager(loop, events);
+	PortSession			*session;
+	int					id;
+	report = HeadlessReport();
+	if (!manager.Start(HEADLESS_CHUNK, HEADLESS_CHUNK, HEADLESS_PACE_MS))
+	{
+		port->Close();
+		delete port;
+		report.portError = true;
+		return true;
+	}
+	if ((id = manager.Open(port, options.port.c_str())) == SessionManager::NONE)	//The port is deleted
+	{
+		report.portError = true;
+		return true;
+	}
+	session = manager.Session(id);
+	session->terminal.UpdateMetrics(metrics, true);
+	session->terminal.SetScrollback(options.scrollbackLines, options.scrollbackBytes);
+	MemoryRenderTarget target(session->terminal.Metrics(), metrics.ClientWidth(), metrics.ClientHeight());
+	HeadlessRun run(manager, id, events, options, target);
+	return run.Run(report);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Headless_Main
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Prints the statistics at the end for --stats
+--			  October 17, 2026 - Hands --cycles to Run_Cycles
+--			  October 17, 2026 - Reports the capture file failing or dropping bytes
+--			  October 17, 2026 - Takes the platform's loop and creates a new port for the session
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int Headless_Main(IoLoop &loop, NewDevice newDevice, int argc, char **argv);
+--					-IoLoop &loop:			Loop of the platform the session is serviced by
+--					-NewDevice newDevice:	Creates the device transport of the platform, used unless the port is "loop"
+--					-int argc:				Number of arguments
+--					-char **argv:			Arguments, without the program name
+--
+-- RETURNS: 0 on success, 1 when the port failed, the send stalled, a write to the capture file failed or the
+--			verification did not hold, 2 for bad arguments
+--
+-- NOTES:
+--	Opens and configures the port, runs it and prints the totals to stderr, so stdout only carries what was
+--	received. With --cycles Run_Cycles opens the ports itself instead.
+----------------------------------------------------------------------------------------------------------------------*/
+int Headless_Main(IoLoop &loop, NewDevice newDevice, int argc, char **argv)
+{
+	HeadlessOptions		options;
+	HeadlessReport		report;
+	std::string			error;
+	Transport			*port;
+	if (!Parse_Headless_Args(argc, argv, options, error))
+	{
+		fprintf(stderr, "%s\n", error.c_str());
+		return 2;
+	}
+	if (!options.send.empty() && options.send != "-" && !std::ifstream(options.send.c_str()).is_open())
+	{
+		fprintf(stderr, "Error opening the file %s\n", options.send.c_str());
+		return 1;
+	}
+	if (options.cycles > 0)
+		return Run_Cycles(loop, newDevice, options);
+	port = New_Port(newDevice, options);
+	if (!port->Open(options.port.c_str()) || !port->Configure(options.settings))
+	{
+		fprintf(stderr, "Error opening %s at %lu %d%c%d\n", options.port.c_str(), options.settings.baud,
+			options.settings.dataBits, options.settings.parity, options.settings.stopBits);
+		port->Close();
+		delete port;
+		return 1;
+	}
+	if (!Run_Headless(loop, port, options, report))
+	{
+		fprintf(stderr, "Error creating the capture file %s\n", options.capture.c_str());
+		return 1;
+	}
+	fprintf(stderr, "%llu bytes sent, %llu received in %.3f s: %.0f bytes/s received\n", report.txBytes,
+		report.rxBytes, report.seconds, report.seconds > 0 ? report.rxBytes / report.seconds : 0.0);
+	if (report.portError)
+		fprintf(stderr, "Error on %s\n", options.port.c_str());
+	if (report.stalled)
+		fprintf(stderr, "Stalled: nothing moved for %lu ms before the send was done\n", options.idleMs);
+	if (options.verify)
+		fprintf(stderr, report.verified ? "Verified: everything sent came back\n"
+			: "Verification failed: what came back is not what was sent\n");
+	if (report.captureFailed)
+		fprintf(stderr, "Error writing the capture file %s, %llu bytes were not captured\n", options.capture.c_str(),
+			report.captureDropped);
+	else if (report.captureDropped)
+		fprintf(stderr, "%llu bytes were not captured, the disk could not keep up\n", report.captureDropped);
+	if (options.statsSeconds >= 0)
+		Print_Stats();
+	return report.portError || report.stalled || report.captureFailed || (options.verify && !report.verified) ? 1 : 0;
+}
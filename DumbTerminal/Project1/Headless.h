@@ -0,0 +1,105 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: Headless.h - Console front end of the dumb terminal emulator program, for scripted soak and
+--			throughput runs without a window
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- bool Parse_Headless_Args(int argc, char **argv, HeadlessOptions &options, std::string &error);
+-- bool Run_Headless(IoLoop &loop, Transport *port, const HeadlessOptions &options, HeadlessReport &report);
+-- int Headless_Main(IoLoop &loop, NewDevice newDevice, int argc, char **argv);
+-- bool Sample_Resources(size_t &handles, size_t &bytes);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Added --stats
+--			  October 17, 2026 - Sample_Resources is shared with dtreadertest
+--			  October 17, 2026 - Added --cycles
+--			  October 17, 2026 - The port is a session of a SessionManager, as the window's ports are
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	The headless mode runs a connection the way the window does, minus the window: the port is opened as a
+--	session of a SessionManager, whose loop's thread reads what the port receives, records it in the capture and
+--	writes what is attached to the session. The main thread stands in for the UI thread: it takes what the
+--	session received, writes it to the session's terminal, which lays it out and composes it into a
+--	RenderTarget, and attaches the file or standard input to the session a block at a time, as a writer thread
+--	reads them. The port parameters come from the command line instead of the CommConfigDialog, and nothing is
+--	created that takes longer than a few milliseconds, so many runs can share a host.
+--
+--	Headless_Main is the whole front end: it parses the arguments, opens the port, runs and prints a report to
+--	stderr. Each platform passes in its own loop and a function that creates its device transport: main in
+--	HeadlessMain.cpp passes an EpollLoop and PosixTransports, so any tty or the slave side of a pty works on Linux,
+--	and the program passes an IocpLoop and Win32Transports for "/headless" (see Session.h). "--port loop" uses
+--	the built-in LoopbackTransport on either.
+--
+--	Arguments:
+--		--port NAME			Device to open, "loop" for the built-in loopback (default)
+--		--baud N			Bits per second (9600)
+--		--data N			Data bits, 5 to 8 (8)
+--		--parity C			N, E, O, M or S (N)
+--		--stop N			Stop bits, 1 or 2 (1)
+--		--flow F			none, rtscts or xonxoff (none)
+--		--send FILE			Send the file, "-" for standard input
+--		--repeat N			Send it N times (1)
+--		--capture FILE		Record what is sent and received in a capture file (see CaptureLog.h)
+--		--quiet				Do not stream what is received to stdout
+--		--seconds S			Stop sending, or listening, after S seconds, 0 for no limit (0)
+--		--idle MS			When sending, stop once nothing was sent or received for MS milliseconds, 0 to
+--							stop as soon as the send is done (1000)
+--		--verify			Fail unless every byte sent came back, in order; on by default with the loopback
+--		--stats S			Print the statistics (see Stats.h) to stderr every S seconds and at the end, 0 for
+--							only at the end
+--		--cycles N			Instead of one run, open and close a session N times, as the window's Connect and
+--							Disconnect do, and fail if handles or memory grew (see Run_Cycles in Headless.cpp)
+--	Without --send the run only listens, until --seconds or until the port hangs up. A send that stops moving
+--	for --idle milliseconds before it is done has stalled. The exit code is 0 on success, 1 when the port
+--	failed, the send stalled or the verification did not hold, 2 for bad arguments.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef HEADLESS_H
+#define HEADLESS_H
+#include <cstddef>
+#include <string>
+#include "IoLoop.h"
+#include "Transport.h"
+typedef Transport *(*NewDevice)();			//Creates a closed device transport of the platform
+struct HeadlessOptions
+{
+	std::string		port;					//Device name, "loop" for the built-in loopback
+	PortSettings	settings;
+	std::string		send;					//File to send, "-" for standard input, empty to only listen
+	unsigned long	repeat;					//Times the file is sent
+	std::string		capture;				//Capture file, empty for none
+	bool			echo;					//Stream received bytes to stdout
+	double			seconds;				//Stop sending or listening after this long, 0 for no limit
+	unsigned long	idleMs;					//When sending, stop this long after the last byte sent or received
+	bool			verify;					//Everything sent has to come back
+	double			statsSeconds;			//Print the statistics this often and at the end, 0 for only at the end,
+											//negative for never
+	size_t			scrollbackLines;		//Limits of the terminal's history, so a soak run stays bounded
+	size_t			scrollbackBytes;
+	unsigned long	cycles;					//Connections to make and break instead of one run, 0 for one run
+};
+
+struct HeadlessReport
+{
+	unsigned long long	rxBytes;			//Bytes received
+	unsigned long long	txBytes;			//Bytes sent
+	double				seconds;			//Wall time from the port being opened to the stop
+	bool				portError;			//A read or write failed, or the port hung up during a send
+	bool				stalled;			//Nothing moved for --idle milliseconds before the send was done
+	bool				verified;			//With verify: what was received is what was sent
+	bool				captureFailed;		//With capture: a write to the capture file failed
+	unsigned long long	captureDropped;		//With capture: bytes that did not make it into the file
+};
+
+bool	Parse_Headless_Args(int argc, char **argv, HeadlessOptions &options, std::string &error);
+bool	Run_Headless(IoLoop &loop, Transport *port, const HeadlessOptions &options, HeadlessReport &report);
+int		Headless_Main(IoLoop &loop, NewDevice newDevice, int argc, char **argv);
+bool	Sample_Resources(size_t &handles, size_t &bytes);	//Handles open and memory used by the process
+#endif
@@ -0,0 +1,69 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: HeadlessMain.cpp - Entry point of the headless dumb terminal emulator on POSIX systems
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- int main(int argc, char **argv);
+-- static Transport *New_Tty();
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - The port is serviced by an EpollLoop
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Built by CMakeLists.txt as dtheadless. "--port" names a tty, e.g. /dev/ttyUSB0 or the slave side of a pty, or
+--	"loop" for the built-in loopback. The arguments are listed in Headless.h. The port is serviced by an EpollLoop,
+--	as dtscale's are.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include "EpollLoop.h"
+#include "Headless.h"
+#include "PosixTransport.h"
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: New_Tty
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static Transport *New_Tty();
+--
+-- RETURNS: A closed PosixTransport, for a session to own
+----------------------------------------------------------------------------------------------------------------------*/
+static Transport *New_Tty()
+{
+	return new PosixTransport();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: main
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Passes an EpollLoop and New_Tty
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int main(int argc, char **argv);
+--					-int argc:		Number of arguments
+--					-char **argv:	Arguments
+--
+-- RETURNS: The exit code of Headless_Main
+----------------------------------------------------------------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+	EpollLoop loop;
+	return Headless_Main(loop, New_Tty, argc - 1, argv + 1);
+}
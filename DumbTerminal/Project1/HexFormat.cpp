@@ -0,0 +1,176 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: HexFormat.cpp - Actual function implementation for HexFormat.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- VOID Hex_Row(char *out, unsigned long long offset, const char *bytes, size_t len);
+-- size_t Hex_Dump(char *out, unsigned long long offset, const char *buf, size_t len);
+-- size_t Hex_Dump_Size(size_t len);
+-- int Hex_Column(size_t index);
+-- int Ascii_Column(size_t index);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Table-driven hex dump rows. See HexFormat.h.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <cstring>
+#include "HexFormat.h"
+static const char HEX_PAIRS[] =						//Two digits of every byte, byte b at 2 * b
+	"000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+	"202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+	"404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+	"606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+	"808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+	"a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+	"c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+	"e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+static const int HEX_FIRST = (int)HEX_OFFSET_DIGITS + 2;	//Cell of the first digit of the first byte
+static const int ASCII_FIRST = HEX_FIRST + (int)HEX_ROW_BYTES * 3 + 3;	//After the middle space, a space and a bar
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Hex_Row
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Hex_Row(char *out, unsigned long long offset, const char *bytes, size_t len);
+--					-char *out:					Receives HEX_ROW_CHARS characters, not terminated
+--					-unsigned long long offset:	Offset of the first byte, shown at the start of the row
+--					-const char *bytes:			Bytes of the row
+--					-size_t len:				Number of bytes, at most HEX_ROW_BYTES
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	The row is blanked first and then filled in, so a short row needs no special case beyond where the closing
+--	bar goes.
+----------------------------------------------------------------------------------------------------------------------*/
+void Hex_Row(char *out, unsigned long long offset, const char *bytes, size_t len)
+{
+	const unsigned char *p = (const unsigned char *)bytes;
+	char *hex = out + HEX_FIRST, *ascii = out + ASCII_FIRST;
+	memset(out, ' ', HEX_ROW_CHARS);
+	for (size_t i = 0; i < HEX_OFFSET_DIGITS; i += 2)	//Most significant pair first
+		memcpy(out + i, HEX_PAIRS + 2 * ((offset >> (4 * (HEX_OFFSET_DIGITS - 2 - i))) & 0xFF), 2);
+	len = len < HEX_ROW_BYTES ? len : HEX_ROW_BYTES;
+	for (size_t i = 0; i < len; ++i)
+	{
+		memcpy(hex + 3 * i + (i >= HEX_ROW_BYTES / 2), HEX_PAIRS + 2 * p[i], 2);
+		ascii[i] = p[i] - 0x20u < 0x5Fu ? (char)p[i] : '.';	//Printable ASCII is 0x20 to 0x7E
+	}
+	ascii[-1] = '|';
+	ascii[len] = '|';
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Hex_Dump
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Hex_Dump(char *out, unsigned long long offset, const char *buf, size_t len);
+--					-char *out:					Receives Hex_Dump_Size(len) characters, not terminated
+--					-unsigned long long offset:	Offset of the first byte
+--					-const char *buf:			Bytes to dump
+--					-size_t len:				Number of bytes in buf
+--
+-- RETURNS: Number of characters written
+--
+-- NOTES:
+--	One row per HEX_ROW_BYTES bytes, each followed by a newline.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t Hex_Dump(char *out, unsigned long long offset, const char *buf, size_t len)
+{
+	char *start = out;
+	for (size_t done = 0, n; done < len; done += n, offset += n)
+	{
+		n = len - done < HEX_ROW_BYTES ? len - done : HEX_ROW_BYTES;
+		Hex_Row(out, offset, buf + done, n);
+		out += HEX_ROW_CHARS;
+		*out++ = '\n';
+	}
+	return (size_t)(out - start);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Hex_Dump_Size
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Hex_Dump_Size(size_t len);
+--					-size_t len: Number of bytes to dump
+--
+-- RETURNS: Number of characters Hex_Dump writes for them
+----------------------------------------------------------------------------------------------------------------------*/
+size_t Hex_Dump_Size(size_t len)
+{
+	return (len + HEX_ROW_BYTES - 1) / HEX_ROW_BYTES * (HEX_ROW_CHARS + 1);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Hex_Column
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int Hex_Column(size_t index);
+--					-size_t index: Byte of the row, 0 to HEX_ROW_BYTES - 1
+--
+-- RETURNS: Cell of the first of its two digits
+----------------------------------------------------------------------------------------------------------------------*/
+int Hex_Column(size_t index)
+{
+	return HEX_FIRST + 3 * (int)index + (index >= HEX_ROW_BYTES / 2);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Ascii_Column
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int Ascii_Column(size_t index);
+--					-size_t index: Byte of the row, 0 to HEX_ROW_BYTES - 1
+--
+-- RETURNS: Cell of the byte between the bars
+----------------------------------------------------------------------------------------------------------------------*/
+int Ascii_Column(size_t index)
+{
+	return ASCII_FIRST + (int)index;
+}
@@ -0,0 +1,48 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: HexFormat.h - Formats bytes as hex dump rows for the hex view of the dumb terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- VOID Hex_Row(char *out, unsigned long long offset, const char *bytes, size_t len);
+-- size_t Hex_Dump(char *out, unsigned long long offset, const char *buf, size_t len);
+-- size_t Hex_Dump_Size(size_t len);
+-- int Hex_Column(size_t index);
+-- int Ascii_Column(size_t index);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	A row shows HEX_ROW_BYTES bytes in HEX_ROW_CHARS characters, the way hexdump -C does: the offset of the first
+--	byte in HEX_OFFSET_DIGITS hex digits, two spaces, the bytes in hex with a space after each and an extra one
+--	after the eighth, then the bytes again between bars, as themselves when they are printable ASCII and as a dot
+--	when not:
+--		0000000000  48 65 6c 6c 6f 0d 0a 00  ff 10 20 41 42 43 44 45  |Hello..... ABCDE|
+--	A short row, the last of a dump, leaves the columns of the missing bytes blank and closes the bar after its
+--	last byte, so every row is the same width and the columns line up.
+--
+--	Every byte is turned into its two digits by one lookup in a table of the 256 pairs, and the offset by five,
+--	so a row costs a few stores per byte and no division or formatting call. Hex_Column and Ascii_Column give
+--	the cell of a byte in either column, for coloring it.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef HEXFORMAT_H
+#define HEXFORMAT_H
+#include <cstddef>
+static const size_t	HEX_ROW_BYTES = 16;				//Bytes per row
+static const size_t	HEX_OFFSET_DIGITS = 10;			//Digits of the offset, a terabyte before it wraps
+static const size_t	HEX_ROW_CHARS = 80;				//Characters per row, newline not included
+
+void	Hex_Row(char *out, unsigned long long offset, const char *bytes, size_t len);	//HEX_ROW_CHARS characters
+size_t	Hex_Dump(char *out, unsigned long long offset, const char *buf, size_t len);	//Rows ending in newlines
+size_t	Hex_Dump_Size(size_t len);											//Characters Hex_Dump writes
+int		Hex_Column(size_t index);											//Cell of the first digit of a byte
+int		Ascii_Column(size_t index);											//Cell of a byte between the bars
+#endif
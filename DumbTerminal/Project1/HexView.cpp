@@ -0,0 +1,675 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: HexView.cpp - Actual function implementation for HexView.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- HexView();
+-- bool UpdateMetrics(const MetricsProvider &provider, bool fontChanged);
+-- VOID Write(const char *buf, size_t len, unsigned long color);
+-- VOID Clear();
+-- bool NextDirty(int &left, int &top, int &right, int &bottom);
+-- VOID Compose(RenderTarget &target, int left, int top, int right, int bottom);
+-- VOID SetLimit(size_t maxBytes);
+-- VOID ScrollTo(size_t row);
+-- VOID ScrollBy(long rows);
+-- int TakeScroll();
+-- size_t PageRows() const;
+-- unsigned short ColorIndex(unsigned long color);
+-- size_t Trim();
+-- VOID PaintRow(RenderTarget &target, size_t row, int left, int right);
+-- size_t ViewRows() const;
+-- size_t MaxTop() const;
+-- VOID MoveTop(size_t top);
+-- VOID MarkRows(size_t first, size_t last);
+-- VOID MarkView(int top, int bottom);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Hex dump view of the history. See HexView.h.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include "HexView.h"
+const size_t HexView::BLOCK;
+const unsigned long HexView::PLAIN;
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: HexView
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: HexView();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Starts empty, without a limit and following new rows. Nothing is allocated until the first Write.
+----------------------------------------------------------------------------------------------------------------------*/
+HexView::HexView()
+	: _base(0), _end(0), _maxBytes(0), _pitch(0), _top(0), _follow(true), _scroll(0), _bandTop(0), _bandBottom(0),
+	_drawCalls(0), _cells(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: UpdateMetrics
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool UpdateMetrics(const MetricsProvider &provider, bool fontChanged);
+--					-const MetricsProvider &provider:	Source of the font and window metrics
+--					-bool fontChanged:					true to reload the font metrics, false for the size only
+--
+-- RETURNS: true when the font or the size changed, and the whole window has to be composed
+--
+-- NOTES:
+--	The cell width is the widest advance of the printable ASCII characters, the only ones a row holds. Rows do not
+--	depend on the width of the window, so nothing is laid out again; the view is only kept in range.
+----------------------------------------------------------------------------------------------------------------------*/
+bool HexView::UpdateMetrics(const MetricsProvider &provider, bool fontChanged)
+{
+	int width = _metrics.ClientWidth(), height = _metrics.ClientHeight();
+	if (fontChanged || !_metrics.Valid())
+	{
+		_metrics.Refresh(provider);
+		_pitch = 0;
+		for (unsigned int c = 0x20; c < 0x7F; ++c)
+			_pitch = std::max(_pitch, _metrics.Advance(c));
+		fontChanged = true;
+	}
+	else
+		_metrics.RefreshSize(provider);
+	if (!fontChanged && width == _metrics.ClientWidth() && height == _metrics.ClientHeight())
+		return false;
+	_top = _follow || _top > MaxTop() ? MaxTop() : _top;
+	_scroll = _bandTop = _bandBottom = 0;				//Caller composes the whole view
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Write
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Records the color changes in the block they fall in
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Write(const char *buf, size_t len, unsigned long color);
+--					-const char *buf:		Bytes sent or received
+--					-size_t len:			Number of bytes in buf
+--					-unsigned long color:	Color they are shown in
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Appends the bytes to the last block, starting new ones as it fills, and records the color in the block when it
+--	differs from the block's last one or the block is new. A block is only allocated while the history grows to its limit; after that each new block
+--	reuses the one the last trim dropped. Marks the rows from the one the first byte went on to the last, and
+--	moves the view down with them while it follows.
+----------------------------------------------------------------------------------------------------------------------*/
+void HexView::Write(const char *buf, size_t len, unsigned long color)
+{
+	if (len == 0)
+		return;
+	size_t			first = (size_t)((_end - _base) / HEX_ROW_BYTES);	//Row the first byte goes on
+	unsigned short	index = ColorIndex(color);
+	for (size_t done = 0, n; done < len; done += n)
+	{
+		if (_blocks.empty() || _blocks.back().bytes.size() == BLOCK)
+		{
+			_blocks.emplace_back();
+			std::swap(_blocks.back(), _spare);			//Empty, or the block the last trim dropped
+			_blocks.back().bytes.clear();
+			_blocks.back().bytes.reserve(BLOCK);
+			_blocks.back().colors.clear();
+		}
+		Block &block = _blocks.back();
+		if (block.colors.empty() || block.colors.back().color != index)
+		{
+			ColorRun run = { (unsigned short)block.bytes.size(), index };
+			block.colors.push_back(run);
+		}
+		n = std::min(len - done, BLOCK - block.bytes.size());
+		block.bytes.insert(block.bytes.end(), buf + done, buf + done + n);
+	}
+	_end += len;
+	size_t dropped = Trim();
+	first = first > dropped ? first - dropped : 0;
+	if (_follow)
+		MoveTop(MaxTop());
+	MarkRows(first, RowCount());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Clear
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Clear();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Forgets the history and starts the offsets from 0 again. One block is kept for the next Write. The caller
+--	composes the whole view afterwards.
+----------------------------------------------------------------------------------------------------------------------*/
+void HexView::Clear()
+{
+	if (!_blocks.empty() && _spare.bytes.capacity() == 0)
+		std::swap(_spare, _blocks.back());
+	_blocks.clear();
+	_palette.clear();
+	_base = _end = 0;
+	_top = 0;
+	_follow = true;
+	_scroll = _bandTop = _bandBottom = 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: NextDirty
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool NextDirty(int &left, int &top, int &right, int &bottom);
+--					-int &left, &top, &right, &bottom: Set to the area of the window that changed
+--
+-- RETURNS: true when an area was returned, false when nothing else changed
+--
+-- NOTES:
+--	Bytes are only ever added at the end and the view only moves, so what changed is always one band of whole
+--	rows, returned once. Areas are in view coordinates.
+----------------------------------------------------------------------------------------------------------------------*/
+bool HexView::NextDirty(int &left, int &top, int &right, int &bottom)
+{
+	if (_bandBottom <= _bandTop)
+		return false;
+	left = 0, top = _bandTop;
+	right = _metrics.ClientWidth(), bottom = _bandBottom;
+	_bandTop = _bandBottom = 0;
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Compose
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Compose(RenderTarget &target, int left, int top, int right, int bottom);
+--					-RenderTarget &target:				Surface to draw on
+--					-int left, top, right, bottom:		Area to compose, right and bottom exclusive
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Clears the area and draws every row of the view that intersects it. Rows outside the view are never
+--	formatted.
+----------------------------------------------------------------------------------------------------------------------*/
+void HexView::Compose(RenderTarget &target, int left, int top, int right, int bottom)
+{
+	int lineHeight = _metrics.LineHeight();
+	if (lineHeight <= 0 || _pitch <= 0 || bottom <= top)
+		return;
+	target.Fill(left, top, right, bottom);
+	size_t first = _top + (top > 0 ? top / lineHeight : 0);
+	size_t last = _top + (bottom + lineHeight - 1) / lineHeight;
+	for (size_t row = first; row < last && row < RowCount(); ++row)
+		PaintRow(target, row, left, right);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: SetLimit
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID SetLimit(size_t maxBytes);
+--					-size_t maxBytes: Bytes of history to keep at least, 0 for no limit
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Whole blocks are dropped from the front as long as maxBytes are left, so the history holds at most one block
+--	more than the limit.
+----------------------------------------------------------------------------------------------------------------------*/
+void HexView::SetLimit(size_t maxBytes)
+{
+	_maxBytes = maxBytes;
+	Trim();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ScrollTo
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID ScrollTo(size_t row);
+--					-size_t row: Row to show at the top of the view
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	The row is clamped so the view never goes past the last page. Scrolling to the bottom makes the view follow
+--	new rows again, scrolling anywhere else stops it.
+----------------------------------------------------------------------------------------------------------------------*/
+void HexView::ScrollTo(size_t row)
+{
+	MoveTop(row < MaxTop() ? row : MaxTop());
+	_follow = _top == MaxTop();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ScrollBy
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID ScrollBy(long rows);
+--					-long rows: Rows to move the view down by, negative to move it back
+--
+-- RETURNS: VOID
+----------------------------------------------------------------------------------------------------------------------*/
+void HexView::ScrollBy(long rows)
+{
+	if (rows < 0 && (size_t)-rows > _top)
+		ScrollTo(0);
+	else
+		ScrollTo(_top + rows);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: TakeScroll
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int TakeScroll();
+--
+-- RETURNS: Pixels the surface has to be scrolled down by since the last call, negative for up
+----------------------------------------------------------------------------------------------------------------------*/
+int HexView::TakeScroll()
+{
+	int dy = _scroll;
+	_scroll = 0;
+	return dy;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: PageRows
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t PageRows() const;
+--
+-- RETURNS: Number of rows that fit completely in the view, at least 1
+----------------------------------------------------------------------------------------------------------------------*/
+size_t HexView::PageRows() const
+{
+	int lineHeight = _metrics.LineHeight();
+	size_t rows = lineHeight > 0 ? _metrics.ClientHeight() / lineHeight : 0;
+	return rows > 0 ? rows : 1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ColorIndex
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: unsigned short ColorIndex(unsigned long color);
+--					-unsigned long color: Color bytes are written in
+--
+-- RETURNS: The entry of _palette holding the color
+--
+-- NOTES:
+--	Bytes come in the read and write colors of their session, changed only from the menus, so the table stays a few
+--	entries long and a linear search from the newest entry is enough. Clear empties it. Should MAX_COLORS colors ever
+--	be picked from the menus in one session, the newest entry is given the new color, recoloring the bytes that had
+--	it.
+----------------------------------------------------------------------------------------------------------------------*/
+unsigned short HexView::ColorIndex(unsigned long color)
+{
+	size_t i = _palette.size();
+	while (i > 0 && _palette[i - 1] != color)
+		--i;
+	if (i > 0)
+		return (unsigned short)(i - 1);
+	if (_palette.size() < MAX_COLORS)
+		_palette.push_back(color);
+	else
+		_palette.back() = color;
+	return (unsigned short)(_palette.size() - 1);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Trim
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - The colors go with their block
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Trim();
+--
+-- RETURNS: Number of rows dropped from the front
+--
+-- NOTES:
+--	Drops blocks from the front while the rest still holds the limit, color changes and all, keeping the last one
+--	dropped as the spare. The rows are renumbered by moving the view up by as many; if rows
+--	that were in view were dropped, the view goes to the first row left and all of it is marked.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t HexView::Trim()
+{
+	size_t dropped = 0;
+	while (_maxBytes > 0 && _blocks.size() > 1 && _end - _base - BLOCK >= _maxBytes)
+	{
+		std::swap(_spare, _blocks.front());
+		_blocks.pop_front();
+		_base += BLOCK;
+		dropped += BLOCK / HEX_ROW_BYTES;
+	}
+	if (dropped == 0)
+		return 0;
+	if (_top >= dropped)
+		_top -= dropped;
+	else
+	{
+		_top = 0;
+		_scroll = 0;
+		MarkView(0, (int)ViewRows() * _metrics.LineHeight());
+	}
+	return dropped;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: PaintRow
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID PaintRow(RenderTarget &target, size_t row, int left, int right);
+--					-RenderTarget &target:	Surface to draw on
+--					-size_t row:			Index of the row to draw
+--					-int left:				Left edge of the area being composed
+--					-int right:				Right edge of the area being composed
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Formats the row with Hex_Row and colors its cells: the two digits and the ASCII cell of each byte take the
+--	color of the byte, found by a binary search for the first and by stepping for the rest, and the space after
+--	a digit pair takes it too when the next byte has the same color. Consecutive cells of one color that overlap
+--	[left, right) are drawn with one DrawCells call; spaces in PLAIN are skipped, Compose cleared them already.
+----------------------------------------------------------------------------------------------------------------------*/
+void HexView::PaintRow(RenderTarget &target, size_t row, int left, int right)
+{
+	char				text[HEX_ROW_CHARS];
+	unsigned long		colors[HEX_ROW_CHARS];
+	unsigned int		run[HEX_ROW_CHARS];
+	unsigned long long	offset = _base + (unsigned long long)row * HEX_ROW_BYTES;
+	size_t				len = (size_t)std::min<unsigned long long>(HEX_ROW_BYTES, _end - offset);
+	const Block			&block = _blocks[(size_t)((offset - _base) / BLOCK)];
+	size_t				at = (size_t)((offset - _base) % BLOCK);	//Rows never straddle two blocks
+	const char			*bytes = block.bytes.data() + at;
+	int					y = (int)(row - _top) * _metrics.LineHeight();
+	size_t				c = std::upper_bound(block.colors.begin(), block.colors.end(), at,
+							[](size_t o, const ColorRun &r) { return o < r.start; }) - block.colors.begin() - 1;
+	unsigned long		color;
+	Hex_Row(text, offset, bytes, len);
+	std::fill(colors, colors + HEX_ROW_CHARS, PLAIN);
+	for (size_t i = 0; i < len; ++i)
+	{
+		while (c + 1 < block.colors.size() && block.colors[c + 1].start <= at + i)
+			++c;
+		int col = Hex_Column(i);
+		color = _palette[block.colors[c].color];
+		if (i > 0 && colors[Hex_Column(i - 1)] == color)			//Same stretch, color the space between
+			std::fill(colors + Hex_Column(i - 1) + 2, colors + col, color);
+		colors[col] = colors[col + 1] = colors[Ascii_Column(i)] = color;
+	}
+	int last = std::min((int)HEX_ROW_CHARS, (right + _pitch - 1) / _pitch);
+	for (int col = std::max(0, left / _pitch), start, n; col < last; )
+	{
+		unsigned long color = colors[col];
+		if (text[col] == ' ' && color == PLAIN)
+		{
+			++col;
+			continue;
+		}
+		for (start = col, n = 0; col < last && colors[col] == color && !(text[col] == ' ' && color == PLAIN); ++col)
+			run[n++] = (unsigned char)text[col];
+		target.DrawCells(start * _pitch, y, run, n, _pitch, color);
+		++_drawCalls;
+		_cells += n;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ViewRows
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t ViewRows() const;
+--
+-- RETURNS: Number of rows that are at least partly in the view, at least 1
+----------------------------------------------------------------------------------------------------------------------*/
+size_t HexView::ViewRows() const
+{
+	int lineHeight = _metrics.LineHeight();
+	size_t rows = lineHeight > 0 ? (_metrics.ClientHeight() + lineHeight - 1) / lineHeight : 0;
+	return rows > 0 ? rows : 1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: MaxTop
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t MaxTop() const;
+--
+-- RETURNS: Top row of the view when it shows the last page
+----------------------------------------------------------------------------------------------------------------------*/
+size_t HexView::MaxTop() const
+{
+	return RowCount() > PageRows() ? RowCount() - PageRows() : 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: MoveTop
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID MoveTop(size_t top);
+--					-size_t top: New first row of the view
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Same as Terminal::MoveTop: records how far the surface has to scroll and marks the rows that scroll into
+--	view, moving an area that was already marked along with its rows. A move of a page or more marks the whole
+--	view instead, which is what a frame after a burst of bytes does, however many rows went by.
+----------------------------------------------------------------------------------------------------------------------*/
+void HexView::MoveTop(size_t top)
+{
+	if (top == _top)
+		return;
+	int lineHeight = _metrics.LineHeight(), view = (int)ViewRows();
+	long delta = (long)top - (long)_top;
+	long total = delta - (lineHeight > 0 ? _scroll / lineHeight : 0);	//Since the last take
+	int bandTop = _bandTop - (int)delta * lineHeight, bandBottom = _bandBottom - (int)delta * lineHeight;
+	bool marked = _bandBottom > _bandTop;
+	_top = top;
+	_scroll = 0;
+	_bandTop = _bandBottom = 0;
+	if (total >= view || -total >= view)
+	{
+		MarkView(0, view * lineHeight);
+		return;
+	}
+	_scroll = (int)-total * lineHeight;
+	if (marked && bandBottom > 0 && bandTop < view * lineHeight)	//Marked area moves with its rows
+		MarkView(bandTop, bandBottom);
+	if (delta > 0)										//Rows come in at the bottom
+		MarkView((view - 1 - (int)delta) * lineHeight, view * lineHeight);	//Includes the partial last row
+	else												//Rows come in at the top
+		MarkView(0, (int)-delta * lineHeight);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: MarkRows
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID MarkRows(size_t first, size_t last);
+--					-size_t first:	First row that changed
+--					-size_t last:	Row after the last that changed
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Marks the part of the rows that is in view.
+----------------------------------------------------------------------------------------------------------------------*/
+void HexView::MarkRows(size_t first, size_t last)
+{
+	int lineHeight = _metrics.LineHeight();
+	first = std::max(first, _top);
+	last = std::min(last, _top + ViewRows());
+	if (first < last)
+		MarkView((int)(first - _top) * lineHeight, (int)(last - _top) * lineHeight);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: MarkView
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID MarkView(int top, int bottom);
+--					-int top, bottom: Pixel rows of the view to compose again
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Grows the pending band to cover the area.
+----------------------------------------------------------------------------------------------------------------------*/
+void HexView::MarkView(int top, int bottom)
+{
+	top = top > 0 ? top : 0;
+	if (_bandBottom <= _bandTop)
+		_bandTop = top, _bandBottom = bottom;
+	else
+	{
+		_bandTop = top < _bandTop ? top : _bandTop;
+		_bandBottom = bottom > _bandBottom ? bottom : _bandBottom;
+	}
+}
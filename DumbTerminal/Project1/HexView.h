@@ -0,0 +1,127 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: HexView.h - Hex dump view of the bytes sent and received for the dumb terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- HexView();
+-- bool UpdateMetrics(const MetricsProvider &provider, bool fontChanged);
+-- VOID Write(const char *buf, size_t len, unsigned long color);
+-- VOID Clear();
+-- bool NextDirty(int &left, int &top, int &right, int &bottom);
+-- VOID Compose(RenderTarget &target, int left, int top, int right, int bottom);
+-- VOID ResetFrame();
+-- VOID SetLimit(size_t maxBytes);
+-- VOID ScrollTo(size_t row);
+-- VOID ScrollBy(long rows);
+-- int TakeScroll();
+-- size_t PageRows() const;
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Each block keeps its own color changes, in four bytes each
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	The bytes of a connection as a hex dump, HEX_ROW_BYTES to a row with their offset, hex and ASCII columns (see
+--	HexFormat.h), for devices that speak binary protocols. Write records bytes in the color they were sent or received
+--	with, the read or write color of its session, as the terminal is given, and every byte is drawn in its color in
+--	both columns; the space between two bytes of the same color takes the color too, so a stretch in one direction
+--	reads as one block.
+--
+--	Writing only stores: the bytes are appended to blocks of BLOCK bytes and the color is recorded once per change
+--	of color, not per byte, so recording costs a copy whatever the rate of the link. A block keeps the color
+--	changes inside it, each an offset in the block and an index into a table of the colors written, and starts
+--	with the color its first byte has, so a change costs four bytes and is dropped together with its bytes. Under
+--	interactive echo, where typed and received bytes alternate, that is still a change per byte, but no more than
+--	four bytes for each byte kept. Nothing is formatted until a
+--	row is composed, and only the rows in the view are, so a frame costs what the visible rows cost however much
+--	arrived since the last one. The rows are a fixed HEX_ROW_BYTES apart, so finding the bytes of a row is a
+--	division and the history needs no layout, on a resize or ever. The history is trimmed to the limit a block at
+--	a time from the front; offsets keep counting from the start of the connection.
+--
+--	The columns have to line up in the window's proportional font, so every character is drawn in a cell as wide
+--	as the widest printable ASCII character, with RenderTarget::DrawCells: a row of one color is one call,
+--	and a row mixing both directions a call per stretch.
+--
+--	The view scrolls, follows new rows while at the bottom and reports dirty areas and scrolling the way the
+--	terminal does (see PagedView.h).
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef HEXVIEW_H
+#define HEXVIEW_H
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include "FontMetrics.h"
+#include "HexFormat.h"
+#include "PagedView.h"
+#include "RenderTarget.h"
+class HexView : public PagedView
+{
+public:
+	static const size_t			BLOCK = 1 << 16;		//Bytes per block of history, a multiple of HEX_ROW_BYTES
+	static const unsigned long	PLAIN = 0x00FFFFFF;		//Color of the offsets and bars, black on white
+
+	HexView();
+	bool				UpdateMetrics(const MetricsProvider &provider, bool fontChanged);
+	void				Write(const char *buf, size_t len, unsigned long color);	//Record bytes
+	void				Clear();
+	bool				NextDirty(int &left, int &top, int &right, int &bottom);
+	void				Compose(RenderTarget &target, int left, int top, int right, int bottom);
+	void				ResetFrame() { _drawCalls = _cells = 0; }
+	void				SetLimit(size_t maxBytes);									//Most bytes kept, 0 for all
+	void				ScrollTo(size_t row);
+	void				ScrollBy(long rows);
+	int					TakeScroll();
+	size_t				TopRow() const { return _top; }
+	size_t				RowCount() const { return (size_t)((_end - _base + HEX_ROW_BYTES - 1) / HEX_ROW_BYTES); }
+	size_t				PageRows() const;
+	unsigned long		FrameDrawCalls() const { return _drawCalls; }
+	unsigned long		FrameCells() const { return _cells; }
+	const MetricsCache	&Metrics() const { return _metrics; }
+	int					Pitch() const { return _pitch; }						//Width of a cell
+	unsigned long long	Offset() const { return _end; }							//Bytes written since Clear
+
+private:
+	struct ColorRun
+	{
+		unsigned short		start;				//Offset in the block of the first byte in this color
+		unsigned short		color;				//Index into _palette
+	};
+	struct Block
+	{
+		std::vector<char>		bytes;
+		std::vector<ColorRun>	colors;			//Color changes in the block, in order, the first at 0
+	};
+	static const size_t	MAX_COLORS = 1 << 16;	//Entries a ColorRun can address
+
+	unsigned short	ColorIndex(unsigned long color);	//Entry of _palette for the color
+	size_t			Trim();
+	void			PaintRow(RenderTarget &target, size_t row, int left, int right);
+	size_t			ViewRows() const;
+	size_t			MaxTop() const;
+	void			MoveTop(size_t top);
+	void			MarkRows(size_t first, size_t last);
+	void			MarkView(int top, int bottom);
+
+	std::deque<Block>	_blocks;				//History, every block full but the last
+	Block				_spare;					//Block dropped by the last trim, reused for the next
+	std::vector<unsigned long>	_palette;		//Colors written in since Clear, referenced by ColorRun
+	unsigned long long	_base;					//Offset of the first byte kept
+	unsigned long long	_end;					//Offset after the last byte
+	size_t				_maxBytes;				//Limit of the history, 0 for none
+	MetricsCache		_metrics;				//Line height, advance widths and client size
+	int					_pitch;					//Width of a cell
+	size_t				_top;					//First row shown in the view
+	bool				_follow;				//View stays at the bottom as rows are added
+	int					_scroll;				//Pixels the surface has to be scrolled down by
+	int					_bandTop, _bandBottom;	//Area of the view to compose, empty when equal
+	unsigned long		_drawCalls;				//DrawCells calls issued in the current frame
+	unsigned long		_cells;					//Cells drawn in the current frame
+};
+#endif
@@ -0,0 +1,167 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: HexViewTest.cpp - Tests of the hex view of the dumb terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- int main();
+-- static unsigned long Byte_Color(unsigned long long offset);
+-- static bool Check_View(HexView &view, size_t row);
+-- static VOID Test_Echo_Colors(size_t chunk, size_t limit);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Built by CMakeLists.txt as dthexviewtest and run by ctest. Bytes are written the way interactive echo writes
+--	them, the color changing every byte or every few, across block boundaries and with the history trimmed, and
+--	every byte of the rows in view has to be drawn in the color it was written in, in the hex and ASCII columns.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <string>
+#include "Check.h"
+#include "HexView.h"
+#include "Replay.h"
+static const unsigned long	SENT = 0x00C0FFC0;		//Colors of the two directions
+static const unsigned long	RECEIVED = 0x00FFE0C0;
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Byte_Color
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static unsigned long Byte_Color(unsigned long long offset);
+--					-unsigned long long offset: Offset of a byte since the view was cleared
+--
+-- RETURNS: The color the byte is written in: a keystroke, its echo, and now and then a line of output
+----------------------------------------------------------------------------------------------------------------------*/
+static unsigned long Byte_Color(unsigned long long offset)
+{
+	return offset % 1000 >= 900 || offset % 2 ? RECEIVED : SENT;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Check_View
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static bool Check_View(HexView &view, size_t row);
+--					-HexView &view:	View to draw
+--					-size_t row:	Row to scroll to first
+--
+-- RETURNS: true when every byte in view is drawn in its color in both columns
+----------------------------------------------------------------------------------------------------------------------*/
+static bool Check_View(HexView &view, size_t row)
+{
+	MemoryRenderTarget	target(view.Metrics(), view.Metrics().ClientWidth(), view.Metrics().ClientHeight());
+	unsigned long long	first = view.Offset() - (unsigned long long)view.RowCount() * HEX_ROW_BYTES;
+	view.ScrollTo(row);
+	view.Compose(target, 0, 0, target.Width(), target.Height());
+	first = (first / HEX_ROW_BYTES + view.TopRow()) * HEX_ROW_BYTES;		//Offset of the top row
+	for (size_t r = 0; r < view.PageRows() && r + view.TopRow() < view.RowCount(); ++r)
+		for (size_t i = 0; i < HEX_ROW_BYTES; ++i)
+		{
+			unsigned long long	offset = first + r * HEX_ROW_BYTES + i;
+			int					y = (int)r * view.Metrics().LineHeight();
+			if (offset >= view.Offset())
+				break;
+			if (target.Pixel(Hex_Column(i) * view.Pitch(), y) != Byte_Color(offset)
+				|| target.Pixel(Ascii_Column(i) * view.Pitch(), y) != Byte_Color(offset))
+			{
+				fprintf(stderr, "byte %llu\n", offset);
+				return false;
+			}
+		}
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_Echo_Colors
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_Echo_Colors(size_t chunk, size_t limit);
+--					-size_t chunk:	Most bytes per Write; a Write stops where the color changes
+--					-size_t limit:	Limit of the history, 0 for none
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Writes 3.5 blocks of bytes and checks the first rows kept, the rows around every block boundary still in the
+--	history and the last rows. Clear has to start the colors over with the offsets.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_Echo_Colors(size_t chunk, size_t limit)
+{
+	FixedMetrics		metrics(8, 16, 80, 20);
+	HexView				view;
+	std::string			bytes(chunk, 'k');
+	unsigned long long	total = HexView::BLOCK * 7 / 2, kept;
+	view.UpdateMetrics(metrics, true);
+	view.SetLimit(limit);
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		for (unsigned long long offset = 0, n; offset < total; offset += n)
+		{
+			for (n = 1; n < chunk && offset + n < total && Byte_Color(offset + n) == Byte_Color(offset); ++n)
+				;
+			view.Write(bytes.data(), (size_t)n, Byte_Color(offset));
+		}
+		kept = (unsigned long long)view.RowCount() * HEX_ROW_BYTES;
+		CHECK(limit == 0 ? kept == total : kept >= limit && kept < limit + HexView::BLOCK);
+		CHECK(Check_View(view, 0));
+		for (unsigned long long boundary = HexView::BLOCK; boundary < total; boundary += HexView::BLOCK)
+			if (boundary >= total - kept + 8 * HEX_ROW_BYTES)
+				CHECK(Check_View(view, (size_t)((boundary - (total - kept)) / HEX_ROW_BYTES - 8)));
+		CHECK(Check_View(view, view.RowCount()));
+		view.Clear();
+		CHECK(view.Offset() == 0 && view.RowCount() == 0);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: main
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int main();
+--
+-- RETURNS: 0 when every check passed, 1 otherwise
+----------------------------------------------------------------------------------------------------------------------*/
+int main()
+{
+	Test_Echo_Colors(1, 0);
+	Test_Echo_Colors(1, 2 * HexView::BLOCK);
+	Test_Echo_Colors(100, 0);
+	Test_Echo_Colors(100, HexView::BLOCK + 1000);
+	return Check_Summary("dthexviewtest");
+}
@@ -0,0 +1,60 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: IoLoop.h - Interface to the event loop that services every open port of the dumb terminal emulator
+--			program from one thread
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- int Wait(Key *keys, int max, int timeoutMs);
+-- VOID Post(Key key);
+-- bool Watch(Handle handle, Key key);
+-- VOID Unwatch(Handle handle);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Watch and Unwatch, so a port registers with any loop without knowing its kind
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	A port that is registered with the loop (see Transport::Register) does not block a thread of its own in Read
+--	and Write. Instead the loop reports the key the port was registered under when the port may have bytes to
+--	read or room to write, and the thread waiting in Wait calls ReadReady and WriteReady on it, which never wait.
+--	Once either returns 0 the port is re-armed and its key is reported again when that changes. A key may be
+--	reported more often than needed, never less, so whoever handles it has to expect nothing to do.
+--
+--	Post reports a key without any I/O, from any thread. That is how other threads hand the loop work, e.g. bytes
+--	queued to send, and how a port without a system handle (LoopbackTransport) reports itself.
+--
+--	Watch is how a port with a system handle registers: the loop reports the key for the handle's I/O until
+--	Unwatch or until the handle is closed. Handle is the platform's own, a HANDLE opened for overlapped I/O on
+--	Windows and a non-blocking descriptor elsewhere.
+--
+--	Each platform has one implementation: IocpLoop (IocpLoop.h) waits on an I/O completion port for the overlapped
+--	operations of Win32Transport, EpollLoop (EpollLoop.h) waits on an edge-triggered epoll instance for the ttys
+--	of PosixTransport. Only the one of the platform is built, so a port never meets a loop of the other kind.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef IOLOOP_H
+#define IOLOOP_H
+#include <cstdint>
+class IoLoop
+{
+public:
+	typedef uintptr_t	Key;								//Identifies a port to its owner, any value but ~0
+#ifdef _WIN32
+	typedef void		*Handle;							//HANDLE of a port
+#else
+	typedef int			Handle;								//Descriptor of a port
+#endif
+
+	virtual ~IoLoop() {}
+	virtual int		Wait(Key *keys, int max, int timeoutMs) = 0;	//Keys reported, 0 on timeout, -1 on error
+	virtual void	Post(Key key) = 0;								//Report key, from any thread
+	virtual bool	Watch(Handle handle, Key key) = 0;				//Report key for handle's I/O, false if refused
+	virtual void	Unwatch(Handle handle) = 0;						//Stop reporting handle
+};
+#endif
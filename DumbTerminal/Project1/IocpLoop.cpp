@@ -0,0 +1,181 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: IocpLoop.cpp - Actual function implementation for IocpLoop.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- IocpLoop();
+-- ~IocpLoop();
+-- int Wait(Key *keys, int max, int timeoutMs);
+-- VOID Post(Key key);
+-- bool Watch(Handle handle, Key key);
+-- VOID Unwatch(Handle handle);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	I/O completion port event loop. See IocpLoop.h.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include "IocpLoop.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: IocpLoop
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: IocpLoop();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Creates the completion port for one waiting thread.
+----------------------------------------------------------------------------------------------------------------------*/
+IocpLoop::IocpLoop()
+	: _port(CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1))
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ~IocpLoop
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: ~IocpLoop();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Closes the completion port. Nothing may be waiting in Wait any more.
+----------------------------------------------------------------------------------------------------------------------*/
+IocpLoop::~IocpLoop()
+{
+	if (_port)
+		CloseHandle(_port);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Wait
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int Wait(Key *keys, int max, int timeoutMs);
+--					-Key *keys:			Receives the keys reported
+--					-int max:			Room in keys
+--					-int timeoutMs:		Longest wait, -1 for no limit
+--
+-- RETURNS: Number of keys put in keys, 0 on timeout, -1 on error
+--
+-- NOTES:
+--	Dequeues the packets of completed operations and of Post together. The result of an operation is not looked
+--	at here; the port reads it back from its OVERLAPPED when ReadReady or WriteReady is called.
+----------------------------------------------------------------------------------------------------------------------*/
+int IocpLoop::Wait(Key *keys, int max, int timeoutMs)
+{
+	OVERLAPPED_ENTRY	entries[64];
+	ULONG				n;
+	if (!GetQueuedCompletionStatusEx(_port, entries, max < 64 ? max : 64, &n,
+		timeoutMs < 0 ? INFINITE : (DWORD)timeoutMs, FALSE))
+		return GetLastError() == WAIT_TIMEOUT ? 0 : -1;
+	for (ULONG i = 0; i < n; ++i)
+		keys[i] = (Key)entries[i].lpCompletionKey;
+	return (int)n;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Post
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Post(Key key);
+--					-Key key: Key to report
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Queues a packet with no OVERLAPPED. Any thread may call it.
+----------------------------------------------------------------------------------------------------------------------*/
+void IocpLoop::Post(Key key)
+{
+	PostQueuedCompletionStatus(_port, 0, (ULONG_PTR)key, NULL);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Watch
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Was Associate
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Watch(Handle handle, Key key);
+--					-Handle handle:	Handle opened with FILE_FLAG_OVERLAPPED
+--					-Key key:		Queued with the completions of handle
+--
+-- RETURNS: false when the handle could not be associated
+--
+-- NOTES:
+--	A handle stays associated until it is closed; there is no way to take it off the port.
+----------------------------------------------------------------------------------------------------------------------*/
+bool IocpLoop::Watch(Handle handle, Key key)
+{
+	return CreateIoCompletionPort(handle, _port, (ULONG_PTR)key, 0) == _port;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Unwatch
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Unwatch(Handle handle);
+--					-Handle handle: Handle watched earlier
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Does nothing: a completion port has no way to let go of a handle before it is closed. Win32Transport cancels
+--	its operations on the port instead, so nothing more is queued for it.
+----------------------------------------------------------------------------------------------------------------------*/
+void IocpLoop::Unwatch(Handle /*handle*/)
+{
+}
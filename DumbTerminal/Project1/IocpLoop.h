@@ -0,0 +1,52 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: IocpLoop.h - Event loop on an I/O completion port for the dumb terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- IocpLoop();
+-- ~IocpLoop();
+-- int Wait(Key *keys, int max, int timeoutMs);
+-- VOID Post(Key key);
+-- bool Watch(Handle handle, Key key);
+-- VOID Unwatch(Handle handle);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Associate is IoLoop's Watch
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	The program's loop. A port handle is associated with the completion port under its key, and every overlapped
+--	operation on the handle whose OVERLAPPED has no event then queues a completion packet with the key when it
+--	finishes: Win32Transport leaves one WaitCommEvent and at most one WriteFile outstanding that way, so the key
+--	comes up when a character arrives or a write is done. Operations that wait on an event of their own set its
+--	low bit, which keeps their completions off the port. Post queues a packet without any I/O.
+--
+--	Wait takes up to max packets with one GetQueuedCompletionStatusEx call. A packet of an operation that was
+--	cancelled, e.g. when a port is closed, is still queued with its key; the owner of the keys has to ignore keys
+--	it no longer uses.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef IOCPLOOP_H
+#define IOCPLOOP_H
+#include <windows.h>
+#include "IoLoop.h"
+class IocpLoop : public IoLoop
+{
+public:
+	IocpLoop();
+	~IocpLoop();
+	int		Wait(Key *keys, int max, int timeoutMs);
+	void	Post(Key key);
+	bool	Watch(Handle handle, Key key);			//Queue the completions of handle under key
+	void	Unwatch(Handle handle);					//Nothing, handle stays associated until it is closed
+
+private:
+	HANDLE	_port;									//The completion port
+};
+#endif
@@ -0,0 +1,494 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: LoopbackTransport.cpp - Actual function implementation for LoopbackTransport.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- LoopbackTransport(size_t capacity);
+-- bool Open(const char *name);
+-- bool Configure(const PortSettings &settings);
+-- bool Settings(PortSettings &settings) const;
+-- long Read(char *buf, size_t len);
+-- long Write(const char *buf, size_t len);
+-- VOID AbortWrite();
+-- VOID Cancel();
+-- VOID Close();
+-- bool Register(IoLoop &loop, IoLoop::Key key);
+-- long ReadReady(char *buf, size_t len);
+-- long WriteReady(const char *buf, size_t len);
+-- VOID Unregister();
+-- size_t Take(char *buf, size_t len);
+-- size_t Put(const char *buf, size_t len);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	In-process loopback port. See LoopbackTransport.h.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstring>
+#include "LoopbackTransport.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: LoopbackTransport
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: LoopbackTransport(size_t capacity);
+--					-size_t capacity: Most bytes held between a write and the read that takes them
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	The loopback starts closed, at 9600 8N1 with no flow control.
+----------------------------------------------------------------------------------------------------------------------*/
+LoopbackTransport::LoopbackTransport(size_t capacity)
+	: _buffer(capacity), _head(0), _count(0), _open(false), _cancelled(false), _abort(false), _loop(NULL), _key(0),
+	_wantRead(false), _wantWrite(false)
+{
+	_settings.baud = 9600;
+	_settings.dataBits = 8;
+	_settings.parity = 'N';
+	_settings.stopBits = 1;
+	_settings.flow = PortSettings::FLOW_NONE;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Open
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Open(const char *name);
+--					-const char *name: Ignored, there is only one loopback
+--
+-- RETURNS: true
+--
+-- NOTES:
+--	Empties the buffer and clears a Cancel or AbortWrite left over from the previous connection.
+----------------------------------------------------------------------------------------------------------------------*/
+bool LoopbackTransport::Open(const char * /*name*/)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	_head = _count = 0;
+	_open = true;
+	_cancelled = _abort = false;
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Configure
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Configure(const PortSettings &settings);
+--					-const PortSettings &settings: Line parameters to set
+--
+-- RETURNS: true
+--
+-- NOTES:
+--	Only remembers the settings; they do not change what the loopback does.
+----------------------------------------------------------------------------------------------------------------------*/
+bool LoopbackTransport::Configure(const PortSettings &settings)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	_settings = settings;
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Settings
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Settings(PortSettings &settings) const;
+--					-PortSettings &settings: Set to the settings last configured
+--
+-- RETURNS: false when the loopback is not open
+--
+-- NOTES:
+--	Returns the settings last configured.
+----------------------------------------------------------------------------------------------------------------------*/
+bool LoopbackTransport::Settings(PortSettings &settings) const
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	settings = _settings;
+	return _open;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Read
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Copies through Take
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: long Read(char *buf, size_t len);
+--					-char *buf:		Receives the bytes
+--					-size_t len:	Most bytes to read
+--
+-- RETURNS: Bytes read, 0 when cancelled, -1 when the loopback is not open
+--
+-- NOTES:
+--	Waits until something was written, then takes up to len bytes and wakes a write waiting for room.
+----------------------------------------------------------------------------------------------------------------------*/
+long LoopbackTransport::Read(char *buf, size_t len)
+{
+	std::unique_lock<std::mutex> guard(_lock);
+	size_t n;
+	_changed.wait(guard, [this] { return _cancelled || !_open || _count > 0; });
+	if (_cancelled)
+		return 0;
+	if (!_open)
+		return -1;
+	n = Take(buf, len);
+	_changed.notify_all();
+	return (long)n;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Write
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Copies through Put
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: long Write(const char *buf, size_t len);
+--					-const char *buf:	Bytes to send
+--					-size_t len:		Number of bytes in buf
+--
+-- RETURNS: len once everything is in the buffer, 0 when aborted or cancelled, -1 when the loopback is not open
+--
+-- NOTES:
+--	Copies as much as fits and waits for the reader to make room for the rest. An AbortWrite made before the write
+--	started is stale and is thrown away first.
+----------------------------------------------------------------------------------------------------------------------*/
+long LoopbackTransport::Write(const char *buf, size_t len)
+{
+	std::unique_lock<std::mutex> guard(_lock);
+	size_t sent = 0;
+	_abort = false;
+	while (sent < len)
+	{
+		_changed.wait(guard, [this] { return _cancelled || _abort || !_open || _count < _buffer.size(); });
+		if (_cancelled || _abort)
+		{
+			_abort = false;
+			return 0;
+		}
+		if (!_open)
+			return -1;
+		sent += Put(buf + sent, len - sent);
+		_changed.notify_all();
+	}
+	return (long)sent;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: AbortWrite
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID AbortWrite();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Wakes the write in progress, which returns 0. Bytes already in the buffer were already "on the line" and are
+--	still read back.
+----------------------------------------------------------------------------------------------------------------------*/
+void LoopbackTransport::AbortWrite()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	_abort = true;
+	_changed.notify_all();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Cancel
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Cancel();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Read and Write return 0 from then on, until the loopback is opened again.
+----------------------------------------------------------------------------------------------------------------------*/
+void LoopbackTransport::Cancel()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	_cancelled = true;
+	_changed.notify_all();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Close
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Close();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Drops what was not read and closes the loopback.
+----------------------------------------------------------------------------------------------------------------------*/
+void LoopbackTransport::Close()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	_head = _count = 0;
+	_open = false;
+	_changed.notify_all();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Register
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Register(IoLoop &loop, IoLoop::Key key);
+--					-IoLoop &loop:		Loop to report to
+--					-IoLoop::Key key:	Posted to loop when the loopback has bytes or room
+--
+-- RETURNS: false when the loopback is not open
+--
+-- NOTES:
+--	Posts the key once, so bytes written before are read.
+----------------------------------------------------------------------------------------------------------------------*/
+bool LoopbackTransport::Register(IoLoop &loop, IoLoop::Key key)
+{
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		if (!_open)
+			return false;
+		_loop = &loop;
+		_key = key;
+		_wantRead = _wantWrite = false;
+	}
+	loop.Post(key);
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ReadReady
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: long ReadReady(char *buf, size_t len);
+--					-char *buf:		Receives the bytes
+--					-size_t len:	Most bytes to read
+--
+-- RETURNS: Bytes read, 0 when there are none, -1 when the loopback is not open
+--
+-- NOTES:
+--	Takes up to len bytes without waiting. Posts the key when a WriteReady is waiting for the room this made, and
+--	leaves a note for WriteReady when there was nothing to take.
+----------------------------------------------------------------------------------------------------------------------*/
+long LoopbackTransport::ReadReady(char *buf, size_t len)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	size_t n;
+	if (!_open)
+		return -1;
+	if ((n = Take(buf, len)) == 0)
+		_wantRead = true;
+	else if (_wantWrite)
+	{
+		_wantWrite = false;
+		_loop->Post(_key);
+	}
+	return (long)n;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: WriteReady
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: long WriteReady(const char *buf, size_t len);
+--					-const char *buf:	Bytes to send
+--					-size_t len:		Number of bytes in buf
+--
+-- RETURNS: Bytes put in the buffer, 0 when it is full, -1 when the loopback is not open
+--
+-- NOTES:
+--	Copies what fits without waiting. Posts the key when a ReadReady is waiting for the bytes this added, and
+--	leaves a note for ReadReady when there was no room.
+----------------------------------------------------------------------------------------------------------------------*/
+long LoopbackTransport::WriteReady(const char *buf, size_t len)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	size_t n;
+	if (!_open)
+		return -1;
+	if ((n = Put(buf, len)) == 0)
+		_wantWrite = true;
+	else if (_wantRead)
+	{
+		_wantRead = false;
+		_loop->Post(_key);
+	}
+	return (long)n;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Unregister
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Unregister();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Stops posting the key.
+----------------------------------------------------------------------------------------------------------------------*/
+void LoopbackTransport::Unregister()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	_loop = NULL;
+	_wantRead = _wantWrite = false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Take
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Take(char *buf, size_t len);
+--					-char *buf:		Receives the bytes
+--					-size_t len:	Most bytes to take
+--
+-- RETURNS: Bytes taken, up to len
+--
+-- NOTES:
+--	Called with _lock held. Copies up to the end of the buffer, then from its start.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t LoopbackTransport::Take(char *buf, size_t len)
+{
+	size_t n = std::min(len, _count), first = std::min(n, _buffer.size() - _head);
+	memcpy(buf, &_buffer[_head], first);
+	memcpy(buf + first, &_buffer[0], n - first);
+	_head = (_head + n) % _buffer.size();
+	_count -= n;
+	return n;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Put
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Put(const char *buf, size_t len);
+--					-const char *buf:	Bytes to add
+--					-size_t len:		Number of bytes in buf
+--
+-- RETURNS: Bytes added, up to len
+--
+-- NOTES:
+--	Called with _lock held. Adds after the last byte, wrapping to the start of the buffer.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t LoopbackTransport::Put(const char *buf, size_t len)
+{
+	size_t n = std::min(len, _buffer.size() - _count), tail = (_head + _count) % _buffer.size();
+	size_t first = std::min(n, _buffer.size() - tail);
+	memcpy(&_buffer[tail], buf, first);
+	memcpy(&_buffer[0], buf + first, n - first);
+	_count += n;
+	return n;
+}
@@ -0,0 +1,86 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: LoopbackTransport.h - Built-in loopback device for the dumb terminal emulator program, a port whose
+--			writes come back as reads
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- LoopbackTransport(size_t capacity);
+-- bool Open(const char *name);
+-- bool Configure(const PortSettings &settings);
+-- bool Settings(PortSettings &settings) const;
+-- long Read(char *buf, size_t len);
+-- long Write(const char *buf, size_t len);
+-- VOID AbortWrite();
+-- VOID Cancel();
+-- VOID Close();
+-- bool Register(IoLoop &loop, IoLoop::Key key);
+-- long ReadReady(char *buf, size_t len);
+-- long WriteReady(const char *buf, size_t len);
+-- VOID Unregister();
+-- size_t Take(char *buf, size_t len);
+-- size_t Put(const char *buf, size_t len);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Can be serviced by an IoLoop
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Stands in for a serial port with a loopback plug on it, so the headless mode (Headless.h) can run on any host
+--	without hardware or a pty. The bytes written are held in a buffer of a fixed capacity, the size of a driver's
+--	queue, until they are read: a write waits for room when the reader falls behind, as it would on a real port
+--	with flow control. There is no line rate; any settings are accepted and reported back.
+--
+--	There is no system handle to wait on, so a registered loopback reports itself with IoLoop::Post: ReadReady
+--	that finds nothing and WriteReady that finds no room leave a note, and the next WriteReady that adds bytes or
+--	ReadReady that makes room posts the key. It works with a loop of either kind.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef LOOPBACKTRANSPORT_H
+#define LOOPBACKTRANSPORT_H
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include "Transport.h"
+class LoopbackTransport : public Transport
+{
+public:
+	explicit LoopbackTransport(size_t capacity);
+	bool	Open(const char *name);
+	bool	Configure(const PortSettings &settings);
+	bool	Settings(PortSettings &settings) const;
+	long	Read(char *buf, size_t len);
+	long	Write(const char *buf, size_t len);
+	void	AbortWrite();
+	void	Cancel();
+	void	Close();
+	bool	Register(IoLoop &loop, IoLoop::Key key);
+	long	ReadReady(char *buf, size_t len);
+	long	WriteReady(const char *buf, size_t len);
+	void	Unregister();
+
+private:
+	size_t	Take(char *buf, size_t len);			//Copy out up to len bytes, under _lock
+	size_t	Put(const char *buf, size_t len);		//Copy in what fits, under _lock
+
+	mutable std::mutex		_lock;
+	std::condition_variable	_changed;				//Signalled when bytes are added or taken, or on Cancel
+	std::vector<char>		_buffer;				//Circular, bytes written and not read yet
+	size_t					_head;					//Next byte to read
+	size_t					_count;					//Bytes in _buffer
+	bool					_open;
+	bool					_cancelled;				//Set by Cancel until the next Open
+	bool					_abort;					//Set by AbortWrite, taken by the write in progress
+	PortSettings			_settings;				//Last settings configured
+	IoLoop					*_loop;					//Loop the loopback is registered with, NULL when none
+	IoLoop::Key				_key;
+	bool					_wantRead;				//ReadReady found nothing, post when bytes are added
+	bool					_wantWrite;				//WriteReady found no room, post when bytes are taken
+};
+#endif
@@ -0,0 +1,67 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: PagedView.h - Interface to what the window of the dumb terminal emulator program shows
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- bool UpdateMetrics(const MetricsProvider &provider, bool fontChanged);
+-- VOID Clear();
+-- bool NextDirty(int &left, int &top, int &right, int &bottom);
+-- VOID Compose(RenderTarget &target, int left, int top, int right, int bottom);
+-- VOID ResetFrame();
+-- VOID ScrollTo(size_t row);
+-- VOID ScrollBy(long rows);
+-- int TakeScroll();
+-- size_t TopRow() const;
+-- size_t RowCount() const;
+-- size_t PageRows() const;
+-- unsigned long FrameDrawCalls() const;
+-- unsigned long FrameCells() const;
+-- const MetricsCache &Metrics() const;
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	The window shows rows of a history through a view that can be scrolled, and only composes what changed:
+--	the text of the Terminal (Terminal.h) or the hex dump of the HexView (HexView.h). Everything the window does
+--	with either, i.e. laying it out for the client area, finding and composing the dirty areas, scrolling and
+--	the scrollbar, goes through this interface, so the same code presents both and the View menu only switches
+--	which one it talks to. Writing to them does not, since the two take their bytes differently.
+--
+--	The meaning of each call is the one Terminal.h gives it: areas are in view coordinates, TakeScroll returns
+--	how far to scroll the surface before composing the areas NextDirty returns, and the view follows new rows
+--	while it is at the bottom.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef PAGEDVIEW_H
+#define PAGEDVIEW_H
+#include <cstddef>
+#include "FontMetrics.h"
+#include "RenderTarget.h"
+class PagedView
+{
+public:
+	virtual ~PagedView() {}
+	virtual bool				UpdateMetrics(const MetricsProvider &provider, bool fontChanged) = 0;
+	virtual void				Clear() = 0;												//Forget all history
+	virtual bool				NextDirty(int &left, int &top, int &right, int &bottom) = 0;
+	virtual void				Compose(RenderTarget &target, int left, int top, int right, int bottom) = 0;
+	virtual void				ResetFrame() = 0;											//Start counting a frame
+	virtual void				ScrollTo(size_t row) = 0;									//Show row at the top
+	virtual void				ScrollBy(long rows) = 0;									//Negative scrolls back
+	virtual int					TakeScroll() = 0;											//Pixels to scroll by
+	virtual size_t				TopRow() const = 0;
+	virtual size_t				RowCount() const = 0;
+	virtual size_t				PageRows() const = 0;										//Rows that fit
+	virtual unsigned long		FrameDrawCalls() const = 0;
+	virtual unsigned long		FrameCells() const = 0;
+	virtual const MetricsCache	&Metrics() const = 0;
+};
+#endif
@@ -5,15 +5,19 @@
 -- PROGRAM: Dumb terminal emulator
 --
 -- FUNCTIONS:
--- BOOL Initialize_Serial_Port();
+-- BOOL Initialize_Serial_Port(Win32Transport &port);
 -- LRESULT CALLBACK WndProc(HWND, UINT, WPARAM, LPARAM);
--- BOOL Setup_Comm_Config(HWND hwnd);
+-- BOOL Setup_Comm_Config(HWND hwnd, Win32Transport &port);
+-- VOID SerialListener::Received(int id);
+-- VOID SerialListener::Sent(int id);
+-- VOID SerialListener::Closed(int id);
+-- DWORD WINAPI Replay_From_File(LPVOID hwnd);
 -- VOID Output_GetLastError();
 --
 --
 -- DATE: October 4, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - Every port connected is a session of a SessionManager
 --
 -- DESIGNER: Ruoqi Jia
 --
@@ -32,6 +36,9 @@
 --  and processed, the corresponding character will be displayed in a colored backgorund also specified
 --  by the user.
 --
+--	Every port connected is a session of sessions (see SessionManager.h), so the reading and writing of all of
+--	them is done by the one thread of its IocpLoop, which tells the window through SerialListener.
+--
 --	Note that the specific features that handles character display and menuitems will be outlined in Session.h
 ----------------------------------------------------------------------------------------------------------------------*/
 
@@ -41,27 +48,25 @@
 --
 -- DATE: September 28, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - Opens the port through the Transport interface
+--			  October 17, 2026 - Opens the port picked in the Port menu into a port of the caller's
 --
 -- DESIGNER: Ruoqi Jia
 --
 -- PROGRAMMER: Ruoqi Jia
 --
--- INTERFACE: BOOL Initialize_Serial_Port(HANDLE hComm);
---					-HANDLE hComm: The handle to the communication device returned by CreateFile()
+-- INTERFACE: BOOL Initialize_Serial_Port(Win32Transport &port);
+--					-Win32Transport &port: Opened on comm_name
 --
 -- RETURNS: TRUE if the serial port successfully opens, FALSE otherwise.
 --
 -- NOTES:
---	Attempt to open a communication device, in this case the serial port, for asynchronous reading and writing
+--	Attempt to open a communication device, in this case the serial port, for asynchronous reading and writing.
+--	Fails when the port is already connected, as a session or by another program.
 ----------------------------------------------------------------------------------------------------------------------*/
-BOOL Initialize_Serial_Port()
+BOOL Initialize_Serial_Port(Win32Transport &port)
 {
-	if (isConnected)
-		return FALSE;
-	if ((hComm = CreateFile(lpszCommName, GENERIC_READ | GENERIC_WRITE, 0,
-		NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL))
-		== INVALID_HANDLE_VALUE)	//Opens the serial port for asyncronous I/O
+	if (!port.Open(comm_name))	//Opens the serial port for asyncronous I/O
 	{
 		MessageBox(NULL, "Error opening COM port:", "", MB_OK);
 		return FALSE;
@@ -74,7 +79,15 @@ BOOL Initialize_Serial_Port()
 --
 -- DATE: September 28, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - WM_ERASEBKGND is swallowed, the back buffer paints every pixel
+--			  October 17, 2026 - WM_VSCROLL and WM_MOUSEWHEEL scroll the view of the history
+--			  October 17, 2026 - WM_TIMER continues laying out the history after a resize
+--			  October 17, 2026 - Keystrokes go through txQueue, Shift+Insert pastes the clipboard
+--			  October 17, 2026 - WM_SEND_DONE and IDT_SEND drive the progress of a file send
+--			  October 17, 2026 - IDT_CAPTURE flushes the capture, WM_DESTROY stops it
+--			  October 17, 2026 - WM_REPLAY_DONE ends a replay
+--			  October 17, 2026 - Keystrokes are sent as UTF-8
+--			  October 17, 2026 - WM_SERIAL_DATA and WM_SEND_DONE carry the id of a session, WM_DESTROY closes them all
 --
 -- DESIGNER: Ruoqi Jia
 --
@@ -102,14 +115,52 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT Message,
 	case WM_COMMAND:
 		Handle_Menu_Commands(hwnd, wParam);	//Handles menuitem operations
 		break;
+	case WM_SERIAL_DATA:					// Bytes are waiting in a session or in replayRing
+		Drain_Received(hwnd, (int)wParam);
+		break;
+	case WM_SEND_DONE:						//A session sent the last byte of a file
+		End_Send(hwnd);
+		break;
+	case WM_REPLAY_DONE:					//The replay thread reached the end of the capture
+		Stop_Replay(hwnd);
+		if (!wParam)
+			MessageBox(NULL, "Error reading the capture file", "", MB_OK);
+		break;
 	case WM_CHAR:							// Process keystroke
 		if (isConnected)					//	If currently in connect mode
-			Write_To_Serial(wParam, hwnd);
+			Send_Key(hwnd, wParam);			//Sent as UTF-8 by the session shown, then echoed
+		break;
+	case WM_KEYDOWN:						//Shift+Insert pastes, like most terminals
+		if (wParam == VK_INSERT && GetKeyState(VK_SHIFT) < 0)
+			Paste_Clipboard(hwnd);
 		break;
+	case WM_SIZE:							//Client width changed, line wrap follows it
+		Update_Metrics(hwnd, FALSE);
+		break;
+	case WM_VSCROLL:						//Scrollbar moves the view of the history
+		Handle_Scroll(hwnd, wParam);
+		break;
+	case WM_MOUSEWHEEL:						//Three rows per notch, like most programs
+		Scroll_Rows(hwnd, -GET_WHEEL_DELTA_WPARAM(wParam) * 3 / WHEEL_DELTA);
+		break;
+	case WM_TIMER:							//Lay out more of the history after a resize
+		if (wParam == IDT_REFLOW)
+			Continue_Reflow(hwnd);
+		else if (wParam == IDT_SEND)		//or show how far a file send has got
+			Show_Send_Progress(hwnd);
+		else if (wParam == IDT_CAPTURE)		//or get the capture onto the disk
+			capture.Flush();
+		break;
+	case WM_ERASEBKGND:						//The back buffer covers the whole client area
+		return 1;
 	case WM_PAINT:							//Process repaint 
 			Repaint(hwnd);
 		break;
 	case WM_DESTROY:						// Terminate program
+		Stop_Replay(hwnd);
+		End_Send(hwnd);						//Sessions let go of the file before they close
+		Stop_Capture(hwnd);
+		sessions.Stop();					//Closes every port and joins the thread
 		PostQuitMessage(0);
 		break;
 	default:
@@ -124,14 +175,16 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT Message,
 --
 -- DATE: September 28, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - Applies the dialog settings through the Transport interface, closes the port when cancelled
+--			  October 17, 2026 - Configures the port it is given, for a new session
 --
 -- DESIGNER: Ruoqi Jia
 --
 -- PROGRAMMER: Ruoqi Jia
 --
--- INTERFACE: BOOL Setup_Comm_Config(HWND hwnd);
---					-HWND hwnd: Handle to the current window
+-- INTERFACE: BOOL Setup_Comm_Config(HWND hwnd, Win32Transport &port);
+--					-HWND hwnd:				Handle to the current window
+--					-Win32Transport &port:	Port to open on comm_name and configure
 --
 -- RETURNS: TRUE if the DCB struture is successfully set by the driver-supplied configuration dialog
 --				FALSE otherwise
@@ -140,26 +193,55 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT Message,
 --	Opens a driver-supplied configuration dialog box for user to initialize the protocol values in a DCB structure
 --	so two devices can communicate between each other
 ----------------------------------------------------------------------------------------------------------------------*/
-BOOL Setup_Comm_Config(HWND hwnd)
+BOOL Setup_Comm_Config(HWND hwnd, Win32Transport &port)
 {
-	if (!Initialize_Serial_Port())
+	if (!Initialize_Serial_Port(port))
 		return FALSE;
 	COMMCONFIG cc;					//Configuration state of the serial port
 	cc.dwSize = sizeof(COMMCONFIG);	//Set the size of the structure to default
 	cc.wVersion = 0x100;			//Set the version number 
-	if (!GetCommConfig(hComm, &cc, &cc.dwSize))		//Retrieves the current configuration of the serial port
+	if (!GetCommConfig(port.Handle(), &cc, &cc.dwSize))		//Retrieves the current configuration of the serial port
 		MessageBox(NULL, "Error Retriving COMMCONFIG:", "", MB_OK);
-	if (!CommConfigDialog(lpszCommName, hwnd, &cc))	//Display configuration box 
+	if (!CommConfigDialog(comm_name, hwnd, &cc))	//Display configuration box 
+	{
+		port.Close();
 		return FALSE;
-	if (!SetCommState(hComm, &cc.dcb))				//Set cc to the current configuration for the serial port
+	}
+	if (!port.Configure(Win32Transport::FromDcb(cc.dcb)))	//Set cc to the current configuration for the serial port
 		MessageBox(NULL, "Error Setting COMMCONFIG:", "", MB_OK);
 	return TRUE;
 }
 
 /*------------------------------------------------------------------------------------------------------------------
--- FUNCTION: Read_From_Serial
+-- FUNCTION: SerialListener::Received
 --
--- DATE: September 28, 2015
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Called by sessions for any of its ports
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Received(int id);
+--					-int id: Session with bytes waiting
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Called on the thread of sessions when bytes were put in the session's RingBuffer and the UI thread has not
+--	been told yet. Posts a single WM_SERIAL_DATA with the id, so the characters are drawn by the UI thread in the
+--	read color of the session.
+----------------------------------------------------------------------------------------------------------------------*/
+void SerialListener::Received(int id)
+{
+	PostMessage(hwnd, WM_SERIAL_DATA, (WPARAM)id, 0);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: SerialListener::Sent
+--
+-- DATE: October 17, 2026
 --
 -- REVISIONS: (Date and Description)
 --
@@ -167,79 +249,105 @@ BOOL Setup_Comm_Config(HWND hwnd)
 --
 -- PROGRAMMER: Ruoqi Jia
 --
--- INTERFACE: DWORD WINAPI Read_From_Serial(LPVOID hwnd);
---					-LPVOID hwnd: A void pointer to the handle of the current window
+-- INTERFACE: VOID Sent(int id);
+--					-int id: Session that sent the last byte of its file
 --
--- RETURNS: 0 when the thread is being terminated
+-- RETURNS: VOID
 --
 -- NOTES:
---	Called by the CreateThread function. This function loops forever as long as the program is connected. This uses an
---  event-driven approach by having a event created when a character arrives to the port. This also checks that the overlapped
---	object that is being passed in the ReadFile function is in a signaled state. The character is then displayed on the screen 
---  in a colored background selected from the menu(default to green).
+--	Called on the thread of sessions when the file attached to the session was sent, or its send ended with a
+--	failed write. Posts WM_SEND_DONE, as Write_To_Serial did, so End_Send takes the file back.
 ----------------------------------------------------------------------------------------------------------------------*/
-DWORD WINAPI Read_From_Serial(LPVOID hwnd)
+void SerialListener::Sent(int id)
 {
-	DWORD read_byte, dwEvent, dwError;
-	COMSTAT cs;
-	char	str[10] = "";					//Character buffer for reading
-	while (isConnected)
-	{
-		SetCommMask(hComm, EV_RXCHAR);			//Create an event when a character arrives
-		HDC		hdc = GetDC((HWND)hwnd);		//Get device context
-		if ((ov_read.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL)) == NULL)	//Create event for reading
-			Output_GetLastError();				//Error checking
-		if (WaitCommEvent(hComm, &dwEvent, NULL))				//Wait for the event to happen
-		{
-			ClearCommError(hComm, &dwError, &cs);				//Clear the communication port
-			if ((dwEvent & EV_RXCHAR) && cs.cbInQue)
-			{
-				if (!ReadFile(hComm, str, 1, &read_byte, &ov_read))	//Attempt to read from port
-					Output_GetLastError();							//Error checking
-				Draw(str, hdc, read_color, FALSE, (HWND)hwnd);		//Display character
-			}
-				
-		}else
-			Output_GetLastError();								//Error Checking
-	}
+	PostMessage(hwnd, WM_SEND_DONE, (WPARAM)id, 0);
+}
 
-	PurgeComm(hComm, PURGE_RXCLEAR);			//Clean out the buffer 
-	return 0;
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: SerialListener::Closed
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Called by sessions for any of its ports
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Closed(int id);
+--					-int id: Session whose port failed
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Called on the thread of sessions when a read or write failed while connected. Nothing more is read or written
+--	on the port; Disconnect still closes the session.
+----------------------------------------------------------------------------------------------------------------------*/
+void SerialListener::Closed(int id)
+{
+	Output_GetLastError();				//Error checking
 }
 
 /*------------------------------------------------------------------------------------------------------------------
--- FUNCTION: Write_To_Serial
+-- FUNCTION: Replay_From_File
 --
--- DATE: September 28, 2015
+-- DATE: October 17, 2026
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - Feeds replayRing, the ring of the replay alone
 --
 -- DESIGNER: Ruoqi Jia
 --
 -- PROGRAMMER: Ruoqi Jia
 --
--- INTERFACE: BOOL Write_To_Serial(HDC	hdc,
---								   HWND hwnd);
---					-HDC hdc:	Device context
---					-HWND hwnd: Handle to the current window
--- RETURNS: 0 if the write operation to the serial port failed, else 1
+-- INTERFACE: DWORD WINAPI Replay_From_File(LPVOID hwnd);
+--					-LPVOID hwnd: A void pointer to the handle of the current window
+--
+-- RETURNS: 0 when the replay ended, 1 when the capture could not be read
 --
 -- NOTES:
---	Performs write operation on the currently opened serial port. Sends 1 character at a time and
---	draw the character on the window with a colored background selected from the menu(default to yellow)
+--	Called by the CreateThread function when a replay is started from the menu, while no port is connected.
+--	Reads replay_path with a CaptureReader and puts every received record into replayRing, posting WM_SERIAL_DATA
+--	the way a session does, so the bytes take the exact path received bytes take to the screen. Each record is
+--	held back until it is due at replay_speed; with speed 0 it is only held back while replayRing is full. Sent
+--	records are skipped. Posts WM_REPLAY_DONE when the capture ends or replayStop is set.
 ----------------------------------------------------------------------------------------------------------------------*/
-BOOL Write_To_Serial(WPARAM wParam, HWND hwnd)
+DWORD WINAPI Replay_From_File(LPVOID hwnd)
 {
-	char	str[10];
-	HDC		hdc = GetDC(hwnd);					//get device context
-	sprintf_s(str, "%c", (char)wParam);			//Convert wParam to a string
-	Draw((str), hdc, write_color, FALSE, hwnd);		//Display the string
-	if ((ov_write.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL)) == NULL)	//Create event for writing
-		MessageBox(NULL, "Creating write event failed", "", MB_OK);
-	if (!WriteFile(hComm, str, strlen(str), NULL, &ov_write))				//Attempt to write to the serial port
-		return FALSE;
-	CloseHandle(ov_write.hEvent);						//Release device context
-	return TRUE;
+	CaptureReader	reader;
+	CaptureRecord	rec;
+	LARGE_INTEGER	frequency, start, now;
+	double			due, elapsed;
+	size_t			done, n;
+	if (!reader.Open(replay_path))
+	{
+		PostMessage((HWND)hwnd, WM_REPLAY_DONE, FALSE, 0);
+		return 1;
+	}
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&start);
+	while (!replayStop && reader.Next(rec))
+	{
+		if (rec.dir != CaptureLog::RX)
+			continue;
+		due = replay_speed > 0 ? reader.Seconds(rec) / replay_speed : 0;
+		while (!replayStop)								//Wait until the record is due
+		{
+			QueryPerformanceCounter(&now);
+			elapsed = (double)(now.QuadPart - start.QuadPart) / frequency.QuadPart;
+			if (elapsed >= due)
+				break;
+			Sleep((DWORD)min((due - elapsed) * 1000, 50.0));
+		}
+		for (done = 0; done < rec.len && !replayStop; done += n)
+		{
+			if ((n = replayRing.Write(rec.data + done, rec.len - done)) == 0)
+				Sleep(1);								//UI thread is behind, let it catch up
+			else if (InterlockedExchange(&replayPending, TRUE) == FALSE)	//Coalesce notifications
+				PostMessage((HWND)hwnd, WM_SERIAL_DATA, (WPARAM)SessionManager::NONE, 0);
+		}
+	}
+	PostMessage((HWND)hwnd, WM_REPLAY_DONE, TRUE, 0);
+	return 0;
 }
 
 /*------------------------------------------------------------------------------------------------------------------
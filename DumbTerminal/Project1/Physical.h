@@ -5,15 +5,19 @@
 -- PROGRAM: Dumb terminal emulator
 --
 -- FUNCTIONS:
--- BOOL Initialize_Serial_Port();
+-- BOOL Initialize_Serial_Port(Win32Transport &port);
 -- LRESULT CALLBACK WndProc(HWND, UINT, WPARAM, LPARAM);
--- BOOL Setup_Comm_Config(HWND hwnd);
+-- BOOL Setup_Comm_Config(HWND hwnd, Win32Transport &port);
+-- VOID SerialListener::Received(int id);
+-- VOID SerialListener::Sent(int id);
+-- VOID SerialListener::Closed(int id);
+-- DWORD WINAPI Replay_From_File(LPVOID hwnd);
 -- VOID Output_GetLastError();
 --
 --
 -- DATE: October 4, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - Every port connected is a session of a SessionManager
 --
 -- DESIGNER: Ruoqi Jia
 --
@@ -32,6 +36,9 @@
 --  and processed, the corresponding character will be displayed in a colored backgorund also specified 
 --  by the user.
 --
+--	Every port connected is a session of sessions (see SessionManager.h), so the reading and writing of all of
+--	them is done by the one thread of its IocpLoop, which tells the window through SerialListener.
+--
 --	Note that the specific features that handles character display and menuitems will be outlined in Session.h
 ----------------------------------------------------------------------------------------------------------------------*/
 
@@ -43,28 +50,30 @@
 --
 -- DATE: September 28, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - Opens the port through the Transport interface
+--			  October 17, 2026 - Opens the port picked in the Port menu into a port of the caller's
 --
 -- DESIGNER: Ruoqi Jia
 --
 -- PROGRAMMER: Ruoqi Jia
 --
--- INTERFACE: BOOL Initialize_Serial_Port(HANDLE hComm);
---					-HANDLE hComm: The handle to the communication device returned by CreateFile()
+-- INTERFACE: BOOL Initialize_Serial_Port(Win32Transport &port);
+--					-Win32Transport &port: Opened on comm_name
 --
 -- RETURNS: TRUE if the serial port successfully opens, FALSE otherwise.
 --
 -- NOTES:
 --	Attempt to open a communication device, in this case the serial port, for asynchronous reading and writing
 ----------------------------------------------------------------------------------------------------------------------*/
-BOOL Initialize_Serial_Port();
+BOOL Initialize_Serial_Port(Win32Transport &port);
 
 /*------------------------------------------------------------------------------------------------------------------
 -- FUNCTION: WndProc
 --
 -- DATE: September 28, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - WM_ERASEBKGND is swallowed, the back buffer paints every pixel
+--			  October 17, 2026 - WM_VSCROLL and WM_MOUSEWHEEL scroll the view of the history
 --
 -- DESIGNER: Ruoqi Jia
 --
@@ -91,14 +100,16 @@ LRESULT CALLBACK WndProc(HWND, UINT, WPARAM, LPARAM);
 --
 -- DATE: September 28, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - Applies the dialog settings through the Transport interface, closes the port when cancelled
+--			  October 17, 2026 - Configures the port it is given, for a new session
 --
 -- DESIGNER: Ruoqi Jia
 --
 -- PROGRAMMER: Ruoqi Jia
 --
--- INTERFACE: BOOL Setup_Comm_Config(HWND hwnd);
---					-HWND hwnd: Handle to the current window
+-- INTERFACE: BOOL Setup_Comm_Config(HWND hwnd, Win32Transport &port);
+--					-HWND hwnd:				Handle to the current window
+--					-Win32Transport &port:	Port to open on comm_name and configure
 --
 -- RETURNS: TRUE if the DCB struture is successfully set by the driver-supplied configuration dialog
 --				FALSE otherwise
@@ -107,54 +118,64 @@ LRESULT CALLBACK WndProc(HWND, UINT, WPARAM, LPARAM);
 --	Opens a driver-supplied configuration dialog box for user to initialize the protocol values in a DCB structure 
 --	so two devices can communicate between each other
 ----------------------------------------------------------------------------------------------------------------------*/
-BOOL Setup_Comm_Config(HWND hwnd);
+BOOL Setup_Comm_Config(HWND hwnd, Win32Transport &port);
 
 /*------------------------------------------------------------------------------------------------------------------
--- FUNCTION: Read_From_Serial
+-- CLASS: SerialListener
 --
--- DATE: September 28, 2015
+-- DATE: October 17, 2026
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - Listens to the SessionManager sessions instead of one PortReader
 --
 -- DESIGNER: Ruoqi Jia
 --
 -- PROGRAMMER: Ruoqi Jia
 --
--- INTERFACE: DWORD WINAPI Read_From_Serial(LPVOID hwnd);
---					-LPVOID hwnd: A void pointer to the handle of the current window
---
--- RETURNS: 0 when the thread is being terminated
---
 -- NOTES:
---	Called by the CreateThread function. This function loops forever attempting to read bytes from the serial port.
---	Also checks that the overlapped object that is being passed in the ReadFile function is in a signaled state
---	(character arrived but it's in the que) when ReadFile fails in order to make sure it can successfully process the character.
---	The character is then displayed on the screen in a green background.
+--	Takes the place of Read_From_Serial and Write_To_Serial, which looped on the serial port until disconnected.
+--	Every port connected is now a session of sessions (see SessionManager.h), whose one thread reads what each
+--	port has into the session's RingBuffer and writes what its SendQueue holds, and calls the listener on that
+--	thread. Received and Sent post WM_SERIAL_DATA and WM_SEND_DONE to hwnd with the id of the session, and Closed
+--	reports the error of a port that failed. Disconnect closes the session, which takes a few milliseconds
+--	whatever the port is doing.
 ----------------------------------------------------------------------------------------------------------------------*/
-DWORD WINAPI Read_From_Serial(LPVOID hwnd);
+class SerialListener : public SessionListener
+{
+public:
+	SerialListener() : hwnd(NULL) {}
+	void	Received(int id);
+	void	Sent(int id);
+	void	Closed(int id);
+
+	HWND	hwnd;						//Window the messages are posted to
+};
+extern	SerialListener listener;		//The listener of sessions
 
 /*------------------------------------------------------------------------------------------------------------------
--- FUNCTION: Write_To_Serial
+-- FUNCTION: Replay_From_File
 --
--- DATE: September 28, 2015
+-- DATE: October 17, 2026
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - Feeds replayRing, the ring of the replay alone
 --
 -- DESIGNER: Ruoqi Jia
 --
 -- PROGRAMMER: Ruoqi Jia
 --
--- INTERFACE: BOOL Write_To_Serial(HDC	hdc,
---								   HWND hwnd);
---					-HDC hdc:	Device context
---					-HWND hwnd: Handle to the current window
--- RETURNS: 0 if the write operation to the serial port failed, else 1
+-- INTERFACE: DWORD WINAPI Replay_From_File(LPVOID hwnd);
+--					-LPVOID hwnd: A void pointer to the handle of the current window
+--
+-- RETURNS: 0 when the replay ended, 1 when the capture could not be read
 --
 -- NOTES:
---	Performs write operation on the currently opened serial port. Sends 1 character at a time and 
---	draw the character on the window with a yellow background
+--	Called by the CreateThread function when a replay is started from the menu, while no port is connected.
+--	Reads replay_path with a CaptureReader and puts every received record into replayRing, posting WM_SERIAL_DATA
+--	the way a session does, so the bytes take the exact path received bytes take to the screen. Each record is
+--	held back until it is due at replay_speed; with speed 0 it is only held back while replayRing is full. Sent
+--	records are skipped. Posts WM_REPLAY_DONE when the capture ends or replayStop is set.
 ----------------------------------------------------------------------------------------------------------------------*/
-BOOL Write_To_Serial(WPARAM wParam, HWND hwnd);
+DWORD WINAPI Replay_From_File(LPVOID hwnd);
+
 /*------------------------------------------------------------------------------------------------------------------
 -- FUNCTION: OutPut_GetLastError
 --
@@ -0,0 +1,252 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: PortReader.cpp - Actual function implementation for PortReader.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- PortReader(RingBuffer &ring, size_t chunk);
+-- ~PortReader();
+-- bool Start(Transport &port, ReaderListener &listener, CaptureLog *capture);
+-- VOID Stop();
+-- size_t Receive(char *buf, size_t len);
+-- VOID Run();
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Reader thread of one connection. See PortReader.h.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <atomic>
+#include <system_error>
+#include "PortReader.h"
+#include "Stats.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: PortReader
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: PortReader(RingBuffer &ring, size_t chunk);
+--					-RingBuffer &ring:	Receives what is read, taken by Receive
+--					-size_t chunk:		Most bytes read at a time
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Allocates the read buffer for every connection the reader will run.
+----------------------------------------------------------------------------------------------------------------------*/
+PortReader::PortReader(RingBuffer &ring, size_t chunk)
+	: _ring(ring), _buffer(chunk), _port(NULL), _listener(NULL), _capture(NULL), _stop(false), _waiting(false),
+	_notified(false)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ~PortReader
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: ~PortReader();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Stops the thread if it is still running.
+----------------------------------------------------------------------------------------------------------------------*/
+PortReader::~PortReader()
+{
+	Stop();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Start
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Start(Transport &port, ReaderListener &listener, CaptureLog *capture);
+--					-Transport &port:				Open and configured port
+--					-ReaderListener &listener:		Told when bytes are waiting and when a read fails
+--					-CaptureLog *capture:			Capture to record what is read in, NULL for none
+--
+-- RETURNS: false when the thread could not be started or is running already
+--
+-- NOTES:
+--	Empties the RingBuffer of what the last connection left and starts the thread.
+----------------------------------------------------------------------------------------------------------------------*/
+bool PortReader::Start(Transport &port, ReaderListener &listener, CaptureLog *capture)
+{
+	if (_thread.joinable())
+		return false;
+	_ring.Clear();
+	_port = &port;
+	_listener = &listener;
+	_capture = capture;
+	_stop = false;
+	_waiting = _notified = false;
+	try
+	{
+		_thread = std::thread(&PortReader::Run, this);
+	}
+	catch (const std::system_error &)
+	{
+		return false;
+	}
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Stop
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Stop();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Wakes the thread wherever it waits, by cancelling the port and signalling the wait for room, and joins it.
+--	Cancelling also wakes a writer in Transport::Write, as Disconnect wants. Does nothing when the thread is not
+--	running.
+----------------------------------------------------------------------------------------------------------------------*/
+void PortReader::Stop()
+{
+	if (!_thread.joinable())
+		return;
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		_stop = true;
+	}
+	_room.notify_one();
+	_port->Cancel();
+	_thread.join();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Receive
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--			  October 17, 2026 - Fenced against the reader, the wake could be lost when it found the room full
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Receive(char *buf, size_t len);
+--					-char *buf:		Receives the bytes
+--					-size_t len:	Room in buf
+--
+-- RETURNS: Bytes taken, 0 when none are waiting
+--
+-- NOTES:
+--	Re-arms Received first so bytes that arrive meanwhile are told about again, then takes what the RingBuffer
+--	holds. When the reader is waiting for room it is woken, under the lock so the wake cannot fall between its
+--	check and its wait. The fence pairs with the one in Run: either the reader sees the room made here, or this
+--	sees that it waits, never neither.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t PortReader::Receive(char *buf, size_t len)
+{
+	size_t n;
+	_notified = false;
+	n = _ring.Read(buf, len);
+	std::atomic_thread_fence(std::memory_order_seq_cst);	//Order freeing the room before looking at _waiting
+	if (n > 0 && _waiting.load(std::memory_order_relaxed))
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		_room.notify_one();
+	}
+	return n;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Run
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--			  October 17, 2026 - Fenced against Receive before waiting for room
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Run();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	The reader thread, Read_From_Serial as it was, minus the polling: reads what the port has queued, never more
+--	than the RingBuffer can take, records and appends it, and calls Received once for everything read until the
+--	owner calls Receive. A full RingBuffer is waited out on _room. Ends when Stop cancels the port, or calls
+--	Failed when a read fails before that.
+----------------------------------------------------------------------------------------------------------------------*/
+void PortReader::Run()
+{
+	size_t	room;
+	long	n;
+	for (;;)
+	{
+		if ((room = _ring.Free()) == 0)					//Owner is behind, let it catch up
+		{
+			std::unique_lock<std::mutex> guard(_lock);
+			_waiting.store(true, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);	//Order the flag before looking at the room
+			_room.wait(guard, [this] { return _stop || _ring.Free() > 0; });
+			_waiting = false;
+			if (_stop)
+				return;
+			continue;
+		}
+		if ((n = _port->Read(_buffer.data(), room < _buffer.size() ? room : _buffer.size())) <= 0)
+		{
+			std::unique_lock<std::mutex> guard(_lock);
+			bool stopping = _stop;
+			guard.unlock();
+			if (n < 0 && !stopping)
+				_listener->Failed();
+			return;										//Cancelled by Stop
+		}
+		if (_capture != NULL)
+			_capture->Record(CaptureLog::RX, Stats_Now(), _buffer.data(), n);	//Copied, never waits for disk
+		_ring.Write(_buffer.data(), n);					//Always fits, n <= Free()
+		Stats_Count(STAT_READS);
+		Stats_Count(STAT_READ_BYTES, n);
+		Stats_Sample(STAT_READ_SIZE, n);
+		Stats_Sample(STAT_RX_DEPTH, _ring.Size());
+		if (!_notified.exchange(true))					//Coalesce notifications
+			_listener->Received();
+	}
+}
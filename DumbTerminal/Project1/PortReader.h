@@ -0,0 +1,84 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: PortReader.h - The reader thread of one connection of the dumb terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- PortReader(RingBuffer &ring, size_t chunk);
+-- ~PortReader();
+-- bool Start(Transport &port, ReaderListener &listener, CaptureLog *capture);
+-- VOID Stop();
+-- size_t Receive(char *buf, size_t len);
+-- bool Running() const;
+-- VOID Run();
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Start runs one thread for the connection that reads what the port receives into a RingBuffer, records it in
+--	the capture and tells the owner through a ReaderListener that bytes are waiting, once until the owner calls
+--	Receive. The read buffer is allocated once, when the reader is constructed, and the port's own events are
+--	allocated once with the port, so nothing is created or leaked per read or per connection but the thread.
+--
+--	The thread only ever waits in two places, and both can be woken by Stop: in Transport::Read, which waits
+--	for the port's data and its cancel signal together, and, when the RingBuffer is full, on a condition that
+--	Receive signals once it made room. Stop cancels the port and joins the thread, so it takes no longer than
+--	Read takes to see the cancel, a few milliseconds, and the port can be closed as soon as it returns.
+--
+--	Start, Stop and Receive are called by one owner thread; the listener is called on the reader's thread and
+--	must not wait for the owner. The capture is recorded with Stats_Now timestamps, so it has to be started with
+--	a frequency of 1000000.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef PORTREADER_H
+#define PORTREADER_H
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "CaptureLog.h"
+#include "RingBuffer.h"
+#include "Transport.h"
+class ReaderListener
+{
+public:
+	virtual ~ReaderListener() {}
+	virtual void	Received() = 0;			//Bytes are waiting, not called again until Receive was called
+	virtual void	Failed() = 0;			//A read failed and the reader ended, Stop is still up to the owner
+};
+
+class PortReader
+{
+public:
+	PortReader(RingBuffer &ring, size_t chunk);
+	~PortReader();
+	bool	Start(Transport &port, ReaderListener &listener, CaptureLog *capture);	//Start reading port
+	void	Stop();											//Cancel the port and join the thread
+	size_t	Receive(char *buf, size_t len);					//Take received bytes
+	bool	Running() const { return _thread.joinable(); }
+
+private:
+	void	Run();
+
+	RingBuffer				&_ring;					//Read, not taken by Receive yet
+	std::vector<char>		_buffer;				//Reads land here first
+	Transport				*_port;
+	ReaderListener			*_listener;
+	CaptureLog				*_capture;
+	std::thread				_thread;
+	std::mutex				_lock;					//Guards the wait for room
+	std::condition_variable	_room;					//Signalled by Receive and Stop
+	bool					_stop;
+	std::atomic<bool>		_waiting;				//The reader waits for room in _ring
+	std::atomic<bool>		_notified;				//Received was called and Receive not yet
+};
+#endif
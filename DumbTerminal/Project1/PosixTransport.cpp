@@ -0,0 +1,625 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: PosixTransport.cpp - Actual function implementation for PosixTransport.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- PosixTransport();
+-- ~PosixTransport();
+-- bool Open(const char *name);
+-- bool Configure(const PortSettings &settings);
+-- bool Settings(PortSettings &settings) const;
+-- long Read(char *buf, size_t len);
+-- long Write(const char *buf, size_t len);
+-- VOID AbortWrite();
+-- VOID Cancel();
+-- VOID Close();
+-- bool Register(IoLoop &loop, IoLoop::Key key);
+-- long ReadReady(char *buf, size_t len);
+-- long WriteReady(const char *buf, size_t len);
+-- VOID Unregister();
+-- int Await(int poll);
+-- bool Cancelled() const;
+-- static bool Speed_Of(unsigned long baud, speed_t &speed);
+-- static VOID Watch(int poll, int fd, unsigned events);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	termios and epoll transport. See PosixTransport.h.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <cerrno>
+#include <cstdint>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <termios.h>
+#include <unistd.h>
+#include "PosixTransport.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Speed_Of
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static bool Speed_Of(unsigned long baud, speed_t &speed);
+--					-unsigned long baud:	Bits per second
+--					-speed_t &speed:		Set to the termios constant for baud
+--
+-- RETURNS: false when termios has no constant for baud
+--
+-- NOTES:
+--	termios only knows a fixed list of rates, so anything else is refused rather than rounded.
+----------------------------------------------------------------------------------------------------------------------*/
+static bool Speed_Of(unsigned long baud, speed_t &speed)
+{
+	static const struct { unsigned long baud; speed_t speed; } rates[] =
+	{
+		{ 300, B300 }, { 600, B600 }, { 1200, B1200 }, { 2400, B2400 }, { 4800, B4800 }, { 9600, B9600 },
+		{ 19200, B19200 }, { 38400, B38400 }, { 57600, B57600 }, { 115200, B115200 }, { 230400, B230400 },
+#ifdef B460800
+		{ 460800, B460800 }, { 921600, B921600 },
+#endif
+	};
+	for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); ++i)
+		if (rates[i].baud == baud)
+		{
+			speed = rates[i].speed;
+			return true;
+		}
+	return false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Watch
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Watch(int poll, int fd, unsigned events);
+--					-int poll:			epoll instance
+--					-int fd:			File descriptor to watch, also stored as the event data
+--					-unsigned events:	EPOLLIN or EPOLLOUT
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Adds fd to the epoll instance, level-triggered.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Watch(int poll, int fd, unsigned events)
+{
+	struct epoll_event ev = {};
+	ev.events = events;
+	ev.data.fd = fd;
+	epoll_ctl(poll, EPOLL_CTL_ADD, fd, &ev);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: PosixTransport
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: PosixTransport();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Creates the two eventfds and the two epoll instances, which watch the eventfds from the start. The tty is
+--	added when it is opened.
+----------------------------------------------------------------------------------------------------------------------*/
+PosixTransport::PosixTransport()
+	: _fd(-1), _cancel(eventfd(0, EFD_NONBLOCK)), _abort(eventfd(0, EFD_NONBLOCK)),
+	_readPoll(epoll_create1(0)), _writePoll(epoll_create1(0)), _loop(NULL)
+{
+	_settings.baud = 9600;
+	_settings.dataBits = 8;
+	_settings.parity = 'N';
+	_settings.stopBits = 1;
+	_settings.flow = PortSettings::FLOW_NONE;
+	Watch(_readPoll, _cancel, EPOLLIN);
+	Watch(_writePoll, _cancel, EPOLLIN);
+	Watch(_writePoll, _abort, EPOLLIN);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ~PosixTransport
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: ~PosixTransport();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Closes the tty if it is still open, the epoll instances and the eventfds.
+----------------------------------------------------------------------------------------------------------------------*/
+PosixTransport::~PosixTransport()
+{
+	Close();
+	close(_readPoll);
+	close(_writePoll);
+	close(_cancel);
+	close(_abort);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Open
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Open(const char *name);
+--					-const char *name: Path of the tty, e.g. "/dev/ttyUSB0"
+--
+-- RETURNS: true when the tty was opened and put in raw mode
+--
+-- NOTES:
+--	Opens the tty non-blocking, without making it the controlling terminal, and applies the last settings, 9600
+--	8N1 with no flow control at first. Clears a Cancel left over from the previous connection.
+----------------------------------------------------------------------------------------------------------------------*/
+bool PosixTransport::Open(const char *name)
+{
+	uint64_t count;
+	if ((_fd = open(name, O_RDWR | O_NOCTTY | O_NONBLOCK)) < 0)
+		return false;
+	if (!Configure(_settings))
+	{
+		Close();
+		return false;
+	}
+	while (read(_cancel, &count, sizeof(count)) > 0)
+		;
+	while (read(_abort, &count, sizeof(count)) > 0)
+		;
+	Watch(_readPoll, _fd, EPOLLIN);
+	Watch(_writePoll, _fd, EPOLLOUT);
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Configure
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Configure(const PortSettings &settings);
+--					-const PortSettings &settings: Line parameters to set
+--
+-- RETURNS: false when the rate has no termios constant or the tty refused the settings
+--
+-- NOTES:
+--	Puts the tty in raw mode, so every byte is passed through as it is, and sets the rate, character size, parity,
+--	stop bits and flow control. Mark and space parity are not available through termios and are refused.
+----------------------------------------------------------------------------------------------------------------------*/
+bool PosixTransport::Configure(const PortSettings &settings)
+{
+	struct termios	tio;
+	speed_t			speed;
+	static const tcflag_t sizes[] = { CS5, CS6, CS7, CS8 };
+	if (!Speed_Of(settings.baud, speed) || settings.dataBits < 5 || settings.dataBits > 8
+		|| settings.parity == 'M' || settings.parity == 'S' || tcgetattr(_fd, &tio) != 0)
+		return false;
+	cfmakeraw(&tio);
+	cfsetispeed(&tio, speed);
+	cfsetospeed(&tio, speed);
+	tio.c_cflag &= ~(CSIZE | PARENB | PARODD | CSTOPB | CRTSCTS);
+	tio.c_cflag |= sizes[settings.dataBits - 5] | CLOCAL | CREAD;
+	if (settings.parity != 'N')
+		tio.c_cflag |= settings.parity == 'O' ? PARENB | PARODD : PARENB;
+	if (settings.stopBits == 2)
+		tio.c_cflag |= CSTOPB;
+	if (settings.flow == PortSettings::FLOW_HARDWARE)
+		tio.c_cflag |= CRTSCTS;
+	tio.c_iflag &= ~(IXON | IXOFF | IXANY);
+	if (settings.flow == PortSettings::FLOW_SOFTWARE)
+		tio.c_iflag |= IXON | IXOFF;
+	tio.c_cc[VMIN] = 1;
+	tio.c_cc[VTIME] = 0;
+	if (tcsetattr(_fd, TCSANOW, &tio) != 0)
+		return false;
+	_settings = settings;
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Settings
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Settings(PortSettings &settings) const;
+--					-PortSettings &settings: Set to the line parameters in effect
+--
+-- RETURNS: false when the tty is not open
+--
+-- NOTES:
+--	Returns the settings last configured.
+----------------------------------------------------------------------------------------------------------------------*/
+bool PosixTransport::Settings(PortSettings &settings) const
+{
+	settings = _settings;
+	return _fd >= 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Read
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: long Read(char *buf, size_t len);
+--					-char *buf:		Receives the bytes
+--					-size_t len:	Most bytes to read
+--
+-- RETURNS: Bytes read, 0 when cancelled, -1 on error or hangup
+--
+-- NOTES:
+--	Reads what the tty has, up to len bytes, waiting for input first when there is none.
+----------------------------------------------------------------------------------------------------------------------*/
+long PosixTransport::Read(char *buf, size_t len)
+{
+	ssize_t n;
+	int ready;
+	if (Cancelled())
+		return 0;
+	for (;;)
+	{
+		if ((n = read(_fd, buf, len)) > 0)
+			return (long)n;
+		if (n == 0 || (errno != EAGAIN && errno != EINTR))	//Hung up, e.g. the other side of a pty closed
+			return -1;
+		if ((ready = Await(_readPoll)) != _fd)
+			return ready == _cancel ? 0 : -1;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Write
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: long Write(const char *buf, size_t len);
+--					-const char *buf:	Bytes to send
+--					-size_t len:		Number of bytes in buf
+--
+-- RETURNS: len once everything is written, 0 when aborted or cancelled, -1 on error
+--
+-- NOTES:
+--	Writes as much as the tty takes and waits for room for the rest. An AbortWrite made before the write started
+--	is stale and is thrown away first.
+----------------------------------------------------------------------------------------------------------------------*/
+long PosixTransport::Write(const char *buf, size_t len)
+{
+	uint64_t	count;
+	size_t		sent = 0;
+	ssize_t		n;
+	int			ready;
+	if (Cancelled())
+		return 0;
+	while (read(_abort, &count, sizeof(count)) > 0)
+		;
+	while (sent < len)
+	{
+		if ((n = write(_fd, buf + sent, len - sent)) > 0)
+		{
+			sent += n;
+			continue;
+		}
+		if (n < 0 && errno != EAGAIN && errno != EINTR)
+			return -1;
+		if ((ready = Await(_writePoll)) != _fd)
+		{
+			if (ready == _abort)
+				read(_abort, &count, sizeof(count));
+			return ready < 0 ? -1 : 0;
+		}
+	}
+	return (long)sent;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: AbortWrite
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID AbortWrite();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Drops what the tty holds to transmit and wakes the write in progress, which returns 0.
+----------------------------------------------------------------------------------------------------------------------*/
+void PosixTransport::AbortWrite()
+{
+	uint64_t one = 1;
+	tcflush(_fd, TCOFLUSH);
+	write(_abort, &one, sizeof(one));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Cancel
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Cancel();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Signals the cancel eventfd. Read and Write return 0 from then on, until the tty is opened again.
+----------------------------------------------------------------------------------------------------------------------*/
+void PosixTransport::Cancel()
+{
+	uint64_t one = 1;
+	write(_cancel, &one, sizeof(one));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Close
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Close();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Closes the tty, which also takes it out of both epoll instances. Called once Read and Write are no longer in
+--	use.
+----------------------------------------------------------------------------------------------------------------------*/
+void PosixTransport::Close()
+{
+	if (_fd >= 0)
+	{
+		tcflush(_fd, TCIFLUSH);					//Clean out the buffer
+		close(_fd);
+		_fd = -1;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Register
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Registers through IoLoop::Watch, without a cast to the concrete loop
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Register(IoLoop &loop, IoLoop::Key key);
+--					-IoLoop &loop:		The platform's loop, an EpollLoop
+--					-IoLoop::Key key:	Reported by loop for the tty
+--
+-- RETURNS: false when the tty is not open or the loop refused it
+--
+-- NOTES:
+--	Has the loop watch the tty. Input that is already waiting is reported at once.
+----------------------------------------------------------------------------------------------------------------------*/
+bool PosixTransport::Register(IoLoop &loop, IoLoop::Key key)
+{
+	if (_fd < 0 || !loop.Watch(_fd, key))
+		return false;
+	_loop = &loop;
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ReadReady
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: long ReadReady(char *buf, size_t len);
+--					-char *buf:		Receives the bytes
+--					-size_t len:	Most bytes to read
+--
+-- RETURNS: Bytes read, 0 when the tty has none, -1 on error or hangup
+--
+-- NOTES:
+--	One non-blocking read. Returning 0 means the read hit EAGAIN, which re-arms the tty in the loop.
+----------------------------------------------------------------------------------------------------------------------*/
+long PosixTransport::ReadReady(char *buf, size_t len)
+{
+	ssize_t n;
+	while ((n = read(_fd, buf, len)) < 0 && errno == EINTR)
+		;
+	if (n > 0)
+		return (long)n;
+	return n < 0 && errno == EAGAIN ? 0 : -1;		//0 bytes or EIO: hung up
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: WriteReady
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: long WriteReady(const char *buf, size_t len);
+--					-const char *buf:	Bytes to send
+--					-size_t len:		Number of bytes in buf
+--
+-- RETURNS: Bytes the tty took, 0 when it has no room, -1 on error
+--
+-- NOTES:
+--	One non-blocking write. It may take only part of buf; the caller calls again with the rest, and gets 0 once
+--	the tty is full, which re-arms it.
+----------------------------------------------------------------------------------------------------------------------*/
+long PosixTransport::WriteReady(const char *buf, size_t len)
+{
+	ssize_t n;
+	while ((n = write(_fd, buf, len)) < 0 && errno == EINTR)
+		;
+	if (n >= 0)
+		return (long)n;
+	return errno == EAGAIN ? 0 : -1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Unregister
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Unregister();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Takes the tty out of the loop's epoll instance. Nothing is outstanding, so nothing has to be waited for.
+----------------------------------------------------------------------------------------------------------------------*/
+void PosixTransport::Unregister()
+{
+	if (_loop != NULL && _fd >= 0)
+		_loop->Unwatch(_fd);
+	_loop = NULL;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Await
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int Await(int poll);
+--					-int poll: _readPoll or _writePoll
+--
+-- RETURNS: The descriptor that is ready, preferring _cancel, then _abort, then the tty; -1 on error
+--
+-- NOTES:
+--	Waits without a timeout; Cancel is what ends the wait when nothing else happens.
+----------------------------------------------------------------------------------------------------------------------*/
+int PosixTransport::Await(int poll)
+{
+	struct epoll_event	ev[3];
+	int					n, ready = -1;
+	while ((n = epoll_wait(poll, ev, 3, -1)) < 0)
+		if (errno != EINTR)
+			return -1;
+	for (int i = 0; i < n; ++i)
+		if (ev[i].data.fd == _cancel || (ev[i].data.fd == _abort && ready != _cancel) || ready < 0)
+			ready = ev[i].data.fd;
+	return ready;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Cancelled
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Cancelled() const;
+--
+-- RETURNS: true when Cancel was called since the tty was opened
+--
+-- NOTES:
+--	Polls the cancel eventfd without consuming it, so Read and Write give up before touching a tty that still has
+--	data or room.
+----------------------------------------------------------------------------------------------------------------------*/
+bool PosixTransport::Cancelled() const
+{
+	struct pollfd pfd = { _cancel, POLLIN, 0 };
+	return poll(&pfd, 1, 0) > 0;
+}
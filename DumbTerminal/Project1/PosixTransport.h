@@ -0,0 +1,79 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: PosixTransport.h - Serial port transport on a POSIX tty with termios and epoll for the dumb
+--			terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- PosixTransport();
+-- ~PosixTransport();
+-- bool Open(const char *name);
+-- bool Configure(const PortSettings &settings);
+-- bool Settings(PortSettings &settings) const;
+-- long Read(char *buf, size_t len);
+-- long Write(const char *buf, size_t len);
+-- VOID AbortWrite();
+-- VOID Cancel();
+-- VOID Close();
+-- bool Register(IoLoop &loop, IoLoop::Key key);
+-- long ReadReady(char *buf, size_t len);
+-- long WriteReady(const char *buf, size_t len);
+-- VOID Unregister();
+-- int Await(int poll);
+-- bool Cancelled() const;
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Can be serviced by an EpollLoop
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Linux counterpart of Win32Transport, built by CMakeLists.txt and not by the Visual Studio project. The tty is
+--	opened non-blocking and put in raw mode. Read and Write each wait in an epoll instance of their own: the
+--	reader's watches the tty for input, the writer's for room to write, and both watch an eventfd that Cancel
+--	signals and leaves signalled until the next Open. The writer's also watches a second eventfd for AbortWrite,
+--	which the write in progress consumes. Any tty works, including the slave side of an openpty pair.
+--
+--	Registered with an EpollLoop the tty is added to the loop's epoll instance as well, edge-triggered, and
+--	ReadReady and WriteReady are a single non-blocking read or write: EAGAIN is what re-arms the tty, so they
+--	return 0 for it and the loop reports the tty again once it has input or room.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef POSIXTRANSPORT_H
+#define POSIXTRANSPORT_H
+#include "Transport.h"
+class PosixTransport : public Transport
+{
+public:
+	PosixTransport();
+	~PosixTransport();
+	bool	Open(const char *name);
+	bool	Configure(const PortSettings &settings);
+	bool	Settings(PortSettings &settings) const;
+	long	Read(char *buf, size_t len);
+	long	Write(const char *buf, size_t len);
+	void	AbortWrite();
+	void	Cancel();
+	void	Close();
+	bool	Register(IoLoop &loop, IoLoop::Key key);
+	long	ReadReady(char *buf, size_t len);
+	long	WriteReady(const char *buf, size_t len);
+	void	Unregister();
+
+private:
+	int		Await(int poll);				//Wait for the tty, Cancel or AbortWrite
+	bool	Cancelled() const;				//Cancel called since Open
+
+	int				_fd;					//The tty, -1 when closed
+	int				_cancel;				//eventfd signalled by Cancel
+	int				_abort;					//eventfd signalled by AbortWrite
+	int				_readPoll;				//epoll of the reader: tty input and _cancel
+	int				_writePoll;				//epoll of the writer: tty output, _cancel and _abort
+	PortSettings	_settings;				//Last settings configured
+	IoLoop			*_loop;					//Loop the tty is registered with, NULL when none
+};
+#endif
@@ -0,0 +1,439 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: QueueTest.cpp - Tests of the queues between the threads of the dumb terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- int main();
+-- static unsigned char Pattern(unsigned long long i);
+-- static VOID Test_Ring_Limits();
+-- static VOID Test_Ring_Threads();
+-- static VOID Test_Send_Spans();
+-- static VOID Test_Send_File();
+-- static VOID Test_Send_Short_Write();
+-- static VOID Test_Send_Failed_Write();
+-- static VOID Test_Send_Close();
+-- static VOID Test_Send_Detach();
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Built by CMakeLists.txt as dtqueuetest and run by ctest. Covers a session's RingBuffer, on one thread at
+--	its limits and between a producer and a consumer thread that push 16MB through it, and its SendQueue as
+--	SessionManager uses it: typed bytes gathered into chunks ahead of the file, the file taken in place, and
+--	what happens to the file when a write only gets part of a chunk out or fails.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "Check.h"
+#include "RingBuffer.h"
+#include "SendQueue.h"
+static const unsigned long long	STREAM_BYTES = 16ULL << 20;	//Bytes passed between the ring's two threads
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Pattern
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static unsigned char Pattern(unsigned long long i);
+--					-unsigned long long i: Position in the stream
+--
+-- RETURNS: The byte at that position, which does not repeat with any power of two up to 2^32
+----------------------------------------------------------------------------------------------------------------------*/
+static unsigned char Pattern(unsigned long long i)
+{
+	return (unsigned char)(i * 2654435761ULL >> 13 ^ i);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_Ring_Limits
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_Ring_Limits();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	The capacity is rounded up to a power of two, a write takes what fits and no more, and bytes come out in
+--	order across the end of the storage.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_Ring_Limits()
+{
+	RingBuffer	ring(100);
+	char		in[256], out[256];
+	for (size_t i = 0; i < sizeof(in); ++i)
+		in[i] = (char)Pattern(i);
+	CHECK(ring.Capacity() == 128);
+	CHECK(ring.Size() == 0 && ring.Free() == 128);
+	CHECK(ring.Write(in, 200) == 128);						//Full, the rest stays with the caller
+	CHECK(ring.Write(in, 1) == 0);
+	CHECK(ring.Size() == 128 && ring.Free() == 0);
+	CHECK(ring.Read(out, 100) == 100 && memcmp(out, in, 100) == 0);
+	CHECK(ring.Write(in + 128, 90) == 90);					//Wraps around the end of the storage
+	CHECK(ring.Read(out, sizeof(out)) == 118);
+	CHECK(memcmp(out, in + 100, 118) == 0);
+	CHECK(ring.Read(out, sizeof(out)) == 0);
+	ring.Write(in, 10);
+	ring.Clear();
+	CHECK(ring.Size() == 0 && ring.Free() == 128);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_Ring_Threads
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_Ring_Threads();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	A producer thread writes STREAM_BYTES in chunks of varying size into a small ring while the consumer reads them in
+--	chunks of other sizes, as SessionManager and the UI thread do with a session's ring. Every byte has to come out
+--	once and in order; the ring is small so both sides keep finding it full and empty.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_Ring_Threads()
+{
+	RingBuffer			ring(4096);
+	std::atomic<bool>	mismatch(false);
+	std::thread producer([&ring]
+	{
+		char buf[1500];
+		for (unsigned long long sent = 0, size = 1, n; sent < STREAM_BYTES; sent += n, size = size * 7 % 1499 + 1)
+		{
+			n = size < STREAM_BYTES - sent ? size : STREAM_BYTES - sent;
+			for (unsigned long long i = 0; i < n; ++i)
+				buf[i] = (char)Pattern(sent + i);
+			for (size_t done = 0; done < n; )
+			{
+				size_t w = ring.Write(buf + done, (size_t)n - done);
+				if (w == 0)
+					std::this_thread::yield();
+				done += w;
+			}
+		}
+	});
+	char out[2000];
+	unsigned long long received = 0;
+	for (size_t size = 1; received < STREAM_BYTES; size = size * 13 % 1999 + 1)
+	{
+		size_t n = ring.Read(out, size);
+		if (n == 0)
+			std::this_thread::yield();
+		for (size_t i = 0; i < n; ++i)
+			if ((unsigned char)out[i] != Pattern(received + i))
+				mismatch = true;
+		received += n;
+	}
+	producer.join();
+	CHECK(received == STREAM_BYTES);
+	CHECK(!mismatch);
+	CHECK(ring.Size() == 0);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_Send_Spans
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_Send_Spans();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Keystrokes pushed one at a time go out together, a paste larger than a chunk goes out in full chunks, and
+--	nothing is taken twice.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_Send_Spans()
+{
+	SendQueue			queue;
+	std::vector<char>	scratch, paste(2500, 'p');
+	const char			*data;
+	queue.Push("x", 1);										//Closed until opened, dropped
+	queue.Open();
+	CHECK(queue.Poll(data, scratch, 1024) == 0);
+	queue.Push("a", 1);
+	queue.Push("b", 1);
+	queue.Push("cd", 2);
+	CHECK(queue.Pending() == 4);
+	CHECK(queue.Take(data, scratch, 1024) == 4 && memcmp(data, "abcd", 4) == 0);
+	CHECK(queue.TakenAt() != 0);
+	CHECK(!queue.Written(4, false));						//Typed bytes never end a file send
+	queue.Push(paste.data(), paste.size());
+	queue.Push("e", 1);
+	CHECK(queue.Take(data, scratch, 1024) == 1024);
+	CHECK(queue.Take(data, scratch, 1024) == 1024);
+	CHECK(queue.Take(data, scratch, 1024) == 453 && data[451] == 'p' && data[452] == 'e');
+	CHECK(queue.Pending() == 0);
+	CHECK(queue.Poll(data, scratch, 1024) == 0);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_Send_File
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_Send_File();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	The file is taken in place, chunk by chunk; a keystroke pushed in the middle goes out before the next chunk;
+--	the last Written reports the end of the file, and Detach returns at once when no write is in progress.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_Send_File()
+{
+	SendQueue			queue;
+	std::vector<char>	file(10000), scratch;
+	const char			*data;
+	size_t				sent = 0, total = 0, n;
+	bool				done = false;
+	for (size_t i = 0; i < file.size(); ++i)
+		file[i] = (char)Pattern(i);
+	queue.Open();
+	queue.Attach(file.data(), file.size());
+	CHECK(queue.Take(data, scratch, 4096) == 4096 && data == file.data());
+	CHECK(queue.TakenAt() == 0);
+	CHECK(!queue.Written(4096, false));
+	queue.Push("k", 1);
+	CHECK(queue.Take(data, scratch, 4096) == 1 && *data == 'k');	//Keystrokes first
+	queue.Written(1, false);
+	while (!done && (n = queue.Take(data, scratch, 4096)) > 0)
+	{
+		CHECK(data == file.data() + 4096 + sent);
+		sent += n;
+		done = queue.Written(n, false);
+	}
+	CHECK(done && sent == file.size() - 4096);
+	queue.Progress(sent, total);
+	CHECK(sent == file.size() && total == file.size());
+	CHECK(queue.Detach(0));
+	CHECK(queue.Poll(data, scratch, 4096) == 0);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_Send_Short_Write
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_Send_Short_Write();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	A write that only gets part of a chunk of the file out leaves the rest to be taken again, so the file still
+--	goes out whole and the send still finishes.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_Send_Short_Write()
+{
+	SendQueue			queue;
+	std::vector<char>	file(1000), scratch;
+	const char			*data;
+	size_t				sent = 0, total = 0, n;
+	bool				done = false;
+	queue.Open();
+	queue.Attach(file.data(), file.size());
+	CHECK(queue.Take(data, scratch, 400) == 400);
+	CHECK(!queue.Written(150, false));
+	CHECK(queue.Take(data, scratch, 400) == 400 && data == file.data() + 150);
+	CHECK(!queue.Written(0, false));
+	while (!done && (n = queue.Take(data, scratch, 400)) > 0)
+		done = queue.Written(n / 2 + 1, false);				//Every write gets only half out
+	CHECK(done);
+	queue.Progress(sent, total);
+	CHECK(sent == total && total == file.size());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_Send_Failed_Write
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_Send_Failed_Write();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	A write of the file that fails ends the send: Written reports it over, so the UI ends it, no more of the file
+--	is taken while keystrokes still are, and the next file starts afresh.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_Send_Failed_Write()
+{
+	SendQueue			queue;
+	std::vector<char>	file(1000), scratch;
+	const char			*data;
+	size_t				sent = 0, total = 0;
+	queue.Open();
+	queue.Attach(file.data(), file.size());
+	CHECK(queue.Take(data, scratch, 400) == 400);
+	CHECK(queue.Written(100, true));
+	CHECK(queue.Poll(data, scratch, 400) == 0);
+	queue.Push("k", 1);
+	CHECK(queue.Take(data, scratch, 400) == 1);
+	queue.Written(1, false);
+	queue.Progress(sent, total);
+	CHECK(sent == 100 && total == file.size());
+	CHECK(queue.Detach(0));
+	queue.Attach(file.data(), file.size());
+	CHECK(queue.Take(data, scratch, 400) == 400 && data == file.data());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_Send_Close
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_Send_Close();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	A writer asleep in Take is woken by a Push from another thread, and by Close, which makes it return 0 and
+--	throws away what was not taken.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_Send_Close()
+{
+	SendQueue			queue;
+	std::atomic<int>	taken(-1);
+	queue.Open();
+	std::thread writer([&queue, &taken]
+	{
+		std::vector<char>	scratch;
+		const char			*data;
+		size_t				n;
+		while ((n = queue.Take(data, scratch, 64)) > 0)
+		{
+			taken = (int)n;
+			queue.Written(n, false);
+		}
+		taken = 0;
+	});
+	queue.Push("abc", 3);
+	for (int i = 0; i < 1000 && taken != 3; ++i)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	CHECK(taken == 3);
+	queue.Close();
+	writer.join();
+	CHECK(taken == 0);
+	queue.Push("x", 1);
+	CHECK(queue.Pending() == 0);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_Send_Detach
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_Send_Detach();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Detach waits for a write still in progress from the file, and lets go once it was reported written.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_Send_Detach()
+{
+	SendQueue			queue;
+	std::vector<char>	file(100), scratch;
+	const char			*data;
+	queue.Open();
+	queue.Attach(file.data(), file.size());
+	CHECK(queue.Take(data, scratch, 64) == 64);
+	CHECK(!queue.Detach(10));								//The chunk is still being written
+	queue.Written(64, false);
+	CHECK(queue.Detach(0));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: main
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int main();
+--
+-- RETURNS: 0 when every check passed, 1 otherwise
+----------------------------------------------------------------------------------------------------------------------*/
+int main()
+{
+	Test_Ring_Limits();
+	Test_Ring_Threads();
+	Test_Send_Spans();
+	Test_Send_File();
+	Test_Send_Short_Write();
+	Test_Send_Failed_Write();
+	Test_Send_Close();
+	Test_Send_Detach();
+	return Check_Summary("dtqueuetest");
+}
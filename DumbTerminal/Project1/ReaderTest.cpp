@@ -0,0 +1,217 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: ReaderTest.cpp - Tests of the reader thread of the dumb terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- int main();
+-- static bool Wait_Received(Owner &owner);
+-- static VOID Test_Cycles(int cycles);
+-- static VOID Test_Full_Ring(size_t ringSize, size_t take);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - The cycles also check that handles and memory stay flat
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Built by CMakeLists.txt as dtreadertest and run by ctest. A LoopbackTransport stands in for the port. The
+--	first test connects and disconnects the reader ten thousand times, a byte going through each time, and
+--	checks that every Start and Stop returns and that the process holds no more handles or memory at the end than
+--	after the first few cycles. The second keeps a tiny RingBuffer full while the owner takes the
+--	bytes out a few at a time, so the reader waits for room over and over: a wake that Receive loses leaves the
+--	reader asleep with room to fill, and shows up here as a wait for Received that times out.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Check.h"
+#include "Headless.h"
+#include "LoopbackTransport.h"
+#include "PortReader.h"
+#include "RingBuffer.h"
+static const int	WAIT_MS = 5000;						//Longest a test waits for the reader before failing
+static const int	WARMUP_CYCLES = 100;				//Cycles before the handles and memory are sampled
+static const size_t	MEMORY_SLACK = 1 << 20;				//Growth of the memory allowed over the cycles
+
+class Owner : public ReaderListener
+{
+public:
+	Owner() : received(false), failed(false) {}
+	void	Received() { std::lock_guard<std::mutex> guard(lock); received = true; changed.notify_one(); }
+	void	Failed() { std::lock_guard<std::mutex> guard(lock); failed = true; changed.notify_one(); }
+
+	std::mutex				lock;
+	std::condition_variable	changed;				//Signalled by Received and Failed
+	bool					received;				//Received was called, cleared by Wait_Received
+	bool					failed;
+};
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Wait_Received
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static bool Wait_Received(Owner &owner);
+--					-Owner &owner: Listener of the reader
+--
+-- RETURNS: false when the reader failed or did not call Received within WAIT_MS
+--
+-- NOTES:
+--	Takes the notification, so the next call waits for the next one, as the window's message loop would.
+----------------------------------------------------------------------------------------------------------------------*/
+static bool Wait_Received(Owner &owner)
+{
+	std::unique_lock<std::mutex> guard(owner.lock);
+	if (!owner.changed.wait_for(guard, std::chrono::milliseconds(WAIT_MS),
+		[&owner] { return owner.received || owner.failed; }) || owner.failed)
+		return false;
+	owner.received = false;
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_Cycles
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Samples the handles and memory after the warmup and at the end
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_Cycles(int cycles);
+--					-int cycles: Connections to make
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Connects the way Connect does and disconnects the way Disconnect does, half the time with the byte still
+--	in the RingBuffer. Start has to find it empty again. A thread, a handle or a buffer left behind by each cycle
+--	shows up as growth between the sample after WARMUP_CYCLES and the one at the end.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_Cycles(int cycles)
+{
+	RingBuffer			ring(64);
+	PortReader			reader(ring, 16);
+	LoopbackTransport	port(64);
+	Owner				owner;
+	int					ok = 0;
+	size_t				baseHandles = 0, baseBytes = 0, handles = 0, bytes = 0;
+	bool				sampled = false;
+	for (int i = 0; i < cycles; ++i)
+	{
+		char c = (char)i, got = 0;
+		if (i == WARMUP_CYCLES)
+			sampled = Sample_Resources(baseHandles, baseBytes);
+		if (!port.Open("loop") || !reader.Start(port, owner, NULL))
+			break;
+		if (port.Write(&c, 1) == 1 && Wait_Received(owner))
+			ok += i % 2 == 0 || (reader.Receive(&got, 1) == 1 && got == c);		//Odd cycles take the byte
+		reader.Stop();
+		port.Close();
+		if (reader.Running())
+			break;
+	}
+	CHECK(ok == cycles);
+	CHECK(!reader.Running() && !owner.failed);
+	if (sampled && CHECK(Sample_Resources(handles, bytes)))
+	{
+		CHECK(handles <= baseHandles && bytes <= baseBytes + MEMORY_SLACK);
+		printf("%d cycles: %zu to %zu handles, %zu to %zu KB\n", cycles - WARMUP_CYCLES, baseHandles, handles,
+			baseBytes >> 10, bytes >> 10);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_Full_Ring
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_Full_Ring(size_t ringSize, size_t take);
+--					-size_t ringSize:	Capacity of the RingBuffer
+--					-size_t take:		Most bytes the owner takes at a time
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	A writer thread pushes numbered bytes through the loopback as fast as it takes them. The owner only takes
+--	bytes after Received, and until Receive finds none, so the reader has to be woken every time it fills the
+--	RingBuffer. Every byte has to arrive, in order.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_Full_Ring(size_t ringSize, size_t take)
+{
+	const size_t		TOTAL = 1 << 20;
+	RingBuffer			ring(ringSize);
+	PortReader			reader(ring, ringSize);
+	LoopbackTransport	port(256);
+	Owner				owner;
+	std::vector<char>	buf(take);
+	size_t				got = 0, wrong = 0, n;
+	port.Open("loop");
+	if (!CHECK(reader.Start(port, owner, NULL)))
+		return;
+	std::thread writer([&port, TOTAL]
+	{
+		char chunk[100];
+		for (size_t sent = 0; sent < TOTAL; sent += sizeof chunk)
+		{
+			for (size_t i = 0; i < sizeof chunk; ++i)
+				chunk[i] = (char)((sent + i) % 251);
+			if (port.Write(chunk, sent + sizeof chunk <= TOTAL ? sizeof chunk : TOTAL - sent) <= 0)
+				return;
+		}
+	});
+	while (got < TOTAL && Wait_Received(owner))
+		while ((n = reader.Receive(buf.data(), buf.size())) > 0)
+			for (size_t i = 0; i < n; ++i, ++got)
+				wrong += buf[i] != (char)(got % 251);
+	CHECK(got == TOTAL && wrong == 0);
+	reader.Stop();											//Also wakes the writer when the reader was lost
+	port.Close();
+	writer.join();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: main
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int main();
+--
+-- RETURNS: 0 when every check passed, 1 otherwise
+----------------------------------------------------------------------------------------------------------------------*/
+int main()
+{
+	Test_Cycles(10000);
+	Test_Full_Ring(16, 1);
+	Test_Full_Ring(16, 7);
+	Test_Full_Ring(1024, 1000);
+	return Check_Summary("dtreadertest");
+}
@@ -0,0 +1,329 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: RenderTarget.cpp - Actual function implementation of MemoryRenderTarget in RenderTarget.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- MemoryRenderTarget(const MetricsCache &metrics, int width, int height);
+-- VOID Resize(int width, int height);
+-- VOID Fill(int left, int top, int right, int bottom);
+-- VOID DrawRun(int x, int y, const unsigned int *text, int len, unsigned long color);
+-- VOID DrawCells(int x, int y, const unsigned int *text, int len, int pitch, unsigned long color);
+-- VOID Scroll(int dy);
+-- VOID FillClipped(int left, int top, int right, int bottom, unsigned long color);
+-- unsigned long Xterm_Color(unsigned int index);
+-- unsigned long Run_Background(unsigned long color);
+-- unsigned long Run_Ink(unsigned long color);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Scroll moves what is already composed when the view scrolls
+--			  October 17, 2026 - Decodes the text color of a run color
+--			  October 17, 2026 - Runs are Unicode code points
+--			  October 17, 2026 - Fixed pitch runs
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Headless render target that composes frames into memory.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <cstring>
+#include "RenderTarget.h"
+const unsigned long MemoryRenderTarget::BACKGROUND;
+const unsigned long MemoryRenderTarget::INK;
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: MemoryRenderTarget
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: MemoryRenderTarget(const MetricsCache &metrics, int width, int height);
+--					-const MetricsCache &metrics:	Cell sizes used to lay out runs
+--					-int width:						Width of the bitmap in pixels
+--					-int height:					Height of the bitmap in pixels
+--
+-- RETURNS: N/A
+----------------------------------------------------------------------------------------------------------------------*/
+MemoryRenderTarget::MemoryRenderTarget(const MetricsCache &metrics, int width, int height)
+	: _metrics(metrics), _width(0), _height(0)
+{
+	Resize(width, height);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Resize
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Resize(int width, int height);
+--					-int width:		New width of the bitmap in pixels
+--					-int height:	New height of the bitmap in pixels
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Reallocates the bitmap and clears it to the background color.
+----------------------------------------------------------------------------------------------------------------------*/
+void MemoryRenderTarget::Resize(int width, int height)
+{
+	_width = width > 0 ? width : 0;
+	_height = height > 0 ? height : 0;
+	_pixels.assign((size_t)_width * _height, BACKGROUND);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Fill
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Fill(int left, int top, int right, int bottom);
+--					-int left, top, right, bottom: Rectangle to clear, right and bottom exclusive
+--
+-- RETURNS: VOID
+----------------------------------------------------------------------------------------------------------------------*/
+void MemoryRenderTarget::Fill(int left, int top, int right, int bottom)
+{
+	FillClipped(left, top, right, bottom, BACKGROUND);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: DrawRun
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Glyph pixels take the text color of the run
+--			  October 17, 2026 - Runs are code points
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID DrawRun(int x, int y, const unsigned int *text, int len, unsigned long color);
+--					-int x, y:					Top left corner of the first character
+--					-const unsigned int *text:	Code points of the characters of the run
+--					-int len:					Number of characters
+--					-unsigned long color:		Background color of the run
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Fills each character cell with the background color and puts a pixel of the text color, INK unless the run
+--	color says otherwise, in the middle of every cell that holds something other than a space.
+----------------------------------------------------------------------------------------------------------------------*/
+void MemoryRenderTarget::DrawRun(int x, int y, const unsigned int *text, int len, unsigned long color)
+{
+	int lineHeight = _metrics.LineHeight();
+	unsigned long background = Run_Background(color), ink = Run_Ink(color);
+	for (int i = 0; i < len; ++i)
+	{
+		int advance = _metrics.Advance(text[i]);
+		FillClipped(x, y, x + advance, y + lineHeight, background);
+		if (text[i] != ' ' && advance > 0)
+			FillClipped(x + advance / 2, y + lineHeight / 2, x + advance / 2 + 1, y + lineHeight / 2 + 1, ink);
+		x += advance;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: DrawCells
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID DrawCells(int x, int y, const unsigned int *text, int len, int pitch, unsigned long color);
+--					-int x, y:					Top left corner of the first character
+--					-const unsigned int *text:	Code points of the characters of the run
+--					-int len:					Number of characters
+--					-int pitch:					Pixels from one character to the next
+--					-unsigned long color:		Background and text color of the run
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Same as DrawRun with every cell pitch pixels wide.
+----------------------------------------------------------------------------------------------------------------------*/
+void MemoryRenderTarget::DrawCells(int x, int y, const unsigned int *text, int len, int pitch, unsigned long color)
+{
+	int lineHeight = _metrics.LineHeight();
+	unsigned long background = Run_Background(color), ink = Run_Ink(color);
+	FillClipped(x, y, x + len * pitch, y + lineHeight, background);
+	for (int i = 0; i < len; ++i, x += pitch)
+		if (text[i] != ' ' && pitch > 0)
+			FillClipped(x + pitch / 2, y + lineHeight / 2, x + pitch / 2 + 1, y + lineHeight / 2 + 1, ink);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Scroll
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Scroll(int dy);
+--					-int dy: Pixels to move the contents down by, negative to move them up
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Moves the pixel rows with one memmove. The rows that are exposed keep their old content until they are
+--	composed again.
+----------------------------------------------------------------------------------------------------------------------*/
+void MemoryRenderTarget::Scroll(int dy)
+{
+	if (dy == 0 || dy >= _height || -dy >= _height)
+		return;
+	size_t rows = (size_t)(_height - (dy > 0 ? dy : -dy));
+	unsigned long *base = _pixels.data();
+	if (dy > 0)
+		memmove(base + (size_t)dy * _width, base, rows * _width * sizeof(unsigned long));
+	else
+		memmove(base, base + (size_t)-dy * _width, rows * _width * sizeof(unsigned long));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: FillClipped
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID FillClipped(int left, int top, int right, int bottom, unsigned long color);
+--					-int left, top, right, bottom:	Rectangle to fill, right and bottom exclusive
+--					-unsigned long color:			Color to fill with
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Clips the rectangle to the bitmap before filling it.
+----------------------------------------------------------------------------------------------------------------------*/
+void MemoryRenderTarget::FillClipped(int left, int top, int right, int bottom, unsigned long color)
+{
+	if (left < 0) left = 0;
+	if (top < 0) top = 0;
+	if (right > _width) right = _width;
+	if (bottom > _height) bottom = _height;
+	for (int y = top; y < bottom; ++y)
+		for (int x = left; x < right; ++x)
+			_pixels[(size_t)y * _width + x] = color;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Xterm_Color
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: unsigned long Xterm_Color(unsigned int index);
+--					-unsigned int index: 0 to 255
+--
+-- RETURNS: The color as 0x00BBGGRR
+--
+-- NOTES:
+--	0 to 15 are the 16 ANSI colors, 16 to 231 a 6x6x6 color cube and 232 to 255 a ramp of grays, with the values
+--	xterm uses. Larger indexes wrap around.
+----------------------------------------------------------------------------------------------------------------------*/
+unsigned long Xterm_Color(unsigned int index)
+{
+	static const unsigned long	ANSI[16] =
+	{
+		0x000000, 0x0000CD, 0x00CD00, 0x00CDCD, 0xEE0000, 0xCD00CD, 0xCDCD00, 0xE5E5E5,	//0x00BBGGRR
+		0x7F7F7F, 0x0000FF, 0x00FF00, 0x00FFFF, 0xFF5C5C, 0xFF00FF, 0xFFFF00, 0xFFFFFF
+	};
+	static const unsigned long	LEVEL[6] = { 0, 95, 135, 175, 215, 255 };	//Steps of the color cube
+	index &= 0xFF;
+	if (index < 16)
+		return ANSI[index];
+	if (index >= 232)
+	{
+		unsigned long gray = 8 + (index - 232) * 10;
+		return gray | gray << 8 | gray << 16;
+	}
+	index -= 16;
+	return LEVEL[index / 36] | LEVEL[index / 6 % 6] << 8 | LEVEL[index % 6] << 16;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Run_Background
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: unsigned long Run_Background(unsigned long color);
+--					-unsigned long color: Run color, as passed to DrawRun
+--
+-- RETURNS: The background as 0x00BBGGRR
+----------------------------------------------------------------------------------------------------------------------*/
+unsigned long Run_Background(unsigned long color)
+{
+	return color & 0x00FFFFFF;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Run_Ink
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: unsigned long Run_Ink(unsigned long color);
+--					-unsigned long color: Run color, as passed to DrawRun
+--
+-- RETURNS: The text color as 0x00BBGGRR
+--
+-- NOTES:
+--	MemoryRenderTarget::INK, black, when the top byte is 0, else the xterm color it selects.
+----------------------------------------------------------------------------------------------------------------------*/
+unsigned long Run_Ink(unsigned long color)
+{
+	unsigned int ink = (unsigned int)(color >> 24 & 0xFF);
+	return ink == 0 ? MemoryRenderTarget::INK : Xterm_Color(ink - 1);
+}
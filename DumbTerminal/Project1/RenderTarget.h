@@ -0,0 +1,93 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: RenderTarget.h - Surfaces the terminal can compose its rows onto for the dumb terminal emulator
+--			program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- VOID Fill(int left, int top, int right, int bottom);
+-- VOID DrawRun(int x, int y, const unsigned int *text, int len, unsigned long color);
+-- VOID DrawCells(int x, int y, const unsigned int *text, int len, int pitch, unsigned long color);
+-- VOID Scroll(int dy);
+-- MemoryRenderTarget(const MetricsCache &metrics, int width, int height);
+-- VOID Resize(int width, int height);
+-- unsigned long Pixel(int x, int y) const;
+-- unsigned long Xterm_Color(unsigned int index);
+-- unsigned long Run_Background(unsigned long color);
+-- unsigned long Run_Ink(unsigned long color);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Scroll moves what is already composed when the view scrolls
+--			  October 17, 2026 - Run colors carry the color of the text in their top byte
+--			  October 17, 2026 - Runs are Unicode code points
+--			  October 17, 2026 - DrawCells draws a run at a fixed pitch
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	The terminal composes a frame with two operations: clearing a rectangle to the background and drawing a run
+--	of characters that share a background color. RenderTarget is the interface for those two operations, plus
+--	Scroll, which moves the whole surface up or down so scrolling only has to compose the rows it exposes. In the
+--	program the target is the off-screen back buffer (see BackBuffer.h). MemoryRenderTarget draws into a plain
+--	32-bit pixel array instead, so a frame can be composed and inspected without a display: every character cell
+--	is filled with its background color and a single pixel of the text color marks cells that hold a visible glyph.
+--
+--	A run color is a 0x00BBGGRR background, the way it has always been, with the color of the text in the top
+--	byte, which a COLORREF leaves at 0: 0 is the default black ink and 1 to 255 are one more than an index into
+--	the 256 colors of xterm (Xterm_Color), as set by the escape sequences the terminal receives. Run_Background
+--	and Run_Ink take the two apart; the colors of the menus have no ink and draw exactly as before.
+--
+--	The characters of a run are Unicode code points, one per cell, as the screen model stores them.
+--
+--	DrawCells draws a run the same way but puts a character every pitch pixels, whatever its own advance width,
+--	and fills the background of every cell, so columns line up in the proportional font of the window. The hex
+--	view draws its rows with it.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef RENDERTARGET_H
+#define RENDERTARGET_H
+#include <cstddef>
+#include <vector>
+#include "FontMetrics.h"
+class RenderTarget
+{
+public:
+	virtual ~RenderTarget() {}
+	virtual void	Fill(int left, int top, int right, int bottom) = 0;	//Clear to the background color
+	virtual void	DrawRun(int x, int y, const unsigned int *text, int len, unsigned long color) = 0;	//Code points
+	virtual void	DrawCells(int x, int y, const unsigned int *text, int len, int pitch, unsigned long color) = 0;
+	virtual void	Scroll(int dy) = 0;										//Move the contents down by dy pixels
+};
+
+class MemoryRenderTarget : public RenderTarget
+{
+public:
+	static const unsigned long	BACKGROUND = 0x00FFFFFF;	//White, same as the window
+	static const unsigned long	INK = 0x00000000;			//Default text color, marks a cell with a visible glyph
+
+	MemoryRenderTarget(const MetricsCache &metrics, int width, int height);
+	void			Resize(int width, int height);
+	void			Fill(int left, int top, int right, int bottom);
+	void			DrawRun(int x, int y, const unsigned int *text, int len, unsigned long color);
+	void			DrawCells(int x, int y, const unsigned int *text, int len, int pitch, unsigned long color);
+	void			Scroll(int dy);
+	unsigned long	Pixel(int x, int y) const { return _pixels[(size_t)y * _width + x]; }
+	int				Width() const { return _width; }
+	int				Height() const { return _height; }
+
+private:
+	void			FillClipped(int left, int top, int right, int bottom, unsigned long color);
+
+	const MetricsCache			&_metrics;		//Advance widths and line height of the cells
+	int							_width, _height;
+	std::vector<unsigned long>	_pixels;		//Row-major, one color per pixel
+};
+
+unsigned long	Xterm_Color(unsigned int index);		//0x00BBGGRR of one of the 256 xterm colors
+unsigned long	Run_Background(unsigned long color);	//Background of a run color
+unsigned long	Run_Ink(unsigned long color);			//Text color of a run color, 0x00BBGGRR
+#endif
@@ -0,0 +1,147 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: Replay.cpp - Actual function implementation for Replay.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- FixedMetrics(int cellWidth, int lineHeight, int columns, int rows);
+-- VOID FixedMetrics::AdvanceWidths(int *widths) const;
+-- bool Replay_Headless(const char *path, double speed, Terminal &terminal, RenderTarget &target,
+--						ReplayReport &report);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Headless replay of a capture. See Replay.h.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include "Replay.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: FixedMetrics
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: FixedMetrics(int cellWidth, int lineHeight, int columns, int rows);
+--					-int cellWidth:		Advance width of every character
+--					-int lineHeight:	Height of a line
+--					-int columns:		Cells across the client area
+--					-int rows:			Lines down the client area
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Metrics of a monospace font in a window of a fixed size, e.g. 8 by 16 pixel cells in an 80 by 25 window.
+----------------------------------------------------------------------------------------------------------------------*/
+FixedMetrics::FixedMetrics(int cellWidth, int lineHeight, int columns, int rows)
+	: _cellWidth(cellWidth), _lineHeight(lineHeight), _columns(columns), _rows(rows)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: AdvanceWidths
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID AdvanceWidths(int *widths) const;
+--					-int *widths: Set to the advance width of each of the first MetricsProvider::CHARS characters
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Every character is one cell wide.
+----------------------------------------------------------------------------------------------------------------------*/
+void FixedMetrics::AdvanceWidths(int *widths) const
+{
+	std::fill(widths, widths + CHARS, _cellWidth);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Replay_Headless
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Replay_Headless(const char *path, double speed, Terminal &terminal, RenderTarget &target,
+--						ReplayReport &report);
+--					-const char *path:			Capture file to replay
+--					-double speed:				1 for the original timing, N for N times faster, 0 for no waiting
+--					-Terminal &terminal:		Terminal the received bytes are written to, with its metrics set
+--					-RenderTarget &target:		Surface the frames are composed onto
+--					-ReplayReport &report:		Set to the totals and frame times
+--
+-- RETURNS: false when the file cannot be opened or is not a capture, else true
+--
+-- NOTES:
+--	Writes every received record to the terminal with color 0 and composes what changed, the same steps
+--	Drain_Received and Present_Dirty take for one chunk a session holds. A frame is timed from the write to the end of
+--	the composition; time spent waiting for the next record is not counted in it. Reading stops at the end of what
+--	decodes, so a capture cut short replays up to its last complete chunk.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Replay_Headless(const char *path, double speed, Terminal &terminal, RenderTarget &target,
+	ReplayReport &report)
+{
+	typedef std::chrono::steady_clock Clock;
+	CaptureReader		reader;
+	CaptureRecord		rec;
+	std::vector<double>	frames;					//Microseconds of every frame
+	int					left, top, right, bottom, dy;
+	report = ReplayReport();
+	if (!reader.Open(path))
+		return false;
+	Clock::time_point start = Clock::now();
+	while (reader.Next(rec))
+	{
+		if (rec.dir != CaptureLog::RX || rec.len == 0)
+			continue;
+		if (speed > 0)							//Wait until the record is due
+			std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(
+				std::chrono::duration<double>(reader.Seconds(rec) / speed)));
+		Clock::time_point begin = Clock::now();
+		terminal.ResetFrame();
+		terminal.Write(rec.data, rec.len, 0);
+		if ((dy = terminal.TakeScroll()) != 0)
+			target.Scroll(dy);
+		while (terminal.NextDirty(left, top, right, bottom))
+			terminal.Compose(target, left, top, right, bottom);
+		frames.push_back(std::chrono::duration<double, std::micro>(Clock::now() - begin).count());
+		report.bytes += rec.len;
+	}
+	report.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	report.frames = (unsigned long)frames.size();
+	if (!frames.empty())
+	{
+		std::sort(frames.begin(), frames.end());
+		report.frameP50 = frames[frames.size() / 2];
+		report.frameP99 = frames[frames.size() * 99 / 100];
+		report.frameMax = frames.back();
+	}
+	return true;
+}
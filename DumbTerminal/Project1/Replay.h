@@ -0,0 +1,65 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: Replay.h - Replays a capture into the terminal without a window, for reproducible performance runs
+--			of the dumb terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- FixedMetrics(int cellWidth, int lineHeight, int columns, int rows);
+-- bool Replay_Headless(const char *path, double speed, Terminal &terminal, RenderTarget &target,
+--						ReplayReport &report);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	A replay feeds the received records of a capture (see CaptureLog.h) to the terminal the way the UI thread
+--	does with what a session's port received: each chunk is written and the areas it changed are composed
+--	as one frame. speed 1 keeps the original timing, speed N plays N times faster and speed 0 plays as fast as
+--	possible. Sent records are skipped, as in the window, where they were only echoed.
+--
+--	Replay_Headless runs the whole replay on the calling thread, with no window: the terminal is laid out with
+--	FixedMetrics and composed into any RenderTarget, normally a MemoryRenderTarget. It times every frame, so the
+--	report gives the rate the terminal keeps up with and the spread of frame times for the same traffic every
+--	run. In the program a replay into the window is started from the menu (see Session.h).
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef REPLAY_H
+#define REPLAY_H
+#include <vector>
+#include "CaptureLog.h"
+#include "FontMetrics.h"
+#include "RenderTarget.h"
+#include "Terminal.h"
+class FixedMetrics : public MetricsProvider		//Monospace cells in a fixed client area, no display needed
+{
+public:
+	FixedMetrics(int cellWidth, int lineHeight, int columns, int rows);
+	int		LineHeight() const { return _lineHeight; }
+	void	AdvanceWidths(int *widths) const;
+	int		ClientWidth() const { return _cellWidth * _columns; }
+	int		ClientHeight() const { return _lineHeight * _rows; }
+
+private:
+	int		_cellWidth, _lineHeight, _columns, _rows;
+};
+
+struct ReplayReport
+{
+	unsigned long long	bytes;					//Received bytes written to the terminal
+	unsigned long		frames;					//Chunks written, each composed as one frame
+	double				seconds;				//Wall time of the whole replay
+	double				frameP50;				//Median microseconds to write and compose a frame
+	double				frameP99;
+	double				frameMax;
+};
+
+bool Replay_Headless(const char *path, double speed, Terminal &terminal, RenderTarget &target,
+	ReplayReport &report);
+#endif
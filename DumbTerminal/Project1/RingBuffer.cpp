@@ -0,0 +1,188 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: RingBuffer.cpp - Actual function implementation for RingBuffer.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- RingBuffer(size_t capacity);
+-- size_t Write(const char *buf, size_t len);
+-- size_t Read(char *buf, size_t len);
+-- size_t Size() const;
+-- size_t Free() const;
+-- VOID Clear();
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Lock-free single-producer/single-consumer queue. See RingBuffer.h for the threading rules.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include "RingBuffer.h"
+#include <algorithm>
+#include <cstring>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: RingBuffer
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: RingBuffer(size_t capacity);
+--					-size_t capacity: Minimum number of bytes the buffer can hold
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Allocates the storage once. The capacity is rounded up to the next power of two.
+----------------------------------------------------------------------------------------------------------------------*/
+RingBuffer::RingBuffer(size_t capacity)
+	: _head(0), _tail(0)
+{
+	size_t size = 1;
+	while (size < capacity)
+		size <<= 1;
+	_buffer.resize(size);
+	_mask = size - 1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Write
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Write(const char *buf, size_t len);
+--					-const char *buf:	Bytes to append
+--					-size_t len:		Number of bytes in buf
+--
+-- RETURNS: The number of bytes actually appended, which is less than len when the buffer is full
+--
+-- NOTES:
+--	Must only be called from the producer thread. Copies in at most two pieces when the write wraps around.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t RingBuffer::Write(const char *buf, size_t len)
+{
+	size_t head = _head.load(std::memory_order_relaxed);
+	size_t tail = _tail.load(std::memory_order_acquire);	//See how much the consumer released
+	size_t n = std::min(len, Capacity() - (head - tail));
+	size_t offset = head & _mask;
+	size_t first = std::min(n, Capacity() - offset);		//Bytes before the end of storage
+	memcpy(&_buffer[offset], buf, first);
+	memcpy(&_buffer[0], buf + first, n - first);
+	_head.store(head + n, std::memory_order_release);		//Publish the new bytes
+	return n;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Read
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Read(char *buf, size_t len);
+--					-char *buf:		Destination for the bytes
+--					-size_t len:	Size of buf
+--
+-- RETURNS: The number of bytes copied into buf, 0 when the buffer is empty
+--
+-- NOTES:
+--	Must only be called from the consumer thread.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t RingBuffer::Read(char *buf, size_t len)
+{
+	size_t tail = _tail.load(std::memory_order_relaxed);
+	size_t head = _head.load(std::memory_order_acquire);	//See what the producer published
+	size_t n = std::min(len, head - tail);
+	size_t offset = tail & _mask;
+	size_t first = std::min(n, Capacity() - offset);
+	memcpy(buf, &_buffer[offset], first);
+	memcpy(buf + first, &_buffer[0], n - first);
+	_tail.store(tail + n, std::memory_order_release);		//Hand the space back to the producer
+	return n;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Size
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Size() const;
+--
+-- RETURNS: The number of bytes currently waiting to be read
+----------------------------------------------------------------------------------------------------------------------*/
+size_t RingBuffer::Size() const
+{
+	return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Free
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Free() const;
+--
+-- RETURNS: The number of bytes that can currently be written without overwriting unread data
+----------------------------------------------------------------------------------------------------------------------*/
+size_t RingBuffer::Free() const
+{
+	return Capacity() - Size();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Clear
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Clear();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Discards all unread bytes. Only safe while neither the producer nor the consumer is running.
+----------------------------------------------------------------------------------------------------------------------*/
+void RingBuffer::Clear()
+{
+	_head.store(0, std::memory_order_relaxed);
+	_tail.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,55 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: RingBuffer.h - Fixed-capacity single-producer/single-consumer byte queue between the reader
+--			thread and the UI thread of the dumb terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- RingBuffer(size_t capacity);
+-- size_t Write(const char *buf, size_t len);
+-- size_t Read(char *buf, size_t len);
+-- size_t Size() const;
+-- size_t Free() const;
+-- VOID Clear();
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	The reader thread is the only writer and the UI thread is the only reader, so the two indices can be kept
+--	in atomics without any lock. The capacity is rounded up to a power of two so the indices can run freely and
+--	be masked on access. Write never blocks: it stores as much as fits and returns the number of bytes taken, which
+--	lets the reader leave the rest in the driver's receive queue until the UI thread catches up.
+--
+--	Clear may only be called while no other thread is using the buffer (e.g. after the reader has exited).
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+#include <atomic>
+#include <cstddef>
+#include <vector>
+class RingBuffer
+{
+public:
+	explicit RingBuffer(size_t capacity);
+	size_t	Write(const char *buf, size_t len);	//Producer side: append up to len bytes
+	size_t	Read(char *buf, size_t len);		//Consumer side: take up to len bytes
+	size_t	Size() const;						//Number of bytes waiting to be read
+	size_t	Free() const;						//Number of bytes that can be written
+	size_t	Capacity() const { return _mask + 1; }
+	void	Clear();
+
+private:
+	std::vector<char>	_buffer;				//Storage, capacity is a power of two
+	size_t				_mask;					//Capacity - 1, used to wrap the indices
+	alignas(64) std::atomic<size_t>	_head;		//Total bytes written, owned by the producer
+	alignas(64) std::atomic<size_t>	_tail;		//Total bytes read, owned by the consumer
+};
+#endif
@@ -0,0 +1,301 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: RowIndex.cpp - Actual function implementation for RowIndex.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- RowIndex();
+-- VOID Clear(size_t line = 0);
+-- VOID StartRow(size_t line, size_t col);
+-- VOID PopRow();
+-- VOID MarkDirty(size_t row, int left);
+-- bool NextDirty(size_t &row, int &left);
+-- size_t DropFront(size_t lines, size_t headCells);
+-- size_t Find(size_t line, size_t col) const;
+-- VOID Prepend(const std::vector<Row> &rows);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Rows follow lines dropped from the front of the history
+--			  October 17, 2026 - Rows can be looked up by the cell they show
+--			  October 17, 2026 - Rows can start at any line and earlier lines can be put in front later
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Row layout and dirty tracking. See RowIndex.h.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include "RowIndex.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: RowIndex
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: RowIndex();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Starts with the single empty row of an empty screen model.
+----------------------------------------------------------------------------------------------------------------------*/
+RowIndex::RowIndex()
+{
+	Clear();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Clear
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - The first row can start at any line
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Clear(size_t line = 0);
+--					-size_t line: Line the first row starts at
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Drops all rows and dirty marks and leaves one empty row at the start of the given line.
+----------------------------------------------------------------------------------------------------------------------*/
+void RowIndex::Clear(size_t line)
+{
+	_rows.clear();
+	_dirty.clear();
+	StartRow(line, 0);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: StartRow
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID StartRow(size_t line, size_t col);
+--					-size_t line:	Line of the screen model the new row shows
+--					-size_t col:	First cell of the line on the new row
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Called when a line break is recorded (col 0) or when a line wraps (col of the first cell that did not fit).
+----------------------------------------------------------------------------------------------------------------------*/
+void RowIndex::StartRow(size_t line, size_t col)
+{
+	Row row = { line, col, INT_MAX };
+	_rows.push_back(row);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: PopRow
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID PopRow();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Removes the last row when its first cell or its line break is erased. The first row is never removed.
+----------------------------------------------------------------------------------------------------------------------*/
+void RowIndex::PopRow()
+{
+	if (_rows.size() > 1)
+		_rows.pop_back();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: MarkDirty
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID MarkDirty(size_t row, int left);
+--					-size_t row:	The row that changed
+--					-int left:		Leftmost pixel of the change
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	A row is only queued once no matter how many times it changes before the next NextDirty pass.
+----------------------------------------------------------------------------------------------------------------------*/
+void RowIndex::MarkDirty(size_t row, int left)
+{
+	if (row >= _rows.size())
+		return;
+	if (_rows[row].dirtyLeft == INT_MAX)
+		_dirty.push_back(row);
+	if (left < _rows[row].dirtyLeft)
+		_rows[row].dirtyLeft = left;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: NextDirty
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool NextDirty(size_t &row, int &left);
+--					-size_t &row:	Set to the dirty row
+--					-int &left:		Set to the leftmost pixel of the row that changed
+--
+-- RETURNS: true when a dirty row was returned, false when every row is clean
+--
+-- NOTES:
+--	Marks the returned row clean. Rows that were removed after being marked are skipped.
+----------------------------------------------------------------------------------------------------------------------*/
+bool RowIndex::NextDirty(size_t &row, int &left)
+{
+	while (!_dirty.empty())
+	{
+		row = _dirty.back();
+		_dirty.pop_back();
+		if (row < _rows.size() && _rows[row].dirtyLeft != INT_MAX)
+		{
+			left = _rows[row].dirtyLeft;
+			_rows[row].dirtyLeft = INT_MAX;
+			return true;
+		}
+	}
+	return false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: DropFront
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID DropFront(size_t lines, size_t headCells);
+--					-size_t lines:		Number of lines dropped from the front of the screen model
+--					-size_t headCells:	Number of cells cut from the head of the new first line
+--
+-- RETURNS: Number of rows removed from the front
+--
+-- NOTES:
+--	Removes the rows of the dropped lines and of the cut head, and renumbers the rest to match the trimmed
+--	screen model. The last row is always kept. Rows that were dirty stay dirty under their new numbers.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t RowIndex::DropFront(size_t lines, size_t headCells)
+{
+	size_t first = 0;
+	while (first + 1 < _rows.size() && (_rows[first].line < lines ||
+		(_rows[first].line == lines && _rows[first + 1].line == lines && _rows[first + 1].col <= headCells)))
+		++first;
+	_rows.erase(_rows.begin(), _rows.begin() + first);
+	for (size_t row = 0; row < _rows.size(); ++row)
+	{
+		Row &r = _rows[row];
+		if (r.line == lines)
+			r.col = r.col > headCells ? r.col - headCells : 0;
+		r.line -= lines;
+	}
+	size_t kept = 0;
+	for (size_t i = 0; i < _dirty.size(); ++i)			//Renumber the dirty rows that are left
+		if (_dirty[i] >= first)
+			_dirty[kept++] = _dirty[i] - first;
+	_dirty.resize(kept);
+	return first;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Find
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Find(size_t line, size_t col) const;
+--					-size_t line:	Line of the screen model
+--					-size_t col:	Cell of the line
+--
+-- RETURNS: The row showing the cell, or the last row before it
+--
+-- NOTES:
+--	Rows are in the order of the cells they show, so this is a binary search.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t RowIndex::Find(size_t line, size_t col) const
+{
+	size_t low = 0, high = _rows.size();				//Answer is in [low, high)
+	while (high - low > 1)
+	{
+		size_t mid = low + (high - low) / 2;
+		if (_rows[mid].line < line || (_rows[mid].line == line && _rows[mid].col <= col))
+			low = mid;
+		else
+			high = mid;
+	}
+	return low;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Prepend
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Prepend(const std::vector<Row> &rows);
+--					-const std::vector<Row> &rows: Rows of the lines before the first row, in order
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Used when the lines before the first row were laid out separately. Dirty rows keep their flags under their
+--	new numbers.
+----------------------------------------------------------------------------------------------------------------------*/
+void RowIndex::Prepend(const std::vector<Row> &rows)
+{
+	_rows.insert(_rows.begin(), rows.begin(), rows.end());
+	for (size_t i = 0; i < _dirty.size(); ++i)
+		_dirty[i] += rows.size();
+}
@@ -0,0 +1,70 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: RowIndex.h - Layout of the screen model into window rows for the dumb terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- RowIndex();
+-- VOID Clear(size_t line = 0);
+-- VOID StartRow(size_t line, size_t col);
+-- VOID PopRow();
+-- size_t Count() const;
+-- const Row &Get(size_t row) const;
+-- VOID MarkDirty(size_t row, int left);
+-- bool NextDirty(size_t &row, int &left);
+-- size_t DropFront(size_t lines, size_t headCells);
+-- size_t Find(size_t line, size_t col) const;
+-- VOID Prepend(const std::vector<Row> &rows);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Rows follow lines dropped from the front of the history
+--			  October 17, 2026 - Rows can be looked up by the cell they show
+--			  October 17, 2026 - Rows can start at any line and earlier lines can be put in front later
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	A line in the screen model is displayed on one or more rows of the window, depending on where it wraps.
+--	Each row records the line it belongs to and the first cell it shows, so the cells of any row can be found
+--	without laying out everything before it.
+--
+--	Rows also carry dirty tracking: a row that changed records the leftmost pixel that has to be redrawn, and the
+--	rows that changed are kept in a list so only they are invalidated instead of the whole window.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef ROWINDEX_H
+#define ROWINDEX_H
+#include <climits>
+#include <cstddef>
+#include <vector>
+class RowIndex
+{
+public:
+	struct Row
+	{
+		size_t	line;				//Line of the screen model shown on this row
+		size_t	col;				//First cell of the line shown on this row
+		int		dirtyLeft;			//Leftmost pixel to redraw, INT_MAX when the row is clean
+	};
+
+	RowIndex();
+	void		Clear(size_t line = 0);					//Back to a single row at the start of line
+	void		StartRow(size_t line, size_t col);		//Add a row starting at the given cell
+	void		PopRow();								//Remove the last row
+	size_t		Count() const { return _rows.size(); }
+	const Row	&Get(size_t row) const { return _rows[row]; }
+	void		MarkDirty(size_t row, int left);		//Row has to be redrawn from pixel left onwards
+	bool		NextDirty(size_t &row, int &left);		//Take the next dirty row, false when there are none
+	size_t		DropFront(size_t lines, size_t headCells);	//Follow a trim of the screen model
+	size_t		Find(size_t line, size_t col) const;	//Row showing the given cell
+	void		Prepend(const std::vector<Row> &rows);	//Put the rows of earlier lines in front
+
+private:
+	std::vector<Row>	_rows;			//Every row of the window, top to bottom
+	std::vector<size_t>	_dirty;			//Rows with dirtyLeft set
+};
+#endif
@@ -0,0 +1,464 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: ScaleBench.cpp - Benchmark of the CPU the dumb terminal emulator program spends per open port
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- int main(int argc, char **argv);
+-- static bool Open_Pty(int &master, std::string &slave);
+-- static VOID Feed(const std::vector<int> &masters, unsigned long baud, double seconds, Feeder &feeder);
+-- static double Cpu_Seconds(clockid_t clock);
+-- static Result Measure(const std::string &mode, int ports, const Options &options);
+-- static VOID Print_Result(const Options &options, const std::string &mode, int ports, const Result &result);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Built by CMakeLists.txt as dtscale, on Linux only. Stands a pty in for every port of a rack of consoles: the
+--	program opens the slave side with a PosixTransport, as it would a /dev/ttyUSB, and a feeder thread writes to
+--	every master side at the rate of a line at --baud, a tick's worth every 10ms, for --seconds. Each port count
+--	is measured in two modes:
+--		loop		Every port opened in a SessionManager on one EpollLoop: one I/O thread for all of them, plus
+--					the owner thread that takes what each session received with Receive
+--		threads		One thread per port blocked in PosixTransport::Read, as the PortReader does for the one
+--					port of the window
+--	and reports the CPU the program spent per second of wall time, as a percentage of one core, without the
+--	feeder's own, along with the threads it took and the bytes received per second. The bytes are only counted,
+--	not laid out in a terminal, so what is measured is the cost of servicing the ports.
+--
+--	Arguments: [--ports N,N,...] [--seconds S] [--baud N] [--mode loop|threads] [--label TEXT] [--json]
+--	The ports default to 1,2,4,8,16,32, at most SessionManager::MAX_SESSIONS. --json prints one JSON object per
+--	line, as dtbench does.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+#include "EpollLoop.h"
+#include "PosixTransport.h"
+#include "SessionManager.h"
+static const char	*MODES[] = { "loop", "threads" };
+static const int	TICK_MS = 10;						//Interval the feeder writes at
+
+struct Options
+{
+	std::vector<int>	ports;				//Port counts to measure
+	double				seconds;			//Time each measurement feeds the ports for
+	unsigned long		baud;				//Rate of every line
+	std::string			mode;				//Only this mode, empty for both
+	std::string			label;				//Tag of the JSON lines
+	bool				json;
+};
+
+struct Result
+{
+	double	cpu;						//CPU seconds per wall second, without the feeder's
+	int		threads;					//Threads that serviced the ports
+	double	bytesPerSecond;				//Received by the program
+	double	dropped;					//Bytes the feeder could not write, the pty was full
+};
+
+struct Feeder
+{
+	double				cpu;			//CPU seconds the feeder spent while it fed
+	double				wall;			//and the wall time it fed for
+	unsigned long long	dropped;
+};
+
+class Owner : public SessionListener	//Takes what the sessions received, as the window's UI thread would
+{
+public:
+	Owner() : _manager(NULL), _stop(false), _bytes(0) {}
+	void Start(SessionManager &manager)
+	{
+		_manager = &manager;
+		_thread = std::thread(&Owner::Run, this);
+	}
+	void Stop()
+	{
+		{
+			std::lock_guard<std::mutex> guard(_lock);
+			_stop = true;
+		}
+		_wake.notify_one();
+		_thread.join();
+	}
+	void Received(int id)
+	{
+		{
+			std::lock_guard<std::mutex> guard(_lock);
+			_ready.push_back(id);
+		}
+		_wake.notify_one();
+	}
+	void				Sent(int) {}
+	void				Closed(int) {}
+	unsigned long long	Bytes() const { return _bytes; }
+
+private:
+	void Run()
+	{
+		std::vector<int>	ids;
+		char				buf[4096];
+		size_t				n;
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> guard(_lock);
+				_wake.wait(guard, [this] { return _stop || !_ready.empty(); });
+				if (_stop)
+					return;
+				ids.swap(_ready);
+			}
+			for (int id : ids)
+				while ((n = _manager->Receive(id, buf, sizeof(buf))) > 0)
+					_bytes += n;
+			ids.clear();
+		}
+	}
+
+	SessionManager						*_manager;
+	std::mutex							_lock;
+	std::condition_variable				_wake;
+	std::vector<int>					_ready;			//Sessions Received was called for
+	bool								_stop;
+	std::atomic<unsigned long long>		_bytes;
+	std::thread							_thread;
+};
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Open_Pty
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static bool Open_Pty(int &master, std::string &slave);
+--					-int &master:			Set to the master side, non-blocking
+--					-std::string &slave:	Set to the path of the slave side
+--
+-- RETURNS: false when no pty could be allocated
+----------------------------------------------------------------------------------------------------------------------*/
+static bool Open_Pty(int &master, std::string &slave)
+{
+	const char *name;
+	if ((master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK)) < 0)
+		return false;
+	if (grantpt(master) != 0 || unlockpt(master) != 0 || (name = ptsname(master)) == NULL)
+	{
+		close(master);
+		return false;
+	}
+	slave = name;
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Cpu_Seconds
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static double Cpu_Seconds(clockid_t clock);
+--					-clockid_t clock: CLOCK_PROCESS_CPUTIME_ID or CLOCK_THREAD_CPUTIME_ID
+--
+-- RETURNS: CPU time used by the process or the calling thread, in seconds
+----------------------------------------------------------------------------------------------------------------------*/
+static double Cpu_Seconds(clockid_t clock)
+{
+	struct timespec ts;
+	clock_gettime(clock, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Feed
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Feed(const std::vector<int> &masters, unsigned long baud, double seconds,
+--						Feeder &feeder);
+--					-const std::vector<int> &masters:	Master sides of the ptys
+--					-unsigned long baud:				Rate of every line
+--					-double seconds:					Time to feed for
+--					-Feeder &feeder:					Receives the CPU and wall time spent, and the bytes dropped
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	The feeder thread. Every TICK_MS it writes what the line carries in a tick, ten bits to the byte, to every
+--	master, on an absolute schedule so slow ticks do not make the rate drift. Log lines of printable text are
+--	written, which is what the consoles send most of the time. What a full pty does not take is dropped.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Feed(const std::vector<int> &masters, unsigned long baud, double seconds, Feeder &feeder)
+{
+	typedef std::chrono::steady_clock Clock;
+	size_t				perTick = baud / 10 * TICK_MS / 1000;
+	std::vector<char>	text(perTick > 0 ? perTick : 1);
+	struct timespec		next;
+	ssize_t				n;
+	long				ticks = (long)(seconds * 1000 / TICK_MS);
+	for (size_t i = 0; i < text.size(); ++i)
+		text[i] = i % 80 == 78 ? '\r' : i % 80 == 79 ? '\n' : (char)('!' + i % 94);
+	feeder.dropped = 0;
+	double				cpu = Cpu_Seconds(CLOCK_THREAD_CPUTIME_ID);
+	Clock::time_point	start = Clock::now();
+	clock_gettime(CLOCK_MONOTONIC, &next);
+	for (long tick = 0; tick < ticks; ++tick)
+	{
+		for (int master : masters)
+			if ((n = write(master, text.data(), text.size())) < (ssize_t)text.size())
+				feeder.dropped += text.size() - (n > 0 ? n : 0);
+		if ((next.tv_nsec += TICK_MS * 1000000L) >= 1000000000L)
+		{
+			next.tv_nsec -= 1000000000L;
+			++next.tv_sec;
+		}
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+	}
+	feeder.cpu = Cpu_Seconds(CLOCK_THREAD_CPUTIME_ID) - cpu;
+	feeder.wall = std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Measure
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static Result Measure(const std::string &mode, int ports, const Options &options);
+--					-const std::string &mode:	"loop" or "threads"
+--					-int ports:					Number of ptys
+--					-const Options &options:	Rate and time to feed them at
+--
+-- RETURNS: The measurement; a CPU of -1 when the ptys or the ports could not be opened
+--
+-- NOTES:
+--	Opens the ptys and the ports first and closes them after, so only the feeding is measured: the process CPU
+--	time and the bytes received are sampled from just before the feeder starts to just after it ends, and the
+--	feeder's own CPU time is taken off.
+----------------------------------------------------------------------------------------------------------------------*/
+static Result Measure(const std::string &mode, int ports, const Options &options)
+{
+	EpollLoop										loop;
+	Owner											owner;
+	SessionManager									manager(loop, owner);
+	std::vector<int>								masters;
+	std::vector<std::unique_ptr<PosixTransport> >	ttys;		//threads mode only, the manager owns them otherwise
+	std::vector<std::thread>						readers;
+	std::atomic<unsigned long long>					received(0);
+	PortSettings									settings = { options.baud, 8, 'N', 1, PortSettings::FLOW_NONE };
+	Result											result = { -1, 0, 0, 0 };
+	Feeder											feeder;
+	std::string										slave;
+	int												master;
+	bool											opened = true;
+	if (mode == "loop")
+	{
+		manager.Start(4096, 1 << 16, 100);
+		owner.Start(manager);
+	}
+	for (int i = 0; i < ports && opened; ++i)
+	{
+		if (!(opened = Open_Pty(master, slave)))
+			break;
+		masters.push_back(master);
+		std::unique_ptr<PosixTransport> tty(new PosixTransport());
+		if (!(opened = tty->Open(slave.c_str()) && tty->Configure(settings)))
+			break;
+		if (mode == "loop")
+			opened = manager.Open(tty.release(), slave.c_str()) != SessionManager::NONE;
+		else
+		{
+			PosixTransport *port = tty.get();
+			ttys.push_back(std::move(tty));
+			readers.push_back(std::thread([port, &received]
+			{
+				char buf[4096];
+				long n;
+				while ((n = port->Read(buf, sizeof(buf))) > 0)	//0 once cancelled
+					received += n;
+			}));
+		}
+	}
+	if (opened)
+	{
+		unsigned long long	bytes = mode == "loop" ? owner.Bytes() : received.load();
+		double				cpu = Cpu_Seconds(CLOCK_PROCESS_CPUTIME_ID);
+		std::thread(Feed, std::cref(masters), options.baud, options.seconds, std::ref(feeder)).join();
+		cpu = Cpu_Seconds(CLOCK_PROCESS_CPUTIME_ID) - cpu - feeder.cpu;
+		bytes = (mode == "loop" ? owner.Bytes() : received.load()) - bytes;
+		result.cpu = cpu / feeder.wall;
+		result.threads = mode == "loop" ? 2 : ports;
+		result.bytesPerSecond = bytes / feeder.wall;
+		result.dropped = (double)feeder.dropped;
+	}
+	if (mode == "loop")
+	{
+		owner.Stop();
+		manager.Stop();										//Closes every port
+	}
+	for (auto &tty : ttys)
+		tty->Cancel();
+	for (auto &reader : readers)
+		reader.join();
+	for (auto &tty : ttys)
+		tty->Close();
+	for (int fd : masters)
+		close(fd);
+	return result;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Print_Result
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Print_Result(const Options &options, const std::string &mode, int ports,
+--						const Result &result);
+--					-const Options &options:	Rate of the lines and the output format
+--					-const std::string &mode:	Mode measured
+--					-int ports:					Port count measured
+--					-const Result &result:		The measurement
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Prints a row of the table, or a JSON line with --json. The CPU is a percentage of one core.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Print_Result(const Options &options, const std::string &mode, int ports, const Result &result)
+{
+	if (options.json)
+		printf("{\"label\":\"%s\",\"mode\":\"%s\",\"ports\":%d,\"baud\":%lu,\"seconds\":%.3f,\"threads\":%d,"
+			"\"cpu_percent\":%.2f,\"cpu_percent_per_port\":%.3f,\"kb_per_s\":%.1f,\"dropped\":%.0f}\n",
+			options.label.c_str(), mode.c_str(), ports, options.baud, options.seconds, result.threads,
+			result.cpu * 100, result.cpu * 100 / ports, result.bytesPerSecond / 1024, result.dropped);
+	else
+		printf("%-8s %6d %8d %8.2f %10.3f %10.1f %10.0f\n", mode.c_str(), ports, result.threads, result.cpu * 100,
+			result.cpu * 100 / ports, result.bytesPerSecond / 1024, result.dropped);
+	fflush(stdout);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: main
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int main(int argc, char **argv);
+--					-int argc:		Number of arguments
+--					-char **argv:	Arguments, listed at the top of the file
+--
+-- RETURNS: 0, 1 when the ptys or the ports could not be opened, or 2 for bad arguments
+--
+-- NOTES:
+--	Measures both modes at every port count, 2 seconds each at 115200 baud unless told otherwise.
+----------------------------------------------------------------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+	Options	options = { std::vector<int>(), 2, 115200, "", "", false };
+	char	*end;
+	long	n;
+	bool	bad = false;
+	for (int i = 1; i < argc && !bad; ++i)
+	{
+		const char *next = i + 1 < argc ? argv[i + 1] : "";
+		if (strcmp(argv[i], "--json") == 0)
+			options.json = true;
+		else if (strcmp(argv[i], "--ports") == 0 && *next != '\0')
+		{
+			for (end = argv[++i]; *end != '\0'; end += *end == ',')
+			{
+				if ((n = strtol(end, &end, 10)) <= 0 || n > SessionManager::MAX_SESSIONS || (*end != ',' && *end))
+				{
+					bad = true;
+					break;
+				}
+				options.ports.push_back((int)n);
+			}
+		}
+		else if (strcmp(argv[i], "--seconds") == 0 && atof(next) > 0)
+			options.seconds = atof(argv[++i]);
+		else if (strcmp(argv[i], "--baud") == 0 && atol(next) > 0)
+			options.baud = (unsigned long)atol(argv[++i]);
+		else if (strcmp(argv[i], "--mode") == 0 && (strcmp(next, "loop") == 0 || strcmp(next, "threads") == 0))
+			options.mode = argv[++i];
+		else if (strcmp(argv[i], "--label") == 0 && i + 1 < argc)
+			options.label = argv[++i];
+		else
+			bad = true;
+	}
+	if (bad)
+	{
+		fprintf(stderr, "usage: dtscale [--ports N,N,...] [--seconds S] [--baud N] [--mode loop|threads]\n"
+			"               [--label TEXT] [--json]\n");
+		return 2;
+	}
+	if (options.ports.empty())
+		options.ports = { 1, 2, 4, 8, 16, 32 };
+	if (!options.json)
+		printf("%-8s %6s %8s %8s %10s %10s %10s\n", "mode", "ports", "threads", "CPU %", "CPU %/port", "KB/s",
+			"dropped");
+	for (int ports : options.ports)
+		for (const char *mode : MODES)
+			if (options.mode.empty() || options.mode == mode)
+			{
+				Result result = Measure(mode, ports, options);
+				if (result.cpu < 0)
+				{
+					fprintf(stderr, "dtscale: could not open %d ptys at %lu baud\n", ports, options.baud);
+					return 1;
+				}
+				Print_Result(options, mode, ports, result);
+			}
+	return 0;
+}
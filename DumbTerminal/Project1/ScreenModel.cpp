@@ -0,0 +1,953 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: ScreenModel.cpp - Actual function implementation for ScreenModel.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- ScreenModel();
+-- VOID Append(unsigned int glyph, unsigned long color);
+-- VOID AppendRun(const char *glyphs, size_t count, unsigned long color);
+-- VOID Put(size_t col, unsigned int glyph, unsigned long color);
+-- VOID NewLine();
+-- VOID EraseLast();
+-- VOID Clear();
+-- size_t LineLength(size_t line) const;
+-- unsigned int Glyph(size_t line, size_t col) const;
+-- unsigned long Color(size_t line, size_t col) const;
+-- VOID SetLimits(size_t maxLines, size_t maxBytes);
+-- size_t Trim(size_t &headCells);
+-- size_t ResidentBytes() const;
+-- VOID StoreHigh(Page &page, size_t at, unsigned int glyph);
+-- VOID StoreInk(Page &page, size_t at, unsigned char ink);
+-- unsigned char FindColor(unsigned long color);
+-- size_t FreeColor();
+-- VOID Reclaim();
+-- unsigned char NearestColor(unsigned long color) const;
+-- const Page &Read(size_t cell) const;
+-- Page &Write(size_t cell);
+-- Page &Thaw(size_t index);
+-- VOID Freeze(Slot &slot);
+-- VOID Expand(const Slot &slot, Page &page) const;
+-- VOID Forget(size_t page) const;
+-- static VOID Mark_Colors(const unsigned char *attr, size_t count,
+--						std::bitset<ScreenModel::MAX_COLORS> &set);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Bounded scrollback, pages behind the live end are kept compressed
+--			  October 17, 2026 - Cells of the last line can be replaced in place
+--			  October 17, 2026 - A run of cells of one color can be appended at once
+--			  October 17, 2026 - Cells hold Unicode code points
+--			  October 17, 2026 - Text colors are stored apart from the palette, unused palette entries are reclaimed
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Cell storage for the screen and scrollback. See ScreenModel.h for the layout.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <cstring>
+#include "BlockCodec.h"
+#include "ScreenModel.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Mark_Colors
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Mark_Colors(const unsigned char *attr, size_t count,
+--						std::bitset<ScreenModel::MAX_COLORS> &set);
+--					-const unsigned char *attr:					Attribute bytes of a page
+--					-size_t count:								Number of them
+--					-std::bitset<ScreenModel::MAX_COLORS> &set:	Receives the palette entries they refer to
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Cells come in long runs of one color, so an entry is only marked where the attribute changes. Setting a bit
+--	for every cell costs a dependent read-modify-write per cell, which made compressing a page several times slower.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Mark_Colors(const unsigned char *attr, size_t count, std::bitset<ScreenModel::MAX_COLORS> &set)
+{
+	unsigned char last;
+	if (count == 0)
+		return;
+	set.set(last = attr[0]);
+	for (size_t i = 1; i < count; ++i)
+		if (attr[i] != last)
+			set.set(last = attr[i]);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ScreenModel
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Starts with no limits on the history
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: ScreenModel();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Starts with a single empty line so there is always a line to append to.
+----------------------------------------------------------------------------------------------------------------------*/
+ScreenModel::ScreenModel()
+	: _paletteFull(false), _cells(0), _firstPage(0), _packedBytes(0), _maxLines(0), _maxBytes(0), _nextCache(0),
+	_lastAttr(0)
+{
+	_palette.reserve(MAX_COLORS);
+	_lineStart.push_back(0);
+	for (size_t i = 0; i < CACHE_PAGES; ++i)
+		_cached[i] = (size_t)-1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Append
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Writes through Write, which compresses pages that fall behind
+--			  October 17, 2026 - Stores a code point
+--			  October 17, 2026 - Stores the text color in the ink byte
+--			  October 17, 2026 - Stores the ink through StoreInk
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Append(unsigned int glyph, unsigned long color);
+--					-unsigned int glyph:	The code point of the character to store
+--					-unsigned long color:	The colors the character is displayed in
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Stores the character at the end of the last line. A new page is only allocated every PAGE_CELLS cells.
+----------------------------------------------------------------------------------------------------------------------*/
+void ScreenModel::Append(unsigned int glyph, unsigned long color)
+{
+	Page &page = Write(_cells);
+	page.Glyph()[_cells % PAGE_CELLS] = (char)glyph;
+	page.Attr()[_cells % PAGE_CELLS] = PaletteIndex(color);
+	if (glyph > 0xFF || page.high)
+		StoreHigh(page, _cells % PAGE_CELLS, glyph);
+	if (color >> 24 || page.ink)
+		StoreInk(page, _cells % PAGE_CELLS, (unsigned char)(color >> 24));
+	++_cells;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: AppendRun
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Clears the high plane of a wide page
+--			  October 17, 2026 - Stores the text color in the ink bytes
+--			  October 17, 2026 - Allocates the ink of a page for the first text color
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID AppendRun(const char *glyphs, size_t count, unsigned long color);
+--					-const char *glyphs:	The characters to store, code points below U+0100 one byte each
+--					-size_t count:			Number of characters
+--					-unsigned long color:	The color they are all displayed in
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Append for a run of characters of one color: the palette is looked up once and the glyphs, attributes and ink
+--	are copied into each page they land on with one memcpy and two memsets. The high plane is only cleared in a wide
+--	page, and the ink only set in an inked page or for a text color.
+----------------------------------------------------------------------------------------------------------------------*/
+void ScreenModel::AppendRun(const char *glyphs, size_t count, unsigned long color)
+{
+	unsigned char attr = PaletteIndex(color), ink = (unsigned char)(color >> 24);
+	while (count > 0)
+	{
+		Page	&page = Write(_cells);
+		size_t	at = _cells % PAGE_CELLS, n = PAGE_CELLS - at < count ? PAGE_CELLS - at : count;
+		memcpy(page.Glyph() + at, glyphs, n);
+		memset(page.Attr() + at, attr, n);
+		if (page.high)
+			memset(page.high.get() + at, 0, n * sizeof(page.high[0]));
+		if (ink && !page.ink)
+			page.ink.reset(new unsigned char[PAGE_CELLS]());
+		if (page.ink)
+			memset(page.ink.get() + at, ink, n);
+		_cells += n;
+		glyphs += n;
+		count -= n;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Put
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Stores a code point
+--			  October 17, 2026 - Stores the text color in the ink byte
+--			  October 17, 2026 - Stores the ink through StoreInk
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Put(size_t col, unsigned int glyph, unsigned long color);
+--					-size_t col:			Cell of the last line to replace
+--					-unsigned int glyph:	The code point of the character to store
+--					-unsigned long color:	The colors the character is displayed in
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Overwrites a cell the cursor moved back over. Nothing after it moves, so it costs the same as Append.
+----------------------------------------------------------------------------------------------------------------------*/
+void ScreenModel::Put(size_t col, unsigned int glyph, unsigned long color)
+{
+	size_t cell = _lineStart.back() + col;
+	Page &page = Thaw(cell / PAGE_CELLS - _firstPage);
+	page.Glyph()[cell % PAGE_CELLS] = (char)glyph;
+	page.Attr()[cell % PAGE_CELLS] = PaletteIndex(color);
+	if (glyph > 0xFF || page.high)
+		StoreHigh(page, cell % PAGE_CELLS, glyph);
+	if (color >> 24 || page.ink)
+		StoreInk(page, cell % PAGE_CELLS, (unsigned char)(color >> 24));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: NewLine
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID NewLine();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Ends the current line. The next appended character starts a new one.
+----------------------------------------------------------------------------------------------------------------------*/
+void ScreenModel::NewLine()
+{
+	_lineStart.push_back(_cells);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: EraseLast
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID EraseLast();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Removes the last character. When the last line is empty, the line break before it is removed instead, the
+--	same way popping the last entry off the old history did.
+----------------------------------------------------------------------------------------------------------------------*/
+void ScreenModel::EraseLast()
+{
+	if (_cells > _lineStart.back())
+		--_cells;
+	else if (_lineStart.size() > 1)
+		_lineStart.pop_back();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Clear
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Also releases compressed pages and the read cache
+--			  October 17, 2026 - Empties the palette as well
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Clear();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Drops all cells and lines and releases the pages. No cell refers to the palette any more, so it is emptied.
+----------------------------------------------------------------------------------------------------------------------*/
+void ScreenModel::Clear()
+{
+	_pages.clear();
+	_lineStart.assign(1, 0);
+	_cells = _firstPage = _packedBytes = 0;
+	_palette.clear();
+	_used.reset();
+	_paletteFull = false;
+	_lastAttr = 0;
+	for (size_t i = 0; i < CACHE_PAGES; ++i)
+	{
+		_cache[i].reset();
+		_cached[i] = (size_t)-1;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: LineLength
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t LineLength(size_t line) const;
+--					-size_t line: Index of the line
+--
+-- RETURNS: The number of cells in the line
+----------------------------------------------------------------------------------------------------------------------*/
+size_t ScreenModel::LineLength(size_t line) const
+{
+	size_t end = (line + 1 < _lineStart.size()) ? _lineStart[line + 1] : _cells;
+	return end - _lineStart[line];
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Glyph
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Reads compressed pages through the read cache
+--			  October 17, 2026 - Returns a code point
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: unsigned int Glyph(size_t line, size_t col) const;
+--					-size_t line:	Index of the line
+--					-size_t col:	Index of the cell within the line
+--
+-- RETURNS: The code point of the character stored in the cell
+----------------------------------------------------------------------------------------------------------------------*/
+unsigned int ScreenModel::Glyph(size_t line, size_t col) const
+{
+	size_t cell = _lineStart[line] + col;
+	const Page		&page = Read(cell);
+	unsigned int	low = (unsigned char)page.Glyph()[cell % PAGE_CELLS];
+	return page.high ? low | (unsigned int)page.high[cell % PAGE_CELLS] << 8 : low;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Color
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Reads compressed pages through the read cache
+--			  October 17, 2026 - Was Attr, puts the palette entry and the ink byte back together
+--			  October 17, 2026 - Reads the ink of inked pages only
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: unsigned long Color(size_t line, size_t col) const;
+--					-size_t line:	Index of the line
+--					-size_t col:	Index of the cell within the line
+--
+-- RETURNS: The color the cell was stored with: the background from the palette, the text color in the top byte
+----------------------------------------------------------------------------------------------------------------------*/
+unsigned long ScreenModel::Color(size_t line, size_t col) const
+{
+	size_t		cell = _lineStart[line] + col;
+	const Page		&page = Read(cell);
+	unsigned long	ink = page.ink ? page.ink[cell % PAGE_CELLS] : 0;		//A page without ink has no text colors
+	return _palette[page.Attr()[cell % PAGE_CELLS]] | ink << 24;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ResidentBytes
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Counts the high planes of wide pages
+--			  October 17, 2026 - Counts the ink of inked pages
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t ResidentBytes() const;
+--
+-- RETURNS: Number of bytes held by expanded pages and the line index
+--
+-- NOTES:
+--	Counts the resident pages, the expanded read cache and the line index. Together with CompressedBytes this
+--	is what the byte limit is checked against.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t ScreenModel::ResidentBytes() const
+{
+	size_t bytes = _lineStart.size() * sizeof(size_t);
+	auto Page_Bytes = [](const Page &page)						//The page and the planes it has
+	{
+		return sizeof(Page) + (page.high ? PLANE_BYTES : 0) + (page.ink ? PAGE_CELLS : 0);
+	};
+	for (size_t i = 0; i < _pages.size(); ++i)
+		if (_pages[i].page)
+			bytes += Page_Bytes(*_pages[i].page);
+	for (size_t i = 0; i < CACHE_PAGES; ++i)
+		if (_cache[i])
+			bytes += Page_Bytes(*_cache[i]);
+	return bytes;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: SetLimits
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID SetLimits(size_t maxLines, size_t maxBytes);
+--					-size_t maxLines:	Most lines of history to keep, 0 for no limit
+--					-size_t maxBytes:	Most bytes of memory the history may use, 0 for no limit
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Only records the limits. They are enforced by the next call to Trim.
+----------------------------------------------------------------------------------------------------------------------*/
+void ScreenModel::SetLimits(size_t maxLines, size_t maxBytes)
+{
+	_maxLines = maxLines;
+	_maxBytes = maxBytes;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Trim
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Lets FreeColor look for unused palette entries again
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Trim(size_t &headCells);
+--					-size_t &headCells:	Receives the number of cells cut from the head of the new first line
+--
+-- RETURNS: Number of lines dropped from the front
+--
+-- NOTES:
+--	Releases the oldest page while the history is over the byte limit, or over the line limit and the page holds
+--	the start of at least one line. The page being written is never released. Lines that start in a released page
+--	are dropped; the line that continues into the next page keeps only its tail. Line numbers shift down by the
+--	number of lines dropped, and cells of the new first line shift left by headCells. The palette entries only the
+--	released pages used become free at the next Reclaim.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t ScreenModel::Trim(size_t &headCells)
+{
+	size_t dropped = 0, firstStart = _lineStart[0];			//Where the current first line started originally
+	while (_pages.size() > 1)
+	{
+		size_t base = (_firstPage + 1) * PAGE_CELLS;		//First cell kept if the oldest page is released
+		bool lines = _maxLines && _lineStart.size() > _maxLines && _lineStart[1] <= base;
+		bool bytes = _maxBytes && MemoryUsage() > _maxBytes;
+		if (!lines && !bytes)
+			break;
+		while (_lineStart.size() > 1 && _lineStart[1] <= base)
+		{
+			_lineStart.pop_front();
+			firstStart = _lineStart[0];
+			++dropped;
+		}
+		if (_lineStart[0] < base)							//Line continues past the released page
+			_lineStart[0] = base;
+		_packedBytes -= _pages.front().packed.capacity();
+		Forget(_firstPage++);
+		_pages.pop_front();
+		_paletteFull = false;
+	}
+	headCells = _lineStart[0] - firstStart;
+	return dropped;
+}
+
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: StoreHigh
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID StoreHigh(Page &page, size_t at, unsigned int glyph);
+--					-Page &page:			Page being written
+--					-size_t at:				Index of the cell within the page
+--					-unsigned int glyph:	The code point stored in the cell
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Stores the bits of the code point above the glyph byte, allocating the high plane the first time a page
+--	holds a code point from U+0100 up. Every cell written before then is below U+0100, so the plane starts out
+--	zero. Kept out of Append so text that never needs it pays one test per cell.
+----------------------------------------------------------------------------------------------------------------------*/
+void ScreenModel::StoreHigh(Page &page, size_t at, unsigned int glyph)
+{
+	if (!page.high)
+		page.high.reset(new unsigned short[PAGE_CELLS]());
+	page.high[at] = (unsigned short)(glyph >> 8);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: StoreInk
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID StoreInk(Page &page, size_t at, unsigned char ink);
+--					-Page &page:		Page being written
+--					-size_t at:			Index of the cell within the page
+--					-unsigned char ink:	The text color of the cell, the top byte of its color
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Allocates the ink the first time a page holds a text color, the way StoreHigh allocates the high plane. The
+--	cells written before then had none, so the ink starts out zero.
+----------------------------------------------------------------------------------------------------------------------*/
+void ScreenModel::StoreInk(Page &page, size_t at, unsigned char ink)
+{
+	if (!page.ink)
+		page.ink.reset(new unsigned char[PAGE_CELLS]());
+	page.ink[at] = ink;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: FindColor
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Was PaletteIndex, which now checks the last color used inline and calls this for
+--			  any other
+--			  October 17, 2026 - Reuses entries no cell refers to, else takes the nearest color, when the palette is
+--			  full
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: unsigned char FindColor(unsigned long color);
+--					-unsigned long color: The background color to look up
+--
+-- RETURNS: The attribute byte for the color
+--
+-- NOTES:
+--	Backgrounds come from the menus and the escape sequences received, so a linear search over the palette is
+--	enough. PaletteIndex checks the last color used first since consecutive cells almost always share it, and only
+--	calls this when the color changes, which keeps Append small enough to stay a handful of instructions per cell.
+--	A new color is added while there is room, then takes an entry FreeColor finds unused. When every entry is in
+--	use by the history, the nearest color stands in for it. The entry returned is marked used either way.
+----------------------------------------------------------------------------------------------------------------------*/
+unsigned char ScreenModel::FindColor(unsigned long color)
+{
+	size_t i = 0;
+	while (i < _palette.size() && _palette[i] != color)
+		++i;
+	if (i == _palette.size() && _palette.size() < MAX_COLORS)
+		_palette.push_back(color);
+	else if (i == _palette.size() && (i = FreeColor()) < MAX_COLORS)
+		_palette[i] = color;
+	else if (i == MAX_COLORS)
+		i = NearestColor(color);
+	_used.set(i);
+	return _lastAttr = (unsigned char)i;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: FreeColor
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t FreeColor();
+--
+-- RETURNS: A palette entry no cell refers to, MAX_COLORS when there is none
+--
+-- NOTES:
+--	Entries stay marked used from the time they are handed out until a Reclaim finds no cell with them. When none
+--	is free, Reclaim is run. If it frees nothing, it is not tried again until a page is started or released, since
+--	only then can the answer change by more than a few cells.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t ScreenModel::FreeColor()
+{
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		for (size_t i = 0; i < _palette.size(); ++i)
+			if (!_used.test(i))
+				return i;
+		if (pass > 0 || _paletteFull)
+			break;
+		Reclaim();
+	}
+	_paletteFull = true;
+	return MAX_COLORS;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Reclaim
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Reclaim();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Marks used exactly the palette entries some cell of the history holds, plus the last one handed out, which
+--	PaletteIndex returns without a search. Compressed pages contribute the set Freeze recorded, so none is
+--	expanded; resident pages are read up to the last cell stored.
+----------------------------------------------------------------------------------------------------------------------*/
+void ScreenModel::Reclaim()
+{
+	_used.reset();
+	_used.set(_lastAttr);
+	for (size_t i = 0; i < _pages.size(); ++i)
+	{
+		const Slot &slot = _pages[i];
+		if (!slot.page)
+		{
+			_used |= slot.colors;
+			continue;
+		}
+		size_t base = (_firstPage + i) * PAGE_CELLS;
+		Mark_Colors(slot.page->Attr(), _cells - base < PAGE_CELLS ? _cells - base : PAGE_CELLS, _used);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: NearestColor
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: unsigned char NearestColor(unsigned long color) const;
+--					-unsigned long color: The background color to match
+--
+-- RETURNS: The palette entry closest to the color, by the sum of the squared differences of red, green and blue
+----------------------------------------------------------------------------------------------------------------------*/
+unsigned char ScreenModel::NearestColor(unsigned long color) const
+{
+	size_t	best = 0;
+	long	bestDistance = -1, d, distance;
+	for (size_t i = 0; i < _palette.size(); ++i)
+	{
+		distance = 0;
+		for (int shift = 0; shift < 24; shift += 8)
+		{
+			d = (long)(_palette[i] >> shift & 0xFF) - (long)(color >> shift & 0xFF);
+			distance += d * d;
+		}
+		if (bestDistance < 0 || distance < bestDistance)
+			best = i, bestDistance = distance;
+	}
+	return (unsigned char)best;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Read
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Expands the page through Expand
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: const Page &Read(size_t cell) const;
+--					-size_t cell: Index of the cell
+--
+-- RETURNS: The page holding the cell
+--
+-- NOTES:
+--	Resident pages are returned directly. A compressed page is looked up in the read cache, and expanded into
+--	the oldest cache entry when it is not there. Reading the rows of a window only ever touches a page or two, so
+--	the small cache keeps scrolling through compressed history from expanding the same page over and over.
+----------------------------------------------------------------------------------------------------------------------*/
+const ScreenModel::Page &ScreenModel::Read(size_t cell) const
+{
+	size_t page = cell / PAGE_CELLS;
+	const Slot &slot = _pages[page - _firstPage];
+	if (slot.page)
+		return *slot.page;
+	for (size_t i = 0; i < CACHE_PAGES; ++i)
+		if (_cached[i] == page)
+			return *_cache[i];
+	size_t entry = _nextCache;
+	_nextCache = (_nextCache + 1) % CACHE_PAGES;
+	if (!_cache[entry])
+		_cache[entry].reset(new Page);
+	Expand(slot, *_cache[entry]);
+	_cached[entry] = page;
+	return *_cache[entry];
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Write
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Expands the page through Thaw
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: Page &Write(size_t cell);
+--					-size_t cell: Index of the cell about to be written
+--
+-- RETURNS: The resident page holding the cell
+--
+-- NOTES:
+--	Starting a new page compresses the page that just fell out of the last HOT_PAGES. Writing into a compressed
+--	page only happens after enough backspaces to erase back into it; the page is expanded again and the empty
+--	pages after it are released, so every page but the last HOT_PAGES stays compressed.
+----------------------------------------------------------------------------------------------------------------------*/
+ScreenModel::Page &ScreenModel::Write(size_t cell)
+{
+	size_t index = cell / PAGE_CELLS - _firstPage;
+	if (index == _pages.size())							//Current page is full
+	{
+		_pages.emplace_back();
+		_pages.back().page.reset(new Page);
+		_paletteFull = false;
+		if (_pages.size() > HOT_PAGES && _pages[_pages.size() - 1 - HOT_PAGES].page)
+			Freeze(_pages[_pages.size() - 1 - HOT_PAGES]);
+	}
+	while (_pages.size() > index + 1)					//Erased back into an earlier page
+	{
+		_packedBytes -= _pages.back().packed.capacity();
+		Forget(_firstPage + _pages.size() - 1);
+		_pages.pop_back();
+	}
+	return Thaw(index);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Thaw
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Expands the page through Expand
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: Page &Thaw(size_t index);
+--					-size_t index: Position of the page in _pages
+--
+-- RETURNS: The resident page
+--
+-- NOTES:
+--	Expands a compressed page back into a resident one and releases its compressed copy. Resident pages are
+--	returned as they are.
+----------------------------------------------------------------------------------------------------------------------*/
+ScreenModel::Page &ScreenModel::Thaw(size_t index)
+{
+	Slot &slot = _pages[index];
+	if (!slot.page)
+	{
+		slot.page.reset(new Page);
+		Expand(slot, *slot.page);
+		_packedBytes -= slot.packed.capacity();
+		std::vector<unsigned char>().swap(slot.packed);
+		Forget(_firstPage + index);
+	}
+	return *slot.page;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Freeze
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Compresses the high plane of a wide page on its own
+--			  October 17, 2026 - Records the palette entries the page uses, compresses the ink on its own
+--			  October 17, 2026 - Works on Page::narrow, not on glyph running over into attr
+--			  October 17, 2026 - A page without ink has no ink to compress
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Freeze(Slot &slot);
+--					-Slot &slot: A page that is resident
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Compresses the page and releases the expanded copy. The glyphs and attributes are compressed first, then the
+--	high plane on its own if the page is wide and the ink on its own if any cell has a text color, and where the
+--	first two parts end closes the block. Plain text leaves the ink zero, and compressing it anyway made storing a
+--	page a third slower. The palette entries of the attributes are recorded for Reclaim. Slot is 64 bytes, which
+--	keeps indexing _pages a shift.
+----------------------------------------------------------------------------------------------------------------------*/
+void ScreenModel::Freeze(Slot &slot)
+{
+	unsigned int				ends[2];						//Where the glyphs and attributes and the high plane end
+	unsigned char				inked = 0;
+	std::vector<unsigned char>	part;
+	slot.colors.reset();
+	Mark_Colors(slot.page->Attr(), PAGE_CELLS, slot.colors);
+	for (size_t cell = 0; slot.page->ink && cell < PAGE_CELLS; ++cell)
+		inked |= slot.page->ink[cell];
+	Compress_Block(slot.page->narrow, NARROW_BYTES, slot.packed);
+	ends[0] = (unsigned int)slot.packed.size();
+	if (slot.page->high)
+	{
+		Compress_Block((const unsigned char *)slot.page->high.get(), PLANE_BYTES, part);
+		slot.packed.insert(slot.packed.end(), part.begin(), part.end());
+	}
+	ends[1] = (unsigned int)slot.packed.size();
+	if (inked)
+	{
+		Compress_Block(slot.page->ink.get(), PAGE_CELLS, part);
+		slot.packed.insert(slot.packed.end(), part.begin(), part.end());
+	}
+	slot.packed.insert(slot.packed.end(), (unsigned char *)ends, (unsigned char *)ends + sizeof(ends));
+	slot.packed.shrink_to_fit();
+	_packedBytes += slot.packed.capacity();
+	slot.page.reset();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Expand
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Expands the ink
+--			  October 17, 2026 - Works on Page::narrow, not on glyph running over into attr
+--			  October 17, 2026 - Leaves a page that had no ink without one
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Expand(const Slot &slot, Page &page) const;
+--					-const Slot &slot:	A compressed page
+--					-Page &page:		Receives the expanded page
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Expands the glyphs and attributes, the high plane if the page was wide and the ink if it had any. A page that
+--	was not wide, or had no text colors, leaves page without a high plane or ink, releasing what it had from an
+--	earlier page.
+----------------------------------------------------------------------------------------------------------------------*/
+void ScreenModel::Expand(const Slot &slot, Page &page) const
+{
+	unsigned int	ends[2];
+	size_t			end = slot.packed.size() - sizeof(ends);		//Compressed ink ends here
+	memcpy(ends, slot.packed.data() + end, sizeof(ends));
+	Expand_Block(slot.packed.data(), ends[0], page.narrow, NARROW_BYTES);
+	if (ends[1] == ends[0])
+		page.high.reset();
+	else
+	{
+		if (!page.high)
+			page.high.reset(new unsigned short[PAGE_CELLS]);
+		Expand_Block(slot.packed.data() + ends[0], ends[1] - ends[0], (unsigned char *)page.high.get(), PLANE_BYTES);
+	}
+	if (end == ends[1])
+		page.ink.reset();
+	else
+	{
+		if (!page.ink)
+			page.ink.reset(new unsigned char[PAGE_CELLS]);
+		Expand_Block(slot.packed.data() + ends[1], end - ends[1], page.ink.get(), PAGE_CELLS);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Forget
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Forget(size_t page) const;
+--					-size_t page: Number of the page
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Marks the cache entry holding the page, if any, as free. Called when the page is released or written.
+----------------------------------------------------------------------------------------------------------------------*/
+void ScreenModel::Forget(size_t page) const
+{
+	for (size_t i = 0; i < CACHE_PAGES; ++i)
+		if (_cached[i] == page)
+			_cached[i] = (size_t)-1;
+}
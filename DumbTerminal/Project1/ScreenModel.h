@@ -0,0 +1,160 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: ScreenModel.h - Compact screen/scrollback storage for the dumb terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- ScreenModel();
+-- VOID Append(unsigned int glyph, unsigned long color);
+-- VOID AppendRun(const char *glyphs, size_t count, unsigned long color);
+-- VOID Put(size_t col, unsigned int glyph, unsigned long color);
+-- VOID NewLine();
+-- VOID EraseLast();
+-- VOID Clear();
+-- size_t LineCount() const;
+-- size_t LineLength(size_t line) const;
+-- unsigned int Glyph(size_t line, size_t col) const;
+-- unsigned long Color(size_t line, size_t col) const;
+-- size_t MemoryUsage() const;
+-- VOID SetLimits(size_t maxLines, size_t maxBytes);
+-- size_t Trim(size_t &headCells);
+-- size_t ResidentBytes() const;
+-- size_t CompressedBytes() const;
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Bounded scrollback, pages behind the live end are kept compressed
+--			  October 17, 2026 - Cells of the last line can be replaced in place
+--			  October 17, 2026 - A run of cells of one color can be appended at once
+--			  October 17, 2026 - Cells hold Unicode code points
+--			  October 17, 2026 - Text colors are stored apart from the palette, unused palette entries are reclaimed
+--			  October 17, 2026 - The glyph and attribute bytes of a page are one array, compressed as one block
+--			  October 17, 2026 - The ink is only allocated for a page that holds a text color
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Holds every character that was received or typed, one cell per character. Cells are kept struct-of-arrays:
+--	one byte of glyph, one byte of attribute, where the attribute is an index into a small palette of background
+--	colors, and one byte of ink, the top byte of the color, i.e. the text color. Cells are stored back to back in
+--	fixed-size pages, so appending a character is a store into the current page and only allocates when a fresh
+--	page of PAGE_CELLS cells is started. Lines are recorded as the index of their first cell.
+--
+--	A glyph is a Unicode code point: the glyph byte holds its low 8 bits and a plane of 16-bit words the rest.
+--	The plane is only allocated for a page that has held a code point from U+0100 up, a wide page, and is
+--	compressed on its own. Every other page reads its glyphs from the byte alone, so text in ASCII and Latin-1
+--	costs one byte a cell for the glyph. The ink is a plane of its own in the same way: only allocated for a page
+--	that has held a cell with a text color, an inked page, and compressed on its own. Text with no text colors at
+--	all costs two bytes a cell resident, not three.
+--
+--	Only the last HOT_PAGES pages, where characters are being written and the window is looking, stay resident.
+--	Older pages are compressed with Compress_Block as soon as they fall behind, and are expanded into a small
+--	cache of CACHE_PAGES pages when something reads them again, e.g. a scroll back through history. A page that
+--	is written to again, after a long run of backspaces or by Put on a very long last line, is expanded back into a
+--	resident page.
+--
+--	SetLimits caps the history by lines and by bytes (resident plus compressed). Trim enforces the caps by
+--	releasing whole pages from the front, together with every line that starts in them; a line that started in
+--	a released page loses its head. Since only whole pages are released, the history can sit up to one page
+--	above the line cap.
+--
+--	Colors are plain 0x00BBGGRR values so this file does not depend on windows.h; they are COLORREFs in practice.
+--	The top byte of a color passed in is the text color (see RenderTarget.h) and is stored as the ink byte as it
+--	is, so only the backgrounds take palette entries. The palette holds MAX_COLORS of them. When it is full and a
+--	new background comes along, the entries no cell refers to any more are reclaimed: each compressed page keeps
+--	the set of entries it uses, taken when it was compressed, and the resident pages are read, so nothing is
+--	expanded. Pages released by Trim give their entries back that way. Only when more than MAX_COLORS
+--	backgrounds are in the history at once does a new one get the nearest color already in the palette.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef SCREENMODEL_H
+#define SCREENMODEL_H
+#include <bitset>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <vector>
+class ScreenModel
+{
+public:
+	static const size_t	PAGE_CELLS = 1 << 16;		//Cells per storage page
+	static const size_t	MAX_COLORS = 256;			//Background colors addressable by one attribute byte
+	static const size_t	HOT_PAGES = 2;				//Pages at the live end that are never compressed
+	static const size_t	CACHE_PAGES = 4;			//Compressed pages kept expanded for reading
+
+	ScreenModel();
+	void			Append(unsigned int glyph, unsigned long color);	//Add a cell to the end of the last line
+	void			AppendRun(const char *glyphs, size_t count, unsigned long color);	//Add cells of one color
+	void			Put(size_t col, unsigned int glyph, unsigned long color);	//Replace a cell of the last line
+	void			NewLine();									//Start a new line
+	void			EraseLast();								//Remove the last cell or line break
+	void			Clear();									//Drop all lines, keep the palette
+	size_t			LineCount() const { return _lineStart.size(); }
+	size_t			LineLength(size_t line) const;
+	unsigned int	Glyph(size_t line, size_t col) const;		//Code point stored in a cell
+	unsigned long	Color(size_t line, size_t col) const;		//Background and text color of a cell
+	size_t			MemoryUsage() const { return ResidentBytes() + CompressedBytes(); }
+	void			SetLimits(size_t maxLines, size_t maxBytes);	//0 means no limit
+	size_t			Trim(size_t &headCells);					//Enforce the limits, returns lines dropped
+	size_t			ResidentBytes() const;						//Bytes held by expanded pages and the line index
+	size_t			CompressedBytes() const { return _packedBytes; }
+
+private:
+	typedef std::bitset<MAX_COLORS>	ColorSet;				//One bit per palette entry
+	static const size_t	NARROW_BYTES = 2 * PAGE_CELLS;		//Glyph and attribute bytes of a page, back to back
+	struct Page
+	{
+		char				*Glyph() { return (char *)narrow; }	//Low 8 bits of the code point of each cell
+		const char			*Glyph() const { return (const char *)narrow; }
+		unsigned char		*Attr() { return narrow + PAGE_CELLS; }	//Palette index of the background of each cell
+		const unsigned char	*Attr() const { return narrow + PAGE_CELLS; }
+
+		unsigned char						narrow[NARROW_BYTES];	//Glyphs then attributes, compressed as one
+		std::unique_ptr<unsigned short[]>	high;				//Rest of the code point of each cell, wide pages only
+		std::unique_ptr<unsigned char[]>	ink;				//Text color of each cell, inked pages only
+	};
+	struct Slot
+	{
+		std::unique_ptr<Page>		page;					//Expanded page, empty while the page is compressed
+		std::vector<unsigned char>	packed;					//Compressed page, see Freeze
+		ColorSet					colors;					//Palette entries the compressed page uses
+	};
+	static const unsigned long	BACKGROUND = 0x00FFFFFF;	//Part of a color the palette holds
+	static const size_t	PLANE_BYTES = PAGE_CELLS * sizeof(unsigned short);	//High plane of a wide page
+
+	void			StoreHigh(Page &page, size_t at, unsigned int glyph);	//Bits above the glyph byte
+	void			StoreInk(Page &page, size_t at, unsigned char ink);		//Text color of a cell
+	unsigned char	PaletteIndex(unsigned long color)			//Attribute byte for the background of the color
+	{
+		color &= BACKGROUND;
+		return _lastAttr < _palette.size() && _palette[_lastAttr] == color ? _lastAttr : FindColor(color);
+	}
+	unsigned char	FindColor(unsigned long color);			//Search the palette, add the color if it is new
+	size_t			FreeColor();							//Palette entry no cell uses, MAX_COLORS if none
+	void			Reclaim();								//Work out which palette entries cells still use
+	unsigned char	NearestColor(unsigned long color) const;	//Entry closest to the color
+	const Page		&Read(size_t cell) const;				//Page holding the cell, expanded if needed
+	Page			&Write(size_t cell);					//Resident page holding the cell
+	Page			&Thaw(size_t index);					//Expand a compressed page for writing
+	void			Freeze(Slot &slot);						//Compress a resident page
+	void			Expand(const Slot &slot, Page &page) const;	//Decompress a page into page
+	void			Forget(size_t page) const;				//Drop the page from the read cache
+
+	std::deque<Slot>					_pages;				//Cell storage, the first one is page _firstPage
+	std::deque<size_t>					_lineStart;			//Index of the first cell of each line
+	std::vector<unsigned long>			_palette;			//Background colors referenced by the attribute bytes
+	ColorSet							_used;				//Palette entries cells may refer to
+	bool								_paletteFull;		//Every entry was in use at the last Reclaim, see FreeColor
+	size_t								_cells;				//Index one past the last cell stored
+	size_t								_firstPage;			//Number of pages released from the front
+	size_t								_packedBytes;		//Bytes held by compressed pages
+	size_t								_maxLines, _maxBytes;	//Limits on the history, 0 for none
+	mutable std::unique_ptr<Page>		_cache[CACHE_PAGES];	//Compressed pages expanded for reading
+	mutable size_t						_cached[CACHE_PAGES];	//Page held by each cache entry
+	mutable size_t						_nextCache;			//Cache entry to replace next
+	unsigned char						_lastAttr;			//Palette index returned by the last lookup
+};
+#endif
@@ -0,0 +1,450 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: SendQueue.cpp - Actual function implementation for SendQueue.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- SendQueue();
+-- VOID Push(const char *buf, size_t len);
+-- VOID Attach(const char *file, size_t len);
+-- bool Detach(unsigned long wait_ms);
+-- size_t Take(const char *&data, std::vector<char> &scratch, size_t max);
+-- size_t Poll(const char *&data, std::vector<char> &scratch, size_t max);
+-- unsigned long long TakenAt() const;
+-- bool Written(size_t len, bool failed);
+-- VOID Close();
+-- VOID Open();
+-- size_t Pending() const;
+-- VOID Progress(size_t &sent, size_t &total) const;
+-- size_t TakeLocked(const char *&data, std::vector<char> &scratch, size_t max);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Transmit queue shared by the UI thread and the writer thread. See SendQueue.h for the threading rules.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include "SendQueue.h"
+#include "Stats.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: SendQueue
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: SendQueue();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Starts closed; Open is called when a connection is made.
+----------------------------------------------------------------------------------------------------------------------*/
+SendQueue::SendQueue()
+	: _offset(0), _pending(0), _closed(true), _file(NULL), _fileLen(0), _fileTaken(0), _fileSent(0), _inUse(false), _fileFailed(false),
+	_takenAt(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Push
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Notes when each span was pushed, for the keystroke-to-wire latency
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Push(const char *buf, size_t len);
+--					-const char *buf:	Bytes to send
+--					-size_t len:		Number of bytes in buf
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Copies the bytes into a new span and wakes the writer. Never waits for the port. Bytes pushed while the
+--	queue is closed are dropped.
+----------------------------------------------------------------------------------------------------------------------*/
+void SendQueue::Push(const char *buf, size_t len)
+{
+	if (len == 0)
+		return;
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		if (_closed)
+			return;
+		_spans.push_back(std::vector<char>(buf, buf + len));
+		_pushedAt.push_back(Stats_Now());
+		_pending += len;
+	}
+	_ready.notify_one();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Attach
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Attach(const char *file, size_t len);
+--					-const char *file:	Contents of the file, which must stay mapped until Detach returns true
+--					-size_t len:		Size of the file
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Starts sending a file after the bytes already queued. Only one file is attached at a time.
+----------------------------------------------------------------------------------------------------------------------*/
+void SendQueue::Attach(const char *file, size_t len)
+{
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		_file = file;
+		_fileLen = len;
+		_fileTaken = _fileSent = 0;
+		_fileFailed = false;
+	}
+	_ready.notify_one();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Detach
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Detach(unsigned long wait_ms);
+--					-unsigned long wait_ms: Most milliseconds to wait for the writer to let go of the file
+--
+-- RETURNS: true when the file may be unmapped, false when the writer is still writing from it
+--
+-- NOTES:
+--	Called when the file has been sent, when the send is cancelled and on disconnect. No more of the file is taken.
+--	A write from the file may still be in progress, and a write held back by flow control can take any time,
+--	so the caller aborts it and calls again until this returns true. Progress keeps reporting the final counts.
+----------------------------------------------------------------------------------------------------------------------*/
+bool SendQueue::Detach(unsigned long wait_ms)
+{
+	std::unique_lock<std::mutex> guard(_lock);
+	_file = NULL;
+	return _ready.wait_for(guard, std::chrono::milliseconds(wait_ms), [this] { return !_inUse; });
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Take
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Sends the attached file from its mapping when nothing typed is waiting
+--			  October 17, 2026 - Samples the queue depth and remembers when the oldest typed byte taken was pushed
+--			  October 17, 2026 - Takes through TakeLocked
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Take(const char *&data, std::vector<char> &scratch, size_t max);
+--					-const char *&data:				Set to the bytes to write
+--					-std::vector<char> &scratch:	Holds typed bytes that were gathered, replacing what it held
+--					-size_t max:					Most bytes to take
+--
+-- RETURNS: Number of bytes at data, 0 once the queue is closed
+--
+-- NOTES:
+--	Blocks until bytes are queued or the queue is closed. Typed bytes go first: everything that is waiting, up to
+--	max bytes, is gathered into scratch across as many spans as it needs; a span that does not fit is taken in
+--	part and the rest is left first in line. The capacity of scratch is kept, so the writer allocates its buffer
+--	only once. When nothing was typed the next max bytes of the attached file are taken, and data points into the
+--	file itself. Every Take is followed by a Written once the write completes.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t SendQueue::Take(const char *&data, std::vector<char> &scratch, size_t max)
+{
+	std::unique_lock<std::mutex> guard(_lock);
+	_ready.wait(guard, [this]
+		{ return _closed || _pending > 0 || (_file != NULL && !_fileFailed && _fileTaken < _fileLen); });
+	return TakeLocked(data, scratch, max);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: TakeLocked
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t TakeLocked(const char *&data, std::vector<char> &scratch, size_t max);
+--					-const char *&data:				Set to the bytes to write
+--					-std::vector<char> &scratch:	Holds typed bytes that were gathered, replacing what it held
+--					-size_t max:					Most bytes to take
+--
+-- RETURNS: Number of bytes at data, 0 when nothing is waiting or the queue is closed
+--
+-- NOTES:
+--	Called with _lock held, by Take and Poll. Typed bytes go first: everything that is waiting, up to max bytes,
+--	is gathered into scratch across as many spans as it needs; a span that does not fit is taken in part and the
+--	rest is left first in line. When nothing was typed the next max bytes of the attached file are taken, and
+--	data points into the file itself.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t SendQueue::TakeLocked(const char *&data, std::vector<char> &scratch, size_t max)
+{
+	scratch.clear();
+	data = scratch.data();
+	bool file = _file != NULL && !_fileFailed;
+	if (_closed || (_pending == 0 && (!file || _fileTaken == _fileLen)))	//Poll found nothing waiting
+		return 0;
+	Stats_Sample(STAT_TX_DEPTH, _pending + (file ? _fileLen - _fileTaken : 0));
+	_takenAt = _pending > 0 ? _pushedAt.front() : 0;
+	if (_pending == 0)									//Nothing typed, send the next part of the file
+	{
+		size_t n = _fileLen - _fileTaken < max ? _fileLen - _fileTaken : max;
+		data = _file + _fileTaken;
+		_fileTaken += n;
+		_inUse = true;
+		return n;
+	}
+	while (!_spans.empty() && scratch.size() < max)
+	{
+		std::vector<char> &span = _spans.front();
+		size_t n = span.size() - _offset < max - scratch.size() ? span.size() - _offset : max - scratch.size();
+		scratch.insert(scratch.end(), span.begin() + _offset, span.begin() + _offset + n);
+		_offset += n;
+		if (_offset == span.size())						//Whole span taken
+		{
+			_spans.pop_front();
+			_pushedAt.pop_front();
+			_offset = 0;
+		}
+	}
+	_pending -= scratch.size();
+	data = scratch.data();
+	return scratch.size();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Poll
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Poll(const char *&data, std::vector<char> &scratch, size_t max);
+--					-const char *&data:				Set to the bytes to write
+--					-std::vector<char> &scratch:	Holds typed bytes that were gathered, replacing what it held
+--					-size_t max:					Most bytes to take
+--
+-- RETURNS: Number of bytes at data, 0 when nothing is waiting or the queue is closed
+--
+-- NOTES:
+--	Takes like Take but never waits, for the thread of an IoLoop that services the port among others. Every Poll
+--	that returns bytes is followed by a Written once they have all been handed to the port.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t SendQueue::Poll(const char *&data, std::vector<char> &scratch, size_t max)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return TakeLocked(data, scratch, max);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: TakenAt
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: unsigned long long TakenAt() const;
+--
+-- RETURNS: Stats_Now when the first typed byte of the last Take was pushed, 0 when it took part of the file
+--
+-- NOTES:
+--	Writer side. Once the write of what was taken completes, the difference to Stats_Now is how long the oldest
+--	keystroke in it waited from the UI thread to the wire.
+----------------------------------------------------------------------------------------------------------------------*/
+unsigned long long SendQueue::TakenAt() const
+{
+	return _takenAt;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Written
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Written(size_t len, bool failed);
+--					-size_t len:	Bytes of the last Take that were sent, fewer when the write was aborted or failed
+--					-bool failed:	The port reported an error, rather than the write being aborted
+--
+-- RETURNS: true when this write finished sending the attached file, or ended it by failing
+--
+-- NOTES:
+--	Called by the writer after every write. When the bytes came from the file the writer no longer points into
+--	it, so a Detach waiting for that is woken. The part of the file that was taken and not sent is put back, so
+--	the next Take starts where the port stopped; after a cancel or a disconnect nothing takes it. A failed write
+--	ends the send instead of retrying it on a port that keeps failing: no more of the file is taken and the UI is
+--	told the send is over, like at the end of the file, and shows how far it got.
+----------------------------------------------------------------------------------------------------------------------*/
+bool SendQueue::Written(size_t len, bool failed)
+{
+	bool done;
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		if (!_inUse)									//Typed bytes, nothing to account for
+			return false;
+		_inUse = false;
+		_fileSent += len;
+		_fileTaken = _fileSent;							//Take again what did not get out
+		_fileFailed = _fileFailed || failed;
+		done = _file != NULL && (_fileSent == _fileLen || failed);
+	}
+	_ready.notify_all();
+	return done;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Close
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Close();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Called on disconnect. Whatever was not taken is thrown away and a writer waiting in Take returns 0.
+----------------------------------------------------------------------------------------------------------------------*/
+void SendQueue::Close()
+{
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		_closed = true;
+		_spans.clear();
+		_pushedAt.clear();
+		_offset = _pending = 0;
+	}
+	_ready.notify_all();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Open
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Open();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Called on connect, before the writer thread is started.
+----------------------------------------------------------------------------------------------------------------------*/
+void SendQueue::Open()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	_closed = false;
+	_spans.clear();
+	_pushedAt.clear();
+	_offset = _pending = 0;
+	_file = NULL;
+	_fileLen = _fileTaken = _fileSent = 0;
+	_inUse = _fileFailed = false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Pending
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Pending() const;
+--
+-- RETURNS: The number of bytes queued and not yet taken by the writer
+----------------------------------------------------------------------------------------------------------------------*/
+size_t SendQueue::Pending() const
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return _pending;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Progress
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Progress(size_t &sent, size_t &total) const;
+--					-size_t &sent:	Set to the bytes of the file written so far
+--					-size_t &total:	Set to the size of the file
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Read by the UI thread for the progress display, and after Detach for the summary.
+----------------------------------------------------------------------------------------------------------------------*/
+void SendQueue::Progress(size_t &sent, size_t &total) const
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	sent = _fileSent;
+	total = _fileLen;
+}
@@ -0,0 +1,98 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: SendQueue.h - Queue of bytes waiting to be sent, between the UI thread and the writer thread of the
+--			dumb terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- SendQueue();
+-- VOID Push(const char *buf, size_t len);
+-- VOID Attach(const char *file, size_t len);
+-- bool Detach(unsigned long wait_ms);
+-- size_t Take(const char *&data, std::vector<char> &scratch, size_t max);
+-- size_t Poll(const char *&data, std::vector<char> &scratch, size_t max);
+-- unsigned long long TakenAt() const;
+-- bool Written(size_t len, bool failed);
+-- VOID Close();
+-- VOID Open();
+-- size_t Pending() const;
+-- VOID Progress(size_t &sent, size_t &total) const;
+-- size_t TakeLocked(const char *&data, std::vector<char> &scratch, size_t max);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Records the push time of every span and the queue depth for the statistics
+--			  October 17, 2026 - Added Poll, a Take that does not wait
+--			  October 17, 2026 - A short write puts the rest of the file back, a failed one ends the send
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	The UI thread pushes spans of bytes, one per keystroke or one for a whole paste, and returns at once. The
+--	writer thread sleeps in Take until something is queued and then takes everything that is waiting, up to one
+--	chunk, gathered across as many spans as it covers; so keystrokes typed while a write is in progress go out
+--	together in the next one and a large paste goes out in full chunks instead of one write per byte.
+--
+--	Unlike rxRing the queue has no fixed capacity: a paste is taken as one span, however large, so the UI thread
+--	never has to wait for the port. Access is serialized with a mutex, which is only held to copy bytes.
+--
+--	A file is not copied at all: Attach hands the queue a mapped view of it, and Take gives the writer pointers
+--	straight into the view once no typed bytes are waiting, so keystrokes still go out in the middle of a long
+--	send. The writer reports each finished write with Written, which is how the queue knows when the whole file
+--	has been sent and when the view is no longer in use and may be unmapped. Bytes of the file a write did not get
+--	out are taken again, so an aborted write never leaves a gap; a write that failed ends the send instead.
+--
+--	A port serviced by an IoLoop has no writer thread to sleep in Take: the loop's thread calls Poll, which takes
+--	the same way but returns 0 at once when nothing is waiting, and the UI thread posts the port's key after every
+--	Push and Attach so the loop comes back for the bytes.
+--
+--	Close makes Take return 0 so the writer can exit and throws away what was not taken; Open empties the queue
+--	and accepts bytes again for the next connection.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef SENDQUEUE_H
+#define SENDQUEUE_H
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <vector>
+class SendQueue
+{
+public:
+	SendQueue();
+	void	Push(const char *buf, size_t len);				//UI side: queue a span of bytes
+	void	Attach(const char *file, size_t len);			//UI side: send len bytes from file without copying
+	bool	Detach(unsigned long wait_ms);					//UI side: stop sending the file, wait until it is let go
+	size_t	Take(const char *&data, std::vector<char> &scratch, size_t max);	//Writer side: wait for bytes
+	size_t	Poll(const char *&data, std::vector<char> &scratch, size_t max);	//Writer side: take without waiting
+	unsigned long long	TakenAt() const;					//Writer side: when the oldest typed byte taken was pushed
+	bool	Written(size_t len, bool failed);				//Writer side: the last bytes taken have been sent
+	void	Close();										//Wake the writer and refuse more bytes
+	void	Open();											//Empty the queue and accept bytes again
+	size_t	Pending() const;								//Bytes queued and not taken yet
+	void	Progress(size_t &sent, size_t &total) const;	//Bytes of the attached file written so far
+
+private:
+	size_t	TakeLocked(const char *&data, std::vector<char> &scratch, size_t max);
+
+	mutable std::mutex				_lock;
+	std::condition_variable			_ready;				//Signalled when bytes are pushed or the queue closes
+	std::deque<std::vector<char> >	_spans;				//Bytes in the order they were pushed
+	std::deque<unsigned long long>	_pushedAt;			//Stats_Now when each span was pushed
+	size_t							_offset;			//Bytes of the first span already taken
+	size_t							_pending;			//Bytes queued and not taken yet
+	bool							_closed;			//Take returns 0, Push drops the bytes
+	const char						*_file;				//Attached file contents, NULL when none
+	size_t							_fileLen;			//Size of the file
+	size_t							_fileTaken;			//Bytes of the file handed to the writer
+	size_t							_fileSent;			//Bytes of the file the writer has sent
+	bool							_inUse;				//The writer holds a pointer into the file
+	bool							_fileFailed;		//A write of the file failed, no more of it is taken
+	unsigned long long				_takenAt;			//Push time of the first span of the last Take, writer side
+};
+#endif
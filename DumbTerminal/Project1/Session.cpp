@@ -9,8 +9,33 @@
 -- VOID Initialize_Window(HINSTANCE &hInst, int nCmdShow, HWND &hwnd, WNDCLASSEX &wcl);
 -- VOID Initialize_WNDCLASSEX(WNDCLASSEX &wcl, HINSTANCE &hInst);
 -- VOID Display_Help();
--- VOID Draw(const char *str, const HDC &hdc, const COLORREF &color, const BOOL &isRepaint, HWND hwnd);
+-- VOID Show_Statistics(HWND hwnd);
+-- static VOID Update_Scrollbar(HWND hwnd);
+-- static VOID Present_Dirty(HWND hwnd);
+-- static VOID Compose_All(HWND hwnd);
+-- static VOID Show_Session(HWND hwnd, int id);
+-- static int Next_Session(int after);
+-- static VOID Toggle_Hex_View(HWND hwnd);
+-- VOID Draw_Chunk(const char *buf, DWORD len, const COLORREF &color, HWND hwnd);
+-- VOID Drain_Received(HWND hwnd, int id);
+-- VOID Send_Chars(HWND hwnd, const char *buf, DWORD len);
+-- VOID Send_Key(HWND hwnd, WPARAM key);
+-- VOID Paste_Clipboard(HWND hwnd);
+-- VOID Send_File(HWND hwnd);
+-- VOID Show_Send_Progress(HWND hwnd);
+-- VOID End_Send(HWND hwnd);
+-- VOID Start_Capture(HWND hwnd);
+-- VOID Stop_Capture(HWND hwnd);
+-- VOID Start_Replay(HWND hwnd, double speed);
+-- VOID Stop_Replay(HWND hwnd);
+-- int Run_Replay(LPSTR args);
+-- static Transport *New_Com();
+-- int Run_Headless_Console(int argc, char **argv);
+-- VOID Update_Metrics(HWND hwnd, BOOL fontChanged);
 -- VOID Repaint(HWND hwnd);
+-- VOID Handle_Scroll(HWND hwnd, WPARAM wParam);
+-- VOID Scroll_Rows(HWND hwnd, long rows);
+-- VOID Continue_Reflow(HWND hwnd);
 -- VOID Handle_Menu_Commands(HWND hwnd, WPARAM wParam);
 -- BOOL Connect(HWND hwnd);
 -- VOID Disconnect(HWND hwnd);
@@ -20,7 +45,7 @@
 --
 -- DATE: October 4, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - Shows one session of sessions at a time, each with its own terminal and hex view
 --
 -- DESIGNER: Ruoqi Jia
 --
@@ -39,16 +64,72 @@
 --  as backspace(remove a character) and return carriage(new line). Additionally, resizing the window
 --  will not affect the content on screen and the apllication will handle word warpping accordingly.
 --
+--	Every Connect opens another port as a session of sessions, with a terminal and a hex view of its own. The
+--	window shows one session at a time, picked with Next Session; what is typed goes to it, the colors are its
+--	own, and Exit closes it. While no port is connected the window shows idle, which a replay is drawn in.
+--
 --	Note that the specific features that handles read and write operations will be outlined in Physical.h
 ----------------------------------------------------------------------------------------------------------------------*/
 
 #include "Session.h"
+static PortSession idle;		//Shown while no port is connected, a replay is drawn in it
+static PortSession *current = &idle;	//Session the window shows, its terminal, hex view and colors
+static int		shown = SessionManager::NONE;	//Its id in sessions, NONE for idle
+static BOOL		hexShown;		//The hex view is shown instead of the terminal, switched by the Hex View menu item
+static PagedView *view = &idle.terminal;	//The one the window shows
+static BackBuffer backBuffer;	//Off-screen bitmap the window contents are composed in
+static HANDLE	pThread;		//Handle for the replay thread
+static DWORD	pThreadId;		//Stores the replay thread id
+static struct
+{
+	int			id;					//Session the file is sent on
+	HANDLE		file;				//File being sent
+	HANDLE		mapping;			//and its read-only mapping
+	const char	*view;				//Mapped contents, written to the port from here
+	const char	*name;				//File name without the path, shown in the title bar
+	char		path[MAX_PATH];
+	DWORD		start;				//GetTickCount when the send started
+	DWORD		last;				//and at the last progress update
+	size_t		lastSent;			//Bytes sent at the last progress update
+	double		rate;				//Smoothed bytes per second
+} sending;
+class GdiMetrics : public MetricsProvider	//Reads the metrics of the window's font from GDI
+{
+public:
+	GdiMetrics(HWND hwnd) : _hwnd(hwnd), _hdc(GetDC(hwnd)) {}
+	~GdiMetrics() { ReleaseDC(_hwnd, _hdc); }
+	int LineHeight() const
+	{
+		TEXTMETRIC	tm;
+		GetTextMetrics(_hdc, &tm);
+		return tm.tmHeight + tm.tmExternalLeading;
+	}
+	void AdvanceWidths(int *widths) const
+	{
+		GetCharWidth32W(_hdc, 0, (UINT)CHARS - 1, widths);
+	}
+	int ClientWidth() const
+	{
+		RECT rc;
+		GetClientRect(_hwnd, &rc);
+		return rc.right - rc.left;
+	}
+	int ClientHeight() const
+	{
+		RECT rc;
+		GetClientRect(_hwnd, &rc);
+		return rc.bottom - rc.top;
+	}
+private:
+	HWND	_hwnd;
+	HDC		_hdc;
+};
 /*------------------------------------------------------------------------------------------------------------------
 -- FUNCTION: Initialize_Window
 --
 -- DATE: September 28, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - Window has a vertical scrollbar
 --
 -- DESIGNER: Ruoqi Jia
 --
@@ -75,7 +156,7 @@ VOID Initialize_Window(HINSTANCE &hInst, int nCmdShow, HWND &hwnd, WNDCLASSEX &w
 	Initialize_WNDCLASSEX(wcl, hInst);	//Set valuues to the current windows class
 	if (!RegisterClassEx(&wcl))			//Register window class 
 		MessageBox(NULL, "Error Registering class:", "", MB_OK);
-	if (!(hwnd = CreateWindow(Name, Name, WS_OVERLAPPEDWINDOW, 10, 10,
+	if (!(hwnd = CreateWindow(Name, Name, WS_OVERLAPPEDWINDOW | WS_VSCROLL, 10, 10,
 		600, 400, NULL, NULL, hInst, NULL)))	//Create an overlapped window
 		MessageBox(NULL, "Error Creating window:", "", MB_OK);
 	ShowWindow(hwnd, nCmdShow);				//Set the window show state
@@ -87,7 +168,7 @@ VOID Initialize_Window(HINSTANCE &hInst, int nCmdShow, HWND &hwnd, WNDCLASSEX &w
 --
 -- DATE: September 28, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - No longer redraws the whole window on every resize
 --
 -- DESIGNER: Ruoqi Jia
 --
@@ -106,7 +187,7 @@ VOID Initialize_Window(HINSTANCE &hInst, int nCmdShow, HWND &hwnd, WNDCLASSEX &w
 VOID Initialize_WNDCLASSEX(WNDCLASSEX &wcl, HINSTANCE &hInst)
 {
 	wcl.cbSize	= sizeof(WNDCLASSEX);
-	wcl.style	= CS_HREDRAW | CS_VREDRAW;
+	wcl.style	= 0;	//Resizing only repaints what changed
 	wcl.hIcon	= LoadIcon(NULL, IDI_APPLICATION);	// large icon 
 	wcl.hIconSm	= NULL;								// use small version of large icon
 	wcl.hCursor = LoadCursor(NULL, IDC_ARROW);		// cursor style
@@ -150,9 +231,159 @@ VOID Display_Help()
 }
 
 /*------------------------------------------------------------------------------------------------------------------
--- FUNCTION: Draw
+-- FUNCTION: Show_Statistics
 --
--- DATE: September 28, 2015
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Shows the stalls of the session shown and how many ports are connected
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Show_Statistics(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Reads the counters and histograms of all threads and shows them in a message box, together with the flow
+--	control stalls of the current or last file send of the session shown and the number of ports connected. Each
+--	time the item is picked the numbers are read again.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Show_Statistics(HWND hwnd)
+{
+	char			line[64];
+	StatsSnapshot	snapshot;
+	Stats_Read(snapshot);
+	std::string text = Stats_Format(snapshot, true);
+	sprintf_s(line, "Flow control stalls %ld\n", sessions.Stalls(shown));
+	text += line;
+	sprintf_s(line, "Ports connected %d\n", sessions.Count());
+	text += line;
+	MessageBox(hwnd, text.c_str(), "Statistics", MB_OK);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Update_Scrollbar
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Shows the rows of the view the window shows
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Update_Scrollbar(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Sets the range of the vertical scrollbar to the rows of the view shown, the page to the rows that fit in the
+--	window and the thumb to the top row of the view. SetScrollInfo is only called when one of them changed. The
+--	bar stays visible when there is nothing to scroll so the client width does not change with it.
+----------------------------------------------------------------------------------------------------------------------*/
+static VOID Update_Scrollbar(HWND hwnd)
+{
+	static SCROLLINFO	shown = { 0 };				//What the scrollbar shows now
+	SCROLLINFO			si = { sizeof(SCROLLINFO) };
+	si.fMask = SIF_RANGE | SIF_PAGE | SIF_POS | SIF_DISABLENOSCROLL;
+	si.nMin = 0;
+	si.nMax = (int)view->RowCount() - 1;
+	si.nPage = (UINT)view->PageRows();
+	si.nPos = (int)view->TopRow();
+	if (si.nMax == shown.nMax && si.nPage == shown.nPage && si.nPos == shown.nPos && shown.cbSize)
+		return;
+	SetScrollInfo(hwnd, SB_VERT, &si, TRUE);
+	shown = si;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Present_Dirty
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Scrolls the back buffer when the view moved
+--			  October 17, 2026 - Counts the frame and samples how long it took to compose
+--			  October 17, 2026 - Composes the view shown, the terminal or the hex view
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Present_Dirty(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Scrolls the back buffer when the view moved, then composes every area the view shown marked dirty into it and
+--	invalidates the same areas without erasing, so the next WM_PAINT only has to copy them onto the window. The number of draw calls and cells
+--	composed are stored in last_frame_draw_calls and last_frame_cells.
+----------------------------------------------------------------------------------------------------------------------*/
+static VOID Present_Dirty(HWND hwnd)
+{
+	int left, top, right, bottom;
+	unsigned long long start = Stats_Now();
+	int dy = view->TakeScroll();
+	view->ResetFrame();
+	if (dy != 0)
+	{
+		backBuffer.Scroll(dy);						//Rows already composed only move
+		InvalidateRect(hwnd, NULL, FALSE);
+	}
+	while (view->NextDirty(left, top, right, bottom))
+	{
+		RECT rc = { left, top, right, bottom };
+		view->Compose(backBuffer, left, top, right, bottom);
+		InvalidateRect(hwnd, &rc, FALSE);
+	}
+	last_frame_draw_calls = view->FrameDrawCalls();
+	last_frame_cells = view->FrameCells();
+	Update_Scrollbar(hwnd);
+	Stats_Count(STAT_FRAMES);
+	Stats_Sample(STAT_FRAME_US, Stats_Now() - start);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Compose_All
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Updates the scrollbar
+--			  October 17, 2026 - Composes the view shown
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Compose_All(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Composes the whole client area into the back buffer and invalidates the window without erasing. Used after
+--	a resize or when the screen was cleared.
+----------------------------------------------------------------------------------------------------------------------*/
+static VOID Compose_All(HWND hwnd)
+{
+	RECT rc;
+	GetClientRect(hwnd, &rc);
+	view->ResetFrame();
+	view->Compose(backBuffer, rc.left, rc.top, rc.right, rc.bottom);
+	last_frame_draw_calls = view->FrameDrawCalls();
+	last_frame_cells = view->FrameCells();
+	InvalidateRect(hwnd, NULL, FALSE);
+	Update_Scrollbar(hwnd);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Show_Session
+--
+-- DATE: October 17, 2026
 --
 -- REVISIONS: (Date and Description)
 --
@@ -160,52 +391,790 @@ VOID Display_Help()
 --
 -- PROGRAMMER: Ruoqi Jia
 --
--- INTERFACE: void Draw (const char		*str,
---						 const HDC		&hdc,
---						 const COLORREF &color,
---						 const BOOL		&isRepaint);
---					-const char		*str:		A pointer to a character to be drawn
---					-const HDC		&hdc:		The device context
---					-const COLORREF	&color:		The background color str will be displayed in
---					-const BOOL		&isRepaint:	Validate if this is used for repaint or not,
---									if it is, call v.push_back(str), else do nothing
+-- INTERFACE: static VOID Show_Session(HWND hwnd, int id);
+--					-HWND hwnd:	Handle to the current window
+--					-int id:	Session to show, NONE or an id that is not open for idle
 --
--- RETURNS: void
+-- RETURNS: VOID
 --
 -- NOTES:
---	Process characters to be displayed on the screen with the specific background color. Each character's position
---	is pinpointed using the Coordinates struct, displayed left to right. Additionally the function also
---	handles backspace(delete a character) and return characters(new line).
+--	Makes the session the one the window shows, types into and takes the colors from, and shows its terminal or
+--	its hex view, whichever the Hex View menu item picks. The capture follows the window, so it records the
+--	session shown. Sessions that were not shown kept the width of the window they were last shown in, so the view
+--	is laid out again for the window first, and what it marked dirty and its pending scroll are dropped, as they
+--	were for a window it was not in; the whole window is composed instead. Also called on the session shown, to
+--	switch between its terminal and its hex view. The title bar names the port, unless it shows a file send.
 ----------------------------------------------------------------------------------------------------------------------*/
-void Draw(const char		*str, 
-		  const HDC			&hdc, 
-		  const COLORREF	&color, 
-		  const BOOL		&isRepaint,
-		  HWND hwnd)
+static VOID Show_Session(HWND hwnd, int id)
 {
-	SIZE		size;				//The current size of the string to be displayed
-	TEXTMETRIC	tm;					//The basic information of the font
-	GetTextMetrics(hdc, &tm);		//Set tm
-	GetTextExtentPoint32(hdc, str, strlen(str), &size);	//Set size
-	if (*str == '\b') 
+	int			left, top, right, bottom;
+	char		title[128];
+	GdiMetrics	provider(hwnd);
+	PortSession	*next = sessions.Session(id);
+	if (next == NULL)
+		id = SessionManager::NONE;
+	if (capture.Capturing() && id != shown)
 	{
-		if (rwHistory.size() >  0)
-			rwHistory.pop_back();
-		InvalidateRect(hwnd, NULL, TRUE);	//send a WM_PAINT to WndProc
+		sessions.Capture(shown, NULL);
+		sessions.Capture(id, &capture);
+	}
+	shown = id;
+	current = next ? next : &idle;
+	isConnected = next != NULL;				//Typing and sending need a port
+	view = hexShown ? (PagedView *)&current->hexView : (PagedView *)&current->terminal;
+	current->terminal.UpdateMetrics(provider, !current->terminal.Metrics().Valid());
+	current->hexView.UpdateMetrics(provider, !current->hexView.Metrics().Valid());
+	view->TakeScroll();
+	while (view->NextDirty(left, top, right, bottom))
+		;
+	Compose_All(hwnd);
+	if (current->terminal.Reflowing())		//Lay out the rest of its history while idle
+		SetTimer(hwnd, IDT_REFLOW, 0, NULL);
+	if (sending.view == NULL)
+	{
+		sprintf_s(title, "%s%s%s", Name, next ? " - " : "", next ? next->name.c_str() : "");
+		SetWindowText(hwnd, title);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Next_Session
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static int Next_Session(int after);
+--					-int after: Session to start after, NONE to start from the first
+--
+-- RETURNS: The id of the next open session, wrapping around to after itself, NONE when none is open
+----------------------------------------------------------------------------------------------------------------------*/
+static int Next_Session(int after)
+{
+	int id;
+	for (int i = 1; i <= SessionManager::MAX_SESSIONS; ++i)
+		if (sessions.Session(id = (after + i) % SessionManager::MAX_SESSIONS) != NULL)
+			return id;
+	return SessionManager::NONE;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Toggle_Hex_View
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Switches the views of the session shown
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Toggle_Hex_View(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Switches the window between the terminal and the hex view of the session shown, and of every session shown
+--	after it, and checks the Hex View menu item while the hex view is shown. Both are fed every byte all along,
+--	so nothing is lost either way. Show_Session composes the view switched to.
+----------------------------------------------------------------------------------------------------------------------*/
+static VOID Toggle_Hex_View(HWND hwnd)
+{
+	hexShown = !hexShown;
+	CheckMenuItem(GetMenu(hwnd), IDM_HEXVIEW, hexShown ? MF_CHECKED : MF_UNCHECKED);
+	Show_Session(hwnd, shown);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Draw_Chunk
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Replaces Draw, characters are drawn in same-color runs
+--			  October 17, 2026 - Backspace only invalidates the erased cell
+--			  October 17, 2026 - Composes into the back buffer instead of drawing on a window DC
+--			  October 17, 2026 - Echoes typed characters through Terminal::Type
+--			  October 17, 2026 - Records them in the hex view as well
+--			  October 17, 2026 - Echoes in the terminal and hex view of the session shown
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Draw_Chunk(const char		*buf,
+--							  DWORD			len,
+--							  const COLORREF &color,
+--							  HWND			hwnd);
+--					-const char		*buf:	The characters typed at the keyboard
+--					-DWORD			len:	Number of characters in buf
+--					-const COLORREF	&color:	The background color the characters will be displayed in
+--					-HWND			hwnd:	Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Echoes typed characters in the terminal of the session shown, which lays them out and handles backspace(erase the
+--	last character typed) and return(new line), and records them in the hex view, then composes the cells that changed
+--	in the view shown into the back buffer. Nothing is drawn on the window directly; the changed areas are invalidated
+--	and copied over on the next WM_PAINT.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Draw_Chunk(const char *buf, DWORD len, const COLORREF &color, HWND hwnd)
+{
+	if (!current->terminal.Metrics().Valid())
+		Update_Metrics(hwnd, TRUE);
+	current->terminal.Type(buf, len, color);
+	current->hexView.Write(buf, len, color);
+	Present_Dirty(hwnd);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Drain_Received
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Composes the drained bytes once instead of per chunk
+--			  October 17, 2026 - Also draws while a capture is replayed
+--			  October 17, 2026 - Takes the bytes through reader.Receive
+--			  October 17, 2026 - Records the bytes in the hex view as well
+--			  October 17, 2026 - Drains one session of sessions, or replayRing, into its own terminal and hex view
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Drain_Received(HWND hwnd, int id);
+--					-HWND hwnd:	Handle to the current window
+--					-int id:	Session with bytes waiting, NONE for the replay
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Called on the UI thread when WM_SERIAL_DATA arrives. Takes everything the session holds through
+--	sessions.Receive, which re-arms its notification first so bytes that arrive meanwhile post a new message and
+--	has the port read again if it waited for room, and records it with the session's read color in both its
+--	terminal and its hex view, so either can be shown at any time. The replay's bytes are taken out of replayRing
+--	into idle the same way. The cells that changed are composed once, after the session is empty, and only when
+--	it is the session shown. Bytes of a session closed since the message was posted, and of a replay that was
+--	stopped, are discarded.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Drain_Received(HWND hwnd, int id)
+{
+	char		buf[4096];						//Chunk taken out of the session
+	size_t		len;
+	PortSession	*session = id == SessionManager::NONE ? &idle : sessions.Session(id);
+	if (id == SessionManager::NONE)
+		InterlockedExchange(&replayPending, FALSE);	//Let the replay post again
+	if (session == NULL)
+		return;
+	if (!current->terminal.Metrics().Valid())
+		Update_Metrics(hwnd, TRUE);
+	while ((len = id == SessionManager::NONE ? replayRing.Read(buf, sizeof(buf))
+		: sessions.Receive(id, buf, sizeof(buf))) > 0)
+		if (id != SessionManager::NONE || isReplaying)
+		{
+			session->terminal.Write(buf, len, session->readColor);
+			session->hexView.Write(buf, len, session->readColor);
+		}
+	if (session == current)
+		Present_Dirty(hwnd);					//Compose everything drained as one frame
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Send_Chars
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Queues the bytes to the session shown
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Send_Chars(HWND hwnd, const char *buf, DWORD len);
+--					-HWND hwnd:			Handle to the current window
+--					-const char *buf:	Bytes to send
+--					-DWORD len:			Number of bytes in buf
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Called for every keystroke and for pastes. The bytes are queued to the session shown first, whose port the
+--	thread of sessions writes them to as soon as it is free, and then echoed on the window with the session's
+--	write color. Neither waits on the other: the UI thread never blocks on the port and the bytes never wait for
+--	the echo to be composed.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Send_Chars(HWND hwnd, const char *buf, DWORD len)
+{
+	sessions.Send(shown, buf, len);			//Thread of sessions sends it
+	Draw_Chunk(buf, len, current->writeColor, hwnd);	//Local echo
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Send_Key
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Send_Key(HWND hwnd, WPARAM key);
+--					-HWND hwnd:		Handle to the current window
+--					-WPARAM key:	Character code of a WM_CHAR message
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	The window gets WM_CHAR in the ANSI code page, a byte at a time, while the other end reads UTF-8. The
+--	character is converted to UTF-16 and then to UTF-8 and the bytes are handed to Send_Chars. The lead byte of
+--	a double-byte character is held until the trail byte comes in the next WM_CHAR.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Send_Key(HWND hwnd, WPARAM key)
+{
+	static char	lead;							//First byte of a double-byte character, 0 when none
+	char		ansi[2] = { lead, (char)key };
+	WCHAR		wide[2];
+	char		utf8[8];
+	int			len;
+	if (lead == 0 && IsDBCSLeadByte((BYTE)key))
+	{
+		lead = (char)key;						//Wait for the trail byte
 		return;
 	}
-	else if (*str == '\r')
-		coor._x = 0, coor._y += tm.tmHeight + tm.tmExternalLeading; // next line;
-	else 
+	len = MultiByteToWideChar(CP_ACP, 0, lead ? ansi : ansi + 1, lead ? 2 : 1, wide, 2);
+	lead = 0;
+	if (len > 0 && (len = WideCharToMultiByte(CP_UTF8, 0, wide, len, utf8, sizeof(utf8), NULL, NULL)) > 0)
+		Send_Chars(hwnd, utf8, (DWORD)len);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Paste_Clipboard
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Sends the Unicode text of the clipboard as UTF-8
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Paste_Clipboard(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Sends the text on the clipboard as one span, so the thread of sessions sends it in chunks of write_chunk_size
+--	bytes and a large paste keeps the link busy instead of costing a write per byte. The text is echoed once,
+--	as a single frame. Does nothing when not connected or when the clipboard holds no text. The text is taken as
+--	Unicode and sent as UTF-8, as typed characters are.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Paste_Clipboard(HWND hwnd)
+{
+	HANDLE				data;
+	const WCHAR			*text;
+	std::vector<char>	utf8;
+	int					len = 0;
+	if (!isConnected || !OpenClipboard(hwnd))
+		return;
+	if ((data = GetClipboardData(CF_UNICODETEXT)) != NULL && (text = (const WCHAR *)GlobalLock(data)) != NULL)
 	{
-		RECT rc;
-		if (GetWindowRect(hwnd, &rc) && coor._x > (rc.right - 50))		//Handles line wrap
-			coor._x = 0, coor._y += tm.tmHeight + tm.tmExternalLeading; //Increment x and add new line
-		if (SetBkColor(hdc, color) && TextOut(hdc, coor._x, coor._y, str, strlen(str))) //set color and display
-			coor._x += size.cx;				//Increment x coordinate
+		if ((len = WideCharToMultiByte(CP_UTF8, 0, text, -1, NULL, 0, NULL, NULL)) > 0)
+		{
+			utf8.resize(len);
+			len = WideCharToMultiByte(CP_UTF8, 0, text, -1, utf8.data(), len, NULL, NULL);
+		}
+		GlobalUnlock(data);
+	}
+	CloseClipboard();
+	if (len > 1)								//Without the terminating NUL
+		Send_Chars(hwnd, utf8.data(), (DWORD)(len - 1));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Send_File
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Sends on the session shown
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Send_File(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Asks for a file, maps it read-only and attaches the mapping to the session shown, so the thread of sessions
+--	sends it from the file's pages without copying it and keystrokes can still be typed while it goes out. The
+--	file is not echoed. Progress is shown in the title bar every SEND_PROGRESS_MS until End_Send. Only one file is
+--	sent at a time, on the session shown when it started, and nothing is done when not connected.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Send_File(HWND hwnd)
+{
+	OPENFILENAME	ofn = { 0 };
+	LARGE_INTEGER	size;
+	if (!isConnected || sending.file)
+		return;
+	sending.path[0] = '\0';
+	ofn.lStructSize = sizeof(OPENFILENAME);
+	ofn.hwndOwner = hwnd;
+	ofn.lpstrFilter = "All Files\0*.*\0";
+	ofn.lpstrFile = sending.path;
+	ofn.nMaxFile = MAX_PATH;
+	ofn.Flags = OFN_FILEMUSTEXIST | OFN_PATHMUSTEXIST;
+	if (!GetOpenFileName(&ofn))
+		return;
+	sending.name = sending.path + ofn.nFileOffset;
+	sending.file = CreateFile(sending.path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+		FILE_FLAG_SEQUENTIAL_SCAN, NULL);		//Pages are read ahead as the writer walks the mapping
+	if (sending.file == INVALID_HANDLE_VALUE || !GetFileSizeEx(sending.file, &size) || size.QuadPart == 0
+		|| (ULONGLONG)size.QuadPart > (SIZE_T)-1
+		|| (sending.mapping = CreateFileMapping(sending.file, NULL, PAGE_READONLY, 0, 0, NULL)) == NULL
+		|| (sending.view = (const char *)MapViewOfFile(sending.mapping, FILE_MAP_READ, 0, 0, 0)) == NULL)
+	{
+		MessageBox(NULL, "Error opening the file to send", "", MB_OK);
+		End_Send(hwnd);
+		return;
 	}
-	if (!isRepaint)		//Check if this is called by repaint or not
-		rwHistory.push_back(std::make_pair(std::string(str), color));	//Adds the string and color to hwHistory
+	sending.id = shown;
+	sending.start = sending.last = GetTickCount();
+	sending.lastSent = 0;
+	sending.rate = 0;
+	sessions.Attach(sending.id, sending.view, (size_t)size.QuadPart);	//Counts stalls from 0
+	SetTimer(hwnd, IDT_SEND, SEND_PROGRESS_MS, NULL);
+	Show_Send_Progress(hwnd);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Show_Send_Progress
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Reads the progress and the stalls from the session sending
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Show_Send_Progress(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Called on the IDT_SEND timer. Shows the percentage sent, the rate over the last interval smoothed with the
+--	earlier ones, the time left at that rate and the number of writes flow control held back.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Show_Send_Progress(HWND hwnd)
+{
+	char	title[MAX_PATH + 128];
+	size_t	sent, total;
+	DWORD	now = GetTickCount(), left;
+	long	stalls = sessions.Stalls(sending.id);
+	sessions.Progress(sending.id, sent, total);
+	if (now != sending.last)
+	{
+		double rate = (sent - sending.lastSent) * 1000.0 / (now - sending.last);
+		sending.rate = sending.last == sending.start ? rate : sending.rate * 0.75 + rate * 0.25;
+		sending.last = now;
+		sending.lastSent = sent;
+	}
+	if (sending.rate >= 1)
+	{
+		left = (DWORD)((total - sent) / sending.rate);
+		sprintf_s(title, "%s - %s %.0f%%, %.0f B/s, %lu:%02lu left, %ld stalls", Name, sending.name,
+			sent * 100.0 / total, sending.rate, left / 60, left % 60, stalls);
+	}
+	else
+		sprintf_s(title, "%s - %s %.0f%%, stalled, %ld stalls", Name, sending.name, sent * 100.0 / total, stalls);
+	SetWindowText(hwnd, title);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: End_Send
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Takes the file back from the session sending
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID End_Send(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Called when the session has sent the whole file, when the send is cancelled and when the session is closed. Takes
+--	the file back from the session, aborting the write in progress until the thread of sessions lets go of the
+--	mapping, then unmaps and closes it. The title bar is left with a summary of the send. Does nothing when no file is
+--	being sent.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID End_Send(HWND hwnd)
+{
+	char	title[MAX_PATH + 128];
+	size_t	sent, total;
+	DWORD	elapsed;
+	if (sending.view)
+	{
+		while (!sessions.Detach(sending.id, 50))
+			sessions.AbortWrite(sending.id);		//Abort the write that still reads the mapping
+		KillTimer(hwnd, IDT_SEND);
+		sessions.Progress(sending.id, sent, total);
+		elapsed = GetTickCount() - sending.start;
+		sprintf_s(title, "%s - %s %s, %llu of %llu bytes in %.1f s, %.0f B/s, %ld stalls", Name, sending.name,
+			sent == total ? "sent" : "cancelled", (unsigned long long)sent, (unsigned long long)total,
+			elapsed / 1000.0, elapsed ? sent * 1000.0 / elapsed : 0.0, sessions.Stalls(sending.id));
+		SetWindowText(hwnd, title);
+		UnmapViewOfFile(sending.view);
+	}
+	if (sending.mapping)
+		CloseHandle(sending.mapping);
+	if (sending.file && sending.file != INVALID_HANDLE_VALUE)
+		CloseHandle(sending.file);
+	sending.file = sending.mapping = NULL;
+	sending.view = NULL;
+}
+
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Start_Capture
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Timestamps with Stats_Now, as the reader does
+--			  October 17, 2026 - Records the session shown
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Start_Capture(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Asks for a file name and starts recording every byte sent and received into it, with its direction and a
+--	Stats_Now timestamp in microseconds, on the session shown. The capture is independent of the connection: it
+--	follows the window from session to session, across Disconnect and Connect, until it is stopped, so it holds
+--	what the window showed. See CaptureLog.h for the file format.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Start_Capture(HWND hwnd)
+{
+	OPENFILENAME	ofn = { 0 };
+	char			path[MAX_PATH] = "";
+	if (capture.Capturing())
+		return;
+	ofn.lStructSize = sizeof(OPENFILENAME);
+	ofn.hwndOwner = hwnd;
+	ofn.lpstrFilter = "Capture Files\0*.dtc\0All Files\0*.*\0";
+	ofn.lpstrDefExt = "dtc";
+	ofn.lpstrFile = path;
+	ofn.nMaxFile = MAX_PATH;
+	ofn.Flags = OFN_OVERWRITEPROMPT | OFN_PATHMUSTEXIST;
+	if (!GetSaveFileName(&ofn))
+		return;
+	if (!capture.Start(path, 1000000, Stats_Now()))
+	{
+		MessageBox(NULL, "Error creating the capture file", "", MB_OK);
+		return;
+	}
+	sessions.Capture(shown, &capture);		//Show_Session moves it along
+	SetTimer(hwnd, IDT_CAPTURE, CAPTURE_FLUSH_MS, NULL);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Stop_Capture
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Reports a failed write to the capture file
+--			  October 17, 2026 - Takes the capture off the session shown
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Stop_Capture(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Writes out what is still buffered and closes the capture file. Called from the menu and when the window is
+--	destroyed. Reports the bytes that were dropped because the disk could not keep up or a write to the file
+--	failed, if any.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Stop_Capture(HWND hwnd)
+{
+	char	msg[128];
+	if (!capture.Capturing())
+		return;
+	KillTimer(hwnd, IDT_CAPTURE);
+	sessions.Capture(shown, NULL);
+	if (!capture.Stop())
+	{
+		sprintf_s(msg, "Writing the capture file failed, %llu bytes were not captured", capture.Dropped());
+		MessageBox(NULL, msg, "", MB_OK);
+	}
+	else if (capture.Dropped())
+	{
+		sprintf_s(msg, "%llu bytes were not captured, the disk could not keep up", capture.Dropped());
+		MessageBox(NULL, msg, "", MB_OK);
+	}
+}
+
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Start_Replay
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Replays into idle through replayRing
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Start_Replay(HWND hwnd, double speed);
+--					-HWND hwnd:		Handle to the current window
+--					-double speed:	1 for the original timing, N for N times faster, 0 for as fast as possible
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Asks for a capture file, clears idle and starts Replay_From_File, which feeds the received bytes of the
+--	capture through replayRing to Drain_Received exactly as a session would. Not available while connected, since
+--	the window shows idle only while no port is.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Start_Replay(HWND hwnd, double speed)
+{
+	OPENFILENAME	ofn = { 0 };
+	if (isConnected || pThread)
+		return;
+	replay_path[0] = '\0';
+	ofn.lStructSize = sizeof(OPENFILENAME);
+	ofn.hwndOwner = hwnd;
+	ofn.lpstrFilter = "Capture Files\0*.dtc\0All Files\0*.*\0";
+	ofn.lpstrFile = replay_path;
+	ofn.nMaxFile = MAX_PATH;
+	ofn.Flags = OFN_FILEMUSTEXIST | OFN_PATHMUSTEXIST;
+	if (!GetOpenFileName(&ofn))
+		return;
+	replayRing.Clear();
+	idle.terminal.Clear();
+	idle.terminal.SetScrollback(scrollback_lines, scrollback_bytes);
+	idle.hexView.Clear();
+	idle.hexView.SetLimit(hex_scrollback_bytes);
+	Compose_All(hwnd);
+	replay_speed = speed;
+	replayStop = FALSE;
+	isReplaying = TRUE;
+	if ((pThread = CreateThread(NULL, 0, Replay_From_File, (LPVOID)hwnd, 0, &pThreadId)) == NULL)
+	{
+		isReplaying = FALSE;
+		MessageBox(NULL, "Error Creating thread for replaying", "", MB_OK);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Stop_Replay
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Drains replayRing
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Stop_Replay(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Ends a replay, early from the menu or on WM_REPLAY_DONE, and waits for the replay thread to exit. What was
+--	replayed stays on screen. Does nothing when no replay is running.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Stop_Replay(HWND hwnd)
+{
+	if (!pThread)
+		return;
+	InterlockedExchange(&replayStop, TRUE);
+	WaitForSingleObject(pThread, INFINITE);
+	CloseHandle(pThread);
+	pThread = NULL;
+	Drain_Received(hwnd, SessionManager::NONE);	//Draw what the thread left in replayRing
+	isReplaying = FALSE;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Run_Replay
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int Run_Replay(LPSTR args);
+--					-LPSTR args: Command line after "/replay": an optional ":speed" and the capture file
+--
+-- RETURNS: 0 when the capture was replayed, 1 when it could not be read
+--
+-- NOTES:
+--	Called from WinMain for "/replay[:speed] file", e.g. "/replay:0 session.dtc". Replays the capture headless with
+--	Replay_Headless, into a MemoryRenderTarget the size of an 80 by 25 window of 8 by 16 pixel cells, and prints
+--	the bytes per second and the frame times to the console the program was started from. No window is created.
+--	The speed defaults to 0, as fast as possible.
+----------------------------------------------------------------------------------------------------------------------*/
+int Run_Replay(LPSTR args)
+{
+	static Terminal		headless;				//Kept off the stack, like idle's terminal
+	FixedMetrics		metrics(8, 16, 80, 25);
+	ReplayReport		report;
+	double				speed = 0;
+	FILE				*out;
+	if (*args == ':')
+		speed = strtod(args + 1, &args);
+	while (*args == ' ' || *args == '"')
+		++args;
+	std::string path(args);
+	while (!path.empty() && (path.back() == ' ' || path.back() == '"'))
+		path.pop_back();
+	if (AttachConsole(ATTACH_PARENT_PROCESS) || AllocConsole())
+		freopen_s(&out, "CONOUT$", "w", stdout);
+	headless.UpdateMetrics(metrics, true);
+	headless.SetScrollback(scrollback_lines, scrollback_bytes);
+	MemoryRenderTarget target(headless.Metrics(), metrics.ClientWidth(), metrics.ClientHeight());
+	if (!Replay_Headless(path.c_str(), speed, headless, target, report))
+	{
+		printf("Error reading the capture file %s\n", path.c_str());
+		return 1;
+	}
+	printf("%llu bytes in %lu frames, %.3f s: %.0f bytes/s\n", report.bytes, report.frames, report.seconds,
+		report.seconds > 0 ? report.bytes / report.seconds : 0.0);
+	printf("frame time p50 %.1f us, p99 %.1f us, max %.1f us\n", report.frameP50, report.frameP99, report.frameMax);
+	return 0;
+}
+
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: New_Com
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static Transport *New_Com();
+--
+-- RETURNS: A closed Win32Transport, for Headless_Main to open
+----------------------------------------------------------------------------------------------------------------------*/
+static Transport *New_Com()
+{
+	return new Win32Transport();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Run_Headless_Console
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - The port is a session serviced by ioLoop, as the window's ports are
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int Run_Headless_Console(int argc, char **argv);
+--					-int argc:		Number of arguments after "/headless"
+--					-char **argv:	Arguments after "/headless"
+--
+-- RETURNS: The exit code of Headless_Main: 0 on success, 1 when the run failed, 2 for bad arguments
+--
+-- NOTES:
+--	Called from WinMain for "/headless", e.g. "/headless --port COM3 --baud 115200 --send soak.bin --quiet". Runs the
+--	headless front end (see Headless.h) with a Win32Transport made by New_Com, or the built-in loopback for "--port
+--	loop", in the console the program was started from. The port is serviced by ioLoop, which the window's sessions
+--	use otherwise. No window is created and the CommConfigDialog is not shown: the port parameters come from the
+--	arguments. Standard output is only attached to the console when it was not redirected, so what is received can be
+--	piped to a file, and it is put in binary mode so the bytes pass through unchanged, as is standard input for
+--	"--send -".
+----------------------------------------------------------------------------------------------------------------------*/
+int Run_Headless_Console(int argc, char **argv)
+{
+	HANDLE	out = GetStdHandle(STD_OUTPUT_HANDLE);
+	FILE	*stream;
+	if (AttachConsole(ATTACH_PARENT_PROCESS) || AllocConsole())
+	{
+		if (out == NULL || out == INVALID_HANDLE_VALUE)		//Not redirected
+			freopen_s(&stream, "CONOUT$", "w", stdout);
+		freopen_s(&stream, "CONOUT$", "w", stderr);
+	}
+	_setmode(_fileno(stdout), _O_BINARY);
+	_setmode(_fileno(stdin), _O_BINARY);
+	return Headless_Main(ioLoop, New_Com, argc, argv);
+}
+
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Update_Metrics
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Resizes the back buffer and recomposes the window
+--			  October 17, 2026 - Starts a timer that lays out the rest of the history after a resize
+--			  October 17, 2026 - Updates the hex view as well
+--			  October 17, 2026 - Updates the views of the session shown, the others when they are shown
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Update_Metrics(HWND hwnd, BOOL fontChanged);
+--					-HWND hwnd:			Handle to the current window
+--					-BOOL fontChanged:	TRUE to reload the font metrics, FALSE to only reload the client width
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Refreshes the metrics cache used to lay out characters. Called with TRUE the first time anything is drawn
+--	or after the font changes, and with FALSE on WM_SIZE. When the width or the font changed the rows around
+--	the view are laid out again, and when the rows or the size of the back buffer changed the whole window is
+--	composed again. The rest of the history is laid out by Continue_Reflow. Only the session shown is updated;
+--	Show_Session lays the others out when they are shown.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Update_Metrics(HWND hwnd, BOOL fontChanged)
+{
+	GdiMetrics provider(hwnd);
+	BOOL relaid = current->terminal.UpdateMetrics(provider, fontChanged != FALSE);
+	BOOL redrawn = current->hexView.UpdateMetrics(provider, fontChanged != FALSE);
+	BOOL resized = backBuffer.Resize(hwnd);
+	if ((hexShown ? redrawn : relaid) || resized)
+		Compose_All(hwnd);
+	if (current->terminal.Reflowing())		//Lay out the rest of the history while idle
+		SetTimer(hwnd, IDT_REFLOW, 0, NULL);
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -213,7 +1182,11 @@ void Draw(const char		*str,
 --
 -- DATE: September 28, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - Characters are drawn in same-color runs, one ExtTextOut per run
+--			  October 17, 2026 - Only the rows and cells inside the update rectangle are drawn
+--			  October 17, 2026 - Copies the update rectangle from the back buffer
+--			  October 17, 2026 - Counts the paint and samples how long it took
+--			  October 17, 2026 - Checks the metrics of the session shown
 --
 -- DESIGNER: Ruoqi Jia
 --
@@ -223,25 +1196,146 @@ void Draw(const char		*str,
 -- RETURNS: VOID
 --
 -- NOTES:
---	Called when the WM_PAINT macro is triggerd. The function iterate through hwHistory and redraws all the
---	characters currently displayed on the screen
+--	Called when the WM_PAINT macro is triggerd. Everything on screen has already been composed into the back
+--	buffer, so the update rectangle is copied onto the window with a single BitBlt. Nothing is erased first,
+--	which keeps the window from flickering while data is arriving or the window is resized.
 ----------------------------------------------------------------------------------------------------------------------*/
 VOID Repaint(HWND hwnd)
 {
 	PAINTSTRUCT ps;		
+	unsigned long long start = Stats_Now();
+	if (!current->terminal.Metrics().Valid())
+		Update_Metrics(hwnd, TRUE);
 	HDC hdc = BeginPaint(hwnd, &ps);	//specify for painting operation and fill out ps
-	coor.Reset();						//Set the coordinates of coors to (0,0), so paint from the beginning
-	for(auto &x : rwHistory)			//Iterate through all the characters that has been processed on the screen
-		Draw(x.first.c_str(), hdc, x.second, TRUE, hwnd);
+	backBuffer.Present(hdc, ps.rcPaint);	//Copy the update rectangle from the back buffer
 	EndPaint(hwnd, &ps);				//End painting operation
+	Stats_Count(STAT_PAINTS);
+	Stats_Sample(STAT_PAINT_US, Stats_Now() - start);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Handle_Scroll
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Handle_Scroll(HWND hwnd, WPARAM wParam);
+--					-HWND	hwnd:	Handle to the current window
+--					-WPARAM wParam: The scroll request of the WM_VSCROLL message
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Moves the view for the scrollbar arrows, the page areas and the thumb. The thumb position is read with
+--	GetScrollInfo since the 16 bits in wParam are not enough for a long history.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Handle_Scroll(HWND hwnd, WPARAM wParam)
+{
+	SCROLLINFO si = { sizeof(SCROLLINFO), SIF_TRACKPOS };
+	long page = (long)view->PageRows();
+	switch (LOWORD(wParam))
+	{
+	case SB_LINEUP:
+		Scroll_Rows(hwnd, -1);
+		break;
+	case SB_LINEDOWN:
+		Scroll_Rows(hwnd, 1);
+		break;
+	case SB_PAGEUP:
+		Scroll_Rows(hwnd, -page);
+		break;
+	case SB_PAGEDOWN:
+		Scroll_Rows(hwnd, page);
+		break;
+	case SB_TOP:
+		view->ScrollTo(0);
+		Present_Dirty(hwnd);
+		break;
+	case SB_BOTTOM:
+		view->ScrollTo(view->RowCount());
+		Present_Dirty(hwnd);
+		break;
+	case SB_THUMBTRACK:
+	case SB_THUMBPOSITION:
+		GetScrollInfo(hwnd, SB_VERT, &si);
+		view->ScrollTo((size_t)si.nTrackPos);
+		Present_Dirty(hwnd);
+		break;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Scroll_Rows
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Scroll_Rows(HWND hwnd, long rows);
+--					-HWND hwnd: Handle to the current window
+--					-long rows: Rows to move the view down by, negative to move it back
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Used by the scrollbar and the mouse wheel. Only the rows that scroll into view are composed.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Scroll_Rows(HWND hwnd, long rows)
+{
+	view->ScrollBy(rows);
+	Present_Dirty(hwnd);
+}
+
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Continue_Reflow
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Reflows the terminal of the session shown
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Continue_Reflow(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Called on WM_TIMER while a resize is still being reflowed. Lays out the next batch of lines of the session
+--	shown and composes whatever changed in view; the timer is stopped once every line is laid out.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Continue_Reflow(HWND hwnd)
+{
+	if (!current->terminal.Reflow(REFLOW_LINES))
+		KillTimer(hwnd, IDT_REFLOW);
+	Present_Dirty(hwnd);
 }
 
+
 /*------------------------------------------------------------------------------------------------------------------
 -- FUNCTION: Handle_Menu_Commands
 --
 -- DATE: October 4, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - Handles the Paste menu item
+--			  October 17, 2026 - Handles the Send File and Cancel Send menu items
+--			  October 17, 2026 - Handles the Start Capture and Stop Capture menu items
+--			  October 17, 2026 - Handles the Replay menu
+--			  October 17, 2026 - Handles the Statistics menu item
+--			  October 17, 2026 - Handles the Hex View menu item
+--			  October 17, 2026 - Handles the Port menu and the Next Session menu item, colors are the session's
 --
 -- DESIGNER: Ruoqi Jia
 --
@@ -253,7 +1347,8 @@ VOID Repaint(HWND hwnd)
 -- RETURNS: VOID
 --
 -- NOTES:
---	Handle and process all menu items that are being triggered in the program.
+--	Handle and process all menu items that are being triggered in the program. The colors picked are those of the
+--	session shown; a session connected later starts with the colors of the one shown when it was connected.
 ----------------------------------------------------------------------------------------------------------------------*/
 VOID Handle_Menu_Commands(HWND hwnd, WPARAM wParam)
 {
@@ -262,48 +1357,95 @@ VOID Handle_Menu_Commands(HWND hwnd, WPARAM wParam)
 	case IDM_HELP:
 		Display_Help(); //Display help message box	
 		break;
+	case IDM_HEXVIEW:
+		Toggle_Hex_View(hwnd);
+		break;
+	case IDM_STATISTICS:
+		Show_Statistics(hwnd);
+		break;
 	case IDM_CONNECT:
 		if (!Connect(hwnd))
-			MessageBox(NULL, "Error Creating thread for reading", "", MB_OK);
+			MessageBox(NULL, "Error Creating a session for the port", "", MB_OK);
+		break;
+	case IDM_NEXTSESSION:
+		Show_Session(hwnd, Next_Session(shown));
+		break;
+	case IDM_PORT1:
+	case IDM_PORT2:
+	case IDM_PORT3:
+	case IDM_PORT4:
+	case IDM_PORT5:
+	case IDM_PORT6:
+	case IDM_PORT7:
+	case IDM_PORT8:
+		sprintf_s(comm_name, "COM%d", LOWORD(wParam) - IDM_PORT1 + 1);	//Opened by the next Connect
+		CheckMenuRadioItem(GetMenu(hwnd), IDM_PORT1, IDM_PORT8, LOWORD(wParam), MF_BYCOMMAND);
 		break;
 	case IDM_EXIT:
 		Disconnect(hwnd);
 		break;
+	case IDM_PASTE:
+		Paste_Clipboard(hwnd);
+		break;
+	case IDM_SENDFILE:
+		Send_File(hwnd);
+		break;
+	case IDM_SENDCANCEL:
+		End_Send(hwnd);
+		break;
+	case IDM_CAPTURE:
+		Start_Capture(hwnd);
+		break;
+	case IDM_CAPTURESTOP:
+		Stop_Capture(hwnd);
+		break;
+	case IDM_REPLAY1:
+		Start_Replay(hwnd, 1);
+		break;
+	case IDM_REPLAY10:
+		Start_Replay(hwnd, 10);
+		break;
+	case IDM_REPLAYMAX:
+		Start_Replay(hwnd, 0);
+		break;
+	case IDM_REPLAYSTOP:
+		Stop_Replay(hwnd);
+		break;
 	case IDM_RRED:
-		read_color = RGB(255, 0, 0);
+		current->readColor = RGB(255, 0, 0);
 		break;
 	case IDM_RWHITE:
-		read_color = RGB(255, 255, 255);
+		current->readColor = RGB(255, 255, 255);
 		break;
 	case IDM_RGREEN:
-		read_color = RGB(0, 255, 0);
+		current->readColor = RGB(0, 255, 0);
 		break;
 	case IDM_RYELLOW:
-		read_color = RGB(255, 255, 0);
+		current->readColor = RGB(255, 255, 0);
 		break;
 	case IDM_RGREY:
-		read_color = RGB(102, 102, 102);
+		current->readColor = RGB(102, 102, 102);
 		break;
 	case IDM_RBLUE:
-		read_color = RGB(0, 0, 255);
+		current->readColor = RGB(0, 0, 255);
 		break;
 	case IDM_WRED:
-		write_color = RGB(255, 0, 0);
+		current->writeColor = RGB(255, 0, 0);
 		break;
 	case IDM_WWHITE:
-		write_color = RGB(255, 255, 255);
+		current->writeColor = RGB(255, 255, 255);
 		break;
 	case IDM_WGREEN:
-		write_color = RGB(0, 255, 0);
+		current->writeColor = RGB(0, 255, 0);
 		break;
 	case IDM_WYELLOW:
-		write_color = RGB(255, 255, 0);
+		current->writeColor = RGB(255, 255, 0);
 		break;
 	case IDM_WGREY:
-		write_color = RGB(102, 102, 102);
+		current->writeColor = RGB(102, 102, 102);
 		break;
 	case IDM_WBLUE:
-		write_color = RGB(0, 0, 255);
+		current->writeColor = RGB(0, 0, 255);
 		break;
 	}
 }
@@ -313,7 +1455,13 @@ VOID Handle_Menu_Commands(HWND hwnd, WPARAM wParam)
 --
 -- DATE: October 4, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - Applies the scrollback limits to the terminal
+--			  October 17, 2026 - Starts the writer thread and opens txQueue
+--			  October 17, 2026 - Stops a replay first
+--			  October 17, 2026 - Reads through the PortReader reader instead of a Read_From_Serial thread
+--			  October 17, 2026 - Applies hex_scrollback_bytes to the hex view
+--			  October 17, 2026 - Rolls back and stays disconnected when a thread cannot be started
+--			  October 17, 2026 - Opens the port as a new session of sessions and shows it
 --
 -- DESIGNER: Ruoqi Jia
 --
@@ -322,19 +1470,35 @@ VOID Handle_Menu_Commands(HWND hwnd, WPARAM wParam)
 -- INTERFACE: BOOL Connect(HWND hwnd);
 --					-HWND hwnd: Handle to the current windows
 --
--- RETURNS: TRUE if read thread is successfully created. else FALSE
+-- RETURNS: TRUE if the port was opened as a session, else FALSE
 --
 -- NOTES:
---	Enters "Connect" mode of the program. Calls Setup_Comm_Config for the user to enter custom communication parameters
---	and creates a thread for reading
+--	Enters "Connect" mode of the program. Calls Setup_Comm_Config for the user to enter custom communication
+--	parameters for comm_name, then hands the port to sessions, whose one thread reads and writes it along with
+--	every port connected before. The new session gets a terminal and a hex view of its own with the scrollback
+--	limits, the colors of the session shown, and is shown. Ports already connected stay connected; Next Session
+--	goes back to them. When the dialog is cancelled or every session is taken, nothing is left open.
 ----------------------------------------------------------------------------------------------------------------------*/
 BOOL Connect(HWND hwnd)
 {
-	if (!Setup_Comm_Config(hwnd))
+	Win32Transport	*port = new Win32Transport();	//Owned by sessions once opened
+	PortSession		*session;
+	int				id;
+	Stop_Replay(hwnd);	//The replay is drawn in idle, which is not shown once connected
+	if (!Setup_Comm_Config(hwnd, *port))
+	{
+		delete port;
+		return FALSE;
+	}
+	if ((id = sessions.Open(port, comm_name)) == SessionManager::NONE)	//Closes and deletes the port
 		return FALSE;
-	isConnected = TRUE;	//Enter connect mode 
-	return (rThread = CreateThread(NULL, 0, Read_From_Serial,(LPVOID)hwnd, 0, &rThreadId)) 
-	? TRUE : FALSE;	//Create thread for reading
+	session = sessions.Session(id);
+	session->readColor = current->readColor;
+	session->writeColor = current->writeColor;
+	session->terminal.SetScrollback(scrollback_lines, scrollback_bytes);
+	session->hexView.SetLimit(hex_scrollback_bytes);
+	Show_Session(hwnd, id);	//Enter connect mode on the new port
+	return TRUE;
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -342,7 +1506,13 @@ BOOL Connect(HWND hwnd)
 --
 -- DATE: October 4, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - Clears the terminal and recomposes instead of erasing the window
+--			  October 17, 2026 - Stops the writer thread and waits for it to exit
+--			  October 17, 2026 - Ends a file send in progress
+--			  October 17, 2026 - Cancels and closes the port through the Transport interface
+--			  October 17, 2026 - Stops and joins the reader before the port is closed
+--			  October 17, 2026 - Clears the hex view
+--			  October 17, 2026 - Closes the session shown and shows the next one
 --
 -- DESIGNER: Ruoqi Jia
 --
@@ -354,16 +1524,19 @@ BOOL Connect(HWND hwnd)
 -- RETURNS: VOID
 --
 -- NOTES:
---	Exits "Connect" mode of the program. All drawing coordinates and I/O operation histories are cleared to 0.
--- Addtionally it force the window to send a WM_PAINT message to WndProc inorder to wipe out all characters on screen.
+--	Disconnects the port shown. A file it is sending is taken back first, then the session is closed, which waits
+--	until the thread of sessions has let go of the port and closed it, and frees the session's terminal and hex
+--	view. The window shows the next port still connected, or idle and leaves "Connect" mode when that was the
+--	last one; either way the whole window is composed again, which wipes out the characters of the port closed.
 ----------------------------------------------------------------------------------------------------------------------*/
 VOID Disconnect(HWND hwnd)
 {
-	isConnected = FALSE;	//Exit connect mode
-	coor.Reset();			//set x y values to 0
-	rwHistory.clear();		//delete content of all I/O operation 
-	InvalidateRect(hwnd, NULL, TRUE);	//send a WM_PAINT to WndProc
-	CloseHandle(rThread);	//Close read thread handle
-	CloseHandle(hComm);		//Close communication handle
+	int id = shown;
+	if (id == SessionManager::NONE)
+		return;
+	if (sending.view && sending.id == id)
+		End_Send(hwnd);			//The session lets go of the file being sent
+	sessions.Close(id);			//Close communication handle, current goes with it
+	current = &idle;
+	Show_Session(hwnd, Next_Session(id));
 }
-
@@ -8,8 +8,26 @@
 -- VOID Initialize_Window(HINSTANCE &hInst, int nCmdShow, HWND &hwnd, WNDCLASSEX &wcl);
 -- VOID Initialize_WNDCLASSEX(WNDCLASSEX &wcl, HINSTANCE &hInst);
 -- VOID Display_Help();
--- VOID Draw(const char *str, const HDC &hdc, const COLORREF &color, const BOOL &isRepaint, HWND hwnd);
+-- VOID Show_Statistics(HWND hwnd);
+-- VOID Draw_Chunk(const char *buf, DWORD len, const COLORREF &color, HWND hwnd);
+-- VOID Drain_Received(HWND hwnd, int id);
+-- VOID Send_Chars(HWND hwnd, const char *buf, DWORD len);
+-- VOID Send_Key(HWND hwnd, WPARAM key);
+-- VOID Paste_Clipboard(HWND hwnd);
+-- VOID Send_File(HWND hwnd);
+-- VOID Show_Send_Progress(HWND hwnd);
+-- VOID End_Send(HWND hwnd);
+-- VOID Start_Capture(HWND hwnd);
+-- VOID Stop_Capture(HWND hwnd);
+-- VOID Start_Replay(HWND hwnd, double speed);
+-- VOID Stop_Replay(HWND hwnd);
+-- int Run_Replay(LPSTR args);
+-- int Run_Headless_Console(int argc, char **argv);
+-- VOID Update_Metrics(HWND hwnd, BOOL fontChanged);
 -- VOID Repaint(HWND hwnd);
+-- VOID Handle_Scroll(HWND hwnd, WPARAM wParam);
+-- VOID Scroll_Rows(HWND hwnd, long rows);
+-- VOID Continue_Reflow(HWND hwnd);
 -- VOID Handle_Menu_Commands(HWND hwnd, WPARAM wParam);
 -- BOOL Connect(HWND hwnd);
 -- VOID Disconnect(HWND hwnd);
@@ -19,7 +37,7 @@
 --
 -- DATE: October 4, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - Shows one session of sessions at a time, each with its own terminal and hex view
 --
 -- DESIGNER: Ruoqi Jia
 --
@@ -38,6 +56,10 @@
 --  as backspace(remove a character) and return carriage(new line). Additionally, resizing the window 
 --  will not affect the content on screen and the apllication will handle word warpping accordingly.
 --
+--	Every Connect opens another port as a session of sessions, with a terminal and a hex view of its own. The
+--	window shows one session at a time, picked with Next Session; what is typed goes to it, the colors are its
+--	own, and Exit closes it. While no port is connected the window shows idle, which a replay is drawn in.
+--
 --	Note that the specific features that handles read and write operations will be outlined in Physical.h
 ----------------------------------------------------------------------------------------------------------------------*/
 
@@ -49,7 +71,7 @@
 --
 -- DATE: September 28, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - Window has a vertical scrollbar
 --
 -- DESIGNER: Ruoqi Jia
 --
@@ -78,7 +100,7 @@ VOID Initialize_Window(HINSTANCE &hInst, int nCmdShow, HWND &hwnd, WNDCLASSEX &w
 --
 -- DATE: September 28, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - No longer redraws the whole window on every resize
 --
 -- DESIGNER: Ruoqi Jia
 --
@@ -117,9 +139,125 @@ VOID Initialize_WNDCLASSEX(WNDCLASSEX &wcl, HINSTANCE &hInst);
 VOID Display_Help();
 
 /*------------------------------------------------------------------------------------------------------------------
--- FUNCTION: Draw
+-- FUNCTION: Show_Statistics
 --
--- DATE: September 28, 2015
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Shows the stalls of the session shown and how many ports are connected
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Show_Statistics(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Reads the counters and histograms of all threads and shows them in a message box, together with the flow
+--	control stalls of the current or last file send of the session shown and the number of ports connected. Each
+--	time the item is picked the numbers are read again.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Show_Statistics(HWND hwnd);
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Draw_Chunk
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Replaces Draw, characters are drawn in same-color runs
+--			  October 17, 2026 - Backspace only invalidates the erased cell
+--			  October 17, 2026 - Composes into the back buffer instead of drawing on a window DC
+--			  October 17, 2026 - Echoes typed characters through Terminal::Type
+--			  October 17, 2026 - Records them in the hex view as well
+--			  October 17, 2026 - Echoes in the terminal and hex view of the session shown
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Draw_Chunk(const char		*buf,
+--							  DWORD			len,
+--							  const COLORREF &color,
+--							  HWND			hwnd);
+--					-const char		*buf:	The characters typed at the keyboard
+--					-DWORD			len:	Number of characters in buf
+--					-const COLORREF	&color:	The background color the characters will be displayed in
+--					-HWND			hwnd:	Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Echoes typed characters in the terminal of the session shown, which lays them out and handles backspace(erase the
+--	last character typed) and return(new line), and records them in the hex view, then composes the cells that changed
+--	in the view shown into the back buffer. Nothing is drawn on the window directly; the changed areas are invalidated
+--	and copied over on the next WM_PAINT.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Draw_Chunk(const char *buf, DWORD len, const COLORREF &color, HWND hwnd);
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Drain_Received
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Composes the drained bytes once instead of per chunk
+--			  October 17, 2026 - Also draws while a capture is replayed
+--			  October 17, 2026 - Takes the bytes through reader.Receive
+--			  October 17, 2026 - Records the bytes in the hex view as well
+--			  October 17, 2026 - Drains one session of sessions, or replayRing, into its own terminal and hex view
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Drain_Received(HWND hwnd, int id);
+--					-HWND hwnd:	Handle to the current window
+--					-int id:	Session with bytes waiting, NONE for the replay
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Called on the UI thread when WM_SERIAL_DATA arrives. Takes everything the session holds through
+--	sessions.Receive, which re-arms its notification first so bytes that arrive meanwhile post a new message and
+--	has the port read again if it waited for room, and records it with the session's read color in both its
+--	terminal and its hex view, so either can be shown at any time. The replay's bytes are taken out of replayRing
+--	into idle the same way. The cells that changed are composed once, after the session is empty, and only when
+--	it is the session shown. Bytes of a session closed since the message was posted, and of a replay that was
+--	stopped, are discarded.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Drain_Received(HWND hwnd, int id);
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Send_Chars
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Queues the bytes to the session shown
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Send_Chars(HWND hwnd, const char *buf, DWORD len);
+--					-HWND hwnd:			Handle to the current window
+--					-const char *buf:	Bytes to send
+--					-DWORD len:			Number of bytes in buf
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Called for every keystroke and for pastes. The bytes are queued to the session shown first, whose port the
+--	thread of sessions writes them to as soon as it is free, and then echoed on the window with the session's
+--	write color. Neither waits on the other: the UI thread never blocks on the port and the bytes never wait for
+--	the echo to be composed.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Send_Chars(HWND hwnd, const char *buf, DWORD len);
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Send_Key
+--
+-- DATE: October 17, 2026
 --
 -- REVISIONS: (Date and Description)
 --
@@ -127,32 +265,299 @@ VOID Display_Help();
 --
 -- PROGRAMMER: Ruoqi Jia
 --
--- INTERFACE: void Draw (const char		*str,
---						 const HDC		&hdc,
---						 const COLORREF &color,
---						 const BOOL		&isRepaint);
---					-const char		*str:		A pointer to a character to be drawn
---					-const HDC		&hdc:		The device context
---					-const COLORREF	&color:		The background color str will be displayed in
---					-const BOOL		&isRepaint:	Validate if this is used for repaint or not,
---									if it is, call v.push_back(str), else do nothing
---					-HWND	hwnd:		Handle to the current window
+-- INTERFACE: VOID Send_Key(HWND hwnd, WPARAM key);
+--					-HWND hwnd:		Handle to the current window
+--					-WPARAM key:	Character code of a WM_CHAR message
 --
--- RETURNS: void
+-- RETURNS: VOID
 --
 -- NOTES:
---	Process characters to be displayed on the screen with the specific background color. Each character's position
---	is pinpointed using the Coordinates struct, displayed left to right. Additionally the function also
---	handles backspace(delete a character) and return characters(new line).
+--	The window gets WM_CHAR in the ANSI code page, a byte at a time, while the other end reads UTF-8. The
+--	character is converted to UTF-16 and then to UTF-8 and the bytes are handed to Send_Chars. The lead byte of
+--	a double-byte character is held until the trail byte comes in the next WM_CHAR.
 ----------------------------------------------------------------------------------------------------------------------*/
-VOID Draw(const char *str, const HDC &hdc, const COLORREF &color, const BOOL &isRepaint, HWND hwnd);
+VOID Send_Key(HWND hwnd, WPARAM key);
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Paste_Clipboard
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Sends the Unicode text of the clipboard as UTF-8
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Paste_Clipboard(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Sends the text on the clipboard as one span, so the writer thread sends it in chunks of write_chunk_size
+--	bytes and a large paste keeps the link busy instead of costing a write per byte. The text is echoed once,
+--	as a single frame. Does nothing when not connected or when the clipboard holds no text. The text is taken as
+--	Unicode and sent as UTF-8, as typed characters are.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Paste_Clipboard(HWND hwnd);
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Send_File
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Sends on the session shown
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Send_File(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Asks for a file, maps it read-only and attaches the mapping to the session shown, so the thread of sessions
+--	sends it from the file's pages without copying it and keystrokes can still be typed while it goes out. The
+--	file is not echoed. Progress is shown in the title bar every SEND_PROGRESS_MS until End_Send. Only one file is
+--	sent at a time, on the session shown when it started, and nothing is done when not connected.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Send_File(HWND hwnd);
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Show_Send_Progress
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Reads the progress and the stalls from the session sending
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Show_Send_Progress(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Called on the IDT_SEND timer. Shows the percentage sent, the rate over the last interval smoothed with the
+--	earlier ones, the time left at that rate and the number of writes flow control held back.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Show_Send_Progress(HWND hwnd);
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: End_Send
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Takes the file back from the session sending
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID End_Send(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Called when the session has sent the whole file, when the send is cancelled and when the session is closed. Takes
+--	the file back from the session, aborting the write in progress until the thread of sessions lets go of the
+--	mapping, then unmaps and closes it. The title bar is left with a summary of the send. Does nothing when no file is
+--	being sent.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID End_Send(HWND hwnd);
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Start_Capture
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Timestamps with Stats_Now, as the reader does
+--			  October 17, 2026 - Records the session shown
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Start_Capture(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Asks for a file name and starts recording every byte sent and received into it, with its direction and a
+--	Stats_Now timestamp in microseconds, on the session shown. The capture is independent of the connection: it
+--	follows the window from session to session, across Disconnect and Connect, until it is stopped, so it holds
+--	what the window showed. See CaptureLog.h for the file format.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Start_Capture(HWND hwnd);
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Stop_Capture
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Reports a failed write to the capture file
+--			  October 17, 2026 - Takes the capture off the session shown
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Stop_Capture(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Writes out what is still buffered and closes the capture file. Called from the menu and when the window is
+--	destroyed. Reports the bytes that were dropped because the disk could not keep up or a write to the file
+--	failed, if any.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Stop_Capture(HWND hwnd);
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Start_Replay
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Replays into idle through replayRing
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Start_Replay(HWND hwnd, double speed);
+--					-HWND hwnd:		Handle to the current window
+--					-double speed:	1 for the original timing, N for N times faster, 0 for as fast as possible
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Asks for a capture file, clears idle and starts Replay_From_File, which feeds the received bytes of the
+--	capture through replayRing to Drain_Received exactly as a session would. Not available while connected, since
+--	the window shows idle only while no port is.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Start_Replay(HWND hwnd, double speed);
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Stop_Replay
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Drains replayRing
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Stop_Replay(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Ends a replay, early from the menu or on WM_REPLAY_DONE, and waits for the replay thread to exit. What was
+--	replayed stays on screen. Does nothing when no replay is running.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Stop_Replay(HWND hwnd);
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Run_Replay
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int Run_Replay(LPSTR args);
+--					-LPSTR args: Command line after "/replay": an optional ":speed" and the capture file
+--
+-- RETURNS: 0 when the capture was replayed, 1 when it could not be read
+--
+-- NOTES:
+--	Called from WinMain for "/replay[:speed] file", e.g. "/replay:0 session.dtc". Replays the capture headless with
+--	Replay_Headless, into a MemoryRenderTarget the size of an 80 by 25 window of 8 by 16 pixel cells, and prints
+--	the bytes per second and the frame times to the console the program was started from. No window is created.
+--	The speed defaults to 0, as fast as possible.
+----------------------------------------------------------------------------------------------------------------------*/
+int Run_Replay(LPSTR args);
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Run_Headless_Console
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - The port is a session serviced by ioLoop, as the window's ports are
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int Run_Headless_Console(int argc, char **argv);
+--					-int argc:		Number of arguments after "/headless"
+--					-char **argv:	Arguments after "/headless"
+--
+-- RETURNS: The exit code of Headless_Main: 0 on success, 1 when the run failed, 2 for bad arguments
+--
+-- NOTES:
+--	Called from WinMain for "/headless", e.g. "/headless --port COM3 --baud 115200 --send soak.bin --quiet". Runs the
+--	headless front end (see Headless.h) with a Win32Transport made by New_Com, or the built-in loopback for "--port
+--	loop", in the console the program was started from. The port is serviced by ioLoop, which the window's sessions
+--	use otherwise. No window is created and the CommConfigDialog is not shown: the port parameters come from the
+--	arguments. Standard output is only attached to the console when it was not redirected, so what is received can be
+--	piped to a file, and it is put in binary mode so the bytes pass through unchanged, as is standard input for
+--	"--send -".
+----------------------------------------------------------------------------------------------------------------------*/
+int Run_Headless_Console(int argc, char **argv);
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Update_Metrics
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Resizes the back buffer and recomposes the window
+--			  October 17, 2026 - Starts a timer that lays out the rest of the history after a resize
+--			  October 17, 2026 - Updates the hex view as well
+--			  October 17, 2026 - Updates the views of the session shown, the others when they are shown
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Update_Metrics(HWND hwnd, BOOL fontChanged);
+--					-HWND hwnd:			Handle to the current window
+--					-BOOL fontChanged:	TRUE to reload the font metrics, FALSE to only reload the client width
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Refreshes the metrics cache used to lay out characters. Called with TRUE the first time anything is drawn
+--	or after the font changes, and with FALSE on WM_SIZE. When the width or the font changed the rows around
+--	the view are laid out again, and when the rows or the size of the back buffer changed the whole window is
+--	composed again. The rest of the history is laid out by Continue_Reflow. Only the session shown is updated;
+--	Show_Session lays the others out when they are shown.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Update_Metrics(HWND hwnd, BOOL fontChanged);
 
 /*------------------------------------------------------------------------------------------------------------------
 -- FUNCTION: Repaint
 --
 -- DATE: September 28, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - Characters are drawn in same-color runs, one ExtTextOut per run
+--			  October 17, 2026 - Only the rows and cells inside the update rectangle are drawn
+--			  October 17, 2026 - Copies the update rectangle from the back buffer
+--			  October 17, 2026 - Counts the paint and samples how long it took
+--			  October 17, 2026 - Checks the metrics of the session shown
 --
 -- DESIGNER: Ruoqi Jia
 --
@@ -162,17 +567,91 @@ VOID Draw(const char *str, const HDC &hdc, const COLORREF &color, const BOOL &is
 -- RETURNS: VOID
 --
 -- NOTES:
---	Called when the WM_PAINT macro is triggerd. The function iterate through hwHistory and redraws all the 
---	characters currently displayed on the screen
+--	Called when the WM_PAINT macro is triggerd. Everything on screen has already been composed into the back
+--	buffer, so the update rectangle is copied onto the window with a single BitBlt. Nothing is erased first,
+--	which keeps the window from flickering while data is arriving or the window is resized.
 ----------------------------------------------------------------------------------------------------------------------*/
 VOID Repaint(HWND hwnd);
 
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Handle_Scroll
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Handle_Scroll(HWND hwnd, WPARAM wParam);
+--					-HWND	hwnd:	Handle to the current window
+--					-WPARAM wParam: The scroll request of the WM_VSCROLL message
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Moves the view of the history for the vertical scrollbar.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Handle_Scroll(HWND hwnd, WPARAM wParam);
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Scroll_Rows
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Scroll_Rows(HWND hwnd, long rows);
+--					-HWND hwnd: Handle to the current window
+--					-long rows: Rows to move the view down by, negative to move it back
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Moves the view of the history by a number of rows and composes the rows that scroll into view.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Scroll_Rows(HWND hwnd, long rows);
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Continue_Reflow
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Reflows the terminal of the session shown
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Continue_Reflow(HWND hwnd);
+--					-HWND hwnd: Handle to the current window
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Called on WM_TIMER while a resize is still being reflowed. Lays out the next batch of lines of the session
+--	shown and composes whatever changed in view; the timer is stopped once every line is laid out.
+----------------------------------------------------------------------------------------------------------------------*/
+VOID Continue_Reflow(HWND hwnd);
+
+
 /*------------------------------------------------------------------------------------------------------------------
 -- FUNCTION: Handle_Menu_Commands
 --
 -- DATE: October 4, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - Handles the Paste menu item
+--			  October 17, 2026 - Handles the Send File and Cancel Send menu items
+--			  October 17, 2026 - Handles the Start Capture and Stop Capture menu items
+--			  October 17, 2026 - Handles the Replay menu
+--			  October 17, 2026 - Handles the Statistics menu item
+--			  October 17, 2026 - Handles the Hex View menu item
+--			  October 17, 2026 - Handles the Port menu and the Next Session menu item, colors are the session's
 --
 -- DESIGNER: Ruoqi Jia
 --
@@ -184,7 +663,8 @@ VOID Repaint(HWND hwnd);
 -- RETURNS: VOID
 --
 -- NOTES:
---	Handle and process all menu items that are being triggered in the program.
+--	Handle and process all menu items that are being triggered in the program. The colors picked are those of the
+--	session shown; a session connected later starts with the colors of the one shown when it was connected.
 ----------------------------------------------------------------------------------------------------------------------*/
 VOID Handle_Menu_Commands(HWND hwnd, WPARAM wParam);
 
@@ -193,7 +673,13 @@ VOID Handle_Menu_Commands(HWND hwnd, WPARAM wParam);
 --
 -- DATE: October 4, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - Applies the scrollback limits to the terminal
+--			  October 17, 2026 - Starts the writer thread and opens txQueue
+--			  October 17, 2026 - Stops a replay first
+--			  October 17, 2026 - Reads through the PortReader reader instead of a Read_From_Serial thread
+--			  October 17, 2026 - Applies hex_scrollback_bytes to the hex view
+--			  October 17, 2026 - Rolls back and stays disconnected when a thread cannot be started
+--			  October 17, 2026 - Opens the port as a new session of sessions and shows it
 --
 -- DESIGNER: Ruoqi Jia
 --
@@ -202,11 +688,14 @@ VOID Handle_Menu_Commands(HWND hwnd, WPARAM wParam);
 -- INTERFACE: BOOL Connect(HWND hwnd);
 --					-HWND hwnd: Handle to the current windows
 --
--- RETURNS: TRUE if read thread is successfully created. else FALSE
+-- RETURNS: TRUE if the port was opened as a session, else FALSE
 --
 -- NOTES:
---	Enters "Connect" mode of the program. Calls Setup_Comm_Config for the user to enter custom communication parameters 
---	and creates a thread for reading
+--	Enters "Connect" mode of the program. Calls Setup_Comm_Config for the user to enter custom communication
+--	parameters for comm_name, then hands the port to sessions, whose one thread reads and writes it along with
+--	every port connected before. The new session gets a terminal and a hex view of its own with the scrollback
+--	limits, the colors of the session shown, and is shown. Ports already connected stay connected; Next Session
+--	goes back to them. When the dialog is cancelled or every session is taken, nothing is left open.
 ----------------------------------------------------------------------------------------------------------------------*/
 BOOL Connect(HWND hwnd);
 
@@ -215,7 +704,13 @@ BOOL Connect(HWND hwnd);
 --
 -- DATE: October 4, 2015
 --
--- REVISIONS: (Date and Description)
+-- REVISIONS: October 17, 2026 - Clears the terminal and recomposes instead of erasing the window
+--			  October 17, 2026 - Stops the writer thread and waits for it to exit
+--			  October 17, 2026 - Ends a file send in progress
+--			  October 17, 2026 - Cancels and closes the port through the Transport interface
+--			  October 17, 2026 - Stops and joins the reader before the port is closed
+--			  October 17, 2026 - Clears the hex view
+--			  October 17, 2026 - Closes the session shown and shows the next one
 --
 -- DESIGNER: Ruoqi Jia
 --
@@ -227,8 +722,10 @@ BOOL Connect(HWND hwnd);
 -- RETURNS: VOID
 --
 -- NOTES:
---	Exits "Connect" mode of the program. All drawing coordinates and I/O operation histories are cleared to 0.
--- Addtionally it force the window to send a WM_PAINT message to WndProc inorder to wipe out all characters on screen.
+--	Disconnects the port shown. A file it is sending is taken back first, then the session is closed, which waits
+--	until the thread of sessions has let go of the port and closed it, and frees the session's terminal and hex
+--	view. The window shows the next port still connected, or idle and leaves "Connect" mode when that was the
+--	last one; either way the whole window is composed again, which wipes out the characters of the port closed.
 ----------------------------------------------------------------------------------------------------------------------*/
 VOID Disconnect(HWND hwnd);
 
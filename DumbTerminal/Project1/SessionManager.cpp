@@ -0,0 +1,839 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: SessionManager.cpp - Actual function implementation for SessionManager.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- SessionManager(IoLoop &loop, SessionListener &listener);
+-- ~SessionManager();
+-- bool Start(size_t readChunk, size_t writeChunk, unsigned long paceMs);
+-- VOID Stop();
+-- int Open(Transport *port, const char *name);
+-- VOID Close(int id);
+-- PortSession *Session(int id);
+-- size_t Receive(int id, char *buf, size_t len);
+-- VOID Send(int id, const char *buf, size_t len);
+-- VOID Attach(int id, const char *file, size_t len);
+-- bool Detach(int id, unsigned long wait_ms);
+-- VOID AbortWrite(int id);
+-- VOID Progress(int id, size_t &sent, size_t &total) const;
+-- long Stalls(int id) const;
+-- VOID Capture(int id, CaptureLog *log);
+-- int Count() const;
+-- VOID Run();
+-- VOID Service(int id);
+-- bool Flush(Slot &slot);
+-- VOID Done(Slot &slot);
+-- bool Fill(int id);
+-- VOID Fail(int id);
+-- VOID Finish(Slot &slot);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Sessions serviced by one I/O thread. See SessionManager.h.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include "SessionManager.h"
+#include "Stats.h"
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: SessionManager
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: SessionManager(IoLoop &loop, SessionListener &listener);
+--					-IoLoop &loop:					Loop the ports are registered with
+--					-SessionListener &listener:		Told about the sessions, on the loop's thread
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Every slot starts free, with its RingBuffer allocated once for every session opened in it. The port and the
+--	PortSession are only allocated when a port is opened.
+----------------------------------------------------------------------------------------------------------------------*/
+SessionManager::SessionManager(IoLoop &loop, SessionListener &listener)
+	: _loop(loop), _listener(listener), _stop(false), _writeChunk(0), _paceMs(0)
+{
+	for (int id = 0; id < MAX_SESSIONS; ++id)
+	{
+		Slot &slot = _slots[id];
+		slot.state = FREE;
+		slot.registered = false;
+		slot.chunk = NULL;
+		slot.notified = slot.stalled = slot.abort = false;
+		slot.stalls = 0;
+		slot.capture = NULL;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ~SessionManager
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: ~SessionManager();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Stops the loop's thread, closing whatever is still open.
+----------------------------------------------------------------------------------------------------------------------*/
+SessionManager::~SessionManager()
+{
+	Stop();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Start
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Start(size_t readChunk, size_t writeChunk, unsigned long paceMs);
+--					-size_t readChunk:			Most bytes read from a port at a time
+--					-size_t writeChunk:			Most bytes written to a port at a time
+--					-unsigned long paceMs:		Link time one write is sized to cover
+--
+-- RETURNS: false when the thread could not be started or is running already
+--
+-- NOTES:
+--	Allocates the one read buffer all ports share and starts the loop's thread.
+----------------------------------------------------------------------------------------------------------------------*/
+bool SessionManager::Start(size_t readChunk, size_t writeChunk, unsigned long paceMs)
+{
+	if (_thread.joinable())
+		return false;
+	_buffer.assign(readChunk, 0);
+	_writeChunk = writeChunk;
+	_paceMs = paceMs;
+	_stop = false;
+	try
+	{
+		_thread = std::thread(&SessionManager::Run, this);
+	}
+	catch (const std::system_error &)
+	{
+		return false;
+	}
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Stop
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Stop();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Closes every session, then wakes the loop's thread with a key no session has and waits for it to exit. Start
+--	may be called again afterwards.
+----------------------------------------------------------------------------------------------------------------------*/
+void SessionManager::Stop()
+{
+	for (int id = 0; id < MAX_SESSIONS; ++id)
+		Close(id);
+	if (!_thread.joinable())
+		return;
+	_stop = true;
+	_loop.Post((IoLoop::Key)MAX_SESSIONS);
+	_thread.join();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Open
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int Open(Transport *port, const char *name);
+--					-Transport *port:	Port opened and configured, owned by the manager from here on
+--					-const char *name:	Shown for the session, e.g. "COM3"
+--
+-- RETURNS: The id of the session, NONE when every slot is taken; the port is deleted then
+--
+-- NOTES:
+--	Sets up the first free slot, with an empty RingBuffer, an open SendQueue and a new PortSession, whose colors
+--	the owner sets, and posts the id. The port is registered by the loop's thread, which
+--	calls Closed when that fails. The chunk written at a time is worked out here from the port's baud rate.
+----------------------------------------------------------------------------------------------------------------------*/
+int SessionManager::Open(Transport *port, const char *name)
+{
+	PortSettings	settings;
+	int				id;
+	for (id = 0; id < MAX_SESSIONS && _slots[id].state != FREE; ++id)
+		;
+	if (id == MAX_SESSIONS)
+	{
+		delete port;
+		return NONE;
+	}
+	Slot &slot = _slots[id];
+	if (!port->Settings(settings) || settings.baud == 0)
+		settings.baud = 9600;
+	slot.baud = settings.baud;
+	slot.chunkMax = settings.baud / 10 * _paceMs / 1000;	//Ten bits on the line for every byte
+	slot.chunkMax = slot.chunkMax < 64 ? 64 : slot.chunkMax > _writeChunk ? _writeChunk : slot.chunkMax;
+	slot.scratch.reserve(slot.chunkMax);
+	slot.port.reset(port);
+	slot.rx.Clear();
+	slot.session.reset(new PortSession());
+	slot.session->name = name;
+	slot.tx.Open();
+	slot.registered = false;
+	slot.chunk = NULL;
+	slot.notified = slot.stalled = slot.abort = false;
+	slot.stalls = 0;
+	slot.capture = NULL;
+	slot.state = ADDING;
+	_loop.Post((IoLoop::Key)id);
+	return id;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Close
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Close(int id);
+--					-int id: Session to close, NONE or a free id does nothing
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Closes the SendQueue so nothing more is taken, hands the slot to the loop's thread to unregister and close the
+--	port, and waits for it to be done, which takes no longer than one Unregister. When the loop's thread is not
+--	running the port is closed here. Then the port and the PortSession are freed.
+----------------------------------------------------------------------------------------------------------------------*/
+void SessionManager::Close(int id)
+{
+	if (id < 0 || id >= MAX_SESSIONS || _slots[id].state == FREE)
+		return;
+	Slot &slot = _slots[id];
+	slot.tx.Close();
+	if (!_thread.joinable())
+		Finish(slot);
+	else
+	{
+		slot.state = CLOSING;
+		_loop.Post((IoLoop::Key)id);
+		std::unique_lock<std::mutex> guard(_lock);
+		_closed.wait(guard, [&slot] { return slot.state == CLOSED; });
+	}
+	slot.port.reset();
+	slot.session.reset();
+	slot.state = FREE;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Session
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: PortSession *Session(int id);
+--					-int id: An open session
+--
+-- RETURNS: Its PortSession, NULL when id is not open
+----------------------------------------------------------------------------------------------------------------------*/
+PortSession *SessionManager::Session(int id)
+{
+	return id >= 0 && id < MAX_SESSIONS && _slots[id].state != FREE ? _slots[id].session.get() : NULL;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Receive
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Receive(int id, char *buf, size_t len);
+--					-int id:		An open session
+--					-char *buf:		Receives the bytes
+--					-size_t len:	Room in buf
+--
+-- RETURNS: Bytes taken, 0 when none are waiting
+--
+-- NOTES:
+--	Re-arms Received first so bytes that arrive meanwhile are told about again, then takes what the RingBuffer
+--	holds. When the loop's thread left the port alone because the RingBuffer was full, the key is posted so it
+--	reads again now that there is room.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t SessionManager::Receive(int id, char *buf, size_t len)
+{
+	size_t n;
+	if (id < 0 || id >= MAX_SESSIONS || _slots[id].state == FREE)
+		return 0;
+	Slot &slot = _slots[id];
+	slot.notified = false;
+	if ((n = slot.rx.Read(buf, len)) > 0 && slot.stalled.exchange(false))
+		_loop.Post((IoLoop::Key)id);
+	return n;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Send
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Send(int id, const char *buf, size_t len);
+--					-int id:				An open session
+--					-const char *buf:		Bytes to send
+--					-size_t len:			Number of bytes in buf
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Queues the bytes in the session's SendQueue and posts the id so the loop's thread writes them.
+----------------------------------------------------------------------------------------------------------------------*/
+void SessionManager::Send(int id, const char *buf, size_t len)
+{
+	if (id < 0 || id >= MAX_SESSIONS || _slots[id].state == FREE)
+		return;
+	_slots[id].tx.Push(buf, len);
+	_loop.Post((IoLoop::Key)id);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Attach
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Attach(int id, const char *file, size_t len);
+--					-int id:				An open session
+--					-const char *file:		Mapped contents of the file
+--					-size_t len:			Size of the file
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Attaches the file to the session's SendQueue, starts counting stalls from 0 and posts the id. Sent is called
+--	once the last byte was written.
+----------------------------------------------------------------------------------------------------------------------*/
+void SessionManager::Attach(int id, const char *file, size_t len)
+{
+	if (id < 0 || id >= MAX_SESSIONS || _slots[id].state == FREE)
+		return;
+	_slots[id].stalls = 0;
+	_slots[id].tx.Attach(file, len);
+	_loop.Post((IoLoop::Key)id);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Detach
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Detach(int id, unsigned long wait_ms);
+--					-int id:					An open session
+--					-unsigned long wait_ms:		Longest wait
+--
+-- RETURNS: true once the loop's thread holds no pointer into the file, false when wait_ms ran out
+--
+-- NOTES:
+--	See SendQueue::Detach. The caller calls AbortWrite and tries again until it returns true.
+----------------------------------------------------------------------------------------------------------------------*/
+bool SessionManager::Detach(int id, unsigned long wait_ms)
+{
+	if (id < 0 || id >= MAX_SESSIONS || _slots[id].state == FREE)
+		return true;
+	return _slots[id].tx.Detach(wait_ms);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: AbortWrite
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID AbortWrite(int id);
+--					-int id: An open session
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Has the loop's thread give up the rest of the chunk it is writing, which lets go of a file being detached.
+----------------------------------------------------------------------------------------------------------------------*/
+void SessionManager::AbortWrite(int id)
+{
+	if (id < 0 || id >= MAX_SESSIONS || _slots[id].state == FREE)
+		return;
+	_slots[id].abort = true;
+	_loop.Post((IoLoop::Key)id);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Progress
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Progress(int id, size_t &sent, size_t &total) const;
+--					-int id:			An open session
+--					-size_t &sent:		Set to the bytes of the file written
+--					-size_t &total:		Set to the size of the file
+--
+-- RETURNS: VOID
+----------------------------------------------------------------------------------------------------------------------*/
+void SessionManager::Progress(int id, size_t &sent, size_t &total) const
+{
+	sent = total = 0;
+	if (id >= 0 && id < MAX_SESSIONS && _slots[id].state != FREE)
+		_slots[id].tx.Progress(sent, total);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Stalls
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: long Stalls(int id) const;
+--					-int id: An open session
+--
+-- RETURNS: Writes held back by flow control since the last Attach
+--
+-- NOTES:
+--	A write counts as held back when it took much longer than its time on the line, as the writer thread counted.
+----------------------------------------------------------------------------------------------------------------------*/
+long SessionManager::Stalls(int id) const
+{
+	return id >= 0 && id < MAX_SESSIONS ? _slots[id].stalls.load() : 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Capture
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Capture(int id, CaptureLog *log);
+--					-int id:				An open session
+--					-CaptureLog *log:		Capture to record the session in, NULL to stop recording it
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Every chunk the session sends or receives is recorded in log with a Stats_Now timestamp, so log has to be
+--	started with a frequency of 1000000.
+----------------------------------------------------------------------------------------------------------------------*/
+void SessionManager::Capture(int id, CaptureLog *log)
+{
+	if (id >= 0 && id < MAX_SESSIONS)
+		_slots[id].capture = log;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Count
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int Count() const;
+--
+-- RETURNS: Number of sessions open
+----------------------------------------------------------------------------------------------------------------------*/
+int SessionManager::Count() const
+{
+	int count = 0;
+	for (int id = 0; id < MAX_SESSIONS; ++id)
+		if (_slots[id].state != FREE)
+			++count;
+	return count;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Run
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Run();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	The loop's thread. Waits for keys, as many as there are slots at a time, and services each one, until Stop
+--	posts the key past the last slot.
+----------------------------------------------------------------------------------------------------------------------*/
+void SessionManager::Run()
+{
+	IoLoop::Key	keys[MAX_SESSIONS + 1];
+	int			n;
+	while (!_stop)
+	{
+		if ((n = _loop.Wait(keys, MAX_SESSIONS + 1, -1)) < 0)
+			break;
+		for (int i = 0; i < n; ++i)
+			if (keys[i] < (IoLoop::Key)MAX_SESSIONS)
+				Service((int)keys[i]);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Service
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Service(int id);
+--					-int id: Key that came up
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Registers a port that was just opened and closes one that is being closed. An open port has its queued bytes
+--	written first, so a key typed while a flood arrives is not held back by it, then is read until it would block
+--	or the RingBuffer is full. A key of a free, closed or failed slot is left from before and ignored.
+----------------------------------------------------------------------------------------------------------------------*/
+void SessionManager::Service(int id)
+{
+	Slot	&slot = _slots[id];
+	int		state = slot.state;
+	if (state == CLOSING)
+	{
+		Finish(slot);
+		return;
+	}
+	if (state == ADDING)
+	{
+		if (!slot.port->Register(_loop, (IoLoop::Key)id))
+		{
+			Fail(id);
+			return;
+		}
+		slot.registered = true;
+		if (!slot.state.compare_exchange_strong(state, OPEN))	//Closed already, its key is on the way
+			return;
+	}
+	else if (state != OPEN)
+		return;
+	if (!Flush(slot) || !Fill(id))
+		Fail(id);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Flush
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Flush(Slot &slot);
+--					-Slot &slot: An open session
+--
+-- RETURNS: false when the port failed
+--
+-- NOTES:
+--	Writes the chunk in progress and then the next ones polled from the SendQueue, until the queue is empty or
+--	the port has no room, which re-arms it. A chunk is only let go by Done once the port took all of it, or when
+--	AbortWrite gave it up.
+----------------------------------------------------------------------------------------------------------------------*/
+bool SessionManager::Flush(Slot &slot)
+{
+	long written;
+	if (slot.abort.exchange(false) && slot.chunk != NULL)	//Give up the rest of the chunk
+		Done(slot);
+	for (;;)
+	{
+		if (slot.chunk == NULL)
+		{
+			if ((slot.chunkLen = slot.tx.Poll(slot.chunk, slot.scratch, slot.chunkMax)) == 0)
+			{
+				slot.chunk = NULL;
+				return true;
+			}
+			slot.chunkDone = 0;
+			slot.chunkStart = Stats_Now();
+		}
+		while (slot.chunkDone < slot.chunkLen)
+		{
+			if ((written = slot.port->WriteReady(slot.chunk + slot.chunkDone, slot.chunkLen - slot.chunkDone)) < 0)
+				return false;
+			if (written == 0)								//No room, the port is re-armed
+				return true;
+			slot.chunkDone += written;
+			Stats_Count(STAT_WRITES);
+			Stats_Count(STAT_WRITE_BYTES, written);
+			Stats_Sample(STAT_WRITE_SIZE, written);
+		}
+		Done(slot);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Done
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Done(Slot &slot);
+--					-Slot &slot: Session with a chunk in progress
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Accounts for the chunk as the writer thread did: records what the port took in the capture, samples the
+--	keystroke-to-wire latency when typed bytes all went out, counts a stall when it took much longer than its time
+--	on the line, and reports the bytes to the SendQueue, calling Sent when that was the end of the file.
+----------------------------------------------------------------------------------------------------------------------*/
+void SessionManager::Done(Slot &slot)
+{
+	unsigned long long	now = Stats_Now();
+	unsigned long long	linkTime = slot.chunkLen * 10000000ULL / slot.baud;	//Microseconds on the line
+	CaptureLog			*log = slot.capture;
+	if (log != NULL)
+		log->Record(CaptureLog::TX, now, slot.chunk, slot.chunkDone);	//Only what really went out
+	if (slot.chunkDone == slot.chunkLen && slot.tx.TakenAt() != 0)		//Typed bytes are on their way
+		Stats_Sample(STAT_KEY_TO_WIRE_US, now - slot.tx.TakenAt());
+	if (now - slot.chunkStart > 2 * linkTime + _paceMs * 1000ULL)		//Held back by CTS/DSR or XOFF
+		++slot.stalls;
+	slot.chunk = NULL;
+	if (slot.tx.Written(slot.chunkDone, false))
+		_listener.Sent((int)(&slot - _slots));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Fill
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Fill(int id);
+--					-int id: An open session
+--
+-- RETURNS: false when the port failed or hung up
+--
+-- NOTES:
+--	Reads into the shared buffer and appends to the session's RingBuffer, never more than it has room for, until
+--	the port has nothing more, which re-arms it. When the RingBuffer is full the port is left as it is and stalled
+--	is set; it is checked again after that, so room Receive made in between is not missed. Received is called
+--	once for everything read until the owner calls Receive.
+----------------------------------------------------------------------------------------------------------------------*/
+bool SessionManager::Fill(int id)
+{
+	Slot		&slot = _slots[id];
+	CaptureLog	*log;
+	size_t		room;
+	long		n;
+	bool		got = false;
+	for (;;)
+	{
+		if ((room = slot.rx.Free()) == 0)
+		{
+			slot.stalled = true;							//Receive posts the key when it makes room
+			if ((room = slot.rx.Free()) == 0)
+				break;
+			slot.stalled = false;
+		}
+		if ((n = slot.port->ReadReady(_buffer.data(), room < _buffer.size() ? room : _buffer.size())) < 0)
+			return false;
+		if (n == 0)											//Nothing more, the port is re-armed
+			break;
+		if ((log = slot.capture) != NULL)
+			log->Record(CaptureLog::RX, Stats_Now(), _buffer.data(), n);
+		slot.rx.Write(_buffer.data(), n);					//Always fits, n <= Free()
+		Stats_Count(STAT_READS);
+		Stats_Count(STAT_READ_BYTES, n);
+		Stats_Sample(STAT_READ_SIZE, n);
+		Stats_Sample(STAT_RX_DEPTH, slot.rx.Size());
+		got = true;
+	}
+	if (got && !slot.notified.exchange(true))				//Coalesce notifications
+		_listener.Received(id);
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Fail
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Lets go of the chunk in progress
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Fail(int id);
+--					-int id: Session whose port failed
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Marks the session failed, so its key is ignored from now on, and lets go of the chunk in progress as a failed
+--	write, which ends the send of an attached file so Detach does not wait for a write that never comes. Calls
+--	Sent when that ended the send, as Done does, then Closed. The port stays registered until the owner closes the
+--	session. Does nothing when the session is being closed already.
+----------------------------------------------------------------------------------------------------------------------*/
+void SessionManager::Fail(int id)
+{
+	Slot	&slot = _slots[id];
+	int		state = slot.state;
+	if ((state != ADDING && state != OPEN) || !slot.state.compare_exchange_strong(state, FAILED))
+		return;
+	if (slot.chunk != NULL)
+	{
+		slot.chunk = NULL;
+		if (slot.tx.Written(slot.chunkDone, true))
+			_listener.Sent(id);
+	}
+	_listener.Closed(id);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Finish
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Finish(Slot &slot);
+--					-Slot &slot: Session being closed
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Unregisters and closes the port, lets go of the chunk in progress, marks the slot closed and wakes Close.
+----------------------------------------------------------------------------------------------------------------------*/
+void SessionManager::Finish(Slot &slot)
+{
+	if (slot.registered)
+		slot.port->Unregister();
+	slot.registered = false;
+	slot.port->Close();
+	if (slot.chunk != NULL)
+	{
+		slot.tx.Written(slot.chunkDone, false);
+		slot.chunk = NULL;
+	}
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		slot.state = CLOSED;
+	}
+	_closed.notify_all();
+}
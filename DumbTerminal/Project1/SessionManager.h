@@ -0,0 +1,179 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: SessionManager.h - The open ports of the dumb terminal emulator program and the one thread that
+--			services them all
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- SessionManager(IoLoop &loop, SessionListener &listener);
+-- ~SessionManager();
+-- bool Start(size_t readChunk, size_t writeChunk, unsigned long paceMs);
+-- VOID Stop();
+-- int Open(Transport *port, const char *name);
+-- VOID Close(int id);
+-- PortSession *Session(int id);
+-- size_t Receive(int id, char *buf, size_t len);
+-- VOID Send(int id, const char *buf, size_t len);
+-- VOID Attach(int id, const char *file, size_t len);
+-- bool Detach(int id, unsigned long wait_ms);
+-- VOID AbortWrite(int id);
+-- VOID Progress(int id, size_t &sent, size_t &total) const;
+-- long Stalls(int id) const;
+-- VOID Capture(int id, CaptureLog *log);
+-- int Count() const;
+-- VOID Run();
+-- VOID Service(int id);
+-- bool Flush(Slot &slot);
+-- VOID Done(Slot &slot);
+-- bool Fill(int id);
+-- VOID Fail(int id);
+-- VOID Finish(Slot &slot);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - States which front ends use the manager
+--			  October 17, 2026 - The window and the headless mode open their ports as sessions, each has a hex view
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Each open port is a session: the port, the bytes received and not drawn yet, the bytes queued to send, and a
+--	PortSession with the terminal the port's history is laid out in and its two colors. Sessions are identified
+--	by a small id, the index of their slot, which is also the key the port is registered under with the IoLoop.
+--	At most MAX_SESSIONS are open at once.
+--
+--	One thread, started by Start, waits in the loop and services every session whose key comes up: it sends what
+--	the session's SendQueue holds with WriteReady and reads what the port has with ReadReady into the session's
+--	RingBuffer, until the port would block. Nothing blocks a thread per port, so an idle port costs nothing but
+--	its slot. The thread tells the owner through a SessionListener when a session has bytes waiting, when the
+--	file attached to it was sent and when its port failed; the listener is called on the loop's thread and must
+--	not wait for the owner.
+--
+--	Writes are sized as the writer thread sized them: what the line carries in paceMs at the port's baud rate,
+--	at most writeChunk bytes, so typed bytes never wait behind more than a fraction of a second of a file. When
+--	a session's RingBuffer is full its port is left alone, not re-armed, and the owner's Receive posts its key
+--	once it made room, so a slow owner holds back one port and not the others.
+--
+--	Open, Close and everything else are called by one owner thread. Open hands the port to the manager and posts
+--	its key; the loop's thread registers it. Close posts the key again and waits until the loop's thread has
+--	unregistered and closed the port, after which the slot is free for the next Open. The owner may use the
+--	PortSession of an open session at any time, the loop's thread never touches it.
+--
+--	Every front end runs its ports through a SessionManager: the window (Session.cpp) opens one session per
+--	Connect and shows one of them at a time, the headless mode (Headless.cpp) opens the one port it checks, and
+--	dtscale (ScaleBench.cpp) opens hundreds.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef SESSIONMANAGER_H
+#define SESSIONMANAGER_H
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "CaptureLog.h"
+#include "HexView.h"
+#include "IoLoop.h"
+#include "RingBuffer.h"
+#include "SendQueue.h"
+#include "Terminal.h"
+#include "Transport.h"
+struct PortSession
+{
+	PortSession() : readColor(0x00FF00), writeColor(0x00FFFF) {}	//Green and yellow, as the program starts
+
+	std::string		name;					//Port name, e.g. "COM3"
+	Terminal		terminal;				//Everything sent and received on the port
+	HexView			hexView;				//The same bytes as a hex dump
+	unsigned long	readColor;				//Background of received characters
+	unsigned long	writeColor;				//and of typed ones
+};
+
+class SessionListener
+{
+public:
+	virtual ~SessionListener() {}
+	virtual void	Received(int id) = 0;	//Bytes are waiting, not called again until Receive was called
+	virtual void	Sent(int id) = 0;		//The last byte of the attached file was written
+	virtual void	Closed(int id) = 0;		//The port failed or hung up, Close is still up to the owner
+};
+
+class SessionManager
+{
+public:
+	static const int	MAX_SESSIONS = 64;
+	static const int	NONE = -1;			//Returned by Open when no session could be opened
+
+	SessionManager(IoLoop &loop, SessionListener &listener);
+	~SessionManager();
+	bool			Start(size_t readChunk, size_t writeChunk, unsigned long paceMs);	//Start the loop's thread
+	void			Stop();											//Close every session and join the thread
+	int				Open(Transport *port, const char *name);		//Take an open port, its id or NONE
+	void			Close(int id);									//Close the port and free the id
+	PortSession		*Session(int id);								//NULL when id is not open
+	size_t			Receive(int id, char *buf, size_t len);			//Take received bytes
+	void			Send(int id, const char *buf, size_t len);		//Queue bytes to send
+	void			Attach(int id, const char *file, size_t len);	//Send a file without copying it
+	bool			Detach(int id, unsigned long wait_ms);			//Stop sending it, wait until it is let go
+	void			AbortWrite(int id);								//Give up the chunk being written
+	void			Progress(int id, size_t &sent, size_t &total) const;	//Bytes of the file sent so far
+	long			Stalls(int id) const;							//Writes held back since the file was attached
+	void			Capture(int id, CaptureLog *log);				//Record the session in log, NULL to stop
+	int				Count() const;									//Sessions open
+
+private:
+	enum State { FREE, ADDING, OPEN, CLOSING, CLOSED, FAILED };
+
+	static const size_t	RX_CAPACITY = 1 << 16;		//Bytes of a session's RingBuffer, as replayRing has
+
+	struct Slot
+	{
+		Slot() : rx(RX_CAPACITY) {}
+
+		std::atomic<int>				state;
+		std::unique_ptr<Transport>		port;
+		RingBuffer						rx;				//Received, not taken by Receive yet
+		std::unique_ptr<PortSession>	session;
+		SendQueue						tx;
+		bool							registered;		//Loop's thread only from here on
+		size_t							chunkMax;		//Bytes per write at the port's baud rate
+		unsigned long					baud;
+		const char						*chunk;			//Bytes taken from tx, NULL when none
+		size_t							chunkLen;
+		size_t							chunkDone;		//Bytes of chunk the port took
+		unsigned long long				chunkStart;		//Stats_Now when chunk was taken
+		std::vector<char>				scratch;		//Typed bytes gathered by tx.Poll
+		std::atomic<bool>				notified;		//Received was called and Receive not yet
+		std::atomic<bool>				stalled;		//rx was full, Receive has to post the key
+		std::atomic<bool>				abort;			//Set by AbortWrite
+		std::atomic<long>				stalls;
+		std::atomic<CaptureLog *>		capture;
+	};
+
+	void			Run();
+	void			Service(int id);
+	bool			Flush(Slot &slot);
+	void			Done(Slot &slot);
+	bool			Fill(int id);
+	void			Fail(int id);
+	void			Finish(Slot &slot);
+
+	IoLoop					&_loop;
+	SessionListener			&_listener;
+	Slot					_slots[MAX_SESSIONS];
+	std::thread				_thread;
+	std::atomic<bool>		_stop;
+	std::mutex				_lock;				//Guards the wait of Close
+	std::condition_variable	_closed;			//Signalled when a slot becomes CLOSED
+	std::vector<char>		_buffer;			//Reads of every port land here first
+	size_t					_writeChunk;
+	unsigned long			_paceMs;
+};
+#endif
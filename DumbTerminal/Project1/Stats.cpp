@@ -0,0 +1,434 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: Stats.cpp - Actual function implementation for Stats.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- VOID Stats_Count(StatCounter counter, unsigned long long n);
+-- VOID Stats_Sample(StatHistogram histogram, unsigned long long value);
+-- unsigned long long Stats_Now();
+-- VOID Stats_Read(StatsSnapshot &snapshot);
+-- unsigned long long Stats_Percentile(const StatsSnapshot &snapshot, StatHistogram histogram, double p);
+-- std::string Stats_Format(const StatsSnapshot &snapshot, bool window);
+-- static StatsBlock &Own();
+-- static int Bucket_Of(unsigned long long value);
+-- static VOID Append_Histogram(std::string &out, const StatsSnapshot &snapshot, const char *name,
+--						StatHistogram histogram, const char *unit);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Per-thread counter blocks added up on read. See Stats.h.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include "Stats.h"
+struct StatsBlock						//Counters of one thread, written by it alone
+{
+	std::atomic<unsigned long long>	counters[STAT_COUNTERS];
+	struct
+	{
+		std::atomic<unsigned long long>	count, sum, max;
+		std::atomic<unsigned long long>	buckets[STAT_BUCKETS];
+	}								histograms[STAT_HISTOGRAMS];
+	bool							inUse;		//Owned by a running thread, guarded by the registry lock
+	char							pad[64];	//Keeps the next block off the last cache line of this one
+};
+
+class StatsOwner						//Ties a block to the thread for as long as the thread runs
+{
+public:
+	StatsOwner();
+	~StatsOwner();
+	StatsBlock	*block;
+};
+
+static std::mutex				registryLock;
+static std::vector<StatsBlock *>	registry;	//Every block handed out, never freed
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: StatsOwner
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: StatsOwner();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Takes a block a thread that ended gave back, or makes a new one with every count at zero.
+----------------------------------------------------------------------------------------------------------------------*/
+StatsOwner::StatsOwner()
+	: block(NULL)
+{
+	std::lock_guard<std::mutex> guard(registryLock);
+	for (size_t i = 0; i < registry.size() && block == NULL; ++i)
+		if (!registry[i]->inUse)
+			block = registry[i];
+	if (block == NULL)
+	{
+		block = new StatsBlock;
+		for (int c = 0; c < STAT_COUNTERS; ++c)
+			block->counters[c].store(0, std::memory_order_relaxed);
+		for (int h = 0; h < STAT_HISTOGRAMS; ++h)
+		{
+			block->histograms[h].count.store(0, std::memory_order_relaxed);
+			block->histograms[h].sum.store(0, std::memory_order_relaxed);
+			block->histograms[h].max.store(0, std::memory_order_relaxed);
+			for (int b = 0; b < STAT_BUCKETS; ++b)
+				block->histograms[h].buckets[b].store(0, std::memory_order_relaxed);
+		}
+		registry.push_back(block);
+	}
+	block->inUse = true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ~StatsOwner
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: ~StatsOwner();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Runs when the thread ends. The block keeps its counts, which stay in the totals, and is free for the next
+--	thread to add to.
+----------------------------------------------------------------------------------------------------------------------*/
+StatsOwner::~StatsOwner()
+{
+	std::lock_guard<std::mutex> guard(registryLock);
+	block->inUse = false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Own
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static StatsBlock &Own();
+--
+-- RETURNS: The block of the calling thread
+--
+-- NOTES:
+--	The first call on a thread takes the registry lock to get a block; every later one is a thread-local lookup.
+----------------------------------------------------------------------------------------------------------------------*/
+static StatsBlock &Own()
+{
+	static thread_local StatsOwner owner;
+	return *owner.block;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Bucket_Of
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static int Bucket_Of(unsigned long long value);
+--					-unsigned long long value: A sample
+--
+-- RETURNS: 0 for 0, else the number of bits value takes, 1 to 64
+--
+-- NOTES:
+--	Six halving steps, without a compiler intrinsic so it builds the same everywhere.
+----------------------------------------------------------------------------------------------------------------------*/
+static int Bucket_Of(unsigned long long value)
+{
+	int bucket = 0;
+	for (int shift = 32; shift > 0; shift >>= 1)
+		if (value >> shift)
+		{
+			value >>= shift;
+			bucket += shift;
+		}
+	return bucket + (int)value;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Stats_Count
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Stats_Count(StatCounter counter, unsigned long long n);
+--					-StatCounter counter:	Counter to add to
+--					-unsigned long long n:	Amount to add, 1 by default
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	The calling thread is the only writer of its block, so a relaxed load and store is enough; the atomics are
+--	only there so a reader on another thread never sees a torn value.
+----------------------------------------------------------------------------------------------------------------------*/
+void Stats_Count(StatCounter counter, unsigned long long n)
+{
+	std::atomic<unsigned long long> &c = Own().counters[counter];
+	c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Stats_Sample
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Stats_Sample(StatHistogram histogram, unsigned long long value);
+--					-StatHistogram histogram:	Histogram to add to
+--					-unsigned long long value:	The sample, e.g. a size or a number of microseconds
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Counts the sample in its bucket and adds it to the sum, the same way Stats_Count does.
+----------------------------------------------------------------------------------------------------------------------*/
+void Stats_Sample(StatHistogram histogram, unsigned long long value)
+{
+	StatsBlock &block = Own();
+	std::atomic<unsigned long long> &bucket = block.histograms[histogram].buckets[Bucket_Of(value)];
+	std::atomic<unsigned long long> &count = block.histograms[histogram].count;
+	std::atomic<unsigned long long> &sum = block.histograms[histogram].sum;
+	std::atomic<unsigned long long> &max = block.histograms[histogram].max;
+	bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	sum.store(sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+	if (value > max.load(std::memory_order_relaxed))
+		max.store(value, std::memory_order_relaxed);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Stats_Now
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: unsigned long long Stats_Now();
+--
+-- RETURNS: Microseconds of the steady clock
+--
+-- NOTES:
+--	The same clock on every thread, so a time taken on the UI thread can be subtracted on the writer thread.
+----------------------------------------------------------------------------------------------------------------------*/
+unsigned long long Stats_Now()
+{
+	return (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Stats_Read
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Stats_Read(StatsSnapshot &snapshot);
+--					-StatsSnapshot &snapshot: Set to the totals of all threads
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Adds up every block while the threads go on counting, so a snapshot is not an instant across threads, but
+--	every value in it is one the thread really had.
+----------------------------------------------------------------------------------------------------------------------*/
+void Stats_Read(StatsSnapshot &snapshot)
+{
+	std::lock_guard<std::mutex> guard(registryLock);
+	memset(&snapshot, 0, sizeof(snapshot));
+	for (size_t i = 0; i < registry.size(); ++i)
+	{
+		const StatsBlock &block = *registry[i];
+		for (int c = 0; c < STAT_COUNTERS; ++c)
+			snapshot.counters[c] += block.counters[c].load(std::memory_order_relaxed);
+		for (int h = 0; h < STAT_HISTOGRAMS; ++h)
+		{
+			snapshot.histograms[h].count += block.histograms[h].count.load(std::memory_order_relaxed);
+			snapshot.histograms[h].sum += block.histograms[h].sum.load(std::memory_order_relaxed);
+			if (block.histograms[h].max.load(std::memory_order_relaxed) > snapshot.histograms[h].max)
+				snapshot.histograms[h].max = block.histograms[h].max.load(std::memory_order_relaxed);
+			for (int b = 0; b < STAT_BUCKETS; ++b)
+				snapshot.histograms[h].buckets[b] += block.histograms[h].buckets[b].load(std::memory_order_relaxed);
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Stats_Percentile
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: unsigned long long Stats_Percentile(const StatsSnapshot &snapshot, StatHistogram histogram, double p);
+--					-const StatsSnapshot &snapshot:	Totals from Stats_Read
+--					-StatHistogram histogram:		Histogram to look at
+--					-double p:						Percentile, 0 to 100
+--
+-- RETURNS: The upper bound of the bucket the percentile falls in, never more than the largest sample; 0 when
+--			there are no samples
+--
+-- NOTES:
+--	The bound is at most twice the real value, which is the resolution of the histogram.
+----------------------------------------------------------------------------------------------------------------------*/
+unsigned long long Stats_Percentile(const StatsSnapshot &snapshot, StatHistogram histogram, double p)
+{
+	unsigned long long count = snapshot.histograms[histogram].count, seen = 0, bound;
+	unsigned long long rank = (unsigned long long)(count * p / 100);
+	if (count == 0)
+		return 0;
+	for (int b = 0; b < STAT_BUCKETS; ++b)
+		if ((seen += snapshot.histograms[histogram].buckets[b]) > rank || seen == count)
+		{
+			bound = b == 0 ? 0 : b == 64 ? ~0ULL : (1ULL << b) - 1;
+			return bound < snapshot.histograms[histogram].max ? bound : snapshot.histograms[histogram].max;
+		}
+	return snapshot.histograms[histogram].max;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Append_Histogram
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Append_Histogram(std::string &out, const StatsSnapshot &snapshot, const char *name,
+--						StatHistogram histogram, const char *unit);
+--					-std::string &out:					Text the line is added to
+--					-const StatsSnapshot &snapshot:		Totals from Stats_Read
+--					-const char *name:					What the histogram measures
+--					-StatHistogram histogram:			Histogram to summarize
+--					-const char *unit:					Unit of the samples
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	One line: the number of samples, their mean, the 50th and 99th percentiles and the largest.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Append_Histogram(std::string &out, const StatsSnapshot &snapshot, const char *name,
+	StatHistogram histogram, const char *unit)
+{
+	char line[256];
+	unsigned long long count = snapshot.histograms[histogram].count;
+	snprintf(line, sizeof(line), "%-22s %10llu samples, mean %.1f, p50 <= %llu, p99 <= %llu, max %llu %s\n", name,
+		count, count ? (double)snapshot.histograms[histogram].sum / count : 0.0,
+		Stats_Percentile(snapshot, histogram, 50), Stats_Percentile(snapshot, histogram, 99),
+		snapshot.histograms[histogram].max, unit);
+	out += line;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Stats_Format
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - What only the window samples is left out for the headless mode
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: std::string Stats_Format(const StatsSnapshot &snapshot, bool window);
+--					-const StatsSnapshot &snapshot:	Totals from Stats_Read
+--					-bool window:					Include what only the window samples: the depths of the
+--													sessions' rings and queues, the paints and the keystroke latency
+--
+-- RETURNS: The statistics as lines of text
+--
+-- NOTES:
+--	Port traffic and error flags first, then the queues, the screen and the keystroke latency.
+----------------------------------------------------------------------------------------------------------------------*/
+std::string Stats_Format(const StatsSnapshot &snapshot, bool window)
+{
+	char		line[256];
+	std::string	out;
+	const unsigned long long *c = snapshot.counters;
+	snprintf(line, sizeof(line), "Reads %llu, %llu bytes; writes %llu, %llu bytes\n", c[STAT_READS],
+		c[STAT_READ_BYTES], c[STAT_WRITES], c[STAT_WRITE_BYTES]);
+	out += line;
+	snprintf(line, sizeof(line), "Errors: overrun %llu, framing %llu, parity %llu, receive queue full %llu, "
+		"break %llu\n", c[STAT_OVERRUN], c[STAT_FRAMING], c[STAT_PARITY], c[STAT_RXOVER], c[STAT_BREAK]);
+	out += line;
+	Append_Histogram(out, snapshot, "Bytes per read", STAT_READ_SIZE, "bytes");
+	Append_Histogram(out, snapshot, "Bytes per write", STAT_WRITE_SIZE, "bytes");
+	if (window)
+	{
+		Append_Histogram(out, snapshot, "Receive ring depth", STAT_RX_DEPTH, "bytes");
+		Append_Histogram(out, snapshot, "Send queue depth", STAT_TX_DEPTH, "bytes");
+	}
+	if (window)
+		snprintf(line, sizeof(line), "Frames %llu, paints %llu\n", c[STAT_FRAMES], c[STAT_PAINTS]);
+	else
+		snprintf(line, sizeof(line), "Frames %llu\n", c[STAT_FRAMES]);
+	out += line;
+	Append_Histogram(out, snapshot, "Frame compose time", STAT_FRAME_US, "us");
+	if (window)
+	{
+		Append_Histogram(out, snapshot, "Paint time", STAT_PAINT_US, "us");
+		Append_Histogram(out, snapshot, "Keystroke to wire", STAT_KEY_TO_WIRE_US, "us");
+	}
+	return out;
+}
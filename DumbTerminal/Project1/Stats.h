@@ -0,0 +1,92 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: Stats.h - Always-on counters and latency histograms of the hot paths of the dumb terminal emulator
+--			program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- VOID Stats_Count(StatCounter counter, unsigned long long n);
+-- VOID Stats_Sample(StatHistogram histogram, unsigned long long value);
+-- unsigned long long Stats_Now();
+-- VOID Stats_Read(StatsSnapshot &snapshot);
+-- unsigned long long Stats_Percentile(const StatsSnapshot &snapshot, StatHistogram histogram, double p);
+-- std::string Stats_Format(const StatsSnapshot &snapshot, bool window);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Every thread that counts gets a block of counters of its own the first time it does, and is the only writer
+--	of it, so counting is a plain load and store of a thread-local value: no lock, no atomic read-modify-write and
+--	no cache line shared with another thread. Stats_Read adds up the blocks of all threads, under a lock that only
+--	readers and threads starting or ending take. When a thread ends its block is kept, totals and all, and handed
+--	to the next thread that starts counting, so connecting and disconnecting over and over does not grow memory.
+--
+--	A histogram counts samples in powers of two: bucket 0 holds 0, bucket b holds 2^(b-1) to 2^b - 1. That is all
+--	a latency or size distribution needs to spot a regression, and a sample is one bucket increment. Percentiles
+--	are reported as the upper bound of the bucket they fall in.
+--
+--	The counters and histograms are listed below. Stats_Format turns a snapshot into the text the Statistics menu
+--	item shows and the headless mode prints. The headless mode hands received bytes to the terminal on the thread
+--	that reads them, writes from its own buffer and paints nothing, so it leaves out the queue depths, the paints
+--	and the keystroke latency, which only the window samples.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef STATS_H
+#define STATS_H
+#include <string>
+enum StatCounter
+{
+	STAT_READS,							//Port reads that returned bytes
+	STAT_READ_BYTES,
+	STAT_WRITES,						//Port writes that sent bytes
+	STAT_WRITE_BYTES,
+	STAT_OVERRUN,						//Error flags reported by the driver: character lost by the UART
+	STAT_FRAMING,						//Bad stop bit
+	STAT_PARITY,						//Parity error
+	STAT_RXOVER,						//Receive queue of the driver full
+	STAT_BREAK,							//Break received
+	STAT_FRAMES,						//Frames composed from received bytes
+	STAT_PAINTS,						//WM_PAINT handled
+	STAT_COUNTERS
+};
+
+enum StatHistogram
+{
+	STAT_READ_SIZE,						//Bytes per read
+	STAT_WRITE_SIZE,					//Bytes per write
+	STAT_RX_DEPTH,						//Bytes waiting in a session's ring after each read
+	STAT_TX_DEPTH,						//Bytes waiting in a session's queue when a write takes some
+	STAT_FRAME_US,						//Microseconds to compose a frame
+	STAT_PAINT_US,						//Microseconds to handle WM_PAINT
+	STAT_KEY_TO_WIRE_US,				//Microseconds from a key or paste being queued to its write completing
+	STAT_HISTOGRAMS
+};
+
+static const int STAT_BUCKETS = 65;		//0, then one per power of two of a 64-bit value
+
+struct StatsSnapshot
+{
+	unsigned long long	counters[STAT_COUNTERS];
+	struct
+	{
+		unsigned long long	count;		//Samples
+		unsigned long long	sum;		//Of the samples
+		unsigned long long	max;		//Largest sample
+		unsigned long long	buckets[STAT_BUCKETS];
+	}					histograms[STAT_HISTOGRAMS];
+};
+
+void				Stats_Count(StatCounter counter, unsigned long long n = 1);
+void				Stats_Sample(StatHistogram histogram, unsigned long long value);
+unsigned long long	Stats_Now();					//Microseconds of a steady clock, for latencies
+void				Stats_Read(StatsSnapshot &snapshot);
+unsigned long long	Stats_Percentile(const StatsSnapshot &snapshot, StatHistogram histogram, double p);
+std::string			Stats_Format(const StatsSnapshot &snapshot, bool window);
+#endif
@@ -0,0 +1,1848 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: Terminal.cpp - Actual function implementation for Terminal.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- Terminal();
+-- bool UpdateMetrics(const MetricsProvider &provider, bool fontChanged);
+-- VOID Write(const char *buf, size_t len, unsigned long color);
+-- VOID Type(const char *buf, size_t len, unsigned long color);
+-- VOID Clear();
+-- bool NextDirty(int &left, int &top, int &right, int &bottom);
+-- VOID Compose(RenderTarget &target, int left, int top, int right, int bottom);
+-- VOID QueueCell(RenderTarget &target, int x, int y, unsigned int c, unsigned long color);
+-- VOID FlushRun(RenderTarget &target);
+-- VOID PaintRow(RenderTarget &target, size_t row, int left, int right);
+-- VOID NewRow(size_t line, size_t col);
+-- size_t RowEnd(size_t row) const;
+-- int RowWidth(size_t row) const;
+-- VOID EraseLast();
+-- VOID Layout();
+-- VOID ScrollTo(size_t row);
+-- VOID ScrollBy(long rows);
+-- int TakeScroll();
+-- size_t PageRows() const;
+-- size_t ViewRows() const;
+-- size_t MaxTop() const;
+-- VOID MoveTop(size_t top);
+-- VOID MarkView(int top, int bottom);
+-- bool Reflow(size_t lines);
+-- VOID Wrap(size_t line, std::vector<size_t> &starts) const;
+-- int MeasureLine(size_t line) const;
+-- VOID LayoutTail(size_t to);
+-- VOID PutChar(unsigned int c, unsigned long color);
+-- VOID LineBreak();
+-- VOID Tab(unsigned long color);
+-- VOID CursorLeft();
+-- VOID CursorRight();
+-- VOID FindCursor();
+-- VOID Rewrap(size_t row);
+-- VOID EndWrite();
+-- VOID Print(const char *text, size_t len);
+-- size_t PrintAscii(const char *text, size_t len);
+-- size_t PrintUtf8(const char *text, size_t len);
+-- VOID FlushUtf8();
+-- VOID Execute(char c);
+-- VOID EscDispatch(const VtSequence &seq, char final);
+-- VOID CsiDispatch(const VtSequence &seq, char final);
+-- VOID OscDispatch(const char *text, size_t len);
+-- VOID SelectGraphics(const VtSequence &seq);
+-- VOID CarriageReturn();
+-- VOID MoveToColumn(size_t col);
+-- VOID Blank(size_t from, size_t count);
+-- VOID EraseToEnd();
+-- VOID EraseInLine(unsigned int mode);
+-- static unsigned int Nearest_Xterm(unsigned long rgb);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - History is trimmed to the scrollback limits after every write
+--			  October 17, 2026 - Only the rows in the view are composed, the view can be scrolled
+--			  October 17, 2026 - Resizing reflows the view first and the rest of the history in steps
+--			  October 17, 2026 - Backspace, return, line feed and tab move a cursor on the last line
+--			  October 17, 2026 - Received bytes go through a VT100/ANSI parser: colors, cursor moves and erases
+--			  October 17, 2026 - Text is decoded as UTF-8, cells hold Unicode code points
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Layout and composition of the terminal. See Terminal.h.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include "Terminal.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Nearest_Xterm
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static unsigned int Nearest_Xterm(unsigned long rgb);
+--					-unsigned long rgb: Color as 0x00BBGGRR
+--
+-- RETURNS: The index of the closest color of the xterm color cube or gray ramp
+--
+-- NOTES:
+--	Each component is rounded to the nearest step of the color cube and the result is compared with the
+--	nearest gray, whichever is closer wins.
+----------------------------------------------------------------------------------------------------------------------*/
+static unsigned int Nearest_Xterm(unsigned long rgb)
+{
+	int c[3] = { (int)(rgb & 0xFF), (int)(rgb >> 8 & 0xFF), (int)(rgb >> 16 & 0xFF) }, step[3];
+	int cube = 0, gray, level, cubeError = 0, grayError = 0;
+	for (int i = 0; i < 3; ++i)
+	{
+		step[i] = c[i] < 48 ? 0 : c[i] < 115 ? 1 : (c[i] - 35) / 40;
+		level = step[i] == 0 ? 0 : 55 + step[i] * 40;
+		cubeError += (c[i] - level) * (c[i] - level);
+		cube = cube * 6 + step[i];
+	}
+	gray = (c[0] + c[1] + c[2]) / 3;
+	gray = gray < 8 ? 0 : gray > 238 ? 23 : (gray - 3) / 10;
+	for (int i = 0; i < 3; ++i)
+		grayError += (c[i] - (8 + gray * 10)) * (c[i] - (8 + gray * 10));
+	return grayError < cubeError ? 232 + gray : 16 + cube;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Terminal
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Starts with the width of the first line
+--			  October 17, 2026 - Starts with the cursor at the origin
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: Terminal();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Starts empty. UpdateMetrics has to be called before anything is written.
+----------------------------------------------------------------------------------------------------------------------*/
+Terminal::Terminal()
+	: _col(0), _crow(0), _x(0), _typed(0), _laidFrom(0), _prefixLine(0), _laidTo(0), _tailPending(false), _top(0), _follow(true), _scroll(0), _bandTop(0), _bandBottom(0), _color(0), _back(0), _sgrBack(false), _ink(0), _drawCalls(0), _cells(0)
+{
+	_run.len = 0;
+	_lineWidth.push_back(0);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: UpdateMetrics
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Also reads the client height and keeps the view in range
+--			  October 17, 2026 - Measures every line again when the font changes
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool UpdateMetrics(const MetricsProvider &provider, bool fontChanged);
+--					-const MetricsProvider &provider:	Source of the font and window metrics
+--					-bool fontChanged:					true to reload the font metrics, false for the width only
+--
+-- RETURNS: true when the rows were laid out again or the view changed size, and the whole window has to be composed
+--
+-- NOTES:
+--	Called the first time anything is drawn or after the font changes with true, and after a resize with false.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Terminal::UpdateMetrics(const MetricsProvider &provider, bool fontChanged)
+{
+	int width = _metrics.ClientWidth(), height = _metrics.ClientHeight();
+	if (fontChanged || !_metrics.Valid())
+	{
+		_metrics.Refresh(provider);
+		fontChanged = true;
+	}
+	else
+		_metrics.RefreshSize(provider);
+	bool relaid = fontChanged || width != _metrics.ClientWidth();
+	if (fontChanged)									//Every advance width may have changed
+		for (size_t line = 0; line < _lineWidth.size(); ++line)
+			_lineWidth[line] = MeasureLine(line);
+	if (relaid)
+		Layout();
+	if (!relaid && height == _metrics.ClientHeight())
+		return false;
+	_top = _follow || _top > MaxTop() ? MaxTop() : _top;
+	_scroll = _bandTop = _bandBottom = 0;				//Caller composes the whole view
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Write
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Trims the history to the scrollback limits
+--			  October 17, 2026 - Keeps the view on the last row while it follows
+--			  October 17, 2026 - Keeps the width of every line, finishes the lines after the view first
+--			  October 17, 2026 - Backspace, return, line feed and tab are cursor moves, trimming moved to EndWrite
+--			  October 17, 2026 - Bytes go through the escape sequence parser
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Write(const char *buf, size_t len, unsigned long color);
+--					-const char *buf:		The characters received from the serial port or typed
+--					-size_t len:			Number of characters in buf
+--					-unsigned long color:	The background color the characters are displayed in
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Records received characters at the cursor and lays them out left to right, wrapping to a new row when a
+--	character does not fit in the client width. The bytes are fed to the parser, which calls Print for text,
+--	Execute for control characters and CsiDispatch for the sequences that color, move and erase. The parser keeps
+--	a sequence split across two writes. The rows written to are marked dirty from the first pixel that changed.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::Write(const char *buf, size_t len, unsigned long color)
+{
+	if (_tailPending)									//Characters go on the last line
+		LayoutTail(_screen.LineCount());
+	_color = color;
+	_parser.Feed(buf, len, *this);						//Calls back Print, Execute and the dispatches
+	_typed = 0;											//Whatever was typed is followed by remote output now
+	EndWrite();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Type
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - A LF right after a CR in the same buffer does not break the line again, so pasted text echoes once per line
+--			  October 17, 2026 - Decodes the typed text as UTF-8
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Type(const char *buf, size_t len, unsigned long color);
+--					-const char *buf:		The characters typed at the keyboard
+--					-size_t len:			Number of characters in buf
+--					-unsigned long color:	The background color the characters are displayed in
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Echoes typed characters. Backspace erases the last character typed, as long as nothing was received after it
+--	and the cursor is at the end of the line; otherwise it does nothing. Return and line feed start a new line, and
+--	a CR LF pair inside one buffer (as pasted text has) starts only one.
+--	Everything else is written at the cursor the same way Write does. The text is UTF-8 and is decoded here;
+--	backspace erases a whole character however many bytes it took.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::Type(const char *buf, size_t len, unsigned long color)
+{
+	Utf8Decoder		utf8;								//Typed text never splits a sequence between calls
+	unsigned int	decoded[2];
+	if (_tailPending)									//Characters go on the last line
+		LayoutTail(_screen.LineCount());
+	for (size_t i = 0; i <= len; ++i)					//One past the end ends an unfinished sequence
+	{
+		size_t n = i < len ? utf8.Decode(buf + i, 1, decoded) : utf8.Flush(decoded[0]) ? 1 : 0;
+		for (size_t k = 0; k < n; ++k)
+		{
+			unsigned int c = decoded[k];
+			size_t line = _screen.LineCount() - 1, end = _screen.LineLength(line);
+			if (c == '\b')
+			{
+				if (_typed > 0 && _col == end)			//Only what was typed here can be erased
+				{
+					EraseLast();
+					--_typed;
+				}
+			}
+			else if (c == '\r' || c == '\n')
+			{
+				if (c == '\n' && i > 0 && buf[i - 1] == '\r')	//A pasted CR LF breaks the line once
+					continue;
+				LineBreak();
+				_typed = 0;
+			}
+			else
+			{
+				bool atEnd = _col == end;
+				if (c == '\t')
+					Tab(color);
+				else
+					PutChar(c, color);
+				_typed = atEnd ? _typed + _screen.LineLength(line) - end : 0;
+			}
+		}
+	}
+	EndWrite();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: EndWrite
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID EndWrite();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Trims the history to the scrollback limits after a write and keeps the view on the last row while it
+--	follows. Rows that are dropped from the front are above the view, so the view only has to be renumbered.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::EndWrite()
+{
+	size_t head, dropped = _screen.Trim(head);
+	if (dropped || head)								//History was trimmed
+	{
+		_lineWidth.erase(_lineWidth.begin(), _lineWidth.begin() + dropped);
+		if (head)
+			_lineWidth[0] = MeasureLine(0);
+		if (_laidFrom > 0)								//Start the lines before the view over
+		{
+			_laidFrom = _laidFrom > dropped ? _laidFrom - dropped : 0;
+			_prefix.clear();
+			_prefixLine = 0;
+		}
+		size_t removed = _rows.DropFront(dropped, head);
+		if (head && _screen.LineCount() == 1)			//The cursor's line lost its head
+		{
+			_col = _col > head ? _col - head : 0;
+			_typed = 0;
+		}
+		FindCursor();
+		if (_top >= removed)							//Same rows stay in view
+			_top -= removed;
+		else
+		{
+			_top = 0;
+			_scroll = 0;
+			MarkView(0, (int)ViewRows() * _metrics.LineHeight());
+		}
+	}
+	if (_follow && MaxTop() > _top)						//Keep the last row in view
+		MoveTop(MaxTop());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Clear
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Forgets rows left to clear by a trim
+--			  October 17, 2026 - Moves the view back to the top
+--			  October 17, 2026 - Forgets a reflow in progress
+--			  October 17, 2026 - Moves the cursor back to the origin
+--			  October 17, 2026 - Forgets a sequence in progress and the colors set by SGR
+--			  October 17, 2026 - Forgets an unfinished UTF-8 sequence
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Clear();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Drops the whole history and moves back to the origin. The caller composes the whole window afterwards.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::Clear()
+{
+	_screen.Clear();
+	_rows.Clear();
+	_col = _crow = _typed = 0;
+	_x = 0;
+	_lineWidth.assign(1, 0);
+	_prefix.clear();
+	_laidFrom = _prefixLine = _laidTo = 0;
+	_tailPending = false;
+	_top = 0;
+	_follow = true;
+	_scroll = _bandTop = _bandBottom = 0;
+	_parser.Reset();
+	_utf8.Reset();
+	_sgrBack = false;
+	_ink = 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: NextDirty
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Also returns the rows emptied by a trim
+--			  October 17, 2026 - Areas are in view coordinates, rows outside the view are skipped
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool NextDirty(int &left, int &top, int &right, int &bottom);
+--					-int &left, &top, &right, &bottom: Set to the area of the window that changed
+--
+-- RETURNS: true when an area was returned, false when nothing else changed
+--
+-- NOTES:
+--	The area exposed by scrolling the view is returned first, then the changed part of each row in the view,
+--	from its leftmost changed pixel to the right edge. Dirty rows outside the view are dropped since they are
+--	composed anyway when the view is scrolled to them. Areas are in view coordinates.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Terminal::NextDirty(int &left, int &top, int &right, int &bottom)
+{
+	size_t row;
+	if (_bandBottom > _bandTop)							//Rows exposed by scrolling come first
+	{
+		left = 0, top = _bandTop;
+		right = _metrics.ClientWidth(), bottom = _bandBottom;
+		_bandTop = _bandBottom = 0;
+		return true;
+	}
+	while (_rows.NextDirty(row, left))
+		if (row >= _top && row < _top + ViewRows())		//Rows outside the view are composed when scrolled to
+		{
+			top = (int)(row - _top) * _metrics.LineHeight();
+			right = _metrics.ClientWidth();
+			bottom = top + _metrics.LineHeight();
+			return true;
+		}
+	return false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Compose
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Composes the rows of the view
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Compose(RenderTarget &target, int left, int top, int right, int bottom);
+--					-RenderTarget &target:				Surface to draw on
+--					-int left, top, right, bottom:		Area to compose, right and bottom exclusive
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Clears the area and draws the cells of every row of the view that intersects it, in same-color runs. The
+--	area is in view coordinates, so row _top is drawn at the top of the surface.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::Compose(RenderTarget &target, int left, int top, int right, int bottom)
+{
+	int lineHeight = _metrics.LineHeight();
+	if (lineHeight <= 0 || bottom <= top)
+		return;
+	target.Fill(left, top, right, bottom);
+	size_t first = _top + (top > 0 ? top / lineHeight : 0);
+	size_t last = _top + (bottom + lineHeight - 1) / lineHeight;
+	for (size_t row = first; row < last && row < _rows.Count(); ++row)
+		PaintRow(target, row, left, right);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: QueueCell
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Takes a code point and leaves moving x past it to the caller
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID QueueCell(RenderTarget &target, int x, int y, unsigned int c, unsigned long color);
+--					-RenderTarget &target:	Surface the run is drawn on
+--					-int x:					Where the character goes
+--					-int y:					Top of the row
+--					-unsigned int c:		The code point of the character to display
+--					-unsigned long color:	The background color of the character
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Appends a character to the pending run. The run is drawn first when the color changes or when it is full.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::QueueCell(RenderTarget &target, int x, int y, unsigned int c, unsigned long color)
+{
+	if (_run.len && (_run.color != color || _run.len == (int)(sizeof(_run.text) / sizeof(_run.text[0]))))
+		FlushRun(target);
+	if (_run.len == 0)									//First character of a new run
+		_run.x = x, _run.y = y, _run.color = color;
+	_run.text[_run.len++] = c;
+	++_cells;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: FlushRun
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID FlushRun(RenderTarget &target);
+--					-RenderTarget &target: Surface the run is drawn on
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Draws the pending run with one DrawRun call and counts it.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::FlushRun(RenderTarget &target)
+{
+	if (_run.len == 0)
+		return;
+	target.DrawRun(_run.x, _run.y, _run.text, _run.len, _run.color);
+	++_drawCalls;
+	_run.len = 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: PaintRow
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Row positions are relative to the top of the view
+--			  October 17, 2026 - Looks up the advance width of each cell once
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID PaintRow(RenderTarget &target, size_t row, int left, int right);
+--					-RenderTarget &target:	Surface to draw on
+--					-size_t row:			Index of the row to draw
+--					-int left:				Left edge of the area being composed
+--					-int right:				Right edge of the area being composed
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Draws the cells of the row that overlap [left, right). Cells outside are skipped.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::PaintRow(RenderTarget &target, size_t row, int left, int right)
+{
+	const RowIndex::Row &r = _rows.Get(row);
+	int x = 0, y = (int)(row - _top) * _metrics.LineHeight();
+	for (size_t col = r.col, end = RowEnd(row); col < end && x < right; ++col)
+	{
+		unsigned int	c = _screen.Glyph(r.line, col);
+		int				advance = _metrics.Advance(c);
+		if (x + advance > left)							//Cells left of the composed area are skipped
+			QueueCell(target, x, y, c, _screen.Color(r.line, col));
+		x += advance;
+	}
+	FlushRun(target);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: NewRow
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Moves the cursor onto the new row
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID NewRow(size_t line, size_t col);
+--					-size_t line:	Line of the screen model shown on the new row
+--					-size_t col:	First cell of the line shown on the new row
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Records the new row in the row index and moves the cursor to the start of it.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::NewRow(size_t line, size_t col)
+{
+	_rows.StartRow(line, col);
+	_crow = _rows.Count() - 1;
+	_x = 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: RowEnd
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t RowEnd(size_t row) const;
+--					-size_t row: Index of the row
+--
+-- RETURNS: One past the last cell of the line that is shown on the row
+----------------------------------------------------------------------------------------------------------------------*/
+size_t Terminal::RowEnd(size_t row) const
+{
+	const RowIndex::Row &r = _rows.Get(row);
+	if (row + 1 < _rows.Count() && _rows.Get(row + 1).line == r.line)	//Line wraps onto the next row
+		return _rows.Get(row + 1).col;
+	return _screen.LineLength(r.line);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: RowWidth
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int RowWidth(size_t row) const;
+--					-size_t row: Index of the row
+--
+-- RETURNS: The width in pixels of the characters on the row
+----------------------------------------------------------------------------------------------------------------------*/
+int Terminal::RowWidth(size_t row) const
+{
+	const RowIndex::Row &r = _rows.Get(row);
+	int width = 0;
+	for (size_t col = r.col, end = RowEnd(row); col < end; ++col)
+		width += _metrics.Advance(_screen.Glyph(r.line, col));
+	return width;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: EraseLast
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Keeps the width of the last line
+--			  October 17, 2026 - Only erases typed characters, never a line break
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID EraseLast();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Handles a typed backspace. The character before the cursor, which is at the end of the last line, is removed
+--	from the screen model, the cursor moves back onto it and only its row is marked dirty from that point on.
+--	When that empties a wrapped row the row is removed and the cursor goes to the end of the row before, so the
+--	rows always match what a fresh layout would produce. Type only calls it for characters typed since the last
+--	received byte, so it never removes a line break.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::EraseLast()
+{
+	size_t line = _screen.LineCount() - 1, len = _screen.LineLength(line);
+	int advance = _metrics.Advance(_screen.Glyph(line, len - 1));
+	_lineWidth.back() -= advance;
+	_screen.EraseLast();
+	if (--_col > 0 && _col == _rows.Get(_crow).col)		//Wrapped row is empty now
+	{
+		if (_crow >= _top && _crow < _top + ViewRows())
+			MarkView((int)(_crow - _top) * _metrics.LineHeight(), (int)(_crow - _top + 1) * _metrics.LineHeight());
+		_rows.PopRow();
+		_x = RowWidth(--_crow);
+	}
+	else
+	{
+		_x -= advance;
+		_rows.MarkDirty(_crow, _x);						//Only the erased cell changed
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: PutChar
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID PutChar(unsigned int c, unsigned long color);
+--					-unsigned int c:		The code point of the character to write
+--					-unsigned long color:	The background color the character is displayed in
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Writes a character at the cursor and moves the cursor past it. At the end of the line the character is
+--	appended, wrapping to a new row when it does not fit. Inside the line it replaces the cell under the cursor;
+--	when the two characters are the same width nothing else moves, otherwise the rest of the line is laid out
+--	again by Rewrap.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::PutChar(unsigned int c, unsigned long color)
+{
+	size_t line = _screen.LineCount() - 1, len = _screen.LineLength(line);
+	int advance = _metrics.Advance(c);
+	if (_col < len)										//Cursor was moved back, replace the cell
+	{
+		int old = _metrics.Advance(_screen.Glyph(line, _col));
+		_screen.Put(_col, c, color);
+		if (advance == old)								//Nothing after it moves
+		{
+			_rows.MarkDirty(_crow, _x);
+			CursorRight();
+		}
+		else
+		{
+			_lineWidth.back() += advance - old;
+			Rewrap(_x == 0 && _rows.Get(_crow).col > 0 ? _crow - 1 : _crow);	//May fit on the row before now
+			++_col;
+			FindCursor();
+		}
+		return;
+	}
+	if (_x > 0 && _x + advance > _metrics.ClientWidth())	//Handles line wrap
+		NewRow(line, len);
+	_rows.MarkDirty(_crow, _x);
+	_screen.Append(c, color);							//Record the character and its color
+	_x += advance;
+	_lineWidth.back() += advance;
+	++_col;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: LineBreak
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID LineBreak();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Records a line break and moves the cursor to the start of the new line. The cursor always lands on a new last
+--	line, even when it was moved back inside the line before.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::LineBreak()
+{
+	_screen.NewLine();
+	_lineWidth.push_back(0);
+	NewRow(_screen.LineCount() - 1, 0);
+	_col = 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Tab
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Tab(unsigned long color);
+--					-unsigned long color: The background color of the spaces added past the end of the line
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Moves the cursor to the next multiple of TAB_CELLS cells. Cells that already exist are stepped over; past the
+--	end of the line spaces are added, so at most TAB_CELLS cells are touched.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::Tab(unsigned long color)
+{
+	size_t line = _screen.LineCount() - 1;
+	for (size_t stop = (_col / TAB_CELLS + 1) * TAB_CELLS; _col < stop;)
+		if (_col < _screen.LineLength(line))
+			CursorRight();
+		else
+			PutChar(' ', color);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: CursorLeft
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID CursorLeft();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Moves the cursor back one cell on the last line. It stops at the start of the line and never moves onto the
+--	line before. Crossing back onto the previous row of a wrapped line measures that row once.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::CursorLeft()
+{
+	if (_col == 0)
+		return;
+	unsigned int c = _screen.Glyph(_screen.LineCount() - 1, --_col);
+	if (_col < _rows.Get(_crow).col)					//Back onto the row before
+		_x = RowWidth(--_crow);
+	_x -= _metrics.Advance(c);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: CursorRight
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID CursorRight();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Steps the cursor over the cell under it, onto the next row when the line wraps there. The cursor must be
+--	inside the line.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::CursorRight()
+{
+	_x += _metrics.Advance(_screen.Glyph(_screen.LineCount() - 1, _col));
+	++_col;
+	if (_crow + 1 < _rows.Count() && _rows.Get(_crow + 1).col == _col)	//Next cell is on the next row
+		_crow++, _x = 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: FindCursor
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID FindCursor();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Works out the row and the pixel position of the cursor from its cell. Needed after the rows of the last line
+--	were rebuilt by a layout, a trim or Rewrap.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::FindCursor()
+{
+	size_t line = _screen.LineCount() - 1;
+	_crow = _rows.Find(line, _col);
+	_x = 0;
+	for (size_t col = _rows.Get(_crow).col; col < _col; ++col)
+		_x += _metrics.Advance(_screen.Glyph(line, col));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Rewrap
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Rewrap(size_t row);
+--					-size_t row: Row of the last line to start from
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Lays out the last line again from the given row onwards after one of its cells was replaced by a character of
+--	a different width. A cell at the start of a row may now fit on the row before, so the caller starts there in
+--	that case. The rows from the given one on that are in view are marked for composition, including the ones
+--	that are now empty.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::Rewrap(size_t row)
+{
+	size_t line = _screen.LineCount() - 1, len = _screen.LineLength(line);
+	size_t count = _rows.Count(), col = _rows.Get(row).col;
+	while (_rows.Count() > row + 1)
+		_rows.PopRow();
+	for (int x = 0, width = _metrics.ClientWidth(); col < len; ++col)
+	{
+		int advance = _metrics.Advance(_screen.Glyph(line, col));
+		if (x > 0 && x + advance > width)				//Handles line wrap
+		{
+			_rows.StartRow(line, col);
+			x = 0;
+		}
+		x += advance;
+	}
+	size_t last = count > _rows.Count() ? count : _rows.Count(), end = _top + ViewRows();
+	last = last < end ? last : end;
+	if (last > row && last > _top)						//Rows from it on that are in view
+		MarkView(((int)row - (int)_top) * _metrics.LineHeight(), (int)(last - _top) * _metrics.LineHeight());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Print
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Decodes UTF-8, ASCII goes to PrintAscii
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Print(const char *text, size_t len);
+--					-const char *text:	Printable bytes received
+--					-size_t len:		Number of bytes in text
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Called by the parser with each run of text between control characters. The run is UTF-8: PrintAscii writes
+--	the stretches of ASCII in it as they are and PrintUtf8 decodes the bytes from 0x80 up between them. The
+--	decoder keeps a sequence the run ends in the middle of for the next run.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::Print(const char *text, size_t len)
+{
+	size_t n;
+	for (; len > 0; text += n, len -= n)
+		if (_utf8.Pending() || (n = PrintAscii(text, len)) == 0)
+			n = PrintUtf8(text, len);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: PrintAscii
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Renamed from Print, takes the ASCII stretches of a run
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t PrintAscii(const char *text, size_t len);
+--					-const char *text:	Printable bytes received
+--					-size_t len:		Number of bytes in text
+--
+-- RETURNS: Number of bytes written, those before the first one from 0x80 up
+--
+-- NOTES:
+--	Writes the ASCII text at the start of a run at the cursor in the colors SGR set last. Cells the cursor was
+--	moved back over are replaced one at a time by PutChar; the rest is appended a row at a time, the characters
+--	that fit being measured first and then copied into the screen model together, with the row marked dirty once.
+--	Measuring already reads every byte, so that is where the ASCII ends is found, instead of in a pass of its own.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t Terminal::PrintAscii(const char *text, size_t len)
+{
+	const char		*start = text, *end = text + len;
+	unsigned long	color = CellColor();
+	size_t			line = _screen.LineCount() - 1, n;
+	int				x, width = _metrics.ClientWidth();
+	for (; text < end && (unsigned char)*text < 0x80 && _col < _screen.LineLength(line); ++text)	//Moved back
+		PutChar(*text, color);
+	for (; text < end && (unsigned char)*text < 0x80; text += n)	//Append the rest a row at a time
+	{
+		if (_x > 0 && _x + _metrics.Advance(text[0]) > width)	//Handles line wrap
+			NewRow(line, _col);
+		x = _x + _metrics.Advance(text[0]);
+		for (n = 1; text + n < end && (unsigned char)text[n] < 0x80 && x + _metrics.Advance(text[n]) <= width; ++n)
+			x += _metrics.Advance(text[n]);
+		_rows.MarkDirty(_crow, _x);
+		_screen.AppendRun(text, n, color);
+		_lineWidth.back() += x - _x;
+		_x = x;
+		_col += n;
+	}
+	return text - start;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: PrintUtf8
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t PrintUtf8(const char *text, size_t len);
+--					-const char *text:	Printable bytes received, starting with one from 0x80 up or in the middle of
+--										a sequence
+--					-size_t len:		Number of bytes in text
+--
+-- RETURNS: Number of bytes decoded
+--
+-- NOTES:
+--	Decodes the bytes up to the next ASCII character, at most STRETCH of them, and writes the code points one at
+--	a time with PutChar. Called for the text that is not ASCII, which is rare enough for a cell at a time.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t Terminal::PrintUtf8(const char *text, size_t len)
+{
+	const size_t	STRETCH = 64;						//Bytes decoded at a time
+	unsigned int	decoded[STRETCH + 1];				//A U+FFFD may come before them
+	size_t			n, count;
+	for (n = 1; n < len && n < STRETCH && (unsigned char)text[n] >= 0x80; ++n)	//Up to the next ASCII
+		;
+	count = _utf8.Decode(text, n, decoded);
+	for (size_t i = 0; i < count; ++i)
+		PutChar(decoded[i], CellColor());
+	return n;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: FlushUtf8
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID FlushUtf8();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Writes a U+FFFD for a UTF-8 sequence a control character or an escape sequence cut short, so it is not
+--	completed by bytes that come after them.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::FlushUtf8()
+{
+	unsigned int c;
+	if (_utf8.Pending() && _utf8.Flush(c))				//Pending is inline, this runs for every control
+		PutChar(c, CellColor());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Execute
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Ends a UTF-8 sequence it cuts short
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Execute(char c);
+--					-char c: C0 control character received
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Backspace moves the cursor back a cell, return moves it to the start of the line, line feed, vertical tab and
+--	form feed start a new line and tab moves it to the next tab stop; none of them erase anything. The other
+--	controls, e.g. BEL and NUL, have nothing to act on and are dropped.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::Execute(char c)
+{
+	FlushUtf8();
+	switch (c)
+	{
+	case '\b':											//Back a cell, nothing is erased
+		CursorLeft();
+		break;
+	case '\r':
+		CarriageReturn();
+		break;
+	case '\n':
+	case '\v':
+	case '\f':
+		LineBreak();
+		break;
+	case '\t':
+		Tab(CellColor());
+		break;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: EscDispatch
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Ends a UTF-8 sequence it cuts short
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID EscDispatch(const VtSequence &seq, char final);
+--					-const VtSequence &seq:	Intermediates of the sequence
+--					-char final:			Final byte
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Only ESC c, the full reset, means anything here: it puts the colors back to the defaults.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::EscDispatch(const VtSequence &seq, char final)
+{
+	FlushUtf8();
+	if (final == 'c' && seq.intermediateCount == 0)
+		_sgrBack = false, _ink = 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: CsiDispatch
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Ends a UTF-8 sequence it cuts short
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID CsiDispatch(const VtSequence &seq, char final);
+--					-const VtSequence &seq:	Parameters, marker and intermediates of the sequence
+--					-char final:			Final byte
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Acts on SGR and on the cursor and erase sequences that apply to the last line (see Terminal.h). Sequences
+--	with a private marker or intermediates, such as the DEC modes, are ignored.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::CsiDispatch(const VtSequence &seq, char final)
+{
+	unsigned int n = seq.Param(0, 1);
+	FlushUtf8();
+	if (seq.marker != 0 || seq.intermediateCount != 0)
+		return;
+	switch (final)
+	{
+	case 'm':											//SGR
+		SelectGraphics(seq);
+		break;
+	case 'C':											//CUF
+	case 'a':											//HPR
+		MoveToColumn(_col + n);
+		break;
+	case 'D':											//CUB
+		MoveToColumn(_col > n ? _col - n : 0);
+		break;
+	case 'G':											//CHA
+	case '`':											//HPA
+		MoveToColumn(n - 1);
+		break;
+	case 'H':											//CUP, only the column
+	case 'f':											//HVP
+		MoveToColumn(seq.Param(1, 1) - 1);
+		break;
+	case 'K':											//EL
+		EraseInLine(seq.Param(0, 0));
+		break;
+	case 'J':											//ED, the last line is all there is
+		EraseInLine(seq.Param(0, 0) >= 2 ? 2 : seq.Param(0, 0));
+		break;
+	case 'X':											//ECH
+		Blank(_col, n);
+		break;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: OscDispatch
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Ends a UTF-8 sequence it cuts short
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID OscDispatch(const char *text, size_t len);
+--					-const char *text:	The string, without ESC ] and the terminator
+--					-size_t len:		Number of characters in text
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Window titles and the like have nowhere to go, so the string is dropped; it is never drawn.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::OscDispatch(const char * /*text*/, size_t /*len*/)
+{
+	FlushUtf8();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: SelectGraphics
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID SelectGraphics(const VtSequence &seq);
+--					-const VtSequence &seq: Parameters of the SGR sequence
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Sets the text color for 30 to 37, 90 to 97 and 38, and the background for 40 to 47, 100 to 107 and 48, where
+--	38 and 48 take 5 and an xterm color or 2 and red, green and blue. A text color given as red, green and blue is
+--	stored as the nearest xterm color. 0 resets both, 39 the text color and 49 the background. Bold, underline
+--	and the other attributes have no cell storage and are ignored.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::SelectGraphics(const VtSequence &seq)
+{
+	size_t count = seq.paramCount > 0 ? seq.paramCount : 1;		//ESC [ m is ESC [ 0 m
+	for (size_t i = 0; i < count; ++i)
+	{
+		unsigned int p = seq.params[i], index;
+		unsigned long rgb;
+		if (p == 0)
+			_sgrBack = false, _ink = 0;
+		else if (p >= 30 && p <= 37)
+			_ink = (unsigned long)(p - 30 + 1) << 24;
+		else if (p >= 90 && p <= 97)
+			_ink = (unsigned long)(p - 90 + 8 + 1) << 24;
+		else if (p == 39)
+			_ink = 0;
+		else if (p >= 40 && p <= 47)
+			_back = Xterm_Color(p - 40), _sgrBack = true;
+		else if (p >= 100 && p <= 107)
+			_back = Xterm_Color(p - 100 + 8), _sgrBack = true;
+		else if (p == 49)
+			_sgrBack = false;
+		else if ((p == 38 || p == 48) && i + 2 < seq.paramCount && seq.params[i + 1] == 5)
+		{
+			index = seq.params[i + 2] & 0xFF;
+			if (p == 38)
+				_ink = (unsigned long)(index < 255 ? index + 1 : 255) << 24;
+			else
+				_back = Xterm_Color(index), _sgrBack = true;
+			i += 2;
+		}
+		else if ((p == 38 || p == 48) && i + 4 < seq.paramCount && seq.params[i + 1] == 2)
+		{
+			rgb = (seq.params[i + 2] & 0xFF) | (seq.params[i + 3] & 0xFF) << 8 | (seq.params[i + 4] & 0xFF) << 16;
+			if (p == 38)
+				_ink = (unsigned long)(Nearest_Xterm(rgb) + 1) << 24;
+			else
+				_back = rgb, _sgrBack = true;
+			i += 4;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: CarriageReturn
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID CarriageReturn();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Moves the cursor to the first cell of the last line, on the first row of the line.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::CarriageReturn()
+{
+	while (_rows.Get(_crow).col > 0)
+		--_crow;
+	_col = 0, _x = 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: MoveToColumn
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID MoveToColumn(size_t col);
+--					-size_t col: Cell of the last line to move to, 0 for the first
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Moves the cursor along the last line. Past the end of the line spaces in the current colors are added, as a
+--	tab does, but only up to the right edge of the row the cursor is on; a move further than that stops there,
+--	the way a terminal stops at its right margin. Moving back to the first cell is a carriage return.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::MoveToColumn(size_t col)
+{
+	size_t len = _screen.LineLength(_screen.LineCount() - 1);
+	if (col == 0)
+		CarriageReturn();
+	while (_col > col)
+		CursorLeft();
+	while (_col < col)
+		if (_col < len)
+			CursorRight();
+		else if (_x + _metrics.Advance(' ') <= _metrics.ClientWidth())
+			PutChar(' ', CellColor());
+		else
+			break;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Blank
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Blank(size_t from, size_t count);
+--					-size_t from:	First cell of the last line to erase
+--					-size_t count:	Number of cells to erase
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Replaces the cells with spaces in the current background, without going past the end of the line, and puts
+--	the cursor back where it was.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::Blank(size_t from, size_t count)
+{
+	size_t col = _col, len = _screen.LineLength(_screen.LineCount() - 1);
+	unsigned long color = CellColor();
+	if (from >= len)
+		return;
+	count = count < len - from ? count : len - from;
+	MoveToColumn(from);
+	while (count-- > 0)
+		PutChar(' ', color);
+	MoveToColumn(col);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: EraseToEnd
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID EraseToEnd();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Removes the cells of the last line from the cursor on. The rows from the cursor's on are laid out again by
+--	Rewrap, starting a row earlier when the cursor is at the start of a wrapped row, which is left empty and
+--	removed, so the rows match what a fresh layout would produce.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::EraseToEnd()
+{
+	size_t line = _screen.LineCount() - 1, len = _screen.LineLength(line);
+	if (_col >= len)
+		return;
+	for (size_t col = _col; col < len; ++col)
+		_lineWidth.back() -= _metrics.Advance(_screen.Glyph(line, col));
+	for (size_t col = _col; col < len; ++col)
+		_screen.EraseLast();
+	Rewrap(_x == 0 && _rows.Get(_crow).col > 0 ? _crow - 1 : _crow);
+	FindCursor();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: EraseInLine
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID EraseInLine(unsigned int mode);
+--					-unsigned int mode: 0 from the cursor to the end, 1 from the start to the cursor, 2 all of it
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	EL on the last line. Cells after the cursor are removed rather than blanked, since a line ends where its
+--	last cell does; cells before it are blanked so the cursor stays in the same column.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::EraseInLine(unsigned int mode)
+{
+	if (mode == 1)
+		Blank(0, _col + 1);
+	else if (mode == 0 || mode == 2)
+	{
+		if (mode == 2)
+			Blank(0, _col);
+		EraseToEnd();
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Layout
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Keeps the top of the view on the same cell
+--			  October 17, 2026 - Lays out the lines around the view and leaves the rest to Reflow
+--			  October 17, 2026 - Finds the cursor when the last line is laid out at once
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Layout();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Rebuilds the row index for the current client width. Needed when the client width or the font changes since
+--	every wrap point may move. Only the lines from a page above the view to two pages below it are laid out here,
+--	all of them when the view follows the end; Reflow does the rest later. The view keeps the cell that was at
+--	its top in view.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::Layout()
+{
+	size_t line = _rows.Get(_top).line, col = _rows.Get(_top).col;	//Cell at the top of the view
+	size_t page = PageRows();
+	_laidFrom = line > page ? line - page : 0;			//A page of lines above the view
+	_prefix.clear();
+	_prefixLine = 0;
+	_rows.Clear(_laidFrom);
+	Wrap(_laidFrom, _wrap);
+	for (size_t i = 1; i < _wrap.size(); ++i)
+		_rows.StartRow(_laidFrom, _wrap[i]);
+	_laidTo = _laidFrom + 1;
+	_tailPending = _laidTo < _screen.LineCount();
+	if (!_tailPending)
+		FindCursor();
+	while (_tailPending && (_rows.Count() < _rows.Find(line, col) + 3 * page))	//Down to two pages below the view
+		LayoutTail(_laidTo + 1);
+	if (_follow)
+		LayoutTail(_screen.LineCount());				//The view is at the end
+	_top = _rows.Find(line, col);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ScrollTo
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID ScrollTo(size_t row);
+--					-size_t row: Row to show at the top of the view
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	The row is clamped so the view never goes past the last page. Scrolling to the bottom makes the view follow
+--	new rows again, scrolling anywhere else stops it.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::ScrollTo(size_t row)
+{
+	MoveTop(row < MaxTop() ? row : MaxTop());
+	_follow = _top == MaxTop();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ScrollBy
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID ScrollBy(long rows);
+--					-long rows: Rows to move the view down by, negative to move it back
+--
+-- RETURNS: VOID
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::ScrollBy(long rows)
+{
+	if (rows < 0 && (size_t)-rows > _top)
+		ScrollTo(0);
+	else
+		ScrollTo(_top + rows);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: TakeScroll
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int TakeScroll();
+--
+-- RETURNS: Pixels the surface has to be scrolled down by since the last call, negative for up
+--
+-- NOTES:
+--	The caller scrolls its surface by this much before composing the areas from NextDirty, so the rows that
+--	were already on the surface only move instead of being drawn again.
+----------------------------------------------------------------------------------------------------------------------*/
+int Terminal::TakeScroll()
+{
+	int dy = _scroll;
+	_scroll = 0;
+	return dy;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: PageRows
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t PageRows() const;
+--
+-- RETURNS: Number of rows that fit completely in the view, at least 1
+----------------------------------------------------------------------------------------------------------------------*/
+size_t Terminal::PageRows() const
+{
+	int lineHeight = _metrics.LineHeight();
+	size_t rows = lineHeight > 0 ? _metrics.ClientHeight() / lineHeight : 0;
+	return rows > 0 ? rows : 1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ViewRows
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t ViewRows() const;
+--
+-- RETURNS: Number of rows that are at least partly in the view, at least 1
+----------------------------------------------------------------------------------------------------------------------*/
+size_t Terminal::ViewRows() const
+{
+	int lineHeight = _metrics.LineHeight();
+	size_t rows = lineHeight > 0 ? (_metrics.ClientHeight() + lineHeight - 1) / lineHeight : 0;
+	return rows > 0 ? rows : 1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: MaxTop
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t MaxTop() const;
+--
+-- RETURNS: Top row of the view when it shows the last page
+----------------------------------------------------------------------------------------------------------------------*/
+size_t Terminal::MaxTop() const
+{
+	return _rows.Count() > PageRows() ? _rows.Count() - PageRows() : 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: MoveTop
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - A marked area moves with the view instead of marking the whole view
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID MoveTop(size_t top);
+--					-size_t top: New first row of the view
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Records how far the surface has to scroll and marks the rows that scroll into view. Moves that were not
+--	taken yet add up, and an area that was already marked moves along with the rows on it. If the view moved by
+--	a whole page or more the whole view is marked instead and nothing is scrolled.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::MoveTop(size_t top)
+{
+	if (top == _top)
+		return;
+	int lineHeight = _metrics.LineHeight(), view = (int)ViewRows();
+	long delta = (long)top - (long)_top;
+	long total = delta - (lineHeight > 0 ? _scroll / lineHeight : 0);	//Since the last take
+	int bandTop = _bandTop - (int)delta * lineHeight, bandBottom = _bandBottom - (int)delta * lineHeight;
+	bool marked = _bandBottom > _bandTop;
+	_top = top;
+	_scroll = 0;
+	_bandTop = _bandBottom = 0;
+	if (total >= view || -total >= view)
+	{
+		MarkView(0, view * lineHeight);
+		return;
+	}
+	_scroll = (int)-total * lineHeight;
+	if (marked && bandBottom > 0 && bandTop < view * lineHeight)	//Marked area moves with its rows
+		MarkView(bandTop, bandBottom);
+	if (delta > 0)										//Rows come in at the bottom
+		MarkView((view - 1 - (int)delta) * lineHeight, view * lineHeight);	//Includes the partial last row
+	else												//Rows come in at the top
+		MarkView(0, (int)-delta * lineHeight);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: MarkView
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID MarkView(int top, int bottom);
+--					-int top, bottom: Pixel rows of the view to compose again
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Grows the pending band to cover the area.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::MarkView(int top, int bottom)
+{
+	top = top > 0 ? top : 0;
+	if (_bandBottom <= _bandTop)
+		_bandTop = top, _bandBottom = bottom;
+	else
+	{
+		_bandTop = top < _bandTop ? top : _bandTop;
+		_bandBottom = bottom > _bandBottom ? bottom : _bandBottom;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Reflow
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Reflow(size_t lines);
+--					-size_t lines: Most lines to lay out in this call
+--
+-- RETURNS: true while lines remain to be laid out
+--
+-- NOTES:
+--	Continues the layout started by Layout. Lines after the view come first and are appended to the row index as
+--	they are done. Lines before the view are collected in _prefix; once the last of them is done they are put in
+--	front of the row index in one go and the view moves down by the same number of rows, so nothing on screen
+--	changes. Meant to be called while the program is otherwise idle.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Terminal::Reflow(size_t lines)
+{
+	if (_tailPending)
+	{
+		size_t to = _laidTo + lines < _screen.LineCount() ? _laidTo + lines : _screen.LineCount();
+		lines -= to - _laidTo;
+		LayoutTail(to);
+	}
+	for (; lines > 0 && _prefixLine < _laidFrom; --lines, ++_prefixLine)
+	{
+		Wrap(_prefixLine, _wrap);
+		for (size_t i = 0; i < _wrap.size(); ++i)
+		{
+			RowIndex::Row row = { _prefixLine, _wrap[i], INT_MAX };
+			_prefix.push_back(row);
+		}
+	}
+	if (_laidFrom > 0 && _prefixLine == _laidFrom)		//All lines before the view are done
+	{
+		_rows.Prepend(_prefix);
+		_top += _prefix.size();
+		_crow += _prefix.size();
+		_prefix.clear();
+		std::vector<RowIndex::Row>().swap(_prefix);
+		_laidFrom = _prefixLine = 0;
+	}
+	return Reflowing();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Wrap
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Wrap(size_t line, std::vector<size_t> &starts) const;
+--					-size_t line:					Line of the screen model
+--					-std::vector<size_t> &starts:	Receives the first cell of every row of the line
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	A line no wider than the view stays on one row, which is known from its cached width without reading a
+--	single cell. Longer lines are wrapped the same way Write wraps them.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::Wrap(size_t line, std::vector<size_t> &starts) const
+{
+	int width = _metrics.ClientWidth(), x = 0;
+	starts.assign(1, 0);
+	if (_lineWidth[line] <= width)						//Fits, nothing to read
+		return;
+	for (size_t col = 0, len = _screen.LineLength(line); col < len; ++col)
+	{
+		int advance = _metrics.Advance(_screen.Glyph(line, col));
+		if (x > 0 && x + advance > width)				//Handles line wrap
+		{
+			starts.push_back(col);
+			x = 0;
+		}
+		x += advance;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: MeasureLine
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int MeasureLine(size_t line) const;
+--					-size_t line: Line of the screen model
+--
+-- RETURNS: Width of the whole line in pixels
+--
+-- NOTES:
+--	Adds up the advance widths of the cells. Only needed after a font change or when the head of a line was
+--	trimmed; otherwise the widths are kept up to date as characters are written.
+----------------------------------------------------------------------------------------------------------------------*/
+int Terminal::MeasureLine(size_t line) const
+{
+	int width = 0;
+	for (size_t col = 0, len = _screen.LineLength(line); col < len; ++col)
+		width += _metrics.Advance(_screen.Glyph(line, col));
+	return width;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: LayoutTail
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Finds the cursor once the last line is laid out
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID LayoutTail(size_t to);
+--					-size_t to: Lay out the lines before this one
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Appends the rows of the lines from _laidTo up to the given line to the row index.
+----------------------------------------------------------------------------------------------------------------------*/
+void Terminal::LayoutTail(size_t to)
+{
+	for (; _laidTo < to; ++_laidTo)
+	{
+		Wrap(_laidTo, _wrap);
+		for (size_t i = 0; i < _wrap.size(); ++i)
+			_rows.StartRow(_laidTo, _wrap[i]);
+	}
+	_tailPending = _laidTo < _screen.LineCount();
+	if (!_tailPending)									//The cursor's line is laid out
+		FindCursor();
+}
@@ -0,0 +1,209 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: Terminal.h - Screen state, layout and frame composition of the dumb terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- Terminal();
+-- bool UpdateMetrics(const MetricsProvider &provider, bool fontChanged);
+-- VOID Write(const char *buf, size_t len, unsigned long color);
+-- VOID Type(const char *buf, size_t len, unsigned long color);
+-- VOID Clear();
+-- bool NextDirty(int &left, int &top, int &right, int &bottom);
+-- VOID Compose(RenderTarget &target, int left, int top, int right, int bottom);
+-- VOID ResetFrame();
+-- VOID SetScrollback(size_t maxLines, size_t maxBytes);
+-- VOID ScrollTo(size_t row);
+-- VOID ScrollBy(long rows);
+-- int TakeScroll();
+-- size_t PageRows() const;
+-- bool Reflow(size_t lines);
+-- bool Reflowing() const;
+-- VOID Print(const char *text, size_t len);
+-- size_t PrintAscii(const char *text, size_t len);
+-- size_t PrintUtf8(const char *text, size_t len);
+-- VOID FlushUtf8();
+-- VOID Execute(char c);
+-- VOID EscDispatch(const VtSequence &seq, char final);
+-- VOID CsiDispatch(const VtSequence &seq, char final);
+-- VOID OscDispatch(const char *text, size_t len);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - History is trimmed to the scrollback limits after every write
+--			  October 17, 2026 - Only the rows in the view are composed, the view can be scrolled
+--			  October 17, 2026 - Resizing reflows the view first and the rest of the history in steps
+--			  October 17, 2026 - Backspace, return, line feed and tab move a cursor on the last line
+--			  October 17, 2026 - Received bytes go through a VT100/ANSI parser: colors, cursor moves and erases
+--			  October 17, 2026 - Text is decoded as UTF-8, cells hold Unicode code points
+--			  October 17, 2026 - Is a PagedView, so the window can show it or the hex view the same way
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Terminal owns everything needed to turn characters into a picture: the screen model holding the history, the
+--	row index that lays it out on the window, the metrics cache and the position where the next character goes.
+--	It has no window or device of its own. Write records characters and marks the cells that changed dirty;
+--	the caller then asks for the dirty rectangles with NextDirty, composes each of them onto a RenderTarget with
+--	Compose and presents them however it likes. Compose draws consecutive characters of the same color on the
+--	same row with one DrawRun call and counts the calls and the cells of the current frame.
+--
+--	The window is a view onto the rows starting at row _top. Everything above and below it is skipped, so
+--	composing and finding dirty areas costs what the visible cells cost no matter how long the history is. While
+--	the view is at the bottom it follows new rows as they are written. Moving the view records how far the
+--	surface has to be scrolled (TakeScroll) and only marks the rows it exposes for composition.
+--
+--	The pixel width of every line is kept up to date as characters are written. A line no wider than the view is
+--	a single row at that width, so laying it out does not read its cells; only lines wider than the view have
+--	their wrap points worked out again. When the width changes the lines around the view are laid out at once
+--	and the rest later, a batch at a time, through Reflow: lines after the view are appended to the row index and
+--	lines before it are collected separately and put in front when all of them are done. Writing first finishes
+--	the lines after the view since characters are always added to the last row.
+--
+--	The screen model is trimmed to the scrollback limits at the end of every Write. Rows that are dropped from
+--	the front are above the view, so the view only has to be renumbered.
+--
+--	Characters go where the cursor is, on the last line; every other line is history and never changes. Received
+--	backspace moves the cursor back a cell without erasing, return moves it to the start of the line, line feed
+--	starts a new line and tab moves to the next multiple of TAB_CELLS cells. A character written with the cursor
+--	inside the line replaces the cell there. Typed characters go through Type, where backspace erases the last
+--	character typed and return starts a new line; only characters typed since the last received byte can be
+--	erased, so neither the line before nor anything the other end sent is ever removed. All of these cost a few
+--	cells of work and mark only the row they change, from the first changed pixel, except a replaced cell of a
+--	different width, which lays out the rest of its line again.
+--
+--	Received bytes go through a VtParser, which hands printable runs, control characters and escape sequences
+--	back to the terminal, so escape sequences are acted on instead of drawn. SGR sets the colors of the cells
+--	written after it: the background replaces the color the bytes were written with and the text color goes in the
+--	top byte of the cell color (see RenderTarget.h); SGR 0, 39 and 49 go back to the defaults. Since every line
+--	but the last is history, the cursor sequences move it along the last line only: CUF, CUB, CHA, HPA, HPR and the
+--	column of CUP and HVP, where a move right past the end of the line adds spaces up to the right edge of the
+--	row. EL, ECH and ED 0 and 1 erase on the last line, and ED 2 and 3 clear it as EL 2 does; the lines above stay
+--	in the history where the scrollbar can reach them. Vertical moves, modes and OSC strings are parsed and
+--	ignored, and C0 controls other than BS, HT, LF, VT, FF and CR are dropped.
+--
+--	Received text and typed text are UTF-8 and every cell holds one Unicode code point. The text runs from the
+--	parser are split at the first byte from 0x80 up, found while the characters are measured: ASCII is copied
+--	into the screen model as it is and only the bytes between go through a Utf8Decoder, which keeps a sequence
+--	split across two writes and replaces what is malformed with U+FFFD, as does a control character or escape
+--	sequence that cuts a sequence short. Typed text comes in whole sequences, from the keyboard or a paste, and
+--	is decoded by Type.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef TERMINAL_H
+#define TERMINAL_H
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include "FontMetrics.h"
+#include "PagedView.h"
+#include "RenderTarget.h"
+#include "RowIndex.h"
+#include "ScreenModel.h"
+#include "Utf8Decoder.h"
+#include "VtParser.h"
+class Terminal : public PagedView, private VtHandler
+{
+public:
+	static const size_t	TAB_CELLS = 8;				//Cells between tab stops
+
+	Terminal();
+	bool				UpdateMetrics(const MetricsProvider &provider, bool fontChanged);
+	void				Write(const char *buf, size_t len, unsigned long color);	//Record and lay out characters
+	void				Type(const char *buf, size_t len, unsigned long color);		//Same for characters typed
+	void				Clear();													//Forget all history
+	bool				NextDirty(int &left, int &top, int &right, int &bottom);	//Next area that changed
+	void				Compose(RenderTarget &target, int left, int top, int right, int bottom);
+	void				ResetFrame() { _drawCalls = _cells = 0; }
+	void				SetScrollback(size_t maxLines, size_t maxBytes) { _screen.SetLimits(maxLines, maxBytes); }
+	void				ScrollTo(size_t row);										//Show row at the top
+	void				ScrollBy(long rows);										//Negative scrolls back
+	int					TakeScroll();												//Pixels to scroll the surface by
+	size_t				TopRow() const { return _top; }
+	size_t				RowCount() const { return _rows.Count(); }
+	size_t				PageRows() const;											//Rows that fit in the view
+	bool				Reflow(size_t lines);										//Lay out more lines after a resize
+	bool				Reflowing() const { return _laidFrom > 0 || _tailPending; }
+	unsigned long		FrameDrawCalls() const { return _drawCalls; }				//DrawRun calls this frame
+	unsigned long		FrameCells() const { return _cells; }						//Cells drawn this frame
+	const MetricsCache	&Metrics() const { return _metrics; }
+	const ScreenModel	&Screen() const { return _screen; }
+
+private:
+	void		Print(const char *text, size_t len);
+	size_t		PrintAscii(const char *text, size_t len);	//Returns the bytes written
+	size_t		PrintUtf8(const char *text, size_t len);	//Returns the bytes decoded
+	void		FlushUtf8();
+	void		Execute(char c);
+	void		EscDispatch(const VtSequence &seq, char final);
+	void		CsiDispatch(const VtSequence &seq, char final);
+	void		OscDispatch(const char *text, size_t len);
+	void		SelectGraphics(const VtSequence &seq);
+	unsigned long	CellColor() const { return (_sgrBack ? _back : _color) | _ink; }
+	void		CarriageReturn();
+	void		MoveToColumn(size_t col);
+	void		Blank(size_t from, size_t count);
+	void		EraseToEnd();
+	void		EraseInLine(unsigned int mode);
+	void		QueueCell(RenderTarget &target, int x, int y, unsigned int c, unsigned long color);
+	void		FlushRun(RenderTarget &target);
+	void		PaintRow(RenderTarget &target, size_t row, int left, int right);
+	void		NewRow(size_t line, size_t col);
+	size_t		RowEnd(size_t row) const;
+	int			RowWidth(size_t row) const;
+	void		EraseLast();
+	void		PutChar(unsigned int c, unsigned long color);
+	void		LineBreak();
+	void		Tab(unsigned long color);
+	void		CursorLeft();
+	void		CursorRight();
+	void		FindCursor();
+	void		Rewrap(size_t row);
+	void		EndWrite();
+	void		Layout();
+	void		Wrap(size_t line, std::vector<size_t> &starts) const;
+	int			MeasureLine(size_t line) const;
+	void		LayoutTail(size_t to);
+	size_t		ViewRows() const;
+	size_t		MaxTop() const;
+	void		MoveTop(size_t top);
+	void		MarkView(int top, int bottom);
+
+	ScreenModel		_screen;			//All I/O history
+	RowIndex		_rows;				//Rows of the window and the cells each one shows
+	MetricsCache	_metrics;			//Line height, advance widths and client width
+	size_t			_col;				//Cell of the last line the cursor is on
+	size_t			_crow;				//Row the cursor is on
+	int				_x;					//Where the cursor is on its row, in pixels
+	size_t			_typed;				//Cells typed at the end of the last line since anything was received
+	std::deque<int>	_lineWidth;			//Width of each line in pixels
+	std::vector<size_t>	_wrap;			//Row starts of the line being laid out
+	std::vector<RowIndex::Row>	_prefix;	//Rows of the lines before _laidFrom laid out so far
+	size_t			_laidFrom;			//First line in the row index, earlier lines are still being laid out
+	size_t			_prefixLine;		//Next line before _laidFrom to lay out
+	size_t			_laidTo;			//First line not in the row index while _tailPending
+	bool			_tailPending;		//Lines after the view are still being laid out
+	size_t			_top;				//First row shown in the view
+	bool			_follow;			//View stays at the bottom as rows are added
+	int				_scroll;			//Pixels the surface has to be scrolled down by
+	int				_bandTop, _bandBottom;	//Area of the view exposed by scrolling, empty when equal
+	struct
+	{
+		unsigned int	text[256];		//Code points waiting to be drawn
+		int				len;			//Number of characters in text
+		int				x, y;			//Where the first character is drawn
+		unsigned long	color;			//Background color shared by the characters
+	} _run;								//Same-colored characters on one row, drawn with one call
+	VtParser		_parser;			//Splits received bytes into text, controls and escape sequences
+	Utf8Decoder		_utf8;				//Decodes received text, keeps a sequence split across writes
+	unsigned long	_color;				//Color of the Write in progress
+	unsigned long	_back;				//Background set by SGR
+	bool			_sgrBack;			//_back replaces _color
+	unsigned long	_ink;				//Text color set by SGR, in the top byte, 0 for the default
+	unsigned long	_drawCalls;			//DrawRun calls issued in the current frame
+	unsigned long	_cells;				//Cells drawn in the current frame
+};
+#endif
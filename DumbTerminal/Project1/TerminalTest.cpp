@@ -0,0 +1,651 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: TerminalTest.cpp - Tests of the terminal model and layout of the dumb terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- int main();
+-- static unsigned int Next(unsigned int &seed);
+-- static std::string Random_Input(unsigned int &seed, size_t pieces, bool forward);
+-- static std::string Line_Text(const Terminal &terminal, size_t line);
+-- static bool Same_Screen(const Terminal &a, const Terminal &b);
+-- static VOID Compose_View(Terminal &terminal, MemoryRenderTarget &target);
+-- static bool Same_Pixels(const MemoryRenderTarget &a, const MemoryRenderTarget &b);
+-- static bool Same_View(Terminal &a, Terminal &b, size_t row);
+-- static VOID Present(Terminal &terminal, MemoryRenderTarget &target);
+-- static VOID Test_Metrics_Cache();
+-- static VOID Test_Cursor_Moves();
+-- static VOID Test_Many_Colors();
+-- static VOID Test_Chunked_Input(bool proportional);
+-- static VOID Test_Reflow(bool proportional, size_t maxLines);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Built by CMakeLists.txt as dtterminaltest and run by ctest. Everything runs against TestMetrics, a provider
+--	with monospace or proportional advance widths in a client area the test resizes, and draws into a
+--	MemoryRenderTarget, so no display is needed. Besides a few fixed cases, the terminal is checked against
+--	itself on random input of text, UTF-8, controls and escape sequences:
+--		colors		More text and background colors than the palette has entries, in a history that keeps them
+--					all and in one that drops its oldest lines, are stored and drawn as they were sent
+--		chunked		The same bytes fed whole and in chunks of 1 to 7 bytes, split anywhere, including inside a
+--					sequence or a character, give the same history, rows and pixels; and a surface that is only
+--					ever scrolled and given the dirty areas looks the same as one composed whole
+--		reflow		A terminal resized to another width and laid out incrementally, with Reflow called a little
+--					at a time and more bytes arriving in between, ends up with the same rows and pixels as one
+--					that had that width from the start, with and without a scrollback limit trimming lines
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <string>
+#include "Check.h"
+#include "FontMetrics.h"
+#include "RenderTarget.h"
+#include "Terminal.h"
+static const int	LINE_HEIGHT = 16;				//Height of a row of TestMetrics
+
+class TestMetrics : public MetricsProvider			//Advance widths of a made-up font, in a client area of any size
+{
+public:
+	TestMetrics(bool proportional, int width, int height)
+		: widthCalls(0), _proportional(proportional), _width(width), _height(height) {}
+	int		LineHeight() const { return LINE_HEIGHT; }
+	void	AdvanceWidths(int *widths) const
+	{
+		++widthCalls;
+		for (size_t c = 0; c < CHARS; ++c)
+			widths[c] = _proportional ? 3 + (int)(c * 7 % 9) : 8;	//3 to 11 pixels
+	}
+	int		ClientWidth() const { return _width; }
+	int		ClientHeight() const { return _height; }
+	void	Resize(int width, int height) { _width = width, _height = height; }
+
+	mutable int	widthCalls;							//AdvanceWidths calls so far
+
+private:
+	bool	_proportional;
+	int		_width, _height;
+};
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Next
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static unsigned int Next(unsigned int &seed);
+--					-unsigned int &seed: State of the generator, advanced
+--
+-- RETURNS: The next pseudo-random number, 0 to 32767, the same for the same seed on every platform
+----------------------------------------------------------------------------------------------------------------------*/
+static unsigned int Next(unsigned int &seed)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 16 & 0x7FFF;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Random_Input
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static std::string Random_Input(unsigned int &seed, size_t pieces, bool forward);
+--					-unsigned int &seed:	State of the generator, advanced
+--					-size_t pieces:			Number of pieces to string together
+--					-bool forward:			Include cursor moves to the right
+--
+-- RETURNS: Bytes as a device sends them
+--
+-- NOTES:
+--	Each piece is a word, a line break, a backspace, a CR, a tab, a UTF-8 character of two to four bytes, an SGR
+--	color (basic, 256-color or reset), a cursor move, an erase, an OSC title, or the odd stray control or
+--	invalid byte, so lines wrap, get overwritten and change color. A move to the right past the end of the line
+--	stops at the right edge of the window, so input laid out at different widths leaves those out.
+----------------------------------------------------------------------------------------------------------------------*/
+static std::string Random_Input(unsigned int &seed, size_t pieces, bool forward)
+{
+	static const char	*UTF8[] = { "\xC3\xA9", "\xCE\xBB", "\xE4\xB8\xAD", "\xE2\x82\xAC", "\xF0\x9F\x98\x80" };
+	static const char	*SEQUENCES[] = { "\x1b[0m", "\x1b[31m", "\x1b[42m", "\x1b[1;33;44m", "\x1b[K", "\x1b[1K",
+		"\x1b[2K", "\x1b[3D", "\x1b[3X", "\x1b[2J", "\x1b]0;title\x07", "\x1b[?25l", "\x1b(B", "\x1b[2C", "\x1b[5G" };
+	static const size_t	MOVES = 2;						//Moves to the right, last in SEQUENCES
+	std::string			out;
+	char				buf[32];
+	for (size_t i = 0; i < pieces; ++i)
+	{
+		unsigned int kind = Next(seed) % 20;
+		if (kind < 8)
+			out.append(1 + Next(seed) % 12, (char)('a' + Next(seed) % 26)).append(" ");
+		else if (kind == 8)
+			out += "\r\n";
+		else if (kind == 9)
+			out += '\b';
+		else if (kind == 10)
+			out += '\r';
+		else if (kind == 11)
+			out += '\t';
+		else if (kind == 12)
+			out += UTF8[Next(seed) % 5];
+		else if (kind < 16)
+			out += SEQUENCES[Next(seed) % (sizeof(SEQUENCES) / sizeof(SEQUENCES[0]) - (forward ? 0 : MOVES))];
+		else if (kind == 16)
+		{
+			snprintf(buf, sizeof(buf), "\x1b[38;5;%um", Next(seed) % 256);
+			out += buf;
+		}
+		else if (kind == 17)
+			out += '\n';
+		else if (kind == 18)
+			out += (char)(Next(seed) % 2 ? 0x07 : 0xFF);
+		else
+			out.append(40 + Next(seed) % 80, (char)('A' + Next(seed) % 26));	//Wraps on a narrow window
+	}
+	return out;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Line_Text
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static std::string Line_Text(const Terminal &terminal, size_t line);
+--					-const Terminal &terminal:	Terminal to read
+--					-size_t line:				Line of its history
+--
+-- RETURNS: The cells of the line, one char each, '?' for anything outside ASCII
+----------------------------------------------------------------------------------------------------------------------*/
+static std::string Line_Text(const Terminal &terminal, size_t line)
+{
+	std::string text;
+	for (size_t col = 0; col < terminal.Screen().LineLength(line); ++col)
+	{
+		unsigned int glyph = terminal.Screen().Glyph(line, col);
+		text += glyph < 0x80 ? (char)glyph : '?';
+	}
+	return text;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Same_Screen
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static bool Same_Screen(const Terminal &a, const Terminal &b);
+--					-const Terminal &a, &b: Terminals to compare
+--
+-- RETURNS: true when both hold the same lines, with the same code point and color in every cell
+----------------------------------------------------------------------------------------------------------------------*/
+static bool Same_Screen(const Terminal &a, const Terminal &b)
+{
+	const ScreenModel &sa = a.Screen(), &sb = b.Screen();
+	if (sa.LineCount() != sb.LineCount())
+		return false;
+	for (size_t line = 0; line < sa.LineCount(); ++line)
+	{
+		if (sa.LineLength(line) != sb.LineLength(line))
+			return false;
+		for (size_t col = 0; col < sa.LineLength(line); ++col)
+			if (sa.Glyph(line, col) != sb.Glyph(line, col)
+				|| sa.Color(line, col) != sb.Color(line, col))
+				return false;
+	}
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Compose_View
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Compose_View(Terminal &terminal, MemoryRenderTarget &target);
+--					-Terminal &terminal:			Terminal to draw
+--					-MemoryRenderTarget &target:	Surface the size of the client area
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Composes the whole view, as Compose_All does in the window.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Compose_View(Terminal &terminal, MemoryRenderTarget &target)
+{
+	terminal.Compose(target, 0, 0, target.Width(), target.Height());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Same_Pixels
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static bool Same_Pixels(const MemoryRenderTarget &a, const MemoryRenderTarget &b);
+--					-const MemoryRenderTarget &a, &b: Surfaces to compare
+--
+-- RETURNS: true when both are the same size with the same color in every pixel
+----------------------------------------------------------------------------------------------------------------------*/
+static bool Same_Pixels(const MemoryRenderTarget &a, const MemoryRenderTarget &b)
+{
+	if (a.Width() != b.Width() || a.Height() != b.Height())
+		return false;
+	for (int y = 0; y < a.Height(); ++y)
+		for (int x = 0; x < a.Width(); ++x)
+			if (a.Pixel(x, y) != b.Pixel(x, y))
+				return false;
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Same_View
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static bool Same_View(Terminal &a, Terminal &b, size_t row);
+--					-Terminal &a, &b:	Terminals to compare, with the same metrics
+--					-size_t row:		Row to scroll both to first
+--
+-- RETURNS: true when both show the same row at the top and compose the same pixels
+----------------------------------------------------------------------------------------------------------------------*/
+static bool Same_View(Terminal &a, Terminal &b, size_t row)
+{
+	MemoryRenderTarget ta(a.Metrics(), a.Metrics().ClientWidth(), a.Metrics().ClientHeight());
+	MemoryRenderTarget tb(b.Metrics(), b.Metrics().ClientWidth(), b.Metrics().ClientHeight());
+	a.ScrollTo(row);
+	b.ScrollTo(row);
+	Compose_View(a, ta);
+	Compose_View(b, tb);
+	return a.TopRow() == b.TopRow() && Same_Pixels(ta, tb);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Present
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Present(Terminal &terminal, MemoryRenderTarget &target);
+--					-Terminal &terminal:			Terminal that changed
+--					-MemoryRenderTarget &target:	Surface kept between frames, as the back buffer is
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	What Present_Dirty does in the window: scroll the surface, then compose only the areas that changed.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Present(Terminal &terminal, MemoryRenderTarget &target)
+{
+	int left, top, right, bottom, dy;
+	if ((dy = terminal.TakeScroll()) != 0)
+		target.Scroll(dy);
+	while (terminal.NextDirty(left, top, right, bottom))
+		terminal.Compose(target, left, top, right, bottom);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_Metrics_Cache
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_Metrics_Cache();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	The cache answers from its tables with what the provider reported, Latin-1 bytes included and code points
+--	past the table as U+FFFD, and a resize reloads the client size without asking for the advance widths again.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_Metrics_Cache()
+{
+	TestMetrics		provider(true, 640, 400);
+	MetricsCache	cache;
+	CHECK(!cache.Valid());
+	cache.Refresh(provider);
+	CHECK(cache.Valid() && provider.widthCalls == 1);
+	CHECK(cache.LineHeight() == LINE_HEIGHT);
+	CHECK(cache.Advance((unsigned int)'A') == 3 + 'A' * 7 % 9);
+	CHECK(cache.Advance('A') == cache.Advance((unsigned int)'A'));
+	CHECK(cache.Advance((char)0xE9) == cache.Advance(0xE9u));
+	CHECK(cache.Advance(0x4E2Du) == 3 + 0x4E2D * 7 % 9);
+	CHECK(cache.Advance(0x1F600u) == cache.Advance(0xFFFDu));
+	CHECK(cache.ClientWidth() == 640 && cache.ClientHeight() == 400);
+	provider.Resize(300, 200);
+	cache.RefreshSize(provider);
+	CHECK(cache.ClientWidth() == 300 && cache.ClientHeight() == 200);
+	CHECK(provider.widthCalls == 1);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_Cursor_Moves
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_Cursor_Moves();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Fixed cases of the cursor on the last line: backspace moves back without erasing and stops at the start of
+--	the line, CR returns to the start and what follows overwrites, tab goes to the next stop, LF starts a new
+--	line, and a typed backspace only erases what was typed since the last received byte.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_Cursor_Moves()
+{
+	TestMetrics	provider(false, 640, 400);
+	Terminal	terminal;
+	terminal.UpdateMetrics(provider, true);
+	terminal.Write("abc\b\bX", 6, 0);
+	CHECK(Line_Text(terminal, 0) == "aXc");
+	terminal.Write("\r\nhello\rJ", 9, 0);
+	CHECK(Line_Text(terminal, 1) == "Jello");
+	terminal.Write("\r\n\b\b\bz", 6, 0);
+	CHECK(Line_Text(terminal, 2) == "z");
+	terminal.Write("\ra\tb", 4, 0);
+	CHECK(Line_Text(terminal, 2) == std::string("a") + std::string(Terminal::TAB_CELLS - 1, ' ') + "b");
+	terminal.Write("\ncd", 3, 0);
+	CHECK(terminal.Screen().LineCount() == 4 && Line_Text(terminal, 3) == "cd");
+	terminal.Type("xy\b", 3, 0);
+	CHECK(Line_Text(terminal, 3) == "cdx");
+	terminal.Type("\b\b\b", 3, 0);							//Stops at what was received
+	CHECK(Line_Text(terminal, 3) == "cd");
+	terminal.Write("\x1b[1D\x1b[K", 7, 0);
+	CHECK(Line_Text(terminal, 3) == "c");
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_Many_Colors
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_Many_Colors();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	First 600 cells, each with its own pair of an xterm text color and a 24-bit background, 255 backgrounds in
+--	all: every cell keeps both, in the screen model and in the pixels of the view. Then 300 backgrounds at once,
+--	more than the palette holds: the text colors are still exact. Last, 1500 lines of 1000 cells, each line in a
+--	background of its own, with a scrollback of 60 lines: the palette gets the entries of dropped lines back, so
+--	every line kept has its own background.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_Many_Colors()
+{
+	static const int	COLS = 40, VIEW_ROWS = 10;
+	TestMetrics			provider(false, COLS * 8, VIEW_ROWS * LINE_HEIGHT);
+	Terminal			terminal, crowded, trimmed;
+	char				buf[64];
+	std::string			input;
+	unsigned long		color;
+	bool				stored = true, drawn = true, inked = true, kept = true;
+	terminal.UpdateMetrics(provider, true);
+	for (unsigned int i = 0; i < 600; ++i)
+	{
+		snprintf(buf, sizeof(buf), "\x1b[38;5;%um\x1b[48;2;%u;%u;%umx", i % 251, i % 255, i % 255 * 7 % 256,
+			i % 255 * 13 % 256);
+		input += buf;
+	}
+	terminal.Write(input.data(), input.size(), 0x00FFFFFF);
+	for (size_t i = 0; i < 600; ++i)
+	{
+		color = (i % 255) | (i % 255 * 7 % 256) << 8 | (i % 255 * 13 % 256) << 16 | (unsigned long)(i % 251 + 1) << 24;
+		stored = stored && terminal.Screen().Color(0, i) == color;
+	}
+	CHECK(stored);
+	for (size_t top = 0; top < terminal.RowCount(); top += VIEW_ROWS)
+	{
+		MemoryRenderTarget target(terminal.Metrics(), COLS * 8, VIEW_ROWS * LINE_HEIGHT);
+		terminal.ScrollTo(top);
+		Compose_View(terminal, target);
+		for (size_t i = terminal.TopRow() * COLS; i < 600 && i < (terminal.TopRow() + VIEW_ROWS) * COLS; ++i)
+		{
+			int x = (int)(i % COLS) * 8, y = (int)(i / COLS - terminal.TopRow()) * LINE_HEIGHT;
+			color = terminal.Screen().Color(0, i);
+			drawn = drawn && target.Pixel(x, y) == Run_Background(color) && target.Pixel(x + 4, y + 8) == Run_Ink(color);
+		}
+	}
+	CHECK(drawn);
+
+	crowded.UpdateMetrics(provider, true);
+	input.clear();
+	for (unsigned int i = 0; i < 300; ++i)
+	{
+		snprintf(buf, sizeof(buf), "\x1b[38;5;%um\x1b[48;2;%u;%u;7mx", i % 200, i % 256, i / 256);
+		input += buf;
+	}
+	crowded.Write(input.data(), input.size(), 0);
+	for (size_t i = 0; i < 300; ++i)
+	{
+		color = crowded.Screen().Color(0, i);
+		inked = inked && color >> 24 == i % 200 + 1;
+		stored = stored && (i >= 255 || (color & 0x00FFFFFF) == ((i % 256) | (i / 256) << 8 | 7 << 16));
+	}
+	CHECK(inked);
+	CHECK(stored);
+
+	trimmed.UpdateMetrics(provider, true);
+	trimmed.SetScrollback(60, 0);
+	for (unsigned int k = 0; k < 1500; ++k)
+	{
+		snprintf(buf, sizeof(buf), "\x1b[48;2;%u;%u;64m%06u", k & 0xFF, k >> 8, k);
+		input = buf + std::string(994, 'x') + "\r\n";
+		trimmed.Write(input.data(), input.size(), 0);
+	}
+	CHECK(trimmed.Screen().LineCount() < 200);
+	for (size_t line = 0; line + 1 < trimmed.Screen().LineCount(); ++line)
+	{
+		unsigned long k = 0;
+		if (trimmed.Screen().LineLength(line) != 1000)		//Lost its head to the trim
+			continue;
+		for (size_t col = 0; col < 6; ++col)
+			k = k * 10 + trimmed.Screen().Glyph(line, col) - '0';
+		for (size_t col = 0; col < 1000; ++col)
+			kept = kept && trimmed.Screen().Color(line, col) == ((k & 0xFF) | (k >> 8) << 8 | 64 << 16);
+	}
+	CHECK(kept);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_Chunked_Input
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_Chunked_Input(bool proportional);
+--					-bool proportional: Lay out with proportional advance widths rather than monospace
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	For each seed, one terminal gets the input whole and another in chunks of 1 to 7 bytes; the second is
+--	presented after every chunk through Present. Both have to end with the same history, rows and view, and the
+--	surface that only ever got the dirty areas has to match a whole compose.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_Chunked_Input(bool proportional)
+{
+	TestMetrics provider(proportional, 320, 160);
+	for (unsigned int seed = 1; seed <= 200; ++seed)
+	{
+		unsigned int	state = seed;
+		std::string		input = Random_Input(state, 300, true);
+		Terminal		whole, chunked;
+		whole.UpdateMetrics(provider, true);
+		chunked.UpdateMetrics(provider, true);
+		MemoryRenderTarget	presented(chunked.Metrics(), 320, 160), composed(chunked.Metrics(), 320, 160);
+		Compose_View(chunked, presented);
+		whole.Write(input.data(), input.size(), 0x00CCFFCC);
+		for (size_t done = 0, n; done < input.size(); done += n)
+		{
+			n = 1 + Next(state) % 7;
+			n = n < input.size() - done ? n : input.size() - done;
+			chunked.Write(input.data() + done, n, 0x00CCFFCC);
+			Present(chunked, presented);
+		}
+		Compose_View(chunked, composed);
+		if (!CHECK(Same_Screen(whole, chunked)) || !CHECK(whole.RowCount() == chunked.RowCount())
+			|| !CHECK(Same_Pixels(presented, composed)) || !CHECK(Same_View(whole, chunked, whole.RowCount())))
+		{
+			fprintf(stderr, "seed %u, %s\n", seed, proportional ? "proportional" : "monospace");
+			return;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_Reflow
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_Reflow(bool proportional, size_t maxLines);
+--					-bool proportional:	Lay out with proportional advance widths rather than monospace
+--					-size_t maxLines:	Scrollback limit of both terminals, 0 for none
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	For each seed, one terminal is written at one width and then resized to another, scrolled somewhere into the
+--	history or left following. It is laid out with Reflow a batch at a time, with more input written between
+--	batches, until it is done. The other terminal had the new width all along and got the same input. Both have
+--	to hold the same rows and show the same pixels at the top, in the middle and at the bottom.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_Reflow(bool proportional, size_t maxLines)
+{
+	static const int	WIDTHS[] = { 640, 200, 97, 333, 1000 };
+	for (unsigned int seed = 1; seed <= 60; ++seed)
+	{
+		unsigned int	state = seed * 7919;
+		TestMetrics		before(proportional, WIDTHS[seed % 5], 160), after(proportional, WIDTHS[(seed + 1) % 5], 160);
+		Terminal		resized, fresh;
+		std::string		input = Random_Input(state, 2000, false);
+		resized.SetScrollback(maxLines, 0);
+		fresh.SetScrollback(maxLines, 0);
+		resized.UpdateMetrics(before, true);
+		fresh.UpdateMetrics(after, true);
+		resized.Write(input.data(), input.size(), 0);
+		fresh.Write(input.data(), input.size(), 0);
+		if (seed % 2)												//Scrolled back, not following
+			resized.ScrollTo(resized.RowCount() / 3);
+		resized.UpdateMetrics(after, false);
+		for (int batch = 0; resized.Reflowing() && batch < 100000; ++batch)
+		{
+			resized.Reflow(1 + Next(state) % 50);
+			if (Next(state) % 4 == 0)
+			{
+				input = Random_Input(state, 5, false);
+				resized.Write(input.data(), input.size(), 0);
+				fresh.Write(input.data(), input.size(), 0);
+			}
+		}
+		if (!CHECK(!resized.Reflowing()) || !CHECK(Same_Screen(resized, fresh))
+			|| !CHECK(resized.RowCount() == fresh.RowCount()) || !CHECK(Same_View(resized, fresh, 0))
+			|| !CHECK(Same_View(resized, fresh, fresh.RowCount() / 2))
+			|| !CHECK(Same_View(resized, fresh, fresh.RowCount())))
+		{
+			fprintf(stderr, "seed %u, %s, %zu lines\n", seed, proportional ? "proportional" : "monospace", maxLines);
+			return;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: main
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int main();
+--
+-- RETURNS: 0 when every check passed, 1 otherwise
+----------------------------------------------------------------------------------------------------------------------*/
+int main()
+{
+	Test_Metrics_Cache();
+	Test_Cursor_Moves();
+	Test_Many_Colors();
+	Test_Chunked_Input(false);
+	Test_Chunked_Input(true);
+	Test_Reflow(false, 0);
+	Test_Reflow(true, 0);
+	Test_Reflow(true, 150);
+	return Check_Summary("dtterminaltest");
+}
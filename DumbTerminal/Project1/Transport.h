@@ -0,0 +1,82 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: Transport.h - Interface to the serial port used by the reader and writer threads of the dumb
+--			terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- bool Open(const char *name);
+-- bool Configure(const PortSettings &settings);
+-- bool Settings(PortSettings &settings) const;
+-- long Read(char *buf, size_t len);
+-- long Write(const char *buf, size_t len);
+-- VOID AbortWrite();
+-- VOID Cancel();
+-- VOID Close();
+-- bool Register(IoLoop &loop, IoLoop::Key key);
+-- long ReadReady(char *buf, size_t len);
+-- long WriteReady(const char *buf, size_t len);
+-- VOID Unregister();
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - A port can be serviced by an IoLoop instead of blocking threads
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Everything the program does with the port goes through this interface, so the reader and writer threads do not
+--	depend on the system underneath. Win32Transport (Win32Transport.h) drives a COM port with overlapped I/O and is
+--	what the program uses; PosixTransport (PosixTransport.h) drives a tty with termios and epoll, so the core can be
+--	built and exercised on Linux, e.g. against an openpty pair.
+--
+--	Read and Write block the calling thread until they complete, but never indefinitely: Cancel wakes both and
+--	makes every later call return 0 at once until the port is opened again, which is how the threads are stopped
+--	on disconnect. AbortWrite only gives up the write in progress and the bytes the driver still holds, which is
+--	how a file send is cancelled. Read is called by one thread and Write by one other thread at the same time;
+--	everything else is called by the UI thread.
+--
+--	A port that is registered with an IoLoop (IoLoop.h) is serviced by the one thread that waits in the loop
+--	instead: nobody calls Read or Write on it until it is unregistered. When the loop reports its key that thread
+--	calls ReadReady and WriteReady, which never wait; each returns 0 once there is nothing more to read or no more
+--	room to write, which re-arms the port, and the key is reported again when that changes. Bytes WriteReady
+--	returns as taken are the port's to send; the caller may reuse its buffer at once. Register, the two and
+--	Unregister are all called on the loop's thread.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+#include <cstddef>
+#include "IoLoop.h"
+struct PortSettings
+{
+	enum Flow { FLOW_NONE, FLOW_HARDWARE, FLOW_SOFTWARE };	//None, RTS/CTS or XON/XOFF
+
+	unsigned long	baud;				//Bits per second
+	int				dataBits;			//5 to 8
+	char			parity;				//'N'one, 'E'ven, 'O'dd, 'M'ark or 'S'pace
+	int				stopBits;			//1 or 2
+	Flow			flow;
+};
+
+class Transport
+{
+public:
+	virtual ~Transport() {}
+	virtual bool	Open(const char *name) = 0;						//Open the port by name, e.g. "COM1" or "/dev/ttyS0"
+	virtual bool	Configure(const PortSettings &settings) = 0;	//Set the line parameters
+	virtual bool	Settings(PortSettings &settings) const = 0;		//Line parameters in effect
+	virtual long	Read(char *buf, size_t len) = 0;				//Bytes read, 0 when cancelled, -1 on error
+	virtual long	Write(const char *buf, size_t len) = 0;			//Bytes written, 0 when aborted, -1 on error
+	virtual void	AbortWrite() = 0;								//Give up the write in progress
+	virtual void	Cancel() = 0;									//Wake Read and Write for good
+	virtual void	Close() = 0;
+	virtual bool	Register(IoLoop &loop, IoLoop::Key key) = 0;	//Have loop report the port under key
+	virtual long	ReadReady(char *buf, size_t len) = 0;			//Bytes read, 0 when none, -1 on error or hangup
+	virtual long	WriteReady(const char *buf, size_t len) = 0;	//Bytes taken, 0 when no room, -1 on error
+	virtual void	Unregister() = 0;								//Give up the operations left with the loop
+};
+#endif
@@ -0,0 +1,667 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: TransportTest.cpp - Tests of the termios transport of the dumb terminal emulator program over a pty
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- int main();
+-- static bool Open_Pty(int &master, std::string &slave);
+-- static bool Master_Read(int master, std::vector<char> &out, size_t len);
+-- static bool Master_Write(int master, const char *buf, size_t len);
+-- static size_t Master_Drain(int master);
+-- static VOID Fill(std::vector<char> &buf, unsigned int seed);
+-- static VOID Send_Loop(Transport &port, SendQueue &queue, size_t chunk, std::atomic<bool> &done);
+-- static bool Wait_Received(Listener &listener);
+-- static VOID Test_Transfer();
+-- static VOID Test_Abort_Write();
+-- static VOID Test_Cancel();
+-- static VOID Test_Hangup();
+-- static VOID Test_File_Send();
+-- static VOID Test_File_Cancel();
+-- static VOID Test_Reader_Throughput();
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Built by CMakeLists.txt as dttransporttest, on Linux only, and run by ctest. A pty stands in for the serial line:
+--	the PosixTransport opens the slave side, as it would a /dev/ttyUSB, and the test plays the device on the master
+--	side. Checks that bytes go through unchanged both ways, that AbortWrite wakes a write the line holds back, that
+--	Cancel wakes a read and keeps the port quiet until it is opened again, and that a hangup is an error. The last two
+--	tests send a file the way Write_To_Serial did, through a SendQueue: it has to arrive whole with a keystroke
+--	pushed in the middle, and a cancelled send has to let go of the file. The last one drives a PortReader from the
+--	pty, as the window read the port before its ports were sessions, and prints the rate it reached.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <poll.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "Check.h"
+#include "PortReader.h"
+#include "PosixTransport.h"
+#include "RingBuffer.h"
+#include "SendQueue.h"
+#include "Stats.h"
+static const int	WAIT_MS = 5000;						//Longest a test waits for the pty before failing
+
+class Listener : public ReaderListener				//Stands in for the window, woken by WM_SERIAL_DATA
+{
+public:
+	Listener() : received(false), failed(false) {}
+	void	Received() { std::lock_guard<std::mutex> guard(lock); received = true; changed.notify_one(); }
+	void	Failed() { std::lock_guard<std::mutex> guard(lock); failed = true; changed.notify_one(); }
+
+	std::mutex				lock;
+	std::condition_variable	changed;				//Signalled by Received and Failed
+	bool					received;				//Received was called, cleared by Wait_Received
+	bool					failed;
+};
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Open_Pty
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static bool Open_Pty(int &master, std::string &slave);
+--					-int &master:			Set to the master side, non-blocking
+--					-std::string &slave:	Set to the name of the slave side, for PosixTransport::Open
+--
+-- RETURNS: false when no pty could be opened
+----------------------------------------------------------------------------------------------------------------------*/
+static bool Open_Pty(int &master, std::string &slave)
+{
+	const char *name;
+	if ((master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK)) < 0)
+		return false;
+	if (grantpt(master) != 0 || unlockpt(master) != 0 || (name = ptsname(master)) == NULL)
+	{
+		close(master);
+		return false;
+	}
+	slave = name;
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Master_Read
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static bool Master_Read(int master, std::vector<char> &out, size_t len);
+--					-int master:				Master side of the pty
+--					-std::vector<char> &out:	Receives the bytes, appended
+--					-size_t len:				Bytes to read
+--
+-- RETURNS: false when the bytes did not all arrive within WAIT_MS of the last one
+----------------------------------------------------------------------------------------------------------------------*/
+static bool Master_Read(int master, std::vector<char> &out, size_t len)
+{
+	char	buf[4096];
+	pollfd	p = { master, POLLIN, 0 };
+	ssize_t	n;
+	while (len > 0)
+	{
+		if (poll(&p, 1, WAIT_MS) <= 0)
+			return false;
+		if ((n = read(master, buf, len < sizeof(buf) ? len : sizeof(buf))) > 0)
+		{
+			out.insert(out.end(), buf, buf + n);
+			len -= (size_t)n;
+		}
+	}
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Master_Write
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static bool Master_Write(int master, const char *buf, size_t len);
+--					-int master:		Master side of the pty
+--					-const char *buf:	Bytes the device sends
+--					-size_t len:		Number of bytes in buf
+--
+-- RETURNS: false when the pty took no bytes for WAIT_MS
+----------------------------------------------------------------------------------------------------------------------*/
+static bool Master_Write(int master, const char *buf, size_t len)
+{
+	pollfd	p = { master, POLLOUT, 0 };
+	ssize_t	n;
+	while (len > 0)
+	{
+		if (poll(&p, 1, WAIT_MS) <= 0)
+			return false;
+		if ((n = write(master, buf, len)) > 0)
+			buf += n, len -= (size_t)n;
+	}
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Master_Drain
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static size_t Master_Drain(int master);
+--					-int master: Master side of the pty
+--
+-- RETURNS: Bytes thrown away, everything that arrives until the line is quiet for 100ms
+----------------------------------------------------------------------------------------------------------------------*/
+static size_t Master_Drain(int master)
+{
+	char	buf[4096];
+	pollfd	p = { master, POLLIN, 0 };
+	size_t	total = 0;
+	ssize_t	n;
+	while (poll(&p, 1, 100) > 0 && (n = read(master, buf, sizeof(buf))) > 0)
+		total += (size_t)n;
+	return total;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Fill
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Fill(std::vector<char> &buf, unsigned int seed);
+--					-std::vector<char> &buf:	Filled with pseudo-random bytes, all 256 values
+--					-unsigned int seed:			Start of the sequence
+--
+-- RETURNS: VOID
+----------------------------------------------------------------------------------------------------------------------*/
+static void Fill(std::vector<char> &buf, unsigned int seed)
+{
+	for (size_t i = 0; i < buf.size(); ++i)
+	{
+		seed = seed * 1103515245 + 12345;
+		buf[i] = (char)(seed >> 16);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Send_Loop
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Send_Loop(Transport &port, SendQueue &queue, size_t chunk, std::atomic<bool> &done);
+--					-Transport &port:			Port to write to
+--					-SendQueue &queue:			Queue to take from until it is closed
+--					-size_t chunk:				Most bytes per write
+--					-std::atomic<bool> &done:	Set when a Written reports the end of the file
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	The loop Write_To_Serial had, without the statistics and the capture.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Send_Loop(Transport &port, SendQueue &queue, size_t chunk, std::atomic<bool> &done)
+{
+	std::vector<char>	buffer;
+	const char			*data;
+	size_t				len, sent;
+	long				written = 0;
+	while ((len = queue.Take(data, buffer, chunk)) > 0)
+	{
+		for (sent = 0; sent < len; sent += written)
+			if ((written = port.Write(data + sent, len - sent)) <= 0)
+				break;
+		if (queue.Written(sent, written < 0))
+			done = true;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Wait_Received
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static bool Wait_Received(Listener &listener);
+--					-Listener &listener: Listener of the reader
+--
+-- RETURNS: false when the reader failed or did not call Received within WAIT_MS
+----------------------------------------------------------------------------------------------------------------------*/
+static bool Wait_Received(Listener &listener)
+{
+	std::unique_lock<std::mutex> guard(listener.lock);
+	if (!listener.changed.wait_for(guard, std::chrono::milliseconds(WAIT_MS),
+		[&listener] { return listener.received || listener.failed; }) || listener.failed)
+		return false;
+	listener.received = false;
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_Transfer
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_Transfer();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	1MB of every byte value goes through unchanged in each direction, with both sides busy at once. The tty is in
+--	raw mode, so nothing is translated or swallowed on the way.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_Transfer()
+{
+	PosixTransport		port;
+	std::vector<char>	out(1 << 20), in(1 << 20), fromPort, toPort;
+	std::string			slave;
+	int					master;
+	if (!CHECK(Open_Pty(master, slave)))
+		return;
+	CHECK(port.Open(slave.c_str()));
+	Fill(out, 1);
+	Fill(in, 2);
+	std::thread writer([&port, &out] { CHECK(port.Write(out.data(), out.size()) == (long)out.size()); });
+	std::thread reader([&port, &toPort, &in]
+	{
+		char	buf[8192];
+		long	n = 1;
+		while (toPort.size() < in.size() && (n = port.Read(buf, sizeof(buf))) > 0)
+			toPort.insert(toPort.end(), buf, buf + n);
+	});
+	std::thread device([master, &in] { CHECK(Master_Write(master, in.data(), in.size())); });
+	CHECK(Master_Read(master, fromPort, out.size()));
+	writer.join();
+	device.join();
+	reader.join();
+	CHECK(fromPort == out);
+	CHECK(toPort == in);
+	port.Close();
+	close(master);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_Abort_Write
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_Abort_Write();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	The device reads nothing, so a large write fills the pty and blocks, as one held back by flow control does.
+--	AbortWrite is called until the write gives up, the way End_Send does, and it has to return 0. The port
+--	writes again afterwards.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_Abort_Write()
+{
+	PosixTransport		port;
+	std::vector<char>	out(4 << 20), got;
+	std::atomic<long>	result(1);
+	std::string			slave;
+	int					master;
+	if (!CHECK(Open_Pty(master, slave)))
+		return;
+	CHECK(port.Open(slave.c_str()));
+	std::thread writer([&port, &out, &result] { result = port.Write(out.data(), out.size()); });
+	for (int i = 0; i < WAIT_MS && result == 1; ++i)
+	{
+		port.AbortWrite();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	writer.join();
+	CHECK(result == 0);
+	Master_Drain(master);
+	CHECK(port.Write("ok", 2) == 2);
+	CHECK(Master_Read(master, got, 2) && memcmp(got.data(), "ok", 2) == 0);
+	port.Close();
+	close(master);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_Cancel
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_Cancel();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	A read waiting on a quiet line is woken by Cancel and returns 0. Every later Read and Write returns 0 at once,
+--	even with bytes waiting, until the port is opened again, after which it reads them.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_Cancel()
+{
+	PosixTransport		port;
+	std::atomic<long>	result(1);
+	std::string			slave;
+	char				buf[16];
+	int					master;
+	if (!CHECK(Open_Pty(master, slave)))
+		return;
+	CHECK(port.Open(slave.c_str()));
+	std::thread reader([&port, &result]
+	{
+		char buf[16];
+		result = port.Read(buf, sizeof(buf));
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	port.Cancel();
+	reader.join();
+	CHECK(result == 0);
+	CHECK(Master_Write(master, "abc", 3));
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	CHECK(port.Read(buf, sizeof(buf)) == 0);
+	CHECK(port.Write("x", 1) == 0);
+	port.Close();
+	CHECK(port.Open(slave.c_str()));
+	CHECK(Master_Write(master, "def", 3));
+	CHECK(port.Read(buf, sizeof(buf)) == 3 && memcmp(buf, "def", 3) == 0);
+	port.Close();
+	close(master);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_Hangup
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_Hangup();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Closing the master side, like unplugging a USB adapter, wakes a waiting read with an error.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_Hangup()
+{
+	PosixTransport		port;
+	std::atomic<long>	result(1);
+	std::string			slave;
+	int					master;
+	if (!CHECK(Open_Pty(master, slave)))
+		return;
+	CHECK(port.Open(slave.c_str()));
+	std::thread reader([&port, &result]
+	{
+		char buf[16];
+		result = port.Read(buf, sizeof(buf));
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	close(master);
+	reader.join();
+	CHECK(result == -1);
+	port.Close();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_File_Send
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_File_Send();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	A 3MB file is attached to the queue and sent by Send_Loop while the device reads. A keystroke is pushed once
+--	part of the file has arrived; it has to land between two chunks of the file, with the file whole around it,
+--	and the send has to be reported finished.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_File_Send()
+{
+	PosixTransport		port;
+	SendQueue			queue;
+	std::vector<char>	file(3 << 20), got;
+	std::atomic<bool>	done(false);
+	std::string			slave;
+	size_t				chunk = 4096, at;
+	int					master;
+	if (!CHECK(Open_Pty(master, slave)))
+		return;
+	CHECK(port.Open(slave.c_str()));
+	Fill(file, 3);
+	queue.Open();
+	std::thread writer([&port, &queue, chunk, &done] { Send_Loop(port, queue, chunk, done); });
+	queue.Attach(file.data(), file.size());
+	CHECK(Master_Read(master, got, file.size() / 2));
+	queue.Push("\x7f", 1);
+	CHECK(Master_Read(master, got, file.size() + 1 - got.size()));
+	for (int i = 0; i < WAIT_MS && !done; ++i)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	CHECK(done);
+	queue.Close();
+	writer.join();
+	for (at = 0; at < file.size() && got[at] == file[at]; ++at)
+		;
+	CHECK(at % chunk == 0 && got.size() == file.size() + 1 && got[at] == '\x7f');
+	CHECK(std::equal(file.begin() + at, file.end(), got.begin() + at + 1));
+	CHECK(queue.Detach(0));
+	port.Close();
+	close(master);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_File_Cancel
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_File_Cancel();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	The device stops reading partway through a file, so the write in progress blocks. Cancelling as End_Send
+--	does, Detach and AbortWrite until Detach lets go, has to succeed, leave the file short and take no more of
+--	it; keystrokes still go out afterwards.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_File_Cancel()
+{
+	PosixTransport		port;
+	SendQueue			queue;
+	std::vector<char>	file(8 << 20), got;
+	std::atomic<bool>	done(false);
+	std::string			slave;
+	size_t				sent, total;
+	int					master, tries = 0;
+	if (!CHECK(Open_Pty(master, slave)))
+		return;
+	CHECK(port.Open(slave.c_str()));
+	queue.Open();
+	std::thread writer([&port, &queue, &done] { Send_Loop(port, queue, 1 << 16, done); });
+	queue.Attach(file.data(), file.size());
+	CHECK(Master_Read(master, got, 100000));
+	while (!queue.Detach(10) && ++tries < WAIT_MS / 10)
+		port.AbortWrite();
+	CHECK(tries < WAIT_MS / 10);
+	queue.Progress(sent, total);
+	CHECK(!done && sent < total);
+	Master_Drain(master);
+	queue.Push("k", 1);
+	got.clear();
+	CHECK(Master_Read(master, got, 1) && got[0] == 'k');
+	CHECK(Master_Drain(master) == 0);
+	queue.Close();
+	writer.join();
+	port.Close();
+	close(master);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Test_Reader_Throughput
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Test_Reader_Throughput();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	The device sends 32MB as fast as the pty takes it while a PortReader reads the slave side into a RingBuffer
+--	and the test takes the bytes out after each Received, as Drain_Received does. Every byte has to arrive in
+--	order, and the reads have to come in batches of what was queued rather than a byte at a time. The rate and
+--	the bytes per read are printed, to compare runs; the pty is far faster than any serial line.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Test_Reader_Throughput()
+{
+	const size_t		TOTAL = 32 << 20;
+	PosixTransport		port;
+	RingBuffer			ring(1 << 16);
+	PortReader			reader(ring, 4096);
+	Listener			listener;
+	StatsSnapshot		before, after;
+	std::vector<char>	sent(TOTAL), buf(1 << 16);
+	std::string			slave;
+	size_t				got = 0, wrong = 0, n;
+	unsigned long long	start, elapsed, reads;
+	int					master;
+	if (!CHECK(Open_Pty(master, slave)))
+		return;
+	CHECK(port.Open(slave.c_str()));
+	Fill(sent, 4);
+	Stats_Read(before);
+	start = Stats_Now();
+	if (!CHECK(reader.Start(port, listener, NULL)))
+		return;
+	std::thread device([master, &sent] { CHECK(Master_Write(master, sent.data(), sent.size())); });
+	while (got < TOTAL && Wait_Received(listener))
+		while (got < TOTAL && (n = reader.Receive(buf.data(), buf.size() < TOTAL - got ? buf.size() : TOTAL - got)) > 0)
+		{
+			wrong += memcmp(buf.data(), sent.data() + got, n) != 0;
+			got += n;
+		}
+	elapsed = Stats_Now() - start;
+	device.join();
+	reader.Stop();
+	Stats_Read(after);
+	reads = after.counters[STAT_READS] - before.counters[STAT_READS];
+	CHECK(got == TOTAL && wrong == 0);
+	CHECK(reads > 0 && TOTAL / reads >= 64);
+	printf("PortReader over a pty: %.1f MB/s, %llu bytes per read\n", elapsed ? TOTAL / (double)elapsed : 0.0,
+		reads ? TOTAL / reads : 0);
+	port.Close();
+	close(master);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: main
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: int main();
+--
+-- RETURNS: 0 when every check passed, 1 otherwise
+----------------------------------------------------------------------------------------------------------------------*/
+int main()
+{
+	Test_Transfer();
+	Test_Abort_Write();
+	Test_Cancel();
+	Test_Hangup();
+	Test_File_Send();
+	Test_File_Cancel();
+	Test_Reader_Throughput();
+	return Check_Summary("dttransporttest");
+}
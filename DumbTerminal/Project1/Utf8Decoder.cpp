@@ -0,0 +1,173 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: Utf8Decoder.cpp - Actual function implementation for Utf8Decoder.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- Utf8Decoder();
+-- size_t Decode(const char *buf, size_t len, unsigned int *out);
+-- bool Flush(unsigned int &c);
+-- VOID Reset();
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Streaming UTF-8 decoding. See Utf8Decoder.h.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include "ControlScan.h"
+#include "Utf8Decoder.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Utf8Decoder
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: Utf8Decoder();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Starts between sequences.
+----------------------------------------------------------------------------------------------------------------------*/
+Utf8Decoder::Utf8Decoder()
+	: _code(0), _need(0), _lower(0x80), _upper(0xBF)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Decode
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: size_t Decode(const char *buf, size_t len, unsigned int *out);
+--					-const char *buf:		Next chunk of UTF-8
+--					-size_t len:			Number of bytes in buf
+--					-unsigned int *out:		Receives the code points, room for len + 1 of them
+--
+-- RETURNS: Number of code points put in out
+--
+-- NOTES:
+--	A sequence that is not finished at the end of buf is kept for the next call. There is never more than one code
+--	point per byte, except that the first byte may also end a sequence from the last call with a U+FFFD, hence
+--	len + 1. The lead byte limits the range of the first continuation byte, which is how overlong forms,
+--	surrogates and code points past U+10FFFF are turned away without decoding them first.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t Utf8Decoder::Decode(const char *buf, size_t len, unsigned int *out)
+{
+	const unsigned char	*p = (const unsigned char *)buf, *end = p + len;
+	unsigned int		*start = out;
+	while (p < end)
+	{
+		if (_need == 0)
+		{
+			size_t ascii = Ascii_Run((const char *)p, end - p);	//Copied as they are
+			for (size_t i = 0; i < ascii; ++i)
+				out[i] = p[i];
+			out += ascii;
+			if ((p += ascii) == end)
+				break;
+			unsigned char c = *p++;
+			if (c >= 0xC2 && c <= 0xDF)
+				_need = 1, _code = c & 0x1F;
+			else if (c >= 0xE0 && c <= 0xEF)
+			{
+				_need = 2, _code = c & 0x0F;
+				_lower = c == 0xE0 ? 0xA0 : 0x80;				//Overlong below U+0800
+				_upper = c == 0xED ? 0x9F : 0xBF;				//Surrogates
+			}
+			else if (c >= 0xF0 && c <= 0xF4)
+			{
+				_need = 3, _code = c & 0x07;
+				_lower = c == 0xF0 ? 0x90 : 0x80;				//Overlong below U+10000
+				_upper = c == 0xF4 ? 0x8F : 0xBF;				//Past U+10FFFF
+			}
+			else												//Continuation byte, C0, C1 or F5 and up
+				*out++ = REPLACEMENT;
+			continue;
+		}
+		if (*p < _lower || *p > _upper)							//Cut short, the byte starts over on its own
+		{
+			Reset();
+			*out++ = REPLACEMENT;
+			continue;
+		}
+		_code = _code << 6 | (*p++ & 0x3F);
+		_lower = 0x80, _upper = 0xBF;
+		if (--_need == 0)
+			*out++ = _code;
+	}
+	return out - start;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Flush
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Flush(unsigned int &c);
+--					-unsigned int &c: Set to U+FFFD when a sequence was left unfinished
+--
+-- RETURNS: true when a sequence was left unfinished
+--
+-- NOTES:
+--	Called when no more of the sequence can come, e.g. a control character was received in the middle of it.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Utf8Decoder::Flush(unsigned int &c)
+{
+	if (_need == 0)
+		return false;
+	Reset();
+	c = REPLACEMENT;
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Reset
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Reset();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Drops a sequence left unfinished without a U+FFFD, e.g. when the history is cleared.
+----------------------------------------------------------------------------------------------------------------------*/
+void Utf8Decoder::Reset()
+{
+	_code = 0;
+	_need = 0;
+	_lower = 0x80, _upper = 0xBF;
+}
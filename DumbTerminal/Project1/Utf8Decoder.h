@@ -0,0 +1,57 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: Utf8Decoder.h - Streaming UTF-8 decoder for the dumb terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- Utf8Decoder();
+-- size_t Decode(const char *buf, size_t len, unsigned int *out);
+-- bool Flush(unsigned int &c);
+-- VOID Reset();
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	The devices on the other end of the port run Linux and print UTF-8. Utf8Decoder turns those bytes into Unicode
+--	code points a chunk at a time, as the reader hands them over, and keeps a sequence that is cut off at the end
+--	of a chunk until the next one completes it.
+--
+--	Anything that is not well-formed UTF-8 becomes U+FFFD, one for each maximal part of a sequence that could
+--	have been the start of a valid one, the way the Unicode standard and the WHATWG Encoding spec recommend: a byte
+--	that cannot start a sequence, a sequence that ends too early, an overlong form, a surrogate or a code point
+--	past U+10FFFF. The byte that cut a sequence short is then decoded on its own, so a stray byte never takes the
+--	text after it with it. Flush ends a sequence that will not be completed, e.g. when a control character comes
+--	in the middle of it.
+--
+--	Decode copies runs of ASCII, found by Ascii_Run 16 or 32 bytes at a time (see ControlScan.h), without looking
+--	at them byte by byte. The terminal does not even call it for those: it copies ASCII straight into the screen
+--	model and only decodes the bytes from 0x80 up.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef UTF8DECODER_H
+#define UTF8DECODER_H
+#include <cstddef>
+class Utf8Decoder
+{
+public:
+	static const unsigned int	REPLACEMENT = 0xFFFD;	//Stands in for every malformed sequence
+
+	Utf8Decoder();
+	size_t	Decode(const char *buf, size_t len, unsigned int *out);	//Returns the code points put in out
+	bool	Flush(unsigned int &c);						//U+FFFD for a sequence left unfinished, if any
+	void	Reset();									//Forget a sequence left unfinished
+	bool	Pending() const { return _need > 0; }		//In the middle of a sequence
+
+private:
+	unsigned int	_code;				//Bits of the code point collected so far
+	int				_need;				//Continuation bytes still to come
+	unsigned char	_lower, _upper;		//Range the next continuation byte has to be in
+};
+#endif
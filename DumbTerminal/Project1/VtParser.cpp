@@ -0,0 +1,333 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: VtParser.cpp - Actual function implementation for VtParser.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- static VOID Set(Row &row, int first, int last, int action, int state);
+-- TransitionTable();
+-- VtParser();
+-- VOID Reset();
+-- VOID Feed(const char *buf, size_t len, VtHandler &handler);
+-- VOID Perform(int action, unsigned char c, VtHandler &handler);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Text runs are found with the vectorized Printable_Run
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Escape sequence state machine. See VtParser.h.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include <cstring>
+#include "ControlScan.h"
+#include "VtParser.h"
+enum VtAction								//What a transition does with the byte, before the state changes
+{
+	ACT_NONE,								//Ignore it
+	ACT_PRINT,								//Print it
+	ACT_EXECUTE,							//Hand the control character to the handler
+	ACT_CLEAR,								//Start a new sequence
+	ACT_COLLECT,							//Keep an intermediate or the private marker
+	ACT_PARAM,								//Add a digit or a separator to the parameters
+	ACT_ESC_DISPATCH,						//ESC sequence is complete
+	ACT_CSI_DISPATCH,						//CSI sequence is complete
+	ACT_OSC_START,							//Start an OSC string
+	ACT_OSC_PUT								//Add to the OSC string
+};
+typedef unsigned char Row[256];				//Transitions of one state, action in the high nibble, state in the low
+
+struct TransitionTable						//Built once, the first time a parser is created, and shared
+{
+	TransitionTable();
+	Row	rows[VtParser::STATES];
+};
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Set
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Set(Row &row, int first, int last, int action, int state);
+--					-Row &row:			Transitions of a state
+--					-int first, last:	Range of bytes, both included
+--					-int action:		What to do with them
+--					-int state:			State to go to
+--
+-- RETURNS: VOID
+----------------------------------------------------------------------------------------------------------------------*/
+static void Set(Row &row, int first, int last, int action, int state)
+{
+	for (int c = first; c <= last; ++c)
+		row[c] = (unsigned char)(action << 4 | state);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: TransitionTable
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: TransitionTable();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Each row starts out ignoring every byte and staying put; the ranges below then follow Williams' diagram. The
+--	C0 controls other than CAN, SUB and ESC are executed in every state but the strings, where they are ignored.
+--	CAN, SUB and ESC are set last since they act the same from any state.
+----------------------------------------------------------------------------------------------------------------------*/
+TransitionTable::TransitionTable()
+{
+	for (int state = 0; state < VtParser::STATES; ++state)
+	{
+		Set(rows[state], 0x00, 0xFF, ACT_NONE, state);
+		if (state != VtParser::OSC_STRING && state != VtParser::STRING_IGNORE)
+		{
+			Set(rows[state], 0x00, 0x17, ACT_EXECUTE, state);
+			Set(rows[state], 0x19, 0x19, ACT_EXECUTE, state);
+			Set(rows[state], 0x1C, 0x1F, ACT_EXECUTE, state);
+		}
+	}
+	Row &ground = rows[VtParser::GROUND];
+	Set(ground, 0x20, 0x7E, ACT_PRINT, VtParser::GROUND);
+	Set(ground, 0x80, 0xFF, ACT_PRINT, VtParser::GROUND);			//No C1 controls, UTF-8 is text
+
+	Row &esc = rows[VtParser::ESCAPE];
+	Set(esc, 0x20, 0x2F, ACT_COLLECT, VtParser::ESCAPE_INTERMEDIATE);
+	Set(esc, 0x30, 0x7E, ACT_ESC_DISPATCH, VtParser::GROUND);
+	Set(esc, '[', '[', ACT_CLEAR, VtParser::CSI_ENTRY);
+	Set(esc, ']', ']', ACT_OSC_START, VtParser::OSC_STRING);
+	Set(esc, 'P', 'P', ACT_NONE, VtParser::STRING_IGNORE);			//DCS
+	Set(esc, 'X', 'X', ACT_NONE, VtParser::STRING_IGNORE);			//SOS
+	Set(esc, '^', '_', ACT_NONE, VtParser::STRING_IGNORE);			//PM and APC
+
+	Row &escInter = rows[VtParser::ESCAPE_INTERMEDIATE];
+	Set(escInter, 0x20, 0x2F, ACT_COLLECT, VtParser::ESCAPE_INTERMEDIATE);
+	Set(escInter, 0x30, 0x7E, ACT_ESC_DISPATCH, VtParser::GROUND);
+
+	Row &entry = rows[VtParser::CSI_ENTRY];
+	Set(entry, 0x20, 0x2F, ACT_COLLECT, VtParser::CSI_INTERMEDIATE);
+	Set(entry, 0x30, 0x3B, ACT_PARAM, VtParser::CSI_PARAM);			//':' separates like ';'
+	Set(entry, 0x3C, 0x3F, ACT_COLLECT, VtParser::CSI_PARAM);		//Private marker
+	Set(entry, 0x40, 0x7E, ACT_CSI_DISPATCH, VtParser::GROUND);
+
+	Row &param = rows[VtParser::CSI_PARAM];
+	Set(param, 0x20, 0x2F, ACT_COLLECT, VtParser::CSI_INTERMEDIATE);
+	Set(param, 0x30, 0x3B, ACT_PARAM, VtParser::CSI_PARAM);
+	Set(param, 0x3C, 0x3F, ACT_NONE, VtParser::CSI_IGNORE);			//Marker after a parameter
+	Set(param, 0x40, 0x7E, ACT_CSI_DISPATCH, VtParser::GROUND);
+
+	Row &csiInter = rows[VtParser::CSI_INTERMEDIATE];
+	Set(csiInter, 0x20, 0x2F, ACT_COLLECT, VtParser::CSI_INTERMEDIATE);
+	Set(csiInter, 0x30, 0x3F, ACT_NONE, VtParser::CSI_IGNORE);
+	Set(csiInter, 0x40, 0x7E, ACT_CSI_DISPATCH, VtParser::GROUND);
+
+	Set(rows[VtParser::CSI_IGNORE], 0x40, 0x7E, ACT_NONE, VtParser::GROUND);
+
+	Row &osc = rows[VtParser::OSC_STRING];
+	Set(osc, 0x07, 0x07, ACT_NONE, VtParser::GROUND);				//xterm ends it with BEL too
+	Set(osc, 0x20, 0x7E, ACT_OSC_PUT, VtParser::OSC_STRING);
+	Set(osc, 0x80, 0xFF, ACT_OSC_PUT, VtParser::OSC_STRING);
+
+	for (int state = 0; state < VtParser::STATES; ++state)
+	{
+		Set(rows[state], 0x18, 0x18, ACT_EXECUTE, VtParser::GROUND);	//CAN
+		Set(rows[state], 0x1A, 0x1A, ACT_EXECUTE, VtParser::GROUND);	//SUB
+		Set(rows[state], 0x1B, 0x1B, ACT_CLEAR, VtParser::ESCAPE);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: VtParser
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VtParser();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Starts in the ground state. The first parser builds the transition table.
+----------------------------------------------------------------------------------------------------------------------*/
+VtParser::VtParser()
+{
+	static const TransitionTable transitions;
+	_table = transitions.rows;
+	Reset();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Reset
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Reset();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Forgets any sequence in progress, e.g. when a new connection starts.
+----------------------------------------------------------------------------------------------------------------------*/
+void VtParser::Reset()
+{
+	_state = GROUND;
+	memset(&_seq, 0, sizeof(_seq));
+	_overflow = _dropParams = false;
+	_oscLen = 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Feed
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Text runs are found with the vectorized Printable_Run
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Feed(const char *buf, size_t len, VtHandler &handler);
+--					-const char *buf:		Bytes received
+--					-size_t len:			Number of bytes in buf
+--					-VtHandler &handler:	Gets the text, controls and sequences found, in order
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	In the ground state the printable run up to the next control character, found by Printable_Run, goes to
+--	Print in one call; every other byte is looked up in the table. A run cut off by the end of the chunk is printed as it is, the rest of
+--	it comes with the next chunk.
+----------------------------------------------------------------------------------------------------------------------*/
+void VtParser::Feed(const char *buf, size_t len, VtHandler &handler)
+{
+	const unsigned char *p = (const unsigned char *)buf, *end = p + len;
+	while (p < end)
+	{
+		if (_state == GROUND)
+		{
+			size_t run = Printable_Run((const char *)p, end - p);
+			if (run > 0)
+				handler.Print((const char *)p, run);
+			p += run;
+			if (p == end)
+				break;
+		}
+		unsigned char next = _table[_state][*p];
+		if (_state == OSC_STRING && (next & 0x0F) != OSC_STRING)	//Leaving the string dispatches it
+			handler.OscDispatch(_osc, _oscLen);
+		Perform(next >> 4, *p, handler);
+		_state = next & 0x0F;
+		++p;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Perform
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Perform(int action, unsigned char c, VtHandler &handler);
+--					-int action:			One of VtAction
+--					-unsigned char c:		Byte the transition was taken on
+--					-VtHandler &handler:	Gets what is complete
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Parameters are kept up to 65535 each; a separator past MAX_PARAMS is ignored along with the digits after
+--	it. A sequence with more than two intermediates is parsed to its end and dropped.
+----------------------------------------------------------------------------------------------------------------------*/
+void VtParser::Perform(int action, unsigned char c, VtHandler &handler)
+{
+	switch (action)
+	{
+	case ACT_PRINT:
+		handler.Print((const char *)&c, 1);
+		break;
+	case ACT_EXECUTE:
+		handler.Execute((char)c);
+		break;
+	case ACT_CLEAR:
+		_seq.paramCount = _seq.intermediateCount = 0;
+		_seq.marker = 0;
+		_overflow = _dropParams = false;
+		break;
+	case ACT_COLLECT:
+		if (c >= 0x3C)										//Private marker, only taken right after ESC [
+			_seq.marker = (char)c;
+		else if (_seq.intermediateCount < sizeof(_seq.intermediates))
+			_seq.intermediates[_seq.intermediateCount++] = (char)c;
+		else
+			_overflow = true;
+		break;
+	case ACT_PARAM:
+		if (_seq.paramCount == 0)							//First parameter, even when left out
+			_seq.params[_seq.paramCount++] = 0;
+		if (c == ';' || c == ':')
+		{
+			if (_seq.paramCount < VtSequence::MAX_PARAMS)
+				_seq.params[_seq.paramCount++] = 0;
+			else
+				_dropParams = true;
+		}
+		else if (!_dropParams)
+		{
+			unsigned int &value = _seq.params[_seq.paramCount - 1];
+			value = value * 10 + (c - '0');
+			if (value > 65535)
+				value = 65535;
+		}
+		break;
+	case ACT_ESC_DISPATCH:
+		if (!_overflow)
+			handler.EscDispatch(_seq, (char)c);
+		break;
+	case ACT_CSI_DISPATCH:
+		if (!_overflow)
+			handler.CsiDispatch(_seq, (char)c);
+		break;
+	case ACT_OSC_START:
+		_oscLen = 0;
+		break;
+	case ACT_OSC_PUT:
+		if (_oscLen < OSC_MAX)
+			_osc[_oscLen++] = (char)c;
+		break;
+	}
+}
@@ -0,0 +1,96 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: VtParser.h - Table-driven VT100/ANSI escape sequence parser of the dumb terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- VtParser();
+-- VOID Feed(const char *buf, size_t len, VtHandler &handler);
+-- VOID Reset();
+-- VOID Perform(int action, unsigned char c, VtHandler &handler);
+-- unsigned int Param(size_t i, unsigned int fallback) const;
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Text runs are found with the vectorized Printable_Run
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	Splits a byte stream into printable text, control characters and escape sequences, the way a DEC VT500 does
+--	(the state machine of Paul Williams' "A parser for DEC's ANSI-compatible video terminals"), minus the 8-bit C1
+--	controls: bytes from 0x80 up are printed, so UTF-8 text passes through untouched. The parser only recognizes
+--	sequences; what they mean is up to the VtHandler it feeds, which is the Terminal in the program.
+--
+--	Every state has a row of 256 entries in a transition table, built once, each a byte holding the action to
+--	perform and the state to go to. The table covers ESC sequences, CSI sequences with up to MAX_PARAMS numeric
+--	parameters, a private marker and two intermediates, OSC strings ended by BEL or ESC \, and DCS, SOS, PM and APC
+--	strings, which are skipped. CAN and SUB abandon any sequence and ESC starts a new one from any state.
+--
+--	Feed takes a whole chunk and keeps its state between calls, so a sequence may be split anywhere across chunks.
+--	In the ground state, which plain text never leaves, the bytes are not looked up one by one: the run up to the
+--	next control character is found by Printable_Run, 16 or 32 bytes per compare (see ControlScan.h), and handed
+--	to Print as one action, so the cost of text is a fraction of a compare per byte and a call per run.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef VTPARSER_H
+#define VTPARSER_H
+#include <cstddef>
+struct VtSequence							//Parameters and intermediates of the sequence being dispatched
+{
+	static const size_t	MAX_PARAMS = 16;	//Parameters kept, the rest are dropped
+
+	unsigned int	params[MAX_PARAMS];		//Numeric parameters, 0 where one was left out
+	size_t			paramCount;				//Parameters given, 0 when there were none
+	char			marker;					//Private marker '<', '=', '>' or '?', 0 for none
+	char			intermediates[2];		//Bytes 0x20 to 0x2F before the final byte
+	size_t			intermediateCount;
+
+	unsigned int	Param(size_t i, unsigned int fallback) const	//Parameter i, fallback when 0 or left out
+	{
+		return i < paramCount && params[i] != 0 ? params[i] : fallback;
+	}
+};
+
+class VtHandler								//What the parser found, in the order it found it
+{
+public:
+	virtual ~VtHandler() {}
+	virtual void	Print(const char *text, size_t len) = 0;				//Run of printable bytes
+	virtual void	Execute(char c) = 0;									//C0 control character
+	virtual void	EscDispatch(const VtSequence &seq, char final) = 0;		//ESC, intermediates, final byte
+	virtual void	CsiDispatch(const VtSequence &seq, char final) = 0;		//ESC [, parameters, final byte
+	virtual void	OscDispatch(const char *text, size_t len) = 0;			//ESC ], string, BEL or ESC \ .
+};
+
+class VtParser
+{
+public:
+	static const size_t	OSC_MAX = 512;		//Bytes of an OSC string kept, the rest are dropped
+
+	enum State
+	{
+		GROUND, ESCAPE, ESCAPE_INTERMEDIATE, CSI_ENTRY, CSI_PARAM, CSI_INTERMEDIATE, CSI_IGNORE, OSC_STRING,
+		STRING_IGNORE, STATES
+	};
+
+	VtParser();
+	void	Feed(const char *buf, size_t len, VtHandler &handler);	//Parse a chunk
+	void	Reset();												//Back to the ground state
+	State	CurrentState() const { return (State)_state; }
+
+private:
+	void	Perform(int action, unsigned char c, VtHandler &handler);
+
+	const unsigned char	(*_table)[256];		//Transition table, one row per state
+	int					_state;
+	VtSequence			_seq;				//Sequence being collected
+	bool				_overflow;			//Too many intermediates, the sequence is not dispatched
+	bool				_dropParams;		//Past MAX_PARAMS, the digits that follow are dropped
+	char				_osc[OSC_MAX];		//OSC string being collected
+	size_t				_oscLen;
+};
+#endif
@@ -0,0 +1,609 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: Win32Transport.cpp - Actual function implementation for Win32Transport.h
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- Win32Transport();
+-- ~Win32Transport();
+-- bool Open(const char *name);
+-- bool Configure(const PortSettings &settings);
+-- bool Settings(PortSettings &settings) const;
+-- long Read(char *buf, size_t len);
+-- long Write(const char *buf, size_t len);
+-- VOID AbortWrite();
+-- VOID Cancel();
+-- VOID Close();
+-- bool Register(IoLoop &loop, IoLoop::Key key);
+-- long ReadReady(char *buf, size_t len);
+-- long WriteReady(const char *buf, size_t len);
+-- VOID Unregister();
+-- static PortSettings FromDcb(const DCB &dcb);
+-- long Finish(OVERLAPPED &ov, DWORD &bytes);
+-- static VOID Count_Errors(DWORD error);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	COM port transport. The calls are the ones Physical.cpp used to make on hComm directly.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include "Stats.h"
+#include "Win32Transport.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Win32Transport
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - The events of _ovRead and _ovWrite are tagged so they never queue a completion
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: Win32Transport();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Creates the events of the two OVERLAPPED structures and the cancel event. The port is not opened yet.
+----------------------------------------------------------------------------------------------------------------------*/
+Win32Transport::Win32Transport()
+	: _handle(INVALID_HANDLE_VALUE), _watchMask(0), _registered(false), _sending(false), _sendAt(0), _sendLen(0)
+{
+	ZeroMemory(&_ovRead, sizeof(OVERLAPPED));
+	ZeroMemory(&_ovWrite, sizeof(OVERLAPPED));
+	ZeroMemory(&_ovWatch, sizeof(OVERLAPPED));
+	ZeroMemory(&_ovSend, sizeof(OVERLAPPED));
+	_ovRead.hEvent = (HANDLE)((ULONG_PTR)CreateEvent(NULL, TRUE, FALSE, NULL) | 1);	//Never queued to a loop
+	_ovWrite.hEvent = (HANDLE)((ULONG_PTR)CreateEvent(NULL, TRUE, FALSE, NULL) | 1);
+	_cancel = CreateEvent(NULL, TRUE, FALSE, NULL);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ~Win32Transport
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: ~Win32Transport();
+--
+-- RETURNS: N/A
+--
+-- NOTES:
+--	Closes the port if it is still open and the events.
+----------------------------------------------------------------------------------------------------------------------*/
+Win32Transport::~Win32Transport()
+{
+	Close();
+	CloseHandle((HANDLE)((ULONG_PTR)_ovRead.hEvent & ~(ULONG_PTR)1));
+	CloseHandle((HANDLE)((ULONG_PTR)_ovWrite.hEvent & ~(ULONG_PTR)1));
+	CloseHandle(_cancel);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Open
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Open(const char *name);
+--					-const char *name: Name of the port, e.g. "COM1"
+--
+-- RETURNS: true when the port was opened for overlapped I/O
+--
+-- NOTES:
+--	Opens the port for asynchronous reading and writing and asks for EV_RXCHAR events. Clears a Cancel left over
+--	from the previous connection.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Win32Transport::Open(const char *name)
+{
+	if ((_handle = CreateFile(name, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL))
+		== INVALID_HANDLE_VALUE)
+		return false;
+	ResetEvent(_cancel);
+	SetCommMask(_handle, EV_RXCHAR);			//Create an event when a character arrives
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Configure
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Configure(const PortSettings &settings);
+--					-const PortSettings &settings: Line parameters to set
+--
+-- RETURNS: true when the driver accepted the settings
+--
+-- NOTES:
+--	Changes the fields of the current DCB that PortSettings covers and leaves the rest as the driver has them.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Win32Transport::Configure(const PortSettings &settings)
+{
+	DCB dcb;
+	dcb.DCBlength = sizeof(DCB);
+	if (!GetCommState(_handle, &dcb))
+		return false;
+	dcb.BaudRate = settings.baud;
+	dcb.ByteSize = (BYTE)settings.dataBits;
+	dcb.fParity = settings.parity != 'N';
+	dcb.Parity = settings.parity == 'E' ? EVENPARITY : settings.parity == 'O' ? ODDPARITY
+		: settings.parity == 'M' ? MARKPARITY : settings.parity == 'S' ? SPACEPARITY : NOPARITY;
+	dcb.StopBits = settings.stopBits == 2 ? TWOSTOPBITS : ONESTOPBIT;
+	dcb.fOutxCtsFlow = settings.flow == PortSettings::FLOW_HARDWARE;
+	dcb.fRtsControl = settings.flow == PortSettings::FLOW_HARDWARE ? RTS_CONTROL_HANDSHAKE : RTS_CONTROL_ENABLE;
+	dcb.fOutX = dcb.fInX = settings.flow == PortSettings::FLOW_SOFTWARE;
+	dcb.fBinary = TRUE;
+	return SetCommState(_handle, &dcb) != FALSE;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Settings
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Settings(PortSettings &settings) const;
+--					-PortSettings &settings: Set to the line parameters in effect
+--
+-- RETURNS: false when the port is not open
+--
+-- NOTES:
+--	Reads the DCB back from the driver.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Win32Transport::Settings(PortSettings &settings) const
+{
+	DCB dcb;
+	dcb.DCBlength = sizeof(DCB);
+	if (!GetCommState(_handle, &dcb))
+		return false;
+	settings = FromDcb(dcb);
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: FromDcb
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static PortSettings FromDcb(const DCB &dcb);
+--					-const DCB &dcb: Device control block, e.g. from the configuration dialog
+--
+-- RETURNS: The settings the DCB describes
+--
+-- NOTES:
+--	CTS output flow control counts as hardware flow control and XON/XOFF on output as software flow control.
+----------------------------------------------------------------------------------------------------------------------*/
+PortSettings Win32Transport::FromDcb(const DCB &dcb)
+{
+	PortSettings settings;
+	settings.baud = dcb.BaudRate;
+	settings.dataBits = dcb.ByteSize;
+	settings.parity = dcb.Parity == EVENPARITY ? 'E' : dcb.Parity == ODDPARITY ? 'O'
+		: dcb.Parity == MARKPARITY ? 'M' : dcb.Parity == SPACEPARITY ? 'S' : 'N';
+	settings.stopBits = dcb.StopBits == TWOSTOPBITS ? 2 : 1;
+	settings.flow = dcb.fOutxCtsFlow ? PortSettings::FLOW_HARDWARE
+		: dcb.fOutX ? PortSettings::FLOW_SOFTWARE : PortSettings::FLOW_NONE;
+	return settings;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Count_Errors
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: static VOID Count_Errors(DWORD error);
+--					-DWORD error: Error flags returned by ClearCommError
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	ClearCommError reports and clears the flags raised since it was last called, so every flag set is counted as
+--	one more occurrence.
+----------------------------------------------------------------------------------------------------------------------*/
+static void Count_Errors(DWORD error)
+{
+	if (error & CE_OVERRUN)
+		Stats_Count(STAT_OVERRUN);
+	if (error & CE_FRAME)
+		Stats_Count(STAT_FRAMING);
+	if (error & CE_RXPARITY)
+		Stats_Count(STAT_PARITY);
+	if (error & CE_RXOVER)
+		Stats_Count(STAT_RXOVER);
+	if (error & CE_BREAK)
+		Stats_Count(STAT_BREAK);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Read
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Counts the error flags ClearCommError reports
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: long Read(char *buf, size_t len);
+--					-char *buf:		Receives the bytes
+--					-size_t len:	Most bytes to read
+--
+-- RETURNS: Bytes read, 0 when cancelled, -1 on error
+--
+-- NOTES:
+--	Reads what the driver has queued, up to len bytes. When nothing is queued it waits for EV_RXCHAR first, so it
+--	always returns at least one byte unless cancelled.
+----------------------------------------------------------------------------------------------------------------------*/
+long Win32Transport::Read(char *buf, size_t len)
+{
+	DWORD	error, mask, bytes;
+	COMSTAT	cs;
+	long	result;
+	if (WaitForSingleObject(_cancel, 0) == WAIT_OBJECT_0)
+		return 0;
+	for (;;)
+	{
+		if (!ClearCommError(_handle, &error, &cs))		//Clear the communication port
+			return -1;
+		if (error != 0)
+			Count_Errors(error);
+		if (cs.cbInQue > 0)
+		{
+			if (!ReadFile(_handle, buf, min(cs.cbInQue, (DWORD)len), NULL, &_ovRead)
+				&& GetLastError() != ERROR_IO_PENDING)
+				return -1;
+			return (result = Finish(_ovRead, bytes)) > 0 ? (long)bytes : result;
+		}
+		if (!WaitCommEvent(_handle, &mask, &_ovRead) && GetLastError() != ERROR_IO_PENDING)
+			return -1;
+		if ((result = Finish(_ovRead, bytes)) <= 0)		//Wait for the event to happen
+			return result;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Write
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: long Write(const char *buf, size_t len);
+--					-const char *buf:	Bytes to send
+--					-size_t len:		Number of bytes in buf
+--
+-- RETURNS: Bytes written, 0 when aborted or cancelled, -1 on error
+--
+-- NOTES:
+--	Starts one overlapped WriteFile and waits for it to complete. The driver may take fewer than len bytes when
+--	write timeouts are set, so the caller sends the rest again.
+----------------------------------------------------------------------------------------------------------------------*/
+long Win32Transport::Write(const char *buf, size_t len)
+{
+	DWORD	bytes;
+	long	result;
+	if (WaitForSingleObject(_cancel, 0) == WAIT_OBJECT_0)
+		return 0;
+	if (!WriteFile(_handle, buf, (DWORD)len, NULL, &_ovWrite) && GetLastError() != ERROR_IO_PENDING)
+		return -1;
+	return (result = Finish(_ovWrite, bytes)) > 0 ? (long)bytes : result;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: AbortWrite
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID AbortWrite();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Aborts the write in progress, which then returns 0, and drops what the driver holds to transmit.
+----------------------------------------------------------------------------------------------------------------------*/
+void Win32Transport::AbortWrite()
+{
+	PurgeComm(_handle, PURGE_TXABORT | PURGE_TXCLEAR);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Cancel
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Cancel();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Sets the cancel event. Read and Write return 0 from then on, until the port is opened again.
+----------------------------------------------------------------------------------------------------------------------*/
+void Win32Transport::Cancel()
+{
+	SetEvent(_cancel);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Close
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Close();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Closes the port. Called once the reader and writer threads no longer use it.
+----------------------------------------------------------------------------------------------------------------------*/
+void Win32Transport::Close()
+{
+	if (_handle != INVALID_HANDLE_VALUE)
+	{
+		PurgeComm(_handle, PURGE_RXCLEAR);			//Clean out the buffer
+		CloseHandle(_handle);
+		_handle = INVALID_HANDLE_VALUE;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Register
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Registers through IoLoop::Watch, without a cast to the concrete loop
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: bool Register(IoLoop &loop, IoLoop::Key key);
+--					-IoLoop &loop:		The platform's loop, an IocpLoop
+--					-IoLoop::Key key:	Queued with the completions of the port
+--
+-- RETURNS: false when the port is not open or the loop refused it
+--
+-- NOTES:
+--	Associates the handle with the completion port. Nothing is started yet: the first ReadReady reads what is
+--	already queued and leaves the WaitCommEvent with the loop.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Win32Transport::Register(IoLoop &loop, IoLoop::Key key)
+{
+	if (_handle == INVALID_HANDLE_VALUE || !loop.Watch(_handle, key))
+		return false;
+	ZeroMemory(&_ovWatch, sizeof(OVERLAPPED));
+	ZeroMemory(&_ovSend, sizeof(OVERLAPPED));
+	_registered = true;
+	_sending = false;
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: ReadReady
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: long ReadReady(char *buf, size_t len);
+--					-char *buf:		Receives the bytes
+--					-size_t len:	Most bytes to read
+--
+-- RETURNS: Bytes read, 0 when the driver has none, -1 on error
+--
+-- NOTES:
+--	Returns 0 at once while the WaitCommEvent left with the loop has not completed. Otherwise reads what the driver
+--	has queued, up to len bytes, which completes without waiting; when nothing is queued the WaitCommEvent is
+--	started again and its completion reports the key. The driver remembers a character that arrived since the
+--	last wait, so one that came between ClearCommError and WaitCommEvent still completes it.
+----------------------------------------------------------------------------------------------------------------------*/
+long Win32Transport::ReadReady(char *buf, size_t len)
+{
+	DWORD	error, bytes;
+	COMSTAT	cs;
+	if (!HasOverlappedIoCompleted(&_ovWatch))		//Still waiting for a character
+		return 0;
+	if (!ClearCommError(_handle, &error, &cs))
+		return -1;
+	if (error != 0)
+		Count_Errors(error);
+	if (cs.cbInQue == 0)
+	{
+		if (!WaitCommEvent(_handle, &_watchMask, &_ovWatch) && GetLastError() != ERROR_IO_PENDING)
+			return -1;
+		return 0;
+	}
+	if (!ReadFile(_handle, buf, min(cs.cbInQue, (DWORD)len), NULL, &_ovRead) && GetLastError() != ERROR_IO_PENDING)
+		return -1;
+	return GetOverlappedResult(_handle, &_ovRead, &bytes, TRUE) ? (long)bytes : -1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: WriteReady
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: long WriteReady(const char *buf, size_t len);
+--					-const char *buf:	Bytes to send
+--					-size_t len:		Number of bytes in buf
+--
+-- RETURNS: Bytes copied to the write started, 0 while the last write is not done, -1 on error
+--
+-- NOTES:
+--	Reads back the result of the last write first. A write the driver only took in part, e.g. because of write
+--	timeouts, is started again for the rest and 0 is returned; an aborted one is given up. Then copies up to
+--	sizeof(_send) bytes and starts one WriteFile, whose completion reports the key.
+----------------------------------------------------------------------------------------------------------------------*/
+long Win32Transport::WriteReady(const char *buf, size_t len)
+{
+	DWORD bytes;
+	if (_sending)
+	{
+		if (!HasOverlappedIoCompleted(&_ovSend))	//Last write still going
+			return 0;
+		_sending = false;
+		if (!GetOverlappedResult(_handle, &_ovSend, &bytes, FALSE))
+		{
+			if (GetLastError() != ERROR_OPERATION_ABORTED)
+				return -1;
+		}
+		else if ((_sendAt += bytes) < _sendLen)		//Taken in part, send the rest
+		{
+			if (!WriteFile(_handle, _send + _sendAt, _sendLen - _sendAt, NULL, &_ovSend)
+				&& GetLastError() != ERROR_IO_PENDING)
+				return -1;
+			_sending = true;
+			return 0;
+		}
+	}
+	if (len == 0)
+		return 0;
+	_sendLen = (DWORD)min(len, sizeof(_send));
+	_sendAt = 0;
+	memcpy(_send, buf, _sendLen);
+	if (!WriteFile(_handle, _send, _sendLen, NULL, &_ovSend) && GetLastError() != ERROR_IO_PENDING)
+		return -1;
+	_sending = true;
+	return (long)_sendLen;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Unregister
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: VOID Unregister();
+--
+-- RETURNS: VOID
+--
+-- NOTES:
+--	Cancels the WaitCommEvent and the WriteFile left with the loop and waits until both are done with their
+--	OVERLAPPED. Their completion packets are still queued; the handle stays associated until it is closed.
+----------------------------------------------------------------------------------------------------------------------*/
+void Win32Transport::Unregister()
+{
+	if (!_registered)
+		return;
+	CancelIoEx(_handle, &_ovWatch);
+	CancelIoEx(_handle, &_ovSend);
+	while (!HasOverlappedIoCompleted(&_ovWatch) || !HasOverlappedIoCompleted(&_ovSend))
+		Sleep(1);
+	_registered = _sending = false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION: Finish
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: (Date and Description)
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- INTERFACE: long Finish(OVERLAPPED &ov, DWORD &bytes);
+--					-OVERLAPPED &ov:	The operation that was started
+--					-DWORD &bytes:		Set to the bytes transferred
+--
+-- RETURNS: 1 when the operation completed, 0 when it was cancelled or aborted, -1 on error
+--
+-- NOTES:
+--	Waits for the operation or for Cancel. On Cancel the operation is cancelled with CancelIo, which is called from
+--	the thread that started it, and waited for, so ov can be used again.
+----------------------------------------------------------------------------------------------------------------------*/
+long Win32Transport::Finish(OVERLAPPED &ov, DWORD &bytes)
+{
+	HANDLE	events[2] = { ov.hEvent, _cancel };
+	bytes = 0;
+	if (WaitForMultipleObjects(2, events, FALSE, INFINITE) != WAIT_OBJECT_0)
+	{
+		CancelIo(_handle);
+		GetOverlappedResult(_handle, &ov, &bytes, TRUE);
+		return 0;
+	}
+	if (!GetOverlappedResult(_handle, &ov, &bytes, FALSE))
+		return GetLastError() == ERROR_OPERATION_ABORTED ? 0 : -1;
+	return 1;
+}
@@ -0,0 +1,88 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE: Win32Transport.h - Serial port transport on a Win32 COM port with overlapped I/O for the dumb
+--			terminal emulator program
+--
+-- PROGRAM: Dumb terminal emulator
+--
+-- FUNCTIONS:
+-- Win32Transport();
+-- ~Win32Transport();
+-- bool Open(const char *name);
+-- bool Configure(const PortSettings &settings);
+-- bool Settings(PortSettings &settings) const;
+-- long Read(char *buf, size_t len);
+-- long Write(const char *buf, size_t len);
+-- VOID AbortWrite();
+-- VOID Cancel();
+-- VOID Close();
+-- bool Register(IoLoop &loop, IoLoop::Key key);
+-- long ReadReady(char *buf, size_t len);
+-- long WriteReady(const char *buf, size_t len);
+-- VOID Unregister();
+-- HANDLE Handle() const;
+-- static PortSettings FromDcb(const DCB &dcb);
+-- long Finish(OVERLAPPED &ov, DWORD &bytes);
+--
+--
+-- DATE: October 17, 2026
+--
+-- REVISIONS: October 17, 2026 - Can be serviced by an IocpLoop
+--
+-- DESIGNER: Ruoqi Jia
+--
+-- PROGRAMMER: Ruoqi Jia
+--
+-- NOTES:
+--	The port is opened for overlapped I/O. Read and Write each own an OVERLAPPED and its event, created once when
+--	the transport is constructed, and wait for their operation together with a cancel event, so Cancel wakes them
+--	whatever the driver is doing. Read waits for EV_RXCHAR with WaitCommEvent when nothing is queued, then reads
+--	what the driver has, up to len bytes. The handle is available for the driver's configuration dialog.
+--
+--	Registered with an IocpLoop the handle is associated with the completion port, and two more operations are
+--	left with it, each with an OVERLAPPED of its own that has no event: a WaitCommEvent for EV_RXCHAR, started
+--	again by ReadReady whenever it finds the driver's queue empty, and the WriteFile WriteReady started last,
+--	from a buffer of the transport's own so the caller's bytes are free at once. The events of _ovRead and
+--	_ovWrite have their low bit set, so the operations that wait on them never queue a completion.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef WIN32TRANSPORT_H
+#define WIN32TRANSPORT_H
+#include <windows.h>
+#include "Transport.h"
+class Win32Transport : public Transport
+{
+public:
+	Win32Transport();
+	~Win32Transport();
+	bool	Open(const char *name);
+	bool	Configure(const PortSettings &settings);
+	bool	Settings(PortSettings &settings) const;
+	long	Read(char *buf, size_t len);
+	long	Write(const char *buf, size_t len);
+	void	AbortWrite();
+	void	Cancel();
+	void	Close();
+	bool	Register(IoLoop &loop, IoLoop::Key key);
+	long	ReadReady(char *buf, size_t len);
+	long	WriteReady(const char *buf, size_t len);
+	void	Unregister();
+	HANDLE	Handle() const { return _handle; }
+	static PortSettings	FromDcb(const DCB &dcb);			//Settings chosen in the configuration dialog
+
+private:
+	long	Finish(OVERLAPPED &ov, DWORD &bytes);			//Wait for an operation or Cancel
+
+	HANDLE		_handle;
+	HANDLE		_cancel;				//Manual-reset event, set by Cancel until the next Open
+	OVERLAPPED	_ovRead;				//Used by the reader thread only
+	OVERLAPPED	_ovWrite;				//Used by the writer thread only
+	OVERLAPPED	_ovWatch;				//WaitCommEvent left with the loop
+	OVERLAPPED	_ovSend;				//WriteFile left with the loop
+	DWORD		_watchMask;				//Events _ovWatch completed with
+	bool		_registered;			//_ovWatch and _ovSend may be outstanding
+	bool		_sending;				//_ovSend was started and its result not read yet
+	DWORD		_sendAt;				//Bytes of _send written by the operations before
+	DWORD		_sendLen;				//Bytes in _send
+	char		_send[4096];			//Bytes of the write left with the loop
+};
+#endif
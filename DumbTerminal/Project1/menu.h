@@ -13,5 +13,25 @@
 #define IDM_RYELLOW		113
 #define IDM_RGREY		114
 #define IDM_RBLUE		115
+#define IDM_PASTE		116
+#define IDM_SENDFILE	117
+#define IDM_SENDCANCEL	118
+#define IDM_CAPTURE		119
+#define IDM_CAPTURESTOP	120
+#define IDM_REPLAY1		121
+#define IDM_REPLAY10	122
+#define IDM_REPLAYMAX	123
+#define IDM_REPLAYSTOP	124
+#define IDM_STATISTICS	125
+#define IDM_HEXVIEW		126
+#define IDM_PORT1		127
+#define IDM_PORT2		128
+#define IDM_PORT3		129
+#define IDM_PORT4		130
+#define IDM_PORT5		131
+#define IDM_PORT6		132
+#define IDM_PORT7		133
+#define IDM_PORT8		134
+#define IDM_NEXTSESSION	135
 
 